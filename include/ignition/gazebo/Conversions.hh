@@ -30,10 +30,12 @@
 #include <ignition/msgs/plugin.pb.h>
 #include <ignition/msgs/plugin_v.pb.h>
 #include <ignition/msgs/physics.pb.h>
+#include <ignition/msgs/pose.pb.h>
 #include <ignition/msgs/scene.pb.h>
 #include <ignition/msgs/sensor.pb.h>
 #include <ignition/msgs/sensor_noise.pb.h>
 #include <ignition/msgs/time.pb.h>
+#include <ignition/msgs/vector3d.pb.h>
 #include <ignition/msgs/world_stats.pb.h>
 
 #include <chrono>
@@ -41,6 +43,8 @@
 
 #include <ignition/common/Console.hh>
 #include <ignition/math/Inertial.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
 #include <sdf/Actor.hh>
 #include <sdf/Atmosphere.hh>
 #include <sdf/Collision.hh>
@@ -88,6 +92,51 @@ namespace ignition
     void IGNITION_GAZEBO_VISIBLE
     set(msgs::Time *_msg, const std::chrono::steady_clock::duration &_in);
 
+    /// \brief Helper function that sets a mutable msgs::Pose object to the
+    /// values contained in a math::Pose3d object. Only the position and
+    /// orientation are written, so a message can be reused across updates
+    /// without allocating.
+    /// \param[out] _msg Pose message to set.
+    /// \param[in] _in Math pose.
+    void IGNITION_GAZEBO_VISIBLE
+    set(msgs::Pose *_msg, const math::Pose3d &_in);
+
+    /// \brief Helper function that sets a mutable msgs::Vector3d object to
+    /// the values contained in a math::Vector3d object.
+    /// \param[out] _msg Vector3d message to set.
+    /// \param[in] _in Math vector.
+    void IGNITION_GAZEBO_VISIBLE
+    set(msgs::Vector3d *_msg, const math::Vector3d &_in);
+
+    /// \brief Helper function that sets a math::Pose3d object to the values
+    /// contained in a msgs::Pose object. The orientation is corrected as in
+    /// convert<math::Pose3d>.
+    /// \param[out] _out Pose to set.
+    /// \param[in] _in Pose message.
+    void IGNITION_GAZEBO_VISIBLE
+    set(math::Pose3d *_out, const msgs::Pose &_in);
+
+    /// \brief Helper function that sets a math::Vector3d object to the
+    /// values contained in a msgs::Vector3d object.
+    /// \param[out] _out Vector to set.
+    /// \param[in] _in Vector3d message.
+    void IGNITION_GAZEBO_VISIBLE
+    set(math::Vector3d *_out, const msgs::Vector3d &_in);
+
+    /// \brief Helper function that sets a std::chrono::steady_clock::duration
+    /// object to the values contained in a msgs::Time object.
+    /// \param[out] _out Chrono duration to set.
+    /// \param[in] _in Time message.
+    void IGNITION_GAZEBO_VISIBLE
+    set(std::chrono::steady_clock::duration *_out, const msgs::Time &_in);
+
+    /// \brief Helper function that sets a gazebo::UpdateInfo object to the
+    /// values contained in a msgs::WorldStatistics object.
+    /// \param[out] _out UpdateInfo to set.
+    /// \param[in] _in WorldStatistics message.
+    void IGNITION_GAZEBO_VISIBLE
+    set(UpdateInfo *_out, const msgs::WorldStatistics &_in);
+
     /// \brief Generic conversion from an SDF geometry to another type.
     /// \param[in] _in SDF geometry.
     /// \return Conversion result.
@@ -312,6 +312,19 @@ namespace ignition
               std::optional<typename ComponentTypeT::Type> ComponentData(
               const Entity _entity) const;
 
+      /// \brief Get a component of an entity, or of its closest ancestor
+      /// that has one. This is meant for components that apply to a whole
+      /// subtree unless a descendant overrides them, such as semantic
+      /// labels: setting the component on a model is then enough for all its
+      /// links and visuals, however deeply nested.
+      /// \param[in] _entity The entity.
+      /// \tparam ComponentTypeT Component type
+      /// \return The component of the entity or of its closest ancestor, or
+      /// nullptr if neither has the component.
+      public: template<typename ComponentTypeT>
+              const ComponentTypeT *ComponentInherited(
+              const Entity _entity) const;
+
       /// \brief Set the data from a component.
       /// * If the component type doesn't hold any data, this won't compile.
       /// * If the entity doesn't have that component, the component will be
@@ -601,6 +614,21 @@ namespace ignition
       public: std::unordered_set<ComponentTypeId>
           ComponentTypesWithPeriodicChanges() const;
 
+      /// \brief Get the entities whose component of the given type is marked
+      /// as a one-time or periodic change. This is cheaper than checking the
+      /// ComponentState of every entity when few of them changed.
+      /// \param[in] _typeId Type of the component.
+      /// \return Entities which had that component changed.
+      public: std::unordered_set<Entity> EntitiesWithComponentChanges(
+          const ComponentTypeId _typeId) const;
+
+      /// \brief Get the entities whose component of the given type was
+      /// removed during the current iteration.
+      /// \param[in] _typeId Type of the component.
+      /// \return Entities which had that component removed.
+      public: std::unordered_set<Entity> EntitiesWithRemovedComponent(
+          const ComponentTypeId _typeId) const;
+
       /// \brief Set the absolute state of the ECM from a serialized message.
       /// Entities / components that are in the new state but not in the old
       /// one will be created.
@@ -695,6 +723,28 @@ namespace ignition
       /// \brief Mark all components as not changed.
       protected: void SetAllComponentsUnchanged();
 
+      /// \brief Get a component to share with another manager, such as the
+      /// one of a forked world, instead of copying it. Both managers copy
+      /// the component before they first modify it. This function is
+      /// protected to facilitate testing.
+      /// \param[in] _entity The entity.
+      /// \param[in] _type Id of the component type.
+      /// \return The component, or nullptr if the entity doesn't have a
+      /// component of this type.
+      protected: std::shared_ptr<const components::BaseComponent>
+                   ShareComponent(const Entity _entity,
+                                  const ComponentTypeId _type);
+
+      /// \brief Add a component shared by another manager, see
+      /// ShareComponent. A component of the same type the entity already has
+      /// is replaced. This function is protected to facilitate testing.
+      /// \param[in] _entity The entity.
+      /// \param[in] _component The shared component.
+      /// \return True if the component was added.
+      protected: bool AddSharedComponent(const Entity _entity,
+                   std::shared_ptr<const components::BaseComponent>
+                   _component);
+
       /// \brief Get whether an Entity exists and is new.
       ///
       /// Entities are considered new in the time between their creation and a
@@ -720,6 +770,19 @@ namespace ignition
                    const ComponentTypeId _componentTypeId,
                    const components::BaseComponent *_data);
 
+      /// \brief Implementation of CreateComponent and AddSharedComponent.
+      /// \param[in] _entity The entity that will be associated with
+      /// the component.
+      /// \param[in] _componentTypeId Id of the component type.
+      /// \param[in] _component The component, which is only stored if the
+      /// entity doesn't have a component of this type yet.
+      /// \return True if the entity already had a component of this type,
+      /// whose data needs to be updated externally; false otherwise.
+      private: bool AddComponentImplementation(
+                   const Entity _entity,
+                   const ComponentTypeId _componentTypeId,
+                   std::shared_ptr<components::BaseComponent> _component);
+
       /// \brief Get a component based on a component type.
       /// \param[in] _entity The entity.
       /// \param[in] _type Id of the component type.
@@ -729,7 +792,8 @@ namespace ignition
                    const Entity _entity,
                    const ComponentTypeId _type) const;
 
-      /// \brief Get a mutable component based on a component type.
+      /// \brief Get a mutable component based on a component type. A
+      /// component shared with another manager is copied first.
       /// \param[in] _entity The entity.
       /// \param[in] _type Id of the component type.
       /// \return The component of the specified type assigned to specified
@@ -738,6 +802,12 @@ namespace ignition
                    const Entity _entity,
                    const ComponentTypeId _type);
 
+      /// \brief Copy the components of the entities in a view which are
+      /// shared with other managers, before mutable pointers to them are
+      /// handed out.
+      /// \param[in] _view The view.
+      private: void UnshareComponents(const detail::BaseView &_view);
+
       /// \brief Find a View that matches the set of ComponentTypeIds. If
       /// a match is not found, then a new view is created.
       /// \tparam ComponentTypeTs All the component types that define a view.
@@ -17,11 +17,14 @@
 #ifndef IGNITION_GAZEBO_EVENTMANAGER_HH_
 #define IGNITION_GAZEBO_EVENTMANAGER_HH_
 
+#include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <typeinfo>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Event.hh>
@@ -29,6 +32,7 @@
 #include <ignition/gazebo/config.hh>
 #include <ignition/gazebo/Export.hh>
 #include <ignition/gazebo/Types.hh>
+#include <ignition/gazebo/detail/EventConnections.hh>
 
 namespace ignition
 {
@@ -68,56 +72,75 @@ namespace ignition
               ignition::common::ConnectionPtr
               Connect(const typename E::CallbackT &_subscriber)
               {
-                if (this->events.find(typeid(E)) == this->events.end()) {
-                  this->events[typeid(E)] = std::make_unique<E>();
-                }
-
-                E *eventPtr = dynamic_cast<E *>(this->events[typeid(E)].get());
-                // All values in the map should be derived from Event,
-                // so this shouldn't be an issue, but it doesn't hurt to check.
-                if (eventPtr != nullptr)
-                {
-                  return eventPtr->Connect(_subscriber);
-                }
-                else
-                {
-                  ignerr << "Failed to connect event: "
-                    << typeid(E).name() << std::endl;
-                  return nullptr;
-                }
+                return this->FindOrCreate<E>()->Connect(_subscriber);
               }
 
       /// \brief Emit an event signal to connected subscribers.
+      ///
+      /// Emitting doesn't take any lock, it's safe to emit from several
+      /// threads at once, and to connect or disconnect while emitting.
       /// \param[in] _args function arguments to be passed to the event
       /// callbacks. Must match the signature of the event type E.
       public: template <typename E, typename ... Args>
               void Emit(Args && ... _args)
               {
-                if (this->events.find(typeid(E)) == this->events.end())
-                {
-                  // If there are no events of type E in the map, create it.
-                  // But it also means there is nothing to signal.
-                  //
-                  // This is also needed to suppress unused function warnings
-                  // for Events that are purely emitted, with no connections.
-                  this->events[typeid(E)] = std::make_unique<E>();
-                  return;
-                }
-
-                E *eventPtr = dynamic_cast<E *>(this->events[typeid(E)].get());
-                // All values in the map should be derived from Event,
-                // so this shouldn't be an issue, but it doesn't hurt to check.
-                if (eventPtr != nullptr)
-                {
+                // If there are no connections of type E there is nothing to
+                // signal.
+                auto eventPtr = this->Find<E>();
+                if (nullptr != eventPtr)
                   eventPtr->Signal(std::forward<Args>(_args) ...);
-                }
-                else
-                {
-                  ignerr << "Failed to signal event: "
-                    << typeid(E).name() << std::endl;
-                }
               }
 
+      /// \brief Get the connections to an event type.
+      /// \return Pointer to the connections, or nullptr if nothing ever
+      /// connected to the event.
+      private: template <typename E>
+               detail::EventConnections<E> *Find() const
+               {
+                 const EventMap *current = this->events.load();
+                 if (nullptr == current)
+                   return nullptr;
+
+                 auto it = current->find(typeid(E));
+                 if (it == current->end())
+                   return nullptr;
+
+                 // Values are only ever added by FindOrCreate with the
+                 // matching type.
+                 return static_cast<detail::EventConnections<E> *>(
+                     it->second);
+               }
+
+      /// \brief Get the connections to an event type, creating them if
+      /// needed.
+      /// \return Pointer to the connections.
+      private: template <typename E>
+               detail::EventConnections<E> *FindOrCreate()
+               {
+                 std::lock_guard<std::mutex> lock(this->mutex);
+                 auto eventPtr = this->Find<E>();
+                 if (nullptr != eventPtr)
+                   return eventPtr;
+
+                 auto newEvent =
+                     std::make_unique<detail::EventConnections<E>>();
+                 eventPtr = newEvent.get();
+
+                 // Copy the table instead of modifying it, so emitters can
+                 // keep reading the current one. Event types are never
+                 // removed, so there are few tables and all are kept until
+                 // destruction.
+                 auto table = std::make_unique<EventMap>();
+                 const EventMap *current = this->events.load();
+                 if (nullptr != current)
+                   *table = *current;
+                 (*table)[typeid(E)] = eventPtr;
+
+                 this->owned.push_back(std::move(newEvent));
+                 this->events.store(table.get());
+                 this->tables.push_back(std::move(table));
+                 return eventPtr;
+               }
 
       /// \brief Convenience type for storing typeinfo references.
       private: using TypeInfoRef = std::reference_wrapper<const std::type_info>;
@@ -140,10 +163,22 @@ namespace ignition
                  }
                };
 
-      /// \brief Container of used signals.
-      private: std::unordered_map<TypeInfoRef,
-                                  std::unique_ptr<ignition::common::Event>,
-                                  Hasher, EqualTo> events;
+      /// \brief Table from event type to its connections.
+      private: using EventMap = std::unordered_map<TypeInfoRef,
+                                                   ignition::common::Event *,
+                                                   Hasher, EqualTo>;
+
+      /// \brief Latest table of used signals, read without locking.
+      private: std::atomic<const EventMap *> events{nullptr};
+
+      /// \brief All tables which have been published.
+      private: std::vector<std::unique_ptr<const EventMap>> tables;
+
+      /// \brief Connections to all used signals.
+      private: std::vector<std::unique_ptr<ignition::common::Event>> owned;
+
+      /// \brief Serializes adding signals.
+      private: std::mutex mutex;
     };
     }
   }
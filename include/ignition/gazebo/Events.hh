@@ -31,6 +31,9 @@ namespace ignition
   {
     // Inline bracket to help doxygen filtering.
     inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class EntityComponentManager;
+
     /// \brief Namespace for all events. Refer to the EventManager class for
     /// more information about events.
     namespace events
@@ -72,6 +75,14 @@ namespace ignition
       /// Makre sure that you don't also connect to the LoadPlugins event.
       using LoadSdfPlugins = common::EventT<void(Entity, sdf::Plugins),
           struct LoadPluginsTag>;
+
+      /// \brief Event emitted between two steps, right before a snapshot of
+      /// the world is taken to fork it or to write a checkpoint. Systems can
+      /// store state they otherwise only keep internally in the entity
+      /// component manager, so it's part of the snapshot. For example, the
+      /// physics system stores the velocities of links and joints.
+      using BeforeSnapshot = common::EventT<void(EntityComponentManager &),
+          struct BeforeSnapshotTag>;
       }
     }  // namespace events
   }  // namespace gazebo
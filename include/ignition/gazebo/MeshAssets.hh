@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_MESHASSETS_HH_
+#define IGNITION_GAZEBO_MESHASSETS_HH_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+
+#include <ignition/common/Mesh.hh>
+#include <sdf/World.hh>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class MeshAssetsPrivate;
+
+    /// \brief Counters of how meshes were obtained by MeshAssets.
+    struct MeshAssetStatistics
+    {
+      /// \brief Number of meshes decoded from their original files.
+      uint64_t decoded{0};
+
+      /// \brief Number of meshes read from the disk cache.
+      uint64_t cacheHits{0};
+
+      /// \brief Number of meshes derived from other meshes.
+      uint64_t derived{0};
+
+      /// \brief Number of meshes written to the disk cache.
+      uint64_t cacheWrites{0};
+
+      /// \brief Number of files removed from the disk cache to keep it
+      /// within its size limit.
+      uint64_t cacheEvictions{0};
+    };
+
+    /// \brief Function deriving a mesh from another one.
+    /// \param[in] _mesh The original mesh.
+    /// \return The derived mesh, or null on failure.
+    using DeriveMeshFn = std::function<std::unique_ptr<common::Mesh>(
+        const common::Mesh &_mesh)>;
+
+    /// \brief Process-wide service loading the meshes used by simulation.
+    ///
+    /// Meshes are decoded once per process and registered with
+    /// common::MeshManager, so physics, rendering and other systems share
+    /// the same instance regardless of how they spelled the path. Decoded
+    /// meshes are also stored in a compact binary cache on disk, keyed by
+    /// the path, modification time and size of the original file, so other
+    /// processes and later runs skip parsing COLLADA, OBJ and STL files.
+    ///
+    /// The cache is stored in `$HOME/.ignition/gazebo/mesh_cache` by
+    /// default, which can be changed through the
+    /// `IGN_GAZEBO_MESH_CACHE_PATH` environment variable. When it grows
+    /// past its size limit, the least recently used files are removed.
+    ///
+    /// Meshes with skeletons or PBR materials are never written to the disk
+    /// cache, they're decoded from the original file every time.
+    ///
+    /// Preloaded meshes are decoded on background threads, but they're only
+    /// registered with common::MeshManager, which isn't thread safe, by the
+    /// threads calling Load. Preloaded meshes which are never loaded are
+    /// kept until all requests preloading them are canceled.
+    class IGNITION_GAZEBO_VISIBLE MeshAssets
+    {
+      /// \brief Get the service.
+      /// \return The process-wide service.
+      public: static MeshAssets &Instance();
+
+      /// \brief Destructor. Waits for meshes being preloaded.
+      /// \sa FinishPreload
+      /// \sa CancelPreload
+      public: ~MeshAssets();
+
+      /// \brief Load a mesh. If the mesh is being preloaded, this waits
+      /// for it, or decodes it right away if no preload thread started on it
+      /// yet.
+      /// \param[in] _path Path to the mesh file. It's resolved with
+      /// common::findFile.
+      /// \return The mesh, owned by common::MeshManager, or null if it
+      /// couldn't be loaded.
+      public: const common::Mesh *Load(const std::string &_path);
+
+      /// \brief Load a mesh derived from a mesh file, such as a simplified
+      /// version of it. Derived meshes are cached in memory and on disk like
+      /// decoded meshes, keyed by the original file and the variant.
+      /// \param[in] _path Path to the original mesh file.
+      /// \param[in] _variant Name of the variant, which must change whenever
+      /// the parameters of _derive change.
+      /// \param[in] _derive Function deriving the mesh, called only if the
+      /// variant isn't cached.
+      /// \return The derived mesh, owned by common::MeshManager, or null if
+      /// it couldn't be derived.
+      public: const common::Mesh *LoadDerived(const std::string &_path,
+                  const std::string &_variant, const DeriveMeshFn &_derive);
+
+      /// \brief Start decoding meshes concurrently on background threads,
+      /// at most one per core. Returns right away, later calls to Load wait
+      /// for the meshes they need.
+      /// \param[in] _paths Paths to mesh files.
+      /// \return Identifier of the request, to cancel it.
+      /// \sa CancelPreload
+      public: uint64_t Preload(const std::set<std::string> &_paths);
+
+      /// \brief Cancel a preload request. Its meshes which weren't loaded
+      /// and aren't wanted by other requests are dropped, whether they were
+      /// decoded already or not.
+      /// \param[in] _request Identifier returned by Preload.
+      public: void CancelPreload(uint64_t _request);
+
+      /// \brief Wait for the meshes being preloaded to be decoded and stop
+      /// the background threads. Later calls to Preload start new threads.
+      public: void FinishPreload();
+
+      /// \brief Start decoding the meshes referenced by a world.
+      /// \param[in] _world The world.
+      /// \param[in] _collisions True to preload the meshes of collisions,
+      /// used by physics.
+      /// \param[in] _visuals True to preload the meshes of visuals, used by
+      /// rendering.
+      /// \return Identifier of the request, to cancel it.
+      /// \sa Preload
+      public: uint64_t PreloadWorld(const sdf::World &_world,
+                  bool _collisions, bool _visuals);
+
+      /// \brief Set the directory of the disk cache.
+      /// \param[in] _path Directory, created if needed. Empty to disable the
+      /// disk cache.
+      public: void SetCachePath(const std::string &_path);
+
+      /// \brief Get the directory of the disk cache.
+      /// \return Directory, empty if the disk cache is disabled.
+      public: std::string CachePath() const;
+
+      /// \brief Set the size limit of the disk cache. Files not read for
+      /// the longest time are removed when a write takes the cache past it.
+      /// \param[in] _bytes Limit in bytes. Defaults to 1 GiB.
+      public: void SetCacheSizeLimit(uint64_t _bytes);
+
+      /// \brief Get the size limit of the disk cache.
+      /// \return Limit in bytes.
+      public: uint64_t CacheSizeLimit() const;
+
+      /// \brief Get how meshes were obtained so far.
+      /// \return Counters.
+      public: MeshAssetStatistics Statistics() const;
+
+      /// \brief Constructor, use Instance().
+      private: MeshAssets();
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<MeshAssetsPrivate> dataPtr;
+    };
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_MESSAGEBUS_HH_
+#define IGNITION_GAZEBO_MESSAGEBUS_HH_
+
+#include <google/protobuf/message.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <ignition/transport/Node.hh>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/EventManager.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class IGNITION_GAZEBO_HIDDEN MessageBusPrivate;
+    class IGNITION_GAZEBO_HIDDEN MessageBusTopic;
+
+    /// \class MessageBus MessageBus.hh ignition/gazebo/MessageBus.hh
+    /// \brief Simulation-local message bus, used by systems of the same
+    /// world to exchange messages without going through ign-transport.
+    ///
+    /// Messages are shared between publishers and subscribers instead of
+    /// being serialized. Messages published during a simulation step are
+    /// queued, and the simulation runner delivers them to the subscribers at
+    /// the beginning of the next step. Delivery order is the publication
+    /// order, so it doesn't depend on thread scheduling.
+    ///
+    /// Threading: subscriber callbacks always run on the simulation thread,
+    /// one after the other, before the systems are updated. They never run
+    /// concurrently with the PreUpdate, Update or PostUpdate of any system,
+    /// so state written by callbacks and read by the subscribing system's
+    /// updates doesn't need to be locked. This makes the bus the command
+    /// inbox of controller systems: commands are ingested at a fixed point
+    /// of the step.
+    ///
+    /// Publishing, from any thread, and ign-transport callbacks push to a
+    /// lock-free queue, so publishers never wait for each other or for the
+    /// dispatch.
+    ///
+    /// Topics are still bridged to ign-transport:
+    ///  * Messages published on the bus are also published on ign-transport
+    ///    when the topic has subscribers outside of the bus. Subscribers are
+    ///    looked up when a topic is advertised and on each dispatch, so
+    ///    publishing doesn't wait for ign-transport.
+    ///  * Subscribers of the bus also receive messages published on
+    ///    ign-transport by anyone else, e.g. from the command line, the GUI
+    ///    or the bus of another world.
+    ///
+    /// There is one bus per world. Systems get it from the event manager
+    /// they receive on `Configure`:
+    ///
+    ///     auto bus = MessageBus::Instance(_eventMgr);
+    ///     auto pub = bus->Advertise<msgs::Double>("/cmd");
+    ///     bus->Subscribe<msgs::Double>("/cmd", callback);
+    class IGNITION_GAZEBO_VISIBLE MessageBus
+    {
+      /// \brief Handle used to publish messages on a topic of the bus. It's
+      /// cheap to copy, and can be used from any thread.
+      public: class IGNITION_GAZEBO_VISIBLE Publisher
+      {
+        /// \brief Default constructor, creates an invalid publisher.
+        public: Publisher() = default;
+
+        /// \brief Publish a message. The message is copied once, and the copy
+        /// is shared by all subscribers.
+        /// \param[in] _msg Message to publish. Its type must match the type
+        /// the topic was advertised with.
+        /// \return True if the message was queued.
+        public: bool Publish(const google::protobuf::Message &_msg);
+
+        /// \brief Publish a message without copying it. The message must not
+        /// be modified after this call.
+        /// \param[in] _msg Message to publish. Its type must match the type
+        /// the topic was advertised with.
+        /// \return True if the message was queued.
+        public: bool Publish(
+                    const std::shared_ptr<const google::protobuf::Message> &_msg);
+
+        /// \brief Whether the publisher was returned by a successful
+        /// Advertise call.
+        /// \return True if valid.
+        public: bool Valid() const;
+
+        /// \brief Whether the topic has any subscriber, on the bus or on
+        /// ign-transport. Subscribers on ign-transport are the ones seen by
+        /// the last dispatch.
+        /// \return True if there are subscribers.
+        public: bool HasConnections() const;
+
+        /// \brief Whether the topic has subscribers on ign-transport, other
+        /// than the bus itself, as seen by the last dispatch. Published
+        /// messages are only forwarded to ign-transport when this is true.
+        /// \return True if there are subscribers on ign-transport.
+        public: bool HasTransportConnections() const;
+
+        /// \brief Conversion to bool, same as Valid.
+        /// \return True if valid.
+        public: explicit operator bool() const;
+
+        /// \brief Bus this publisher belongs to.
+        private: std::shared_ptr<MessageBusPrivate> bus;
+
+        /// \brief Topic of this publisher, owned by the bus.
+        private: MessageBusTopic *topic{nullptr};
+
+        friend class MessageBus;
+      };
+
+      /// \brief Constructor. Systems should use Instance instead.
+      public: MessageBus();
+
+      /// \brief Destructor
+      public: ~MessageBus();
+
+      /// \brief Get the bus shared by all users of an event manager, which
+      /// means all systems of a world. The bus is created on the first call.
+      /// \param[in] _eventMgr Event manager of the world.
+      /// \return The bus.
+      public: static std::shared_ptr<MessageBus> Instance(
+                  const EventManager &_eventMgr);
+
+      /// \brief Advertise a topic.
+      /// \param[in] _topic Topic name.
+      /// \tparam MsgT Message type.
+      /// \return Publisher for the topic. It's invalid if the topic name is
+      /// invalid or the topic already has a different message type.
+      public: template<typename MsgT>
+              Publisher Advertise(const std::string &_topic)
+      {
+        return this->AdvertiseImpl(_topic, MsgT().GetTypeName(),
+            [this](const std::string &_validTopic)
+            {
+              return this->Node().Advertise<MsgT>(_validTopic);
+            });
+      }
+
+      /// \brief Subscribe to a topic. The callback is called from the
+      /// simulation thread, at the beginning of the step that follows the
+      /// publication.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _callback Function called for each message.
+      /// \tparam MsgT Message type.
+      /// \return True if subscribed. False if the topic name is invalid or
+      /// the topic already has a different message type.
+      public: template<typename MsgT>
+              bool Subscribe(const std::string &_topic,
+                             const std::function<void(const MsgT &)> &_callback)
+      {
+        return this->SubscribeImpl(_topic, MsgT().GetTypeName(),
+            [_callback](const google::protobuf::Message &_msg)
+            {
+              _callback(static_cast<const MsgT &>(_msg));
+            },
+            [this](const std::string &_validTopic,
+                   const EnqueueFn &_enqueue)
+            {
+              std::function<void(const MsgT &)> cb =
+                  [_enqueue](const MsgT &_msg)
+                  {
+                    _enqueue(std::make_shared<MsgT>(_msg));
+                  };
+              return this->Node().Subscribe(_validTopic, cb);
+            });
+      }
+
+      /// \brief Subscribe to a topic with a member function callback.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _callback Member function called for each message.
+      /// \param[in] _obj Object whose member function is called.
+      /// \tparam ClassT Class of the object.
+      /// \tparam MsgT Message type.
+      /// \return True if subscribed.
+      public: template<typename ClassT, typename MsgT>
+              bool Subscribe(const std::string &_topic,
+                             void (ClassT::*_callback)(const MsgT &),
+                             ClassT *_obj)
+      {
+        std::function<void(const MsgT &)> cb =
+            [_callback, _obj](const MsgT &_msg)
+            {
+              (_obj->*_callback)(_msg);
+            };
+        return this->Subscribe(_topic, cb);
+      }
+
+      /// \brief Deliver all queued messages to their subscribers, and look
+      /// up which topics have subscribers on ign-transport. Called by the
+      /// simulation runner at the beginning of each step.
+      public: void Dispatch();
+
+      /// \brief Function that queues a message received from ign-transport.
+      private: using EnqueueFn = std::function<void(
+          const std::shared_ptr<const google::protobuf::Message> &)>;
+
+      /// \brief Implementation of Advertise.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _msgType Message type name.
+      /// \param[in] _advertise Function that advertises the validated topic
+      /// on ign-transport.
+      /// \return Publisher for the topic.
+      private: Publisher AdvertiseImpl(const std::string &_topic,
+          const std::string &_msgType,
+          const std::function<transport::Node::Publisher(
+              const std::string &)> &_advertise);
+
+      /// \brief Implementation of Subscribe.
+      /// \param[in] _topic Topic name.
+      /// \param[in] _msgType Message type name.
+      /// \param[in] _callback Type-erased subscriber callback.
+      /// \param[in] _subscribe Function that subscribes to the validated
+      /// topic on ign-transport, and passes received messages to the given
+      /// function.
+      /// \return True if subscribed.
+      private: bool SubscribeImpl(const std::string &_topic,
+          const std::string &_msgType,
+          const std::function<void(const google::protobuf::Message &)>
+              &_callback,
+          const std::function<bool(const std::string &, const EnqueueFn &)>
+              &_subscribe);
+
+      /// \brief Transport node used to bridge topics.
+      /// \return The node.
+      private: transport::Node &Node();
+
+      /// \brief Private data pointer.
+      private: std::shared_ptr<MessageBusPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
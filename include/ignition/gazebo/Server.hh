@@ -21,6 +21,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 #include <ignition/gazebo/config.hh>
 #include <ignition/gazebo/EntityComponentManager.hh>
 #include <ignition/gazebo/Export.hh>
@@ -285,6 +286,25 @@ namespace ignition
                                       bool _recursive = true,
                                       const unsigned int _worldIndex = 0);
 
+      /// \brief Fork a world into independent copies of its current state.
+      /// Each copy is a new world with the same entities, components, time
+      /// and system plugins as the original, which can then be modified and
+      /// stepped on its own. Components are shared between the worlds and
+      /// only copied once a world modifies them. Velocities held by the
+      /// physics engine are copied too, so forks keep moving like the
+      /// original. Systems added through AddSystem aren't copied.
+      /// Worlds being recorded, played back or distributed can't be forked.
+      /// The server must not be running when calling this.
+      /// \param[in] _count Number of copies.
+      /// \param[in] _worldIndex Index of the world to fork.
+      /// \return Indices of the new worlds, to be passed to the other
+      /// functions, or std::nullopt if the world couldn't be forked. The new
+      /// worlds are named after the original one, followed by "_fork_" and a
+      /// number.
+      public: std::optional<std::vector<unsigned int>> ForkWorld(
+                  const unsigned int _count,
+                  const unsigned int _worldIndex = 0);
+
       /// \brief Stop the server. This will stop all running simulations.
       public: void Stop();
 
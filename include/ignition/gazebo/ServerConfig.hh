@@ -20,7 +20,9 @@
 #include <chrono>
 #include <list>
 #include <memory>
+#include <map>
 #include <optional> // NOLINT(*)
+#include <set>
 #include <string>
 #include <vector>
 #include <sdf/Element.hh>
@@ -28,6 +30,7 @@
 #include <sdf/Root.hh>
 #include <ignition/gazebo/config.hh>
 #include <ignition/gazebo/Export.hh>
+#include <ignition/gazebo/ThreadRegistry.hh>
 
 namespace ignition
 {
@@ -58,6 +61,9 @@ namespace ignition
 
         // The source is an SDF string.
         kSdfString,
+
+        // The source is a checkpoint file.
+        kCheckpoint,
       };
 
 
@@ -343,6 +349,22 @@ namespace ignition
       /// \param[in] _playbackPath Path to recorded states
       public: void SetLogPlaybackPath(const std::string &_playbackPath);
 
+      /// \brief Set a checkpoint file to restore the world from, instead of
+      /// loading it from SDF. Checkpoints are saved by the
+      /// `/world/<world_name>/checkpoint` service. The world is rebuilt from
+      /// the entities and components in the checkpoint, simulation resumes
+      /// from the time of the checkpoint, and the systems that were loaded
+      /// when it was taken are loaded again. This overrides any SDF file,
+      /// string or root previously set.
+      /// \param[in] _path Path to the checkpoint file.
+      /// \return True if the path is not empty.
+      public: bool SetCheckpointRestorePath(const std::string &_path);
+
+      /// \brief Get the checkpoint file to restore the world from.
+      /// \return Path to the checkpoint file, empty if the world isn't
+      /// restored from a checkpoint.
+      public: const std::string &CheckpointRestorePath() const;
+
       /// \brief Get whether meshes and material files are recorded
       /// \return True if resources should be recorded.
       public: bool LogRecordResources() const;
@@ -420,6 +442,30 @@ namespace ignition
       /// \param[in] _renderEngineGui File containing render engine library.
       public: void SetRenderEngineGui(const std::string &_renderEngineGui);
 
+      /// \brief Set the cores a class of simulation threads runs on, such
+      /// as the simulation loop or the PostUpdate threads. Threads of
+      /// classes without cores may run on any core. The cores are applied
+      /// when the server is created, and are shared by all servers in the
+      /// process.
+      /// \param[in] _class Class of threads.
+      /// \param[in] _cores Indices of the cores, as numbered by the
+      /// operating system. Empty to let the threads run on any core.
+      /// \sa ThreadRegistry
+      public: void SetThreadAffinity(ThreadClass _class,
+                                     const std::set<unsigned int> &_cores);
+
+      /// \brief Get the cores a class of simulation threads runs on.
+      /// \param[in] _class Class of threads.
+      /// \return Indices of the cores, empty if the threads may run on any
+      /// core.
+      public: std::set<unsigned int> ThreadAffinity(ThreadClass _class) const;
+
+      /// \brief Get the cores of all classes of simulation threads which
+      /// have been set.
+      /// \return Cores of each class of threads.
+      public: const std::map<ThreadClass, std::set<unsigned int>> &
+              ThreadAffinities() const;
+
       /// \brief Instruct simulation to attach a plugin to a specific
       /// entity when simulation starts.
       /// \param[in] _info Information about the plugin to load.
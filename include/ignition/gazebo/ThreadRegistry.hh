@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_THREADREGISTRY_HH_
+#define IGNITION_GAZEBO_THREADREGISTRY_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class ThreadRegistryPrivate;
+
+    /// \brief Classes of threads started by simulation. All threads of a
+    /// class can be placed on the same set of cores.
+    enum class ThreadClass
+    {
+      /// \brief Threads running the simulation loop, one per world.
+      kSimulation,
+
+      /// \brief Threads running the PostUpdate of systems.
+      kPostUpdate,
+
+      /// \brief Threads serializing the state of the entity component
+      /// manager.
+      kState,
+
+      /// \brief Threads rendering sensors.
+      kRendering,
+    };
+
+    /// \brief Statistics of a registered thread, as reported by the
+    /// operating system. Only available on Linux, zero elsewhere.
+    struct ThreadStatistics
+    {
+      /// \brief Name of the thread.
+      std::string name;
+
+      /// \brief Class of the thread.
+      ThreadClass threadClass{ThreadClass::kSimulation};
+
+      /// \brief Operating system id of the thread.
+      uint64_t id{0};
+
+      /// \brief CPU time spent by the thread, in user and kernel space.
+      std::chrono::steady_clock::duration cpuTime{0};
+
+      /// \brief Number of times the thread was moved to another core.
+      uint64_t migrations{0};
+
+      /// \brief Number of times the thread was preempted.
+      uint64_t involuntarySwitches{0};
+
+      /// \brief Core the thread last ran on.
+      int lastCore{-1};
+    };
+
+    /// \brief Process-wide registry of the threads started by simulation.
+    ///
+    /// Threads register themselves when they start, which gives them a name
+    /// visible in debuggers and system monitors, places them on the cores
+    /// configured for their class, and makes their statistics available.
+    /// The cores are configured through ServerConfig::SetThreadAffinity
+    /// when a server is created.
+    class IGNITION_GAZEBO_VISIBLE ThreadRegistry
+    {
+      /// \brief Get the registry.
+      /// \return The process-wide registry.
+      public: static ThreadRegistry &Instance();
+
+      /// \brief Destructor
+      public: ~ThreadRegistry();
+
+      /// \brief Set the cores a class of threads runs on. Threads which are
+      /// already registered are moved right away.
+      /// \param[in] _class Class of threads.
+      /// \param[in] _cores Indices of the cores, as numbered by the operating
+      /// system. Empty to let the threads run on any core.
+      public: void SetAffinity(ThreadClass _class,
+                               const std::set<unsigned int> &_cores);
+
+      /// \brief Get the cores a class of threads runs on.
+      /// \param[in] _class Class of threads.
+      /// \return Indices of the cores, empty if the threads can run on any
+      /// core.
+      public: std::set<unsigned int> Affinity(ThreadClass _class) const;
+
+      /// \brief Register the calling thread. It's named, and placed on the
+      /// cores of its class until it's unregistered.
+      /// \param[in] _class Class of the thread.
+      /// \param[in] _name Name of the thread. Only the first 15 characters
+      /// are visible to the operating system.
+      public: void Register(ThreadClass _class, const std::string &_name);
+
+      /// \brief Unregister the calling thread, restoring the name it had and
+      /// the cores it ran on before it was registered.
+      public: void Unregister();
+
+      /// \brief Get statistics of all registered threads.
+      /// \return Statistics of each thread.
+      public: std::vector<ThreadStatistics> Statistics() const;
+
+      /// \brief Constructor, use Instance().
+      private: ThreadRegistry();
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<ThreadRegistryPrivate> dataPtr;
+    };
+
+    /// \brief Registers the calling thread on construction, and unregisters
+    /// it on destruction.
+    class IGNITION_GAZEBO_VISIBLE ScopedThreadRegistration
+    {
+      /// \brief Constructor
+      /// \param[in] _class Class of the thread.
+      /// \param[in] _name Name of the thread.
+      public: ScopedThreadRegistration(ThreadClass _class,
+                                       const std::string &_name);
+
+      /// \brief Destructor
+      public: ~ScopedThreadRegistration();
+
+      /// \brief Not copyable.
+      public: ScopedThreadRegistration(
+                  const ScopedThreadRegistration &) = delete;
+
+      /// \brief Not copyable.
+      public: ScopedThreadRegistration &operator=(
+                  const ScopedThreadRegistration &) = delete;
+    };
+
+    /// \brief Get the name of a class of threads.
+    /// \param[in] _class Class of threads.
+    /// \return Name, such as "simulation".
+    std::string IGNITION_GAZEBO_VISIBLE threadClassName(ThreadClass _class);
+    }
+  }
+}
+
+#endif
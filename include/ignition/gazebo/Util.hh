@@ -300,6 +300,10 @@ namespace ignition
     /// \brief Environment variable holding paths to custom rendering engine
     /// plugins.
     const std::string kRenderPluginPathEnv{"IGN_GAZEBO_RENDER_ENGINE_PATH"};
+
+    /// \brief Environment variable holding the directory where decoded meshes
+    /// are cached.
+    const std::string kMeshCachePathEnv{"IGN_GAZEBO_MESH_CACHE_PATH"};
     }
   }
 }
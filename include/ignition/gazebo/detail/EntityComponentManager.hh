@@ -170,6 +170,25 @@ std::optional<typename ComponentTypeT::Type>
   return std::make_optional(comp->Data());
 }
 
+//////////////////////////////////////////////////
+template<typename ComponentTypeT>
+const ComponentTypeT *EntityComponentManager::ComponentInherited(
+    const Entity _entity) const
+{
+  // Skip walking up the tree if no entity has the component
+  if (!this->HasComponentType(ComponentTypeT::typeId))
+    return nullptr;
+
+  for (auto entity = _entity; entity != kNullEntity;
+       entity = this->ParentEntity(entity))
+  {
+    auto comp = this->Component<ComponentTypeT>(entity);
+    if (comp)
+      return comp;
+  }
+  return nullptr;
+}
+
 //////////////////////////////////////////////////
 template<typename ComponentTypeT>
 bool EntityComponentManager::SetComponentData(const Entity _entity,
@@ -445,6 +464,7 @@ void EntityComponentManager::Each(typename identity<std::function<
   // Get the view. This will create a new view if one does not already
   // exist.
   auto view = this->FindView<ComponentTypeTs...>();
+  this->UnshareComponents(*view);
 
   // Iterate over the entities in the view, and invoke the callback
   // function.
@@ -474,6 +494,7 @@ void EntityComponentManager::EachNew(typename identity<std::function<
   // Get the view. This will create a new view if one does not already
   // exist.
   auto view = this->FindView<ComponentTypeTs...>();
+  this->UnshareComponents(*view);
 
   // Iterate over the entities in the view and in the newly created
   // entities list, and invoke the callback
@@ -561,14 +582,16 @@ detail::View *EntityComponentManager::FindView() const
       viewLock = std::make_unique<std::lock_guard<std::mutex>>(*mutexPtr);
     }
 
-    // add any new entities to the view before using it
+    // add any new entities to the view before using it. Components shared
+    // with other managers aren't copied here, the non-const Each functions
+    // copy them before handing out mutable pointers.
     for (const auto &[entity, isNew] : view->ToAddEntities())
     {
       view->AddEntityWithConstComps(entity, isNew,
           this->Component<ComponentTypeTs>(entity)...);
       view->AddEntityWithComps(entity, isNew,
-          const_cast<EntityComponentManager*>(this)->Component<ComponentTypeTs>(
-            entity)...);
+          const_cast<ComponentTypeTs *>(
+            this->Component<ComponentTypeTs>(entity))...);
     }
     view->ClearToAddEntities();
 
@@ -589,8 +612,8 @@ detail::View *EntityComponentManager::FindView() const
     view.AddEntityWithConstComps(entity, this->IsNewEntity(entity),
         this->Component<ComponentTypeTs>(entity)...);
     view.AddEntityWithComps(entity, this->IsNewEntity(entity),
-        const_cast<EntityComponentManager*>(this)->Component<ComponentTypeTs>(
-            entity)...);
+        const_cast<ComponentTypeTs *>(
+            this->Component<ComponentTypeTs>(entity))...);
     if (this->IsMarkedForRemoval(entity))
       view.MarkEntityToRemove(entity);
   }
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_DETAIL_EVENTCONNECTIONS_HH_
+#define IGNITION_GAZEBO_DETAIL_EVENTCONNECTIONS_HH_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/gazebo/config.hh"
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace detail
+{
+/// \brief Connections to a single event type, used by the EventManager in
+/// place of common::EventT.
+///
+/// Connecting and disconnecting are rare and copy the current list of
+/// callbacks into a new one, which is then published with an atomic
+/// exchange. Signaling is frequent, potentially many times per iteration
+/// and from several threads, and only loads the published list, without
+/// taking any lock.
+///
+/// A list which has been replaced is kept until no thread is signaling,
+/// so a callback may safely connect or disconnect while being called.
+/// \tparam E The event type, such as events::Pause.
+template <typename E>
+class EventConnections : public common::Event
+{
+  /// \brief Callback type of the event.
+  public: using CallbackT = typename E::CallbackT;
+
+  /// \brief Destructor
+  public: ~EventConnections() override
+  {
+    delete this->slots.load();
+  }
+
+  /// \brief Add a connection.
+  /// \param[in] _subscriber Callback to be called on every signal.
+  /// \return A Connection pointer, which will automatically call
+  /// Disconnect when it goes out of scope.
+  public: common::ConnectionPtr Connect(const CallbackT &_subscriber)
+  {
+    auto slot = std::make_shared<Slot>();
+    slot->callback = _subscriber;
+
+    RetiredList released;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      slot->id = this->nextId++;
+
+      auto updated = std::make_unique<SlotList>();
+      const SlotList *current = this->slots.load();
+      if (nullptr != current)
+      {
+        updated->reserve(current->size() + 1);
+        *updated = *current;
+      }
+      updated->push_back(slot);
+      released = this->PublishLocked(std::move(updated));
+    }
+
+    return std::make_shared<common::Connection>(this, slot->id);
+  }
+
+  // Documentation inherited
+  public: void Disconnect(int _id) override
+  {
+    RetiredList released;
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      const SlotList *current = this->slots.load();
+      if (nullptr == current)
+        return;
+
+      auto updated = std::make_unique<SlotList>();
+      updated->reserve(current->size());
+      for (const auto &slot : *current)
+      {
+        if (slot->id == _id)
+        {
+          // Signals already iterating over the current list must skip it
+          slot->on = false;
+        }
+        else
+        {
+          updated->push_back(slot);
+        }
+      }
+
+      if (updated->size() == current->size())
+        return;
+
+      released = this->PublishLocked(std::move(updated));
+    }
+  }
+
+  /// \brief Call all connected callbacks.
+  /// \param[in] _args Arguments passed to every callback.
+  public: template <typename ... Args>
+          void Signal(Args && ... _args)
+          {
+            this->readers.fetch_add(1);
+            const SlotList *current = this->slots.load();
+            if (nullptr != current)
+            {
+              for (const auto &slot : *current)
+              {
+                if (slot->on.load(std::memory_order_acquire))
+                  slot->callback(_args...);
+              }
+            }
+
+            // The last thread out frees lists which were replaced while it
+            // was signaling.
+            if (this->readers.fetch_sub(1) == 1 &&
+                this->retiredCount.load() > 0)
+            {
+              RetiredList released;
+              std::unique_lock<std::mutex> lock(this->mutex, std::try_to_lock);
+              if (lock.owns_lock())
+                released = this->ReleaseLocked();
+            }
+          }
+
+  /// \brief A connected callback.
+  private: struct Slot
+  {
+    /// \brief Connection id.
+    int id{0};
+
+    /// \brief Callback to be called on every signal.
+    CallbackT callback;
+
+    /// \brief False once disconnected.
+    std::atomic<bool> on{true};
+  };
+
+  /// \brief An immutable list of callbacks.
+  private: using SlotList = std::vector<std::shared_ptr<Slot>>;
+
+  /// \brief Lists which have been replaced.
+  private: using RetiredList = std::vector<std::unique_ptr<const SlotList>>;
+
+  /// \brief Publish a new list of callbacks. Must be called with the mutex
+  /// locked.
+  /// \param[in] _updated The new list.
+  /// \return Replaced lists which can be freed. They must be destroyed
+  /// after the mutex is unlocked, because destroying a callback may
+  /// disconnect another one.
+  private: RetiredList PublishLocked(std::unique_ptr<SlotList> _updated)
+  {
+    const SlotList *old = this->slots.exchange(_updated.release());
+    if (nullptr != old)
+      this->retired.emplace_back(old);
+    return this->ReleaseLocked();
+  }
+
+  /// \brief Take the replaced lists if no thread is signaling. Must be
+  /// called with the mutex locked.
+  /// \return Replaced lists which can be freed.
+  private: RetiredList ReleaseLocked()
+  {
+    RetiredList released;
+    // Storing the count before checking for readers guarantees that a
+    // thread still signaling will see it once done and retry.
+    this->retiredCount.store(this->retired.size());
+
+    // A thread which starts signaling after this check is guaranteed to
+    // load the latest list, which is never retired while the mutex is held.
+    if (this->readers.load() == 0)
+    {
+      std::swap(released, this->retired);
+      this->retiredCount.store(0u);
+    }
+    return released;
+  }
+
+  /// \brief Latest list of callbacks.
+  private: std::atomic<const SlotList *> slots{nullptr};
+
+  /// \brief Number of threads currently reading the list.
+  private: mutable std::atomic<unsigned int> readers{0};
+
+  /// \brief Lists replaced while some thread was reading them.
+  private: RetiredList retired;
+
+  /// \brief Size of retired, readable without the mutex.
+  private: std::atomic<std::size_t> retiredCount{0};
+
+  /// \brief Serializes connecting and disconnecting.
+  private: std::mutex mutex;
+
+  /// \brief Id of the next connection.
+  private: int nextId{0};
+};
+}  // namespace detail
+}  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
+}  // namespace gazebo
+}  // namespace ignition
+#endif
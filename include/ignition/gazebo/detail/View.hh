@@ -120,6 +120,16 @@ class IGNITION_GAZEBO_VISIBLE View : public BaseView
   /// \brief Documentation inherited
   public: void Reset() override;
 
+  /// \brief Point the view to another instance of one of the components of
+  /// an entity, after the entity component manager replaced it. Nothing
+  /// happens if the view doesn't hold the entity's components.
+  /// \param[in] _entity The entity
+  /// \param[in] _index Index of the component type within the types the
+  /// view was created with, in the order they were requested.
+  /// \param[in] _comp The new instance of the component.
+  public: void ReplaceComponent(const Entity _entity,
+              const std::size_t _index, components::BaseComponent *_comp);
+
   /// \brief A map of entities to their component data. Since tuples are defined
   /// at compile time, we need separate containers that have tuples for both
   /// non-const and const component pointers (calls to ECM::Each can have a
@@ -17,6 +17,8 @@
 
 #include "Barrier.hh"
 
+#include <thread>
+
 class ignition::gazebo::BarrierPrivate
 {
   /// \brief Mutex for syncronization
@@ -32,20 +34,40 @@ class ignition::gazebo::BarrierPrivate
   public: unsigned int threadCount;
 
   /// \brief Current remaining thread count (decrements from threadCount)
-  public: unsigned int count;
+  public: std::atomic<unsigned int> count;
 
   /// \brief Barrier generation, incremented when all threads report
-  public: unsigned int generation{0};
+  public: std::atomic<unsigned int> generation{0};
+
+  /// \brief Number of threads blocked on the condition variable, so that
+  /// the last thread only notifies when someone is waiting.
+  public: std::atomic<unsigned int> parked{0};
+
+  /// \brief How threads wait for each other
+  public: Barrier::WaitPolicy policy{Barrier::WaitPolicy::PARK};
+
+  /// \brief Iterations spent spinning before parking
+  public: unsigned int spinCount{0};
 };
 
 using namespace ignition::gazebo;
 
 //////////////////////////////////////////////////
 Barrier::Barrier(unsigned int _threadCount)
+  : Barrier(_threadCount, WaitPolicy::PARK, 0)
+{
+}
+
+//////////////////////////////////////////////////
+Barrier::Barrier(unsigned int _threadCount, WaitPolicy _policy,
+                 unsigned int _spinCount)
   : dataPtr(std::make_unique<BarrierPrivate>())
 {
   this->dataPtr->threadCount = _threadCount;
   this->dataPtr->count = _threadCount;
+  this->dataPtr->policy = _policy;
+  if (_policy == WaitPolicy::SPIN_THEN_PARK)
+    this->dataPtr->spinCount = _spinCount;
 }
 
 //////////////////////////////////////////////////
@@ -59,23 +81,51 @@ Barrier::ExitStatus Barrier::Wait()
     return Barrier::ExitStatus::CANCELLED;
   }
 
-  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
-  unsigned int gen = this->dataPtr->generation;
+  // The generation can only change once this thread arrives, so this is the
+  // generation being waited on.
+  unsigned int gen = this->dataPtr->generation.load();
 
-  if (--this->dataPtr->count == 0)
+  if (this->dataPtr->count.fetch_sub(1) == 1)
   {
-    // All threads have reached the wait, so reset the barrier.
-    this->dataPtr->generation++;
+    // All threads have reached the wait, so reset the barrier before
+    // releasing the others, which may reach it again right away.
     this->dataPtr->count = this->dataPtr->threadCount;
-    this->dataPtr->cv.notify_all();
+    this->dataPtr->generation++;
+
+    // Parked threads check the generation while holding the mutex, so taking
+    // it here guarantees that they either see the new generation or are
+    // already waiting on the condition variable.
+    if (this->dataPtr->parked > 0)
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      this->dataPtr->cv.notify_all();
+    }
     return Barrier::ExitStatus::DONE_LAST;
   }
 
-  while (gen == this->dataPtr->generation && !this->dataPtr->cancelled)
+  auto released = [this, gen]()
+  {
+    return gen != this->dataPtr->generation.load() ||
+        this->dataPtr->cancelled;
+  };
+
+  // Spin for a while in case the remaining threads arrive soon
+  for (unsigned int i = 0; i < this->dataPtr->spinCount && !released(); ++i)
+  {
+    // Let other threads run every now and then, in case there are more
+    // threads than cores
+    if ((i & 0xff) == 0xff)
+      std::this_thread::yield();
+  }
+
+  if (!released())
   {
+    std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+    ++this->dataPtr->parked;
     // All threads haven't reached, so wait until generation is reached
     // or a cancel occurs
-    this->dataPtr->cv.wait(lock);
+    this->dataPtr->cv.wait(lock, released);
+    --this->dataPtr->parked;
   }
 
   if (this->dataPtr->cancelled)
@@ -92,9 +142,16 @@ Barrier::ExitStatus Barrier::Wait()
 void Barrier::Cancel()
 {
   std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  // Cancel before changing the generation, so spinning threads which see
+  // the new generation also see that the barrier was cancelled
+  this->dataPtr->cancelled.store(true, std::memory_order_seq_cst);
   // This forces pending threads to release
-  this->dataPtr->generation++;
-  this->dataPtr->cancelled = true;
+  this->dataPtr->generation.fetch_add(1, std::memory_order_seq_cst);
   this->dataPtr->cv.notify_all();
 }
 
+//////////////////////////////////////////////////
+Barrier::WaitPolicy Barrier::Policy() const
+{
+  return this->dataPtr->policy;
+}
@@ -46,6 +46,24 @@ namespace ignition
     /// is ratified: https://en.cppreference.com/w/cpp/experimental/barrier
     class IGNITION_GAZEBO_VISIBLE Barrier
     {
+      /// \brief Enumeration of the ways threads can wait for each other
+      public: enum class WaitPolicy
+      {
+        /// \brief Block on a condition variable right away.
+        PARK,
+        /// \brief Spin on the barrier's generation for a number of
+        /// iterations before blocking. This avoids putting threads to sleep
+        /// and waking them up when they all reach the barrier within a short
+        /// time of each other, at the cost of the CPU time spent spinning.
+        /// It should only be used when there are at least as many cores as
+        /// threads.
+        SPIN_THEN_PARK,
+      };
+
+      /// \brief Default number of iterations spent spinning with the
+      /// SPIN_THEN_PARK policy.
+      public: static constexpr unsigned int kDefaultSpinCount{4000};
+
       /// \brief Constructor
       /// \param[in] _threadCount Number of threads to syncronize
       /// Note: it is important to include a main thread (if used) in this
@@ -53,6 +71,15 @@ namespace ignition
       ///       1 main thread would require _threadCount=11.
       public: explicit Barrier(unsigned int _threadCount);
 
+      /// \brief Constructor
+      /// \param[in] _threadCount Number of threads to syncronize, including
+      /// any main thread.
+      /// \param[in] _policy How threads wait for each other.
+      /// \param[in] _spinCount Number of iterations spent spinning before
+      /// blocking, only used by SPIN_THEN_PARK.
+      public: Barrier(unsigned int _threadCount, WaitPolicy _policy,
+                      unsigned int _spinCount = kDefaultSpinCount);
+
       /// \brief Destructor
       public: ~Barrier();
 
@@ -85,6 +112,10 @@ namespace ignition
       ///        return CANCELLED
       public: void Cancel();
 
+      /// \brief Get the policy threads use to wait for each other.
+      /// \return The wait policy.
+      public: WaitPolicy Policy() const;
+
       /// \brief Pointer to private data.
       private: std::unique_ptr<BarrierPrivate> dataPtr;
     };
@@ -17,7 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #include "Barrier.hh"
 
@@ -30,9 +32,11 @@ inline bool wasCancelled(const gazebo::Barrier::ExitStatus &_ret)
 }
 
 //////////////////////////////////////////////////
-void syncThreadsTest(unsigned int _threadCount)
+void syncThreadsTest(unsigned int _threadCount,
+    gazebo::Barrier::WaitPolicy _policy = gazebo::Barrier::WaitPolicy::PARK)
 {
-  auto barrier = std::make_unique<gazebo::Barrier>(_threadCount + 1);
+  auto barrier = std::make_unique<gazebo::Barrier>(_threadCount + 1, _policy);
+  EXPECT_EQ(_policy, barrier->Policy());
 
   unsigned int preBarrier { 0 };
   unsigned int postBarrier { 0 };
@@ -120,6 +124,69 @@ TEST(Barrier, Sync50Threads)
   syncThreadsTest(50);
 }
 
+//////////////////////////////////////////////////
+TEST(Barrier, SpinSync1Thread)
+{
+  syncThreadsTest(1, gazebo::Barrier::WaitPolicy::SPIN_THEN_PARK);
+}
+
+//////////////////////////////////////////////////
+TEST(Barrier, SpinSync10Threads)
+{
+  syncThreadsTest(10, gazebo::Barrier::WaitPolicy::SPIN_THEN_PARK);
+}
+
+//////////////////////////////////////////////////
+void generationsTest(gazebo::Barrier::WaitPolicy _policy)
+{
+  // Threads go through the barrier many times in a row, as the simulation
+  // runner's threads do on every step.
+  const unsigned int threadCount{4};
+  const unsigned int generations{1000};
+  gazebo::Barrier barrier(threadCount + 1, _policy);
+
+  std::atomic<unsigned int> lastCount{0};
+  std::atomic<unsigned int> work{0};
+  std::vector<std::thread> threads;
+  for (unsigned int ii = 0; ii < threadCount; ++ii)
+  {
+    threads.push_back(std::thread([&]()
+    {
+      for (unsigned int gen = 0; gen < generations; ++gen)
+      {
+        work++;
+        if (barrier.Wait() == gazebo::Barrier::ExitStatus::DONE_LAST)
+          lastCount++;
+      }
+    }));
+  }
+
+  for (unsigned int gen = 0; gen < generations; ++gen)
+  {
+    if (barrier.Wait() == gazebo::Barrier::ExitStatus::DONE_LAST)
+      lastCount++;
+  }
+
+  for (auto &t : threads)
+    t.join();
+
+  // Exactly one thread is last on each generation
+  EXPECT_EQ(generations, lastCount);
+  EXPECT_EQ(generations * threadCount, work);
+}
+
+//////////////////////////////////////////////////
+TEST(Barrier, Generations)
+{
+  generationsTest(gazebo::Barrier::WaitPolicy::PARK);
+}
+
+//////////////////////////////////////////////////
+TEST(Barrier, SpinGenerations)
+{
+  generationsTest(gazebo::Barrier::WaitPolicy::SPIN_THEN_PARK);
+}
+
 //////////////////////////////////////////////////
 TEST(Barrier, Cancel)
 {
@@ -174,3 +241,40 @@ TEST(Barrier, Cancel)
 
   t.join();
 }
+
+//////////////////////////////////////////////////
+TEST(Barrier, CancelWhileSpinning)
+{
+  // Cancelling races with the spinning threads checking the barrier, so
+  // repeat it
+  const unsigned int threadCount = 4;
+  for (unsigned int run = 0; run < 200; ++run)
+  {
+    // Spin for long enough that the threads never park
+    auto barrier = std::make_unique<gazebo::Barrier>(threadCount + 1,
+        gazebo::Barrier::WaitPolicy::SPIN_THEN_PARK, 1u << 30);
+
+    std::atomic<unsigned int> preBarrier{0};
+    std::atomic<unsigned int> cancelled{0};
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+      threads.push_back(std::thread([&]()
+      {
+        ++preBarrier;
+        if (wasCancelled(barrier->Wait()))
+          ++cancelled;
+      }));
+    }
+
+    while (preBarrier < threadCount)
+      std::this_thread::yield();
+
+    barrier->Cancel();
+    for (auto &t : threads)
+      t.join();
+
+    // No thread mistakes the cancellation for the barrier being reached
+    ASSERT_EQ(threadCount, cancelled) << "Run " << run;
+  }
+}
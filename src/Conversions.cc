@@ -119,15 +119,8 @@ template<>
 IGNITION_GAZEBO_VISIBLE
 math::Pose3d ignition::gazebo::convert(const msgs::Pose &_in)
 {
-  math::Pose3d out(_in.position().x(),
-                   _in.position().y(),
-                   _in.position().z(),
-                   _in.orientation().w(),
-                   _in.orientation().x(),
-                   _in.orientation().y(),
-                   _in.orientation().z());
-  out.Correct();
-
+  math::Pose3d out;
+  set(&out, _in);
   return out;
 }
 
@@ -732,12 +725,7 @@ msgs::Time ignition::gazebo::convert(
     const std::chrono::steady_clock::duration &_in)
 {
   msgs::Time out;
-
-  auto secNsec = ignition::math::durationToSecNsec(_in);
-
-  out.set_sec(secNsec.first);
-  out.set_nsec(secNsec.second);
-
+  set(&out, _in);
   return out;
 }
 
@@ -747,7 +735,9 @@ IGNITION_GAZEBO_VISIBLE
 std::chrono::steady_clock::duration ignition::gazebo::convert(
     const msgs::Time &_in)
 {
-  return std::chrono::seconds(_in.sec()) + std::chrono::nanoseconds(_in.nsec());
+  std::chrono::steady_clock::duration out;
+  set(&out, _in);
+  return out;
 }
 
 //////////////////////////////////////////////////
@@ -954,6 +944,64 @@ void ignition::gazebo::set(msgs::WorldStatistics *_msg,
   _msg->set_paused(_in.paused);
 }
 
+//////////////////////////////////////////////////
+void ignition::gazebo::set(msgs::Pose *_msg, const math::Pose3d &_in)
+{
+  set(_msg->mutable_position(), _in.Pos());
+
+  auto orientation = _msg->mutable_orientation();
+  orientation->set_x(_in.Rot().X());
+  orientation->set_y(_in.Rot().Y());
+  orientation->set_z(_in.Rot().Z());
+  orientation->set_w(_in.Rot().W());
+}
+
+//////////////////////////////////////////////////
+void ignition::gazebo::set(msgs::Vector3d *_msg, const math::Vector3d &_in)
+{
+  _msg->set_x(_in.X());
+  _msg->set_y(_in.Y());
+  _msg->set_z(_in.Z());
+}
+
+//////////////////////////////////////////////////
+void ignition::gazebo::set(math::Pose3d *_out, const msgs::Pose &_in)
+{
+  _out->Set(math::Vector3d(_in.position().x(),
+                            _in.position().y(),
+                            _in.position().z()),
+            math::Quaterniond(_in.orientation().w(),
+                              _in.orientation().x(),
+                              _in.orientation().y(),
+                              _in.orientation().z()));
+  _out->Correct();
+}
+
+//////////////////////////////////////////////////
+void ignition::gazebo::set(math::Vector3d *_out, const msgs::Vector3d &_in)
+{
+  _out->Set(_in.x(), _in.y(), _in.z());
+}
+
+//////////////////////////////////////////////////
+void ignition::gazebo::set(std::chrono::steady_clock::duration *_out,
+    const msgs::Time &_in)
+{
+  *_out = std::chrono::seconds(_in.sec()) +
+      std::chrono::nanoseconds(_in.nsec());
+}
+
+//////////////////////////////////////////////////
+void ignition::gazebo::set(gazebo::UpdateInfo *_out,
+    const msgs::WorldStatistics &_in)
+{
+  _out->iterations = _in.iterations();
+  _out->paused = _in.paused();
+  set(&_out->simTime, _in.sim_time());
+  set(&_out->realTime, _in.real_time());
+  set(&_out->dt, _in.step_size());
+}
+
 //////////////////////////////////////////////////
 template<>
 IGNITION_GAZEBO_VISIBLE
@@ -1585,11 +1633,7 @@ IGNITION_GAZEBO_VISIBLE
 gazebo::UpdateInfo ignition::gazebo::convert(const msgs::WorldStatistics &_in)
 {
   gazebo::UpdateInfo out;
-  out.iterations = _in.iterations();
-  out.paused = _in.paused();
-  out.simTime = convert<std::chrono::steady_clock::duration>(_in.sim_time());
-  out.realTime = convert<std::chrono::steady_clock::duration>(_in.real_time());
-  out.dt = convert<std::chrono::steady_clock::duration>(_in.step_size());
+  set(&out, _in);
   return out;
 }
 
@@ -223,6 +223,44 @@ TEST(Conversions, Pose)
   EXPECT_EQ(math::Pose3d(1, 2, 3, 1.0, 0, 0, 0), pose);
 }
 
+/////////////////////////////////////////////////
+TEST(Conversions, SetPose)
+{
+  math::Pose3d pose(1, 2, 3, 0.1, 0.2, 0.3);
+
+  // Other fields of a reused message are kept
+  msgs::Pose msg;
+  msg.set_name("reused");
+  msg.mutable_position()->set_x(100);
+  set(&msg, pose);
+  EXPECT_EQ("reused", msg.name());
+  EXPECT_EQ(msgs::Convert(pose).position().DebugString(),
+            msg.position().DebugString());
+  EXPECT_EQ(msgs::Convert(pose).orientation().DebugString(),
+            msg.orientation().DebugString());
+
+  math::Pose3d pose2(10, 20, 30, 0, 0, 0);
+  set(&pose2, msg);
+  EXPECT_EQ(pose, pose2);
+  EXPECT_EQ(convert<math::Pose3d>(msg), pose2);
+
+  // Empty orientation is corrected
+  msgs::Pose msg2;
+  set(&pose2, msg2);
+  EXPECT_EQ(math::Pose3d::Zero, pose2);
+
+  math::Vector3d vec(4, 5, 6);
+  msgs::Vector3d vecMsg;
+  set(&vecMsg, vec);
+  EXPECT_DOUBLE_EQ(4, vecMsg.x());
+  EXPECT_DOUBLE_EQ(5, vecMsg.y());
+  EXPECT_DOUBLE_EQ(6, vecMsg.z());
+
+  math::Vector3d vec2;
+  set(&vec2, vecMsg);
+  EXPECT_EQ(vec, vec2);
+}
+
 /////////////////////////////////////////////////
 TEST(Conversions, Time)
 {
@@ -235,6 +273,14 @@ TEST(Conversions, Time)
   auto duration2 = convert<std::chrono::steady_clock::duration>(msg);
   EXPECT_EQ(duration, duration2);
   EXPECT_EQ(2000000, duration2.count());
+
+  msgs::Time msg2;
+  set(&msg2, std::chrono::steady_clock::duration{3500ms});
+  EXPECT_EQ(3, msg2.sec());
+  EXPECT_EQ(500000000, msg2.nsec());
+
+  set(&duration2, msg2);
+  EXPECT_EQ(3500ms, duration2);
 }
 
 /////////////////////////////////////////////////
@@ -869,6 +915,14 @@ TEST(Conversions, UpdateInfo)
   auto newInfo = convert<UpdateInfo>(statsMsg);
   EXPECT_EQ(1234000000, newInfo.simTime.count());
   EXPECT_TRUE(newInfo.paused);
+
+  UpdateInfo newInfo2;
+  set(&newInfo2, statsMsg2);
+  EXPECT_EQ(info.simTime, newInfo2.simTime);
+  EXPECT_EQ(info.realTime, newInfo2.realTime);
+  EXPECT_EQ(info.dt, newInfo2.dt);
+  EXPECT_EQ(info.iterations, newInfo2.iterations);
+  EXPECT_TRUE(newInfo2.paused);
 }
 
 /////////////////////////////////////////////////
@@ -17,6 +17,9 @@
 
 #include "ignition/gazebo/EntityComponentManager.hh"
 
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -24,6 +27,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -41,10 +45,70 @@
 #include "ignition/gazebo/components/ParentLinkName.hh"
 #include "ignition/gazebo/components/Recreate.hh"
 #include "ignition/gazebo/components/World.hh"
+#include "ignition/gazebo/ThreadRegistry.hh"
 
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief Threads serializing state, shared by all the entity component
+/// managers in the process. Most managers, such as those of forks and
+/// levels, never serialize their whole state, so the threads are only
+/// started the first time a task needs them. They're registered once, so
+/// they're kept on their cores between calls.
+class StatePool
+{
+  /// \brief Get the pool shared by all managers.
+  /// \return The pool.
+  public: static StatePool &Instance();
+
+  /// \brief Destructor, stops the threads.
+  public: ~StatePool();
+
+  /// \brief Run a task on the threads and wait for it to finish. Concurrent
+  /// calls run one after the other.
+  /// \param[in] _count Number of parts of the task.
+  /// \param[in] _task Called with the index of each part, from several
+  /// threads.
+  public: void Run(std::size_t _count,
+              const std::function<void(std::size_t)> &_task);
+
+  /// \brief Constructor, use Instance().
+  private: StatePool();
+
+  /// \brief Loop of the threads.
+  private: void Work();
+
+  /// \brief Threads serializing state.
+  private: std::vector<std::thread> workers;
+
+  /// \brief Makes concurrent calls to Run() run one after the other.
+  private: std::mutex runMutex;
+
+  /// \brief Protects the task run by the threads.
+  private: std::mutex taskMutex;
+
+  /// \brief Notified when a task is started or the threads are stopped.
+  private: std::condition_variable taskCondition;
+
+  /// \brief Notified when all parts of a task are done.
+  private: std::condition_variable taskDoneCondition;
+
+  /// \brief Task being run, null when idle.
+  private: const std::function<void(std::size_t)> *task{nullptr};
+
+  /// \brief Number of parts of the task being run.
+  private: std::size_t taskCount{0};
+
+  /// \brief Index of the next part of the task to run.
+  private: std::size_t taskNext{0};
+
+  /// \brief Number of parts of the task which aren't done yet.
+  private: std::size_t taskPending{0};
+
+  /// \brief True when the threads should exit.
+  private: bool stop{false};
+};
+
 class ignition::gazebo::EntityComponentManagerPrivate
 {
   /// \brief Implementation of the CreateEntity function, which takes a specific
@@ -104,6 +168,23 @@ class ignition::gazebo::EntityComponentManagerPrivate
   public: bool ComponentMarkedAsRemoved(const Entity _entity,
               const ComponentTypeId _typeId) const;
 
+  /// \brief Replace a component in the storage and in all views holding
+  /// it. The replaced component is kept until the end of the step, so
+  /// pointers to it that were handed out during the step stay valid.
+  /// \param[in] _entity The entity.
+  /// \param[in] _typeId Type of the component.
+  /// \param[in] _comp The new component.
+  public: void ReplaceComponent(const Entity _entity,
+              const ComponentTypeId _typeId,
+              std::shared_ptr<components::BaseComponent> _comp);
+
+  /// \brief Copy a component if it's shared with other managers, so it can
+  /// be modified.
+  /// \param[in] _entity The entity.
+  /// \param[in] _typeId Type of the component.
+  public: void UnshareComponent(const Entity _entity,
+              const ComponentTypeId _typeId);
+
   /// \brief Set a cloned joint's parent or child link name.
   /// \param[in] _joint The cloned joint.
   /// \param[in] _originalLink The original joint's parent or child link.
@@ -200,11 +281,23 @@ class ignition::gazebo::EntityComponentManagerPrivate
   public: std::unordered_map<Entity, std::unordered_set<ComponentTypeId>>
     componentsMarkedAsRemoved;
 
-  /// \brief A map of an entity to its components
+  /// \brief A map of an entity to its components. Components can be shared
+  /// with other managers, see sharedComponents.
   public: std::unordered_map<Entity,
-           std::vector<std::unique_ptr<components::BaseComponent>>>
+           std::vector<std::shared_ptr<components::BaseComponent>>>
              componentStorage;
 
+  /// \brief Components shared with other managers or snapshots, which are
+  /// copied before they're first modified. The key is the component type,
+  /// and the value the entities whose component of that type is shared.
+  public: std::unordered_map<ComponentTypeId, std::unordered_set<Entity>>
+    sharedComponents;
+
+  /// \brief Components replaced during the current step, see
+  /// ReplaceComponent.
+  public: std::vector<std::shared_ptr<components::BaseComponent>>
+    replacedComponents;
+
   /// \brief A map that keeps track of where each type of component is
   /// located in the componentStorage vector. Since the componentStorage vector
   /// is of type BaseComponent, we need to keep track of which component type
@@ -324,7 +417,7 @@ Entity EntityComponentManagerPrivate::CreateEntityImplementation(Entity _entity)
   this->descendantCache.clear();
 
   const auto result = this->componentStorage.insert({_entity,
-      std::vector<std::unique_ptr<components::BaseComponent>>()});
+      std::vector<std::shared_ptr<components::BaseComponent>>()});
   if (!result.second)
   {
     ignwarn << "Attempted to add entity [" << _entity
@@ -760,6 +853,7 @@ void EntityComponentManager::ProcessRemoveEntityRequests()
     this->dataPtr->componentStorage.clear();
     this->dataPtr->componentTypeIndex.clear();
     this->dataPtr->componentTypeIndexDirty = true;
+    this->dataPtr->sharedComponents.clear();
 
     // All views are now invalid.
     this->dataPtr->views.clear();
@@ -781,6 +875,8 @@ void EntityComponentManager::ProcessRemoveEntityRequests()
       this->dataPtr->componentStorage.erase(entity);
       this->dataPtr->componentTypeIndex.erase(entity);
       this->dataPtr->componentTypeIndexDirty = true;
+      for (auto &shared : this->dataPtr->sharedComponents)
+        shared.second.erase(entity);
 
       // Remove the entity from views.
       for (auto &view : this->dataPtr->views)
@@ -794,6 +890,9 @@ void EntityComponentManager::ProcessRemoveEntityRequests()
 
   // Reset descendants cache
   this->dataPtr->descendantCache.clear();
+
+  // Components replaced during the step aren't referenced anymore
+  this->dataPtr->replacedComponents.clear();
 }
 
 /////////////////////////////////////////////////
@@ -963,6 +1062,44 @@ std::unordered_set<ComponentTypeId>
   return periodicComponents;
 }
 
+/////////////////////////////////////////////////
+std::unordered_set<Entity>
+    EntityComponentManager::EntitiesWithComponentChanges(
+    const ComponentTypeId _typeId) const
+{
+  std::unordered_set<Entity> entities;
+
+  auto oneTimeIter = this->dataPtr->oneTimeChangedComponents.find(_typeId);
+  if (oneTimeIter != this->dataPtr->oneTimeChangedComponents.end())
+    entities = oneTimeIter->second;
+
+  auto periodicIter = this->dataPtr->periodicChangedComponents.find(_typeId);
+  if (periodicIter != this->dataPtr->periodicChangedComponents.end())
+  {
+    entities.insert(periodicIter->second.begin(),
+        periodicIter->second.end());
+  }
+
+  return entities;
+}
+
+/////////////////////////////////////////////////
+std::unordered_set<Entity>
+    EntityComponentManager::EntitiesWithRemovedComponent(
+    const ComponentTypeId _typeId) const
+{
+  std::unordered_set<Entity> entities;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->removedComponentsMutex);
+  for (const auto &[entity, types] : this->dataPtr->removedComponents)
+  {
+    if (types.find(_typeId) != types.end())
+      entities.insert(entity);
+  }
+
+  return entities;
+}
+
 /////////////////////////////////////////////////
 bool EntityComponentManager::HasEntity(const Entity _entity) const
 {
@@ -1029,6 +1166,15 @@ bool EntityComponentManager::CreateComponentImplementation(
     return false;
   }
 
+  return this->AddComponentImplementation(_entity, _componentTypeId,
+      components::Factory::Instance()->New(_componentTypeId, _data));
+}
+
+/////////////////////////////////////////////////
+bool EntityComponentManager::AddComponentImplementation(
+    const Entity _entity, const ComponentTypeId _componentTypeId,
+    std::shared_ptr<components::BaseComponent> _component)
+{
   // assume the component data needs to be updated externally unless this
   // component is a brand new creation/addition
   bool updateData = true;
@@ -1055,15 +1201,12 @@ bool EntityComponentManager::CreateComponentImplementation(
     return false;
   }
 
-  // Instantiate the new component.
-  auto newComp = components::Factory::Instance()->New(_componentTypeId, _data);
-
   const auto compIdxIter = typeMapIter->second.find(_componentTypeId);
   // If entity has never had a component of this type
   if (compIdxIter == typeMapIter->second.end())
   {
     const auto vectorIdx = entityCompIter->second.size();
-    entityCompIter->second.push_back(std::move(newComp));
+    entityCompIter->second.push_back(std::move(_component));
     this->dataPtr->componentTypeIndex[_entity][_componentTypeId] = vectorIdx;
     this->dataPtr->componentTypeIndexDirty = true;
 
@@ -1196,12 +1339,97 @@ const components::BaseComponent
 components::BaseComponent *EntityComponentManager::ComponentImplementation(
     const Entity _entity, const ComponentTypeId _type)
 {
+  if (!this->dataPtr->sharedComponents.empty())
+    this->dataPtr->UnshareComponent(_entity, _type);
+
   // Call the const version of the function
   return const_cast<components::BaseComponent *>(
       static_cast<const EntityComponentManager &>(
       *this).ComponentImplementation(_entity, _type));
 }
 
+/////////////////////////////////////////////////
+void EntityComponentManager::UnshareComponents(const detail::BaseView &_view)
+{
+  if (this->dataPtr->sharedComponents.empty())
+    return;
+
+  for (const auto type : _view.ComponentTypes())
+  {
+    auto sharedIter = this->dataPtr->sharedComponents.find(type);
+    if (sharedIter == this->dataPtr->sharedComponents.end())
+      continue;
+
+    // Go through the smaller of the two sets
+    std::vector<Entity> entities;
+    if (sharedIter->second.size() < _view.Entities().size())
+    {
+      for (const Entity entity : sharedIter->second)
+      {
+        if (_view.HasEntity(entity))
+          entities.push_back(entity);
+      }
+    }
+    else
+    {
+      for (const Entity entity : _view.Entities())
+      {
+        if (sharedIter->second.find(entity) != sharedIter->second.end())
+          entities.push_back(entity);
+      }
+    }
+
+    for (const Entity entity : entities)
+      this->dataPtr->UnshareComponent(entity, type);
+  }
+}
+
+/////////////////////////////////////////////////
+std::shared_ptr<const components::BaseComponent>
+    EntityComponentManager::ShareComponent(const Entity _entity,
+    const ComponentTypeId _type)
+{
+  const auto &constThis = static_cast<const EntityComponentManager &>(*this);
+  if (nullptr == constThis.ComponentImplementation(_entity, _type))
+    return nullptr;
+
+  this->dataPtr->sharedComponents[_type].insert(_entity);
+  return this->dataPtr->componentStorage.at(_entity).at(
+      this->dataPtr->componentTypeIndex.at(_entity).at(_type));
+}
+
+/////////////////////////////////////////////////
+bool EntityComponentManager::AddSharedComponent(const Entity _entity,
+    std::shared_ptr<const components::BaseComponent> _component)
+{
+  if (nullptr == _component || !this->HasEntity(_entity))
+    return false;
+
+  // The component isn't modified through this manager while it's shared
+  auto comp = std::const_pointer_cast<components::BaseComponent>(
+      std::move(_component));
+  const auto type = comp->TypeId();
+
+  if (this->AddComponentImplementation(_entity, type, comp))
+  {
+    // The entity already had a component of this type
+    this->dataPtr->ReplaceComponent(_entity, type, comp);
+    if (type == components::ParentEntity::typeId)
+    {
+      this->SetParentEntity(_entity,
+          static_cast<const components::ParentEntity *>(comp.get())->Data());
+    }
+  }
+  else if (static_cast<const EntityComponentManager &>(
+      *this).ComponentImplementation(_entity, type) != comp.get())
+  {
+    return false;
+  }
+
+  this->dataPtr->sharedComponents[type].insert(_entity);
+  return true;
+}
+
 /////////////////////////////////////////////////
 bool EntityComponentManager::HasComponentType(
     const ComponentTypeId _typeId) const
@@ -1563,6 +1791,85 @@ void EntityComponentManager::ChangedState(
   }
 }
 
+//////////////////////////////////////////////////
+StatePool &StatePool::Instance()
+{
+  static StatePool instance;
+  return instance;
+}
+
+//////////////////////////////////////////////////
+StatePool::StatePool()
+{
+  // The threads unregister when they exit, so the registry must outlive
+  // the pool
+  ThreadRegistry::Instance();
+}
+
+//////////////////////////////////////////////////
+StatePool::~StatePool()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->taskMutex);
+    this->stop = true;
+  }
+  this->taskCondition.notify_all();
+  for (auto &worker : this->workers)
+    worker.join();
+}
+
+//////////////////////////////////////////////////
+void StatePool::Run(std::size_t _count,
+    const std::function<void(std::size_t)> &_task)
+{
+  if (_count == 0)
+    return;
+
+  std::lock_guard<std::mutex> runLock(this->runMutex);
+  std::unique_lock<std::mutex> lock(this->taskMutex);
+
+  // One thread per part, up to the number of cores
+  const std::size_t maxThreads =
+      std::max(1u, std::thread::hardware_concurrency());
+  while (this->workers.size() < std::min(_count, maxThreads))
+    this->workers.emplace_back(&StatePool::Work, this);
+
+  this->task = &_task;
+  this->taskCount = _count;
+  this->taskNext = 0;
+  this->taskPending = _count;
+  this->taskCondition.notify_all();
+  this->taskDoneCondition.wait(lock,
+      [this]() {return this->taskPending == 0;});
+  this->task = nullptr;
+}
+
+//////////////////////////////////////////////////
+void StatePool::Work()
+{
+  ScopedThreadRegistration registration(ThreadClass::kState, "ecm_state");
+
+  std::unique_lock<std::mutex> lock(this->taskMutex);
+  while (true)
+  {
+    this->taskCondition.wait(lock, [this]()
+    {
+      return this->stop || this->taskNext < this->taskCount;
+    });
+    if (this->stop)
+      return;
+
+    const auto index = this->taskNext++;
+    const auto *currentTask = this->task;
+    lock.unlock();
+    (*currentTask)(index);
+    lock.lock();
+
+    if (--this->taskPending == 0)
+      this->taskDoneCondition.notify_all();
+  }
+}
+
 //////////////////////////////////////////////////
 void EntityComponentManagerPrivate::CalculateStateThreadLoad()
 {
@@ -1636,13 +1943,24 @@ void EntityComponentManager::State(
     const std::unordered_set<ComponentTypeId> &_types,
     bool _full) const
 {
+  // When specific entities are requested, visit only those, so the cost is
+  // proportional to the request instead of to the number of entities
+  if (!_entities.empty())
+  {
+    for (const Entity entity : _entities)
+      this->AddEntityToMessage(_state, entity, _types, _full);
+    return;
+  }
+
   std::mutex stateMapMutex;
-  std::vector<std::thread> workers;
 
   this->dataPtr->CalculateStateThreadLoad();
+  const auto &iterators = this->dataPtr->componentTypeIndexIterators;
 
-  auto functor = [&](auto itStart, auto itEnd)
+  auto functor = [&](std::size_t _index)
   {
+    auto itStart = iterators[_index];
+    auto itEnd = iterators[_index + 1];
     msgs::SerializedStateMap threadMap;
     while (itStart != itEnd)
     {
@@ -1662,20 +1980,8 @@ void EntityComponentManager::State(
     }
   };
 
-  // Spawn workers
-  uint64_t numThreads = this->dataPtr->componentTypeIndexIterators.size() - 1;
-  for (uint64_t i = 0; i < numThreads; i++)
-  {
-    workers.push_back(std::thread(functor,
-        this->dataPtr->componentTypeIndexIterators[i],
-        this->dataPtr->componentTypeIndexIterators[i+1]));
-  }
-
-  // Wait for each thread to finish processing its components
-  std::for_each(workers.begin(), workers.end(), [](std::thread &_t)
-  {
-    _t.join();
-  });
+  // Each range of entities is processed by one of the state threads
+  StatePool::Instance().Run(iterators.size() - 1, functor);
 }
 
 //////////////////////////////////////////////////
@@ -1757,7 +2063,7 @@ void EntityComponentManager::SetState(
         newComp->Deserialize(istr);
 
         auto updateData =
-          this->CreateComponentImplementation(entity, type, newComp.get());
+          this->AddComponentImplementation(entity, type, std::move(newComp));
         if (updateData)
         {
           // Set comp so we deserialize the data below again
@@ -1771,6 +2077,10 @@ void EntityComponentManager::SetState(
         std::istringstream istr(compMsg.component());
         comp->Deserialize(istr);
         this->dataPtr->AddModifiedComponent(entity);
+
+        // Newly created components are already marked as one-time changes
+        if (this->ComponentState(entity, type) == ComponentState::NoChange)
+          this->SetChanged(entity, type, ComponentState::PeriodicChange);
       }
     }
   }
@@ -1849,8 +2159,8 @@ void EntityComponentManager::SetState(
         }
         newComp->Deserialize(istr);
 
-        auto updateData = this->CreateComponentImplementation(
-          entity, newComp->TypeId(), newComp.get());
+        auto updateData = this->AddComponentImplementation(
+          entity, compIter.first, std::move(newComp));
         if (updateData)
         {
           // Set comp so we deserialize the data below again
@@ -2021,6 +2331,71 @@ bool EntityComponentManagerPrivate::ComponentMarkedAsRemoved(
   return false;
 }
 
+/////////////////////////////////////////////////
+void EntityComponentManagerPrivate::ReplaceComponent(const Entity _entity,
+    const ComponentTypeId _typeId,
+    std::shared_ptr<components::BaseComponent> _comp)
+{
+  auto typeMapIter = this->componentTypeIndex.find(_entity);
+  auto entityCompIter = this->componentStorage.find(_entity);
+  if (typeMapIter == this->componentTypeIndex.end() ||
+      entityCompIter == this->componentStorage.end())
+  {
+    return;
+  }
+
+  auto compIdxIter = typeMapIter->second.find(_typeId);
+  if (compIdxIter == typeMapIter->second.end())
+    return;
+
+  auto &stored = entityCompIter->second.at(compIdxIter->second);
+  this->replacedComponents.push_back(std::move(stored));
+  stored = std::move(_comp);
+
+  // Views hold pointers to components, ordered like the types of their keys
+  for (auto &[key, viewPair] : this->views)
+  {
+    auto keyIter = std::find(key.begin(), key.end(), _typeId);
+    if (keyIter == key.end())
+      continue;
+
+    static_cast<detail::View *>(viewPair.first.get())->ReplaceComponent(
+        _entity, static_cast<std::size_t>(keyIter - key.begin()),
+        stored.get());
+  }
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManagerPrivate::UnshareComponent(const Entity _entity,
+    const ComponentTypeId _typeId)
+{
+  auto sharedIter = this->sharedComponents.find(_typeId);
+  if (sharedIter == this->sharedComponents.end() ||
+      sharedIter->second.erase(_entity) == 0)
+  {
+    return;
+  }
+  if (sharedIter->second.empty())
+    this->sharedComponents.erase(sharedIter);
+
+  auto typeMapIter = this->componentTypeIndex.find(_entity);
+  if (typeMapIter == this->componentTypeIndex.end())
+    return;
+
+  auto compIdxIter = typeMapIter->second.find(_typeId);
+  if (compIdxIter == typeMapIter->second.end())
+    return;
+
+  const auto &comp =
+      this->componentStorage.at(_entity).at(compIdxIter->second);
+
+  // Nobody else holds the component anymore, so it can be modified in place
+  if (comp.use_count() == 1)
+    return;
+
+  this->ReplaceComponent(_entity, _typeId, comp->Clone());
+}
+
 /////////////////////////////////////////////////
 template<typename ComponentTypeT>
 bool EntityComponentManagerPrivate::ClonedJointLinkName(Entity _joint,
@@ -17,6 +17,10 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <set>
+#include <utility>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Util.hh>
 #include <ignition/math/Pose3.hh>
@@ -34,6 +38,7 @@
 #include "ignition/gazebo/components/ParentLinkName.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/ThreadRegistry.hh"
 #include "ignition/gazebo/config.hh"
 #include "../test/helpers/EnvTestFixture.hh"
 
@@ -106,6 +111,16 @@ class EntityCompMgrTest : public EntityComponentManager
   {
     this->ClearRemovedComponents();
   }
+  public: std::shared_ptr<const components::BaseComponent> Share(
+              Entity _entity, ComponentTypeId _type)
+  {
+    return this->ShareComponent(_entity, _type);
+  }
+  public: bool AddShared(Entity _entity,
+              std::shared_ptr<const components::BaseComponent> _component)
+  {
+    return this->AddSharedComponent(_entity, std::move(_component));
+  }
 };
 
 class EntityComponentManagerFixture
@@ -2301,6 +2316,62 @@ TEST_P(EntityComponentManagerFixture,
       manager.ComponentState(e2, c2->TypeId()));
 }
 
+//////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture,
+       IGN_UTILS_TEST_DISABLED_ON_WIN32(EntitiesWithComponentChanges))
+{
+  Entity e1 = manager.CreateEntity();
+  Entity e2 = manager.CreateEntity();
+  Entity e3 = manager.CreateEntity();
+  manager.CreateComponent<IntComponent>(e1, IntComponent(1));
+  manager.CreateComponent<IntComponent>(e2, IntComponent(2));
+  manager.CreateComponent<IntComponent>(e3, IntComponent(3));
+  manager.CreateComponent<DoubleComponent>(e3, DoubleComponent(3.0));
+
+  // Newly created components are changed
+  EXPECT_EQ(std::unordered_set<Entity>({e1, e2, e3}),
+      manager.EntitiesWithComponentChanges(IntComponent::typeId));
+  EXPECT_EQ(std::unordered_set<Entity>({e3}),
+      manager.EntitiesWithComponentChanges(DoubleComponent::typeId));
+  EXPECT_TRUE(manager.EntitiesWithComponentChanges(
+      StringComponent::typeId).empty());
+
+  manager.RunSetAllComponentsUnchanged();
+  EXPECT_TRUE(manager.EntitiesWithComponentChanges(
+      IntComponent::typeId).empty());
+
+  // Both one-time and periodic changes are included
+  manager.SetChanged(e1, IntComponent::typeId,
+      ComponentState::OneTimeChange);
+  manager.SetChanged(e3, IntComponent::typeId,
+      ComponentState::PeriodicChange);
+  EXPECT_EQ(std::unordered_set<Entity>({e1, e3}),
+      manager.EntitiesWithComponentChanges(IntComponent::typeId));
+  EXPECT_TRUE(manager.EntitiesWithComponentChanges(
+      DoubleComponent::typeId).empty());
+
+  // Removed components aren't changed
+  manager.RemoveComponent<IntComponent>(e3);
+  EXPECT_EQ(std::unordered_set<Entity>({e1}),
+      manager.EntitiesWithComponentChanges(IntComponent::typeId));
+
+  // Components updated through a state message are changed
+  manager.RunSetAllComponentsUnchanged();
+  msgs::SerializedState stateMsg;
+  auto entityMsg = stateMsg.add_entities();
+  entityMsg->set_id(e2);
+  auto compMsg = entityMsg->add_components();
+  compMsg->set_type(IntComponent::typeId);
+  compMsg->set_component("20");
+  manager.SetState(stateMsg);
+
+  EXPECT_EQ(20, manager.Component<IntComponent>(e2)->Data());
+  EXPECT_EQ(std::unordered_set<Entity>({e2}),
+      manager.EntitiesWithComponentChanges(IntComponent::typeId));
+  EXPECT_EQ(ComponentState::PeriodicChange,
+      manager.ComponentState(e2, IntComponent::typeId));
+}
+
 //////////////////////////////////////////////////
 TEST_P(EntityComponentManagerFixture,
     IGN_UTILS_TEST_DISABLED_ON_WIN32(SetEntityCreateOffset))
@@ -3254,6 +3325,165 @@ TEST_P(EntityComponentManagerFixture,
   EXPECT_EQ(321, comp->Data());
 }
 
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ComponentInherited)
+{
+  // e1 -> e2 -> e3
+  //          -> e4
+  Entity e1 = manager.CreateEntity();
+  Entity e2 = manager.CreateEntity();
+  Entity e3 = manager.CreateEntity();
+  Entity e4 = manager.CreateEntity();
+  EXPECT_TRUE(manager.SetParentEntity(e2, e1));
+  EXPECT_TRUE(manager.SetParentEntity(e3, e2));
+  EXPECT_TRUE(manager.SetParentEntity(e4, e2));
+
+  // No entity has the component
+  EXPECT_EQ(nullptr, manager.ComponentInherited<IntComponent>(e3));
+
+  // Descendants inherit from the root
+  manager.CreateComponent<IntComponent>(e1, IntComponent(1));
+  for (auto entity : {e1, e2, e3, e4})
+  {
+    auto comp = manager.ComponentInherited<IntComponent>(entity);
+    ASSERT_NE(nullptr, comp);
+    EXPECT_EQ(1, comp->Data());
+  }
+
+  // The closest ancestor wins
+  manager.CreateComponent<IntComponent>(e4, IntComponent(4));
+  EXPECT_EQ(1, manager.ComponentInherited<IntComponent>(e3)->Data());
+  EXPECT_EQ(4, manager.ComponentInherited<IntComponent>(e4)->Data());
+
+  // Other component types aren't affected
+  EXPECT_EQ(nullptr, manager.ComponentInherited<DoubleComponent>(e4));
+}
+
+/////////////////////////////////////////////////
+// The threads serializing state are kept, registered once and shared by all
+// managers
+TEST_P(EntityComponentManagerFixture, StateThreadsReused)
+{
+  for (int i = 0; i < 16; ++i)
+  {
+    Entity entity = manager.CreateEntity();
+    manager.CreateComponent<IntComponent>(entity, IntComponent(i));
+  }
+
+  auto stateThreads = []()
+  {
+    std::multiset<uint64_t> ids;
+    for (const auto &stats : ThreadRegistry::Instance().Statistics())
+    {
+      if (stats.threadClass == ThreadClass::kState)
+        ids.insert(stats.id);
+    }
+    return ids;
+  };
+
+  msgs::SerializedStateMap stateMsg;
+  manager.State(stateMsg);
+  EXPECT_EQ(16, stateMsg.entities_size());
+  auto threads = stateThreads();
+  EXPECT_FALSE(threads.empty());
+
+  for (int i = 0; i < 10; ++i)
+  {
+    msgs::SerializedStateMap repeatMsg;
+    manager.State(repeatMsg);
+    EXPECT_EQ(16, repeatMsg.entities_size());
+    EXPECT_EQ(threads, stateThreads());
+  }
+
+  // Other managers share the same threads
+  EntityCompMgrTest otherManager;
+  for (int i = 0; i < 16; ++i)
+  {
+    Entity entity = otherManager.CreateEntity();
+    otherManager.CreateComponent<IntComponent>(entity, IntComponent(i));
+  }
+
+  msgs::SerializedStateMap otherMsg;
+  otherManager.State(otherMsg);
+  EXPECT_EQ(16, otherMsg.entities_size());
+  EXPECT_EQ(threads, stateThreads());
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, CopyOnWrite)
+{
+  Entity entity = manager.CreateEntity();
+  manager.CreateComponent<IntComponent>(entity, IntComponent(1));
+  manager.CreateComponent<DoubleComponent>(entity, DoubleComponent(0.5));
+
+  // Cache the components in a view
+  int count{0};
+  manager.Each<IntComponent, DoubleComponent>(
+      [&](const Entity &, IntComponent *, DoubleComponent *) -> bool
+      {
+        ++count;
+        return true;
+      });
+  EXPECT_EQ(1, count);
+
+  EntityCompMgrTest other;
+  Entity otherEntity = other.CreateEntity();
+  EXPECT_EQ(entity, otherEntity);
+
+  auto sharedInt = manager.Share(entity, IntComponent::typeId);
+  auto sharedDouble = manager.Share(entity, DoubleComponent::typeId);
+  ASSERT_NE(nullptr, sharedInt);
+  ASSERT_NE(nullptr, sharedDouble);
+  EXPECT_EQ(nullptr, manager.Share(entity, StringComponent::typeId));
+  EXPECT_TRUE(other.AddShared(otherEntity, sharedInt));
+  EXPECT_TRUE(other.AddShared(otherEntity, sharedDouble));
+  EXPECT_FALSE(other.AddShared(otherEntity + 1, sharedInt));
+
+  // Both managers read the same instances
+  const EntityComponentManager &constManager = manager;
+  const EntityComponentManager &constOther = other;
+  EXPECT_EQ(sharedInt.get(), constManager.Component<IntComponent>(entity));
+  EXPECT_EQ(sharedInt.get(), constOther.Component<IntComponent>(otherEntity));
+  EXPECT_TRUE(other.EntityHasComponentType(otherEntity,
+      DoubleComponent::typeId));
+
+  // A manager modifying a component modifies its own copy
+  other.Component<IntComponent>(otherEntity)->Data() = 2;
+  EXPECT_NE(sharedInt.get(), constOther.Component<IntComponent>(otherEntity));
+  EXPECT_EQ(2, constOther.Component<IntComponent>(otherEntity)->Data());
+  EXPECT_EQ(1, constManager.Component<IntComponent>(entity)->Data());
+
+  // Views are updated with the copies
+  manager.Each<IntComponent, DoubleComponent>(
+      [&](const Entity &, IntComponent *_int, DoubleComponent *_double) -> bool
+      {
+        _int->Data() = 3;
+        _double->Data() = 1.5;
+        return true;
+      });
+  EXPECT_EQ(3, constManager.Component<IntComponent>(entity)->Data());
+  EXPECT_DOUBLE_EQ(1.5, constManager.Component<DoubleComponent>(
+      entity)->Data());
+  constManager.Each<IntComponent, DoubleComponent>(
+      [&](const Entity &, const IntComponent *_int,
+          const DoubleComponent *_double) -> bool
+      {
+        EXPECT_EQ(3, _int->Data());
+        EXPECT_DOUBLE_EQ(1.5, _double->Data());
+        return true;
+      });
+  EXPECT_EQ(1, static_cast<const IntComponent *>(sharedInt.get())->Data());
+  EXPECT_EQ(2, constOther.Component<IntComponent>(otherEntity)->Data());
+  EXPECT_DOUBLE_EQ(0.5, constOther.Component<DoubleComponent>(
+      otherEntity)->Data());
+
+  // Components nobody else holds anymore are modified in place
+  sharedDouble.reset();
+  manager.ProcessEntityRemovals();
+  auto otherDouble = constOther.Component<DoubleComponent>(otherEntity);
+  EXPECT_EQ(otherDouble, other.Component<DoubleComponent>(otherEntity));
+}
+
 // Run multiple times. We want to make sure that static globals don't cause
 // problems.
 INSTANTIATE_TEST_SUITE_P(EntityComponentManagerRepeat,
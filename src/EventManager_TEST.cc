@@ -18,6 +18,8 @@
 #include <gtest/gtest.h>
 
 #include <atomic>
+#include <thread>
+#include <vector>
 
 #include "ignition/gazebo/Events.hh"
 #include "ignition/gazebo/EventManager.hh"
@@ -119,3 +121,103 @@ TEST(EventManager, Disambiguate)
   EXPECT_EQ(1, calls);
 }
 
+/////////////////////////////////////////////////
+TEST(EventManager, DisconnectWhileEmitting)
+{
+  EventManager eventManager;
+
+  // A callback which disconnects itself is not called again
+  int calls1 = 0;
+  ignition::common::ConnectionPtr connection1;
+  connection1 = eventManager.Connect<events::Pause>(
+    [&](bool)
+    {
+      calls1++;
+      connection1.reset();
+    });
+
+  // A callback disconnected by an earlier callback in the same emission is
+  // not called
+  int calls2 = 0;
+  ignition::common::ConnectionPtr connection3;
+  auto connection2 = eventManager.Connect<events::Pause>(
+    [&](bool)
+    {
+      calls2++;
+      connection3.reset();
+    });
+
+  int calls3 = 0;
+  connection3 = eventManager.Connect<events::Pause>(
+    [&](bool)
+    {
+      calls3++;
+    });
+
+  eventManager.Emit<events::Pause>(true);
+  eventManager.Emit<events::Pause>(true);
+  EXPECT_EQ(1, calls1);
+  EXPECT_EQ(2, calls2);
+  EXPECT_EQ(0, calls3);
+  EXPECT_EQ(nullptr, connection1);
+  EXPECT_EQ(nullptr, connection3);
+
+  // Connecting while emitting takes effect on the next emission
+  int calls4 = 0;
+  ignition::common::ConnectionPtr connection4;
+  connection2 = eventManager.Connect<events::Pause>(
+    [&](bool)
+    {
+      if (nullptr == connection4)
+      {
+        connection4 = eventManager.Connect<events::Pause>(
+            [&](bool){ calls4++; });
+      }
+    });
+  eventManager.Emit<events::Pause>(true);
+  EXPECT_EQ(0, calls4);
+  eventManager.Emit<events::Pause>(true);
+  EXPECT_EQ(1, calls4);
+}
+
+/////////////////////////////////////////////////
+TEST(EventManager, EmitFromThreads)
+{
+  EventManager eventManager;
+
+  std::atomic<int> calls = 0;
+  auto connection = eventManager.Connect<events::Pause>(
+    [&](bool)
+    {
+      calls++;
+    });
+
+  const int threadCount = 4;
+  const int emitCount = 1000;
+  std::atomic<bool> stop{false};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < threadCount; ++i)
+  {
+    threads.emplace_back([&]()
+      {
+        for (int j = 0; j < emitCount; ++j)
+          eventManager.Emit<events::Pause>(true);
+      });
+  }
+
+  // Connect and disconnect while other threads emit
+  std::thread churn([&]()
+    {
+      while (!stop)
+      {
+        auto other = eventManager.Connect<events::Pause>([](bool){});
+      }
+    });
+
+  for (auto &thread : threads)
+    thread.join();
+  stop = true;
+  churn.join();
+
+  EXPECT_EQ(threadCount * emitCount, calls);
+}
@@ -0,0 +1,1300 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <sys/stat.h>
+#ifdef _WIN32
+  #include <sys/utime.h>
+#else
+  #include <utime.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sdf/Collision.hh>
+#include <sdf/Geometry.hh>
+#include <sdf/Link.hh>
+#include <sdf/Mesh.hh>
+#include <sdf/Model.hh>
+#include <sdf/Visual.hh>
+
+#include <ignition/common/ColladaLoader.hh>
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Material.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/OBJLoader.hh>
+#include <ignition/common/STLLoader.hh>
+#include <ignition/common/SubMesh.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/common/Uuid.hh>
+
+#include "ignition/gazebo/MeshAssets.hh"
+#include "ignition/gazebo/Util.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief A mesh decoded by MeshAssets, before and after it's registered
+/// with common::MeshManager.
+struct DecodedMesh
+{
+  /// \brief The mesh, until it's handed to the mesh manager.
+  std::unique_ptr<common::Mesh> mesh;
+
+  /// \brief False if the format isn't supported by MeshAssets, so the mesh
+  /// is left to the mesh manager.
+  bool supported{true};
+
+  /// \brief True once the mesh went through MeshAssetsPrivate::Register.
+  bool registered{false};
+
+  /// \brief The registered mesh, null if it couldn't be loaded.
+  const common::Mesh *result{nullptr};
+};
+
+/// \brief A mesh waiting to be decoded, and who's waiting for it.
+using PendingMesh = std::pair<std::string,
+    std::shared_ptr<std::promise<std::shared_ptr<DecodedMesh>>>>;
+
+/// \brief Private data for MeshAssets
+class ignition::gazebo::MeshAssetsPrivate
+{
+  /// \brief Resolve the path of a mesh, which is also its name in
+  /// common::MeshManager.
+  /// \param[in] _path Path as given by the caller.
+  /// \return Resolved path, or the path as given if it couldn't be found.
+  public: static std::string Resolve(const std::string &_path);
+
+  /// \brief Decode a mesh and wake up whoever waits for it.
+  /// \param[in] _pending The mesh.
+  public: void Fulfill(PendingMesh &_pending);
+
+  /// \brief Claim a mesh which is being loaded, so it isn't evicted when
+  /// its preload requests are canceled. If no preload thread started on it
+  /// yet, it's taken out of the queue. Must be called with the mutex
+  /// locked.
+  /// \param[in] _path Resolved path of the mesh.
+  /// \return Who's waiting for the mesh if the caller should decode it,
+  /// null otherwise.
+  public: std::shared_ptr<std::promise<std::shared_ptr<DecodedMesh>>>
+      ClaimLocked(const std::string &_path);
+
+  /// \brief Account for a file written to the disk cache, removing the
+  /// files which weren't read for the longest time if it's over its limit.
+  /// \param[in] _file Path to the cache file.
+  public: void AddToCache(const std::string &_file);
+
+  /// \brief Decode a mesh, from the disk cache if possible. This doesn't
+  /// touch common::MeshManager, so it can run on any thread.
+  /// \param[in] _path Resolved path to the mesh file.
+  /// \return The decoded mesh.
+  public: std::shared_ptr<DecodedMesh> Decode(const std::string &_path);
+
+  /// \brief Register a decoded mesh with common::MeshManager, unless
+  /// another one was registered with the same name. Meshes which couldn't
+  /// be loaded are forgotten, so they're retried. Called from the threads
+  /// calling Load, never from the preload threads.
+  /// \param[in] _name Name of the mesh.
+  /// \param[in] _decoded The decoded mesh.
+  /// \return The registered mesh, or null if it couldn't be loaded.
+  public: const common::Mesh *Register(const std::string &_name,
+      DecodedMesh &_decoded);
+
+  /// \brief Decode preloaded meshes until FinishPreload is called.
+  public: void Work();
+
+  /// \brief Get the cache file of a mesh file.
+  /// \param[in] _path Resolved path to the mesh file.
+  /// \param[in] _variant Variant of the mesh, empty for the mesh as
+  /// decoded from the file.
+  /// \return Path to the cache file, empty if the cache is disabled or the
+  /// mesh file doesn't exist.
+  public: std::string CacheFile(const std::string &_path,
+      const std::string &_variant = std::string()) const;
+
+  /// \brief Meshes loaded or being loaded, keyed by resolved path. Meshes
+  /// which failed to load are removed, so they're retried.
+  public: std::map<std::string,
+      std::shared_future<std::shared_ptr<DecodedMesh>>> meshes;
+
+  /// \brief Meshes waiting for a preload thread.
+  public: std::deque<PendingMesh> queue;
+
+  /// \brief Preloaded meshes which weren't loaded yet, keyed by resolved
+  /// path, with the requests which preloaded them.
+  public: std::map<std::string, std::set<uint64_t>> unclaimed;
+
+  /// \brief Identifier of the next preload request.
+  public: uint64_t nextRequest{1};
+
+  /// \brief Notified when meshes are queued or the preload threads should
+  /// stop.
+  public: std::condition_variable queueCondition;
+
+  /// \brief True when the preload threads should stop once the queue is
+  /// empty.
+  public: bool stopWorkers{false};
+
+  /// \brief Threads decoding preloaded meshes, at most one per core. They
+  /// only decode, meshes are registered by whoever loads them.
+  public: std::vector<std::thread> workers;
+
+  /// \brief Directory of the disk cache, empty if disabled.
+  public: std::string cachePath;
+
+  /// \brief Size limit of the disk cache, in bytes.
+  public: uint64_t cacheSizeLimit{1024ull * 1024 * 1024};
+
+  /// \brief Size of the disk cache in bytes, counted when the first file
+  /// is written to it. Files written by other processes are only noticed
+  /// when the cache is trimmed.
+  public: uint64_t cacheSize{0};
+
+  /// \brief Whether cacheSize was counted for the current directory.
+  public: bool cacheSizeKnown{false};
+
+  /// \brief Protects cacheSize and cacheSizeKnown, and serializes trimming
+  /// the disk cache.
+  public: std::mutex cacheMutex;
+
+  /// \brief Counters of how meshes were obtained.
+  public: MeshAssetStatistics stats;
+
+  /// \brief Protects meshes, queue, unclaimed, nextRequest, stopWorkers,
+  /// workers, cachePath, cacheSizeLimit and stats, and serializes the calls
+  /// to common::MeshManager made by this class.
+  public: mutable std::mutex mutex;
+
+  /// \brief Serializes Preload and FinishPreload, which start and join the
+  /// preload threads.
+  public: std::mutex workersMutex;
+};
+
+namespace
+{
+/// \brief Identifies cache files.
+const char kMagic[8] = {'I', 'G', 'N', 'M', 'E', 'S', 'H', '\0'};
+
+/// \brief Version of the cache file format. Files with another version are
+/// ignored and overwritten.
+const uint32_t kFormatVersion = 2;
+
+/// \brief Smallest size of a material in a cache file.
+const uint64_t kMinMaterialSize = 4 * 4 * sizeof(float) +
+    3 * sizeof(double) + 4 * sizeof(uint8_t) + sizeof(uint32_t);
+
+/// \brief Smallest size of a submesh in a cache file.
+const uint64_t kMinSubMeshSize = 7 * sizeof(uint32_t);
+
+/// \brief Write a value in host byte order.
+/// \param[in] _out Stream to write to.
+/// \param[in] _value Value to write.
+template <typename T>
+void writeValue(std::ostream &_out, const T &_value)
+{
+  _out.write(reinterpret_cast<const char *>(&_value), sizeof(T));
+}
+
+/// \brief Read a value written by writeValue.
+/// \param[in] _in Stream to read from.
+/// \param[out] _value Value read.
+/// \return True if the value could be read.
+template <typename T>
+bool readValue(std::istream &_in, T &_value)
+{
+  _in.read(reinterpret_cast<char *>(&_value), sizeof(T));
+  return static_cast<bool>(_in);
+}
+
+/// \brief Write a string, prefixed by its size.
+/// \param[in] _out Stream to write to.
+/// \param[in] _value String to write.
+void writeString(std::ostream &_out, const std::string &_value)
+{
+  writeValue(_out, static_cast<uint32_t>(_value.size()));
+  _out.write(_value.data(), _value.size());
+}
+
+/// \brief Check that a number of elements read from a cache file fits in
+/// what's left of the file, so sizes in corrupt files aren't trusted.
+/// \param[in] _in Stream being read.
+/// \param[in] _fileSize Size of the file.
+/// \param[in] _count Number of elements.
+/// \param[in] _elementSize Smallest size of an element.
+/// \return True if the elements fit.
+bool fits(std::istream &_in, uint64_t _fileSize, uint64_t _count,
+    uint64_t _elementSize)
+{
+  const auto position = _in.tellg();
+  if (position < 0 || static_cast<uint64_t>(position) > _fileSize)
+    return false;
+  return _count <= (_fileSize - static_cast<uint64_t>(position)) /
+      _elementSize;
+}
+
+/// \brief Read a string written by writeString.
+/// \param[in] _in Stream to read from.
+/// \param[in] _fileSize Size of the file, which bounds the string.
+/// \param[out] _value String read.
+/// \return True if the string could be read.
+bool readString(std::istream &_in, uint64_t _fileSize, std::string &_value)
+{
+  uint32_t size{0};
+  if (!readValue(_in, size) || !fits(_in, _fileSize, size, 1))
+    return false;
+  _value.resize(size);
+  _in.read(&_value[0], size);
+  return static_cast<bool>(_in);
+}
+
+/// \brief Write a color as 4 floats.
+/// \param[in] _out Stream to write to.
+/// \param[in] _color Color to write.
+void writeColor(std::ostream &_out, const math::Color &_color)
+{
+  writeValue(_out, _color.R());
+  writeValue(_out, _color.G());
+  writeValue(_out, _color.B());
+  writeValue(_out, _color.A());
+}
+
+/// \brief Read a color written by writeColor.
+/// \param[in] _in Stream to read from.
+/// \param[out] _color Color read.
+/// \return True if the color could be read.
+bool readColor(std::istream &_in, math::Color &_color)
+{
+  float r, g, b, a;
+  if (!readValue(_in, r) || !readValue(_in, g) || !readValue(_in, b) ||
+      !readValue(_in, a))
+  {
+    return false;
+  }
+  _color.Set(r, g, b, a);
+  return true;
+}
+
+/// \brief Write a vector as 3 doubles.
+/// \param[in] _out Stream to write to.
+/// \param[in] _vector Vector to write.
+void writeVector3(std::ostream &_out, const math::Vector3d &_vector)
+{
+  writeValue(_out, _vector.X());
+  writeValue(_out, _vector.Y());
+  writeValue(_out, _vector.Z());
+}
+
+/// \brief Read a vector written by writeVector3.
+/// \param[in] _in Stream to read from.
+/// \param[out] _vector Vector read.
+/// \return True if the vector could be read.
+bool readVector3(std::istream &_in, math::Vector3d &_vector)
+{
+  double x, y, z;
+  if (!readValue(_in, x) || !readValue(_in, y) || !readValue(_in, z))
+    return false;
+  _vector.Set(x, y, z);
+  return true;
+}
+
+/// \brief Check if a path is absolute, on any platform.
+/// \param[in] _path The path.
+/// \return True if it starts with a separator or a drive letter.
+bool isAbsolute(const std::string &_path)
+{
+  return (!_path.empty() && (_path[0] == '/' || _path[0] == '\\')) ||
+      (_path.size() > 1 && _path[1] == ':');
+}
+
+/// \brief Split a path into its components, dropping "." and collapsing
+/// "..".
+/// \param[in] _path The path.
+/// \return Components. Absolute paths start with an empty component or a
+/// drive letter.
+std::vector<std::string> pathComponents(const std::string &_path)
+{
+  std::vector<std::string> components;
+  std::size_t root{0};
+  if (isAbsolute(_path))
+  {
+    root = 1;
+    if (_path[0] == '/' || _path[0] == '\\')
+      components.emplace_back();
+  }
+
+  std::size_t start{0};
+  while (start < _path.size())
+  {
+    std::size_t end = _path.find_first_of("/\\", start);
+    if (end == std::string::npos)
+      end = _path.size();
+    const std::string component = _path.substr(start, end - start);
+    start = end + 1;
+
+    if (component.empty() || component == ".")
+      continue;
+    if (component == ".." && components.size() > root &&
+        components.back() != "..")
+    {
+      components.pop_back();
+    }
+    else
+    {
+      components.push_back(component);
+    }
+  }
+  return components;
+}
+
+/// \brief Join path components split by pathComponents.
+/// \param[in] _components Components.
+/// \return The path.
+std::string joinComponents(const std::vector<std::string> &_components)
+{
+  if (_components.size() == 1 && _components[0].empty())
+    return "/";
+
+  std::string path;
+  for (std::size_t i = 0; i < _components.size(); ++i)
+  {
+    if (i > 0)
+      path += '/';
+    path += _components[i];
+  }
+  return path;
+}
+
+/// \brief Express a path relative to a directory.
+/// \param[in] _path Absolute path.
+/// \param[in] _dir Absolute path to the directory.
+/// \return Relative path, empty if either path isn't absolute or they're on
+/// different drives.
+std::string relativePath(const std::string &_path, const std::string &_dir)
+{
+  if (!isAbsolute(_path) || !isAbsolute(_dir))
+    return std::string();
+
+  const auto path = pathComponents(_path);
+  const auto dir = pathComponents(_dir);
+  if (path.empty() || dir.empty() || path[0] != dir[0])
+    return std::string();
+
+  std::size_t shared{0};
+  while (shared < path.size() && shared < dir.size() &&
+      path[shared] == dir[shared])
+  {
+    ++shared;
+  }
+
+  std::vector<std::string> relative(dir.size() - shared, "..");
+  relative.insert(relative.end(), path.begin() + shared, path.end());
+  return joinComponents(relative);
+}
+
+/// \brief Write a mesh to a cache file. The file is written under a
+/// temporary name and then renamed, so concurrent readers, including other
+/// processes, never see a partial file.
+/// Cache entries are shared by copies of a mesh file, so textures are stored
+/// relative to the mesh file and resolved next to each copy when read.
+/// \param[in] _mesh Mesh to write.
+/// \param[in] _file Path to the cache file.
+/// \param[in] _dir Directory of the mesh file.
+/// \return True if the mesh was written, false if it can't be cached or the
+/// file couldn't be written.
+bool writeMesh(const common::Mesh &_mesh, const std::string &_file,
+    const std::string &_dir)
+{
+  // Skeletons and PBR materials aren't supported by the format
+  if (_mesh.HasSkeleton())
+    return false;
+  for (unsigned int i = 0; i < _mesh.MaterialCount(); ++i)
+  {
+    auto material = _mesh.MaterialByIndex(i);
+    if (nullptr == material || nullptr != material->PbrMaterial())
+      return false;
+  }
+
+  const std::string tmpFile = _file + "." + common::Uuid().String() + ".tmp";
+  {
+    std::ofstream out(tmpFile, std::ios::binary);
+    if (!out)
+      return false;
+
+    out.write(kMagic, sizeof(kMagic));
+    writeValue(out, kFormatVersion);
+
+    writeValue(out, static_cast<uint32_t>(_mesh.MaterialCount()));
+    for (unsigned int i = 0; i < _mesh.MaterialCount(); ++i)
+    {
+      auto material = _mesh.MaterialByIndex(i);
+      writeColor(out, material->Ambient());
+      writeColor(out, material->Diffuse());
+      writeColor(out, material->Specular());
+      writeColor(out, material->Emissive());
+      writeValue(out, material->Transparency());
+      writeValue(out, material->Shininess());
+      writeValue(out, static_cast<uint8_t>(material->Lighting()));
+      writeValue(out, static_cast<uint8_t>(material->TextureAlphaEnabled()));
+      writeValue(out, material->AlphaThreshold());
+      writeValue(out, static_cast<uint8_t>(material->TwoSidedEnabled()));
+
+      // Textures which weren't found are kept as they are
+      const std::string texture = material->TextureImage();
+      const std::string relative = relativePath(texture, _dir);
+      writeValue(out, static_cast<uint8_t>(!relative.empty()));
+      writeString(out, relative.empty() ? texture : relative);
+    }
+
+    writeValue(out, static_cast<uint32_t>(_mesh.SubMeshCount()));
+    for (unsigned int i = 0; i < _mesh.SubMeshCount(); ++i)
+    {
+      auto subMesh = _mesh.SubMeshByIndex(i).lock();
+      writeString(out, subMesh->Name());
+      writeValue(out, static_cast<uint32_t>(subMesh->SubMeshPrimitiveType()));
+      writeValue(out, static_cast<uint32_t>(subMesh->MaterialIndex()));
+
+      writeValue(out, static_cast<uint32_t>(subMesh->VertexCount()));
+      for (unsigned int v = 0; v < subMesh->VertexCount(); ++v)
+        writeVector3(out, subMesh->Vertex(v));
+
+      writeValue(out, static_cast<uint32_t>(subMesh->NormalCount()));
+      for (unsigned int n = 0; n < subMesh->NormalCount(); ++n)
+        writeVector3(out, subMesh->Normal(n));
+
+      writeValue(out, static_cast<uint32_t>(subMesh->TexCoordCount()));
+      for (unsigned int t = 0; t < subMesh->TexCoordCount(); ++t)
+      {
+        writeValue(out, subMesh->TexCoord(t).X());
+        writeValue(out, subMesh->TexCoord(t).Y());
+      }
+
+      writeValue(out, static_cast<uint32_t>(subMesh->IndexCount()));
+      for (unsigned int n = 0; n < subMesh->IndexCount(); ++n)
+        writeValue(out, static_cast<uint32_t>(subMesh->Index(n)));
+    }
+
+    if (!out)
+    {
+      out.close();
+      std::remove(tmpFile.c_str());
+      return false;
+    }
+  }
+
+  if (std::rename(tmpFile.c_str(), _file.c_str()) != 0)
+  {
+    std::remove(tmpFile.c_str());
+    return false;
+  }
+  return true;
+}
+
+/// \brief Read a mesh from a cache file written by writeMesh.
+/// \param[in] _file Path to the cache file.
+/// \param[in] _dir Directory of the mesh file, which relative texture paths
+/// are resolved against.
+/// \return The mesh, or null if the file doesn't exist or is invalid.
+common::Mesh *readMesh(const std::string &_file, const std::string &_dir)
+{
+  std::ifstream in(_file, std::ios::binary | std::ios::ate);
+  if (!in)
+    return nullptr;
+  const auto end = in.tellg();
+  if (end < 0)
+    return nullptr;
+  const uint64_t fileSize = static_cast<uint64_t>(end);
+  in.seekg(0);
+
+  char magic[sizeof(kMagic)];
+  uint32_t version{0};
+  in.read(magic, sizeof(magic));
+  if (!in || !std::equal(magic, magic + sizeof(magic), kMagic) ||
+      !readValue(in, version) || version != kFormatVersion)
+  {
+    igndbg << "Ignoring mesh cache file [" << _file
+           << "] with unknown format." << std::endl;
+    return nullptr;
+  }
+
+  auto mesh = std::make_unique<common::Mesh>();
+
+  // Counts which don't fit in the file are corrupt, treated as a miss
+  uint32_t materialCount{0};
+  if (!readValue(in, materialCount) ||
+      !fits(in, fileSize, materialCount, kMinMaterialSize))
+  {
+    return nullptr;
+  }
+  for (uint32_t i = 0; i < materialCount; ++i)
+  {
+    math::Color ambient, diffuse, specular, emissive;
+    double transparency, shininess, alphaThreshold;
+    uint8_t lighting, alphaFromTexture, twoSided, relative;
+    std::string texture;
+    if (!readColor(in, ambient) || !readColor(in, diffuse) ||
+        !readColor(in, specular) || !readColor(in, emissive) ||
+        !readValue(in, transparency) || !readValue(in, shininess) ||
+        !readValue(in, lighting) || !readValue(in, alphaFromTexture) ||
+        !readValue(in, alphaThreshold) || !readValue(in, twoSided) ||
+        !readValue(in, relative) || !readString(in, fileSize, texture))
+    {
+      return nullptr;
+    }
+
+    auto material = std::make_shared<common::Material>();
+    material->SetAmbient(ambient);
+    material->SetDiffuse(diffuse);
+    material->SetSpecular(specular);
+    material->SetEmissive(emissive);
+    material->SetTransparency(transparency);
+    material->SetShininess(shininess);
+    material->SetLighting(lighting != 0);
+    material->SetAlphaFromTexture(alphaFromTexture != 0, alphaThreshold,
+        twoSided != 0);
+    if (relative != 0)
+      texture = joinComponents(pathComponents(_dir + "/" + texture));
+    if (!texture.empty())
+    {
+      material->SetTextureImage(common::basename(texture),
+          common::parentPath(texture));
+    }
+    mesh->AddMaterial(material);
+  }
+
+  uint32_t subMeshCount{0};
+  if (!readValue(in, subMeshCount) ||
+      !fits(in, fileSize, subMeshCount, kMinSubMeshSize))
+  {
+    return nullptr;
+  }
+  for (uint32_t i = 0; i < subMeshCount; ++i)
+  {
+    common::SubMesh subMesh;
+
+    std::string name;
+    uint32_t primitiveType, materialIndex;
+    if (!readString(in, fileSize, name) || !readValue(in, primitiveType) ||
+        !readValue(in, materialIndex))
+    {
+      return nullptr;
+    }
+    subMesh.SetName(name);
+    subMesh.SetPrimitiveType(
+        static_cast<common::SubMesh::PrimitiveType>(primitiveType));
+    if (materialIndex < materialCount)
+      subMesh.SetMaterialIndex(materialIndex);
+
+    uint32_t count{0};
+    math::Vector3d vector3;
+    if (!readValue(in, count) ||
+        !fits(in, fileSize, count, 3 * sizeof(double)))
+    {
+      return nullptr;
+    }
+    for (uint32_t v = 0; v < count; ++v)
+    {
+      if (!readVector3(in, vector3))
+        return nullptr;
+      subMesh.AddVertex(vector3);
+    }
+
+    if (!readValue(in, count) ||
+        !fits(in, fileSize, count, 3 * sizeof(double)))
+    {
+      return nullptr;
+    }
+    for (uint32_t n = 0; n < count; ++n)
+    {
+      if (!readVector3(in, vector3))
+        return nullptr;
+      subMesh.AddNormal(vector3);
+    }
+
+    double u, v;
+    if (!readValue(in, count) ||
+        !fits(in, fileSize, count, 2 * sizeof(double)))
+    {
+      return nullptr;
+    }
+    for (uint32_t t = 0; t < count; ++t)
+    {
+      if (!readValue(in, u) || !readValue(in, v))
+        return nullptr;
+      subMesh.AddTexCoord(math::Vector2d(u, v));
+    }
+
+    uint32_t index;
+    if (!readValue(in, count) ||
+        !fits(in, fileSize, count, sizeof(uint32_t)))
+    {
+      return nullptr;
+    }
+    for (uint32_t n = 0; n < count; ++n)
+    {
+      if (!readValue(in, index))
+        return nullptr;
+      subMesh.AddIndex(index);
+    }
+
+    mesh->AddSubMesh(subMesh);
+  }
+
+  return mesh.release();
+}
+
+/// \brief Get the modification time and size of a file.
+/// \param[in] _path Path to the file.
+/// \param[out] _mtime Modification time, in seconds.
+/// \param[out] _size Size in bytes.
+/// \return False if the file doesn't exist.
+bool fileStamp(const std::string &_path, int64_t &_mtime, uint64_t &_size)
+{
+  struct stat info;
+  if (stat(_path.c_str(), &info) != 0)
+    return false;
+  _mtime = static_cast<int64_t>(info.st_mtime);
+  _size = static_cast<uint64_t>(info.st_size);
+  return true;
+}
+
+/// \brief Mark a cache file as just used, so it's removed last when the
+/// cache is trimmed.
+/// \param[in] _file Path to the cache file.
+void touch(const std::string &_file)
+{
+#ifdef _WIN32
+  _utime(_file.c_str(), nullptr);
+#else
+  utime(_file.c_str(), nullptr);
+#endif
+}
+
+/// \brief A file of the disk cache.
+struct CacheEntry
+{
+  /// \brief Path to the file.
+  std::string path;
+
+  /// \brief Last time the file was written or read, in seconds.
+  int64_t mtime{0};
+
+  /// \brief Size in bytes.
+  uint64_t size{0};
+};
+
+/// \brief List the files of the disk cache. Temporary files being written
+/// are left out.
+/// \param[in] _dir Directory of the cache.
+/// \return The files.
+std::vector<CacheEntry> cacheEntries(const std::string &_dir)
+{
+  std::vector<CacheEntry> entries;
+  for (common::DirIter file(_dir); file != common::DirIter(); ++file)
+  {
+    CacheEntry entry;
+    entry.path = *file;
+    const std::string extension = ".mesh";
+    if (entry.path.size() < extension.size() ||
+        entry.path.compare(entry.path.size() - extension.size(),
+            extension.size(), extension) != 0 ||
+        !fileStamp(entry.path, entry.mtime, entry.size))
+    {
+      continue;
+    }
+    entries.push_back(entry);
+  }
+  return entries;
+}
+
+/// \brief Decode a mesh file with the loader for its format.
+/// \param[in] _path Resolved path to the mesh file.
+/// \param[out] _supported False if the format isn't supported.
+/// \return The mesh, or null if it couldn't be decoded.
+common::Mesh *decodeFile(const std::string &_path, bool &_supported)
+{
+  std::string extension = _path.substr(_path.rfind('.') + 1);
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+      [](unsigned char _c) {return std::tolower(_c);});
+
+  // Each call uses its own loader, so files can be decoded concurrently
+  _supported = true;
+  if (extension == "dae")
+  {
+    common::ColladaLoader loader;
+    return loader.Load(_path);
+  }
+  if (extension == "obj")
+  {
+    common::OBJLoader loader;
+    return loader.Load(_path);
+  }
+  if (extension == "stl" || extension == "stlb" || extension == "stla")
+  {
+    common::STLLoader loader;
+    return loader.Load(_path);
+  }
+  _supported = false;
+  return nullptr;
+}
+}
+
+//////////////////////////////////////////////////
+std::string MeshAssetsPrivate::Resolve(const std::string &_path)
+{
+  auto resolved = common::findFile(_path);
+  return resolved.empty() ? _path : resolved;
+}
+
+//////////////////////////////////////////////////
+void MeshAssetsPrivate::Fulfill(PendingMesh &_pending)
+{
+  _pending.second->set_value(this->Decode(_pending.first));
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<DecodedMesh> MeshAssetsPrivate::Decode(
+    const std::string &_path)
+{
+  auto decoded = std::make_shared<DecodedMesh>();
+  const std::string dir = common::parentPath(_path);
+  const std::string file = this->CacheFile(_path);
+  decoded->mesh.reset(file.empty() ? nullptr : readMesh(file, dir));
+  if (nullptr != decoded->mesh)
+  {
+    touch(file);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    ++this->stats.cacheHits;
+  }
+  else
+  {
+    decoded->mesh.reset(decodeFile(_path, decoded->supported));
+    if (nullptr == decoded->mesh)
+      return decoded;
+
+    bool written = !file.empty() && writeMesh(*decoded->mesh, file, dir);
+    if (written)
+      this->AddToCache(file);
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    ++this->stats.decoded;
+    if (written)
+      ++this->stats.cacheWrites;
+  }
+  decoded->mesh->SetPath(dir);
+  return decoded;
+}
+
+//////////////////////////////////////////////////
+const common::Mesh *MeshAssetsPrivate::Register(const std::string &_name,
+    DecodedMesh &_decoded)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (_decoded.registered)
+    return _decoded.result;
+
+  auto *meshManager = common::MeshManager::Instance();
+  if (meshManager->HasMesh(_name))
+  {
+    // Loaded directly through the mesh manager, for example by a plugin
+    _decoded.result = meshManager->MeshByName(_name);
+  }
+  else if (nullptr != _decoded.mesh)
+  {
+    _decoded.mesh->SetName(_name);
+    _decoded.result = _decoded.mesh.get();
+    meshManager->AddMesh(_decoded.mesh.release());
+  }
+  else if (!_decoded.supported)
+  {
+    // Let the mesh manager deal with formats it may support in the future
+    _decoded.result = meshManager->Load(_name);
+  }
+
+  _decoded.mesh.reset();
+  _decoded.registered = true;
+  if (nullptr == _decoded.result)
+  {
+    ignerr << "Unable to load mesh [" << _name << "]" << std::endl;
+    this->meshes.erase(_name);
+  }
+  return _decoded.result;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<std::promise<std::shared_ptr<DecodedMesh>>>
+    MeshAssetsPrivate::ClaimLocked(const std::string &_path)
+{
+  this->unclaimed.erase(_path);
+
+  auto queued = std::find_if(this->queue.begin(), this->queue.end(),
+      [&_path](const PendingMesh &_pending)
+      {
+        return _pending.first == _path;
+      });
+  if (queued == this->queue.end())
+    return nullptr;
+
+  auto promise = queued->second;
+  this->queue.erase(queued);
+  return promise;
+}
+
+//////////////////////////////////////////////////
+void MeshAssetsPrivate::AddToCache(const std::string &_file)
+{
+  std::string dir;
+  uint64_t limit{0};
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    dir = this->cachePath;
+    limit = this->cacheSizeLimit;
+  }
+  if (dir.empty())
+    return;
+
+  std::lock_guard<std::mutex> cacheLock(this->cacheMutex);
+  if (!this->cacheSizeKnown)
+  {
+    // Includes the file just written
+    this->cacheSize = 0;
+    for (const auto &entry : cacheEntries(dir))
+      this->cacheSize += entry.size;
+    this->cacheSizeKnown = true;
+  }
+  else
+  {
+    int64_t mtime{0};
+    uint64_t size{0};
+    if (fileStamp(_file, mtime, size))
+      this->cacheSize += size;
+  }
+
+  if (this->cacheSize <= limit)
+    return;
+
+  // Remove the files which weren't written or read for the longest time,
+  // including those written by other processes
+  auto entries = cacheEntries(dir);
+  std::sort(entries.begin(), entries.end(),
+      [](const CacheEntry &_a, const CacheEntry &_b)
+      {
+        return _a.mtime < _b.mtime;
+      });
+
+  uint64_t total{0};
+  for (const auto &entry : entries)
+    total += entry.size;
+
+  // The file just written is kept, even if its modification time is the
+  // same as older files
+  const std::string written = common::basename(_file);
+  uint64_t removed{0};
+  for (const auto &entry : entries)
+  {
+    if (total <= limit)
+      break;
+    if (common::basename(entry.path) == written)
+      continue;
+    if (std::remove(entry.path.c_str()) == 0)
+    {
+      total -= entry.size;
+      ++removed;
+    }
+  }
+  this->cacheSize = total;
+
+  igndbg << "Removed [" << removed << "] files from mesh cache [" << dir
+         << "] to keep it under [" << limit << "] bytes." << std::endl;
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->stats.cacheEvictions += removed;
+}
+
+//////////////////////////////////////////////////
+void MeshAssetsPrivate::Work()
+{
+  while (true)
+  {
+    PendingMesh pending;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->queueCondition.wait(lock, [this]
+      {
+        return !this->queue.empty() || this->stopWorkers;
+      });
+      if (this->queue.empty())
+        return;
+      pending = std::move(this->queue.front());
+      this->queue.pop_front();
+    }
+    this->Fulfill(pending);
+  }
+}
+
+//////////////////////////////////////////////////
+std::string MeshAssetsPrivate::CacheFile(const std::string &_path,
+    const std::string &_variant) const
+{
+  std::string dir;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    dir = this->cachePath;
+  }
+  if (dir.empty())
+    return std::string();
+
+  // Edited files change modification time or size, so they aren't read
+  // from stale entries, without reading the whole file to find out
+  int64_t mtime{0};
+  uint64_t size{0};
+  if (!fileStamp(_path, mtime, size))
+    return std::string();
+
+  std::string name = common::sha1(_path + "\n" + std::to_string(mtime) +
+      "\n" + std::to_string(size));
+  if (!_variant.empty())
+    name += "_" + common::sha1(_variant);
+  return common::joinPaths(dir, name + ".mesh");
+}
+
+//////////////////////////////////////////////////
+MeshAssets::MeshAssets()
+  : dataPtr(std::make_unique<MeshAssetsPrivate>())
+{
+  std::string path;
+  if (!common::env(kMeshCachePathEnv, path) || path.empty())
+  {
+    std::string home;
+    common::env(IGN_HOMEDIR, home);
+    path = common::joinPaths(home, ".ignition", "gazebo", "mesh_cache");
+  }
+  this->SetCachePath(path);
+}
+
+//////////////////////////////////////////////////
+MeshAssets::~MeshAssets()
+{
+  this->FinishPreload();
+}
+
+//////////////////////////////////////////////////
+MeshAssets &MeshAssets::Instance()
+{
+  static MeshAssets instance;
+  return instance;
+}
+
+//////////////////////////////////////////////////
+const common::Mesh *MeshAssets::Load(const std::string &_path)
+{
+  if (_path.empty())
+    return nullptr;
+
+  PendingMesh pending;
+  std::shared_future<std::shared_ptr<DecodedMesh>> future;
+  pending.first = MeshAssetsPrivate::Resolve(_path);
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto it = this->dataPtr->meshes.find(pending.first);
+    if (it != this->dataPtr->meshes.end())
+    {
+      future = it->second;
+      pending.second = this->dataPtr->ClaimLocked(pending.first);
+    }
+    else
+    {
+      pending.second =
+          std::make_shared<std::promise<std::shared_ptr<DecodedMesh>>>();
+      future = pending.second->get_future().share();
+      this->dataPtr->meshes[pending.first] = future;
+    }
+  }
+
+  if (pending.second)
+    this->dataPtr->Fulfill(pending);
+  return this->dataPtr->Register(pending.first, *future.get());
+}
+
+//////////////////////////////////////////////////
+const common::Mesh *MeshAssets::LoadDerived(const std::string &_path,
+    const std::string &_variant, const DeriveMeshFn &_derive)
+{
+  if (_path.empty())
+    return nullptr;
+
+  const std::string resolved = MeshAssetsPrivate::Resolve(_path);
+  PendingMesh pending;
+  std::shared_future<std::shared_ptr<DecodedMesh>> future;
+  pending.first = resolved + "#" + _variant;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto it = this->dataPtr->meshes.find(pending.first);
+    if (it != this->dataPtr->meshes.end())
+    {
+      future = it->second;
+    }
+    else
+    {
+      pending.second =
+          std::make_shared<std::promise<std::shared_ptr<DecodedMesh>>>();
+      future = pending.second->get_future().share();
+      this->dataPtr->meshes[pending.first] = future;
+    }
+  }
+
+  // Being derived by another thread, or already derived
+  if (!pending.second)
+    return this->dataPtr->Register(pending.first, *future.get());
+
+  auto derived = std::make_shared<DecodedMesh>();
+  const std::string dir = common::parentPath(resolved);
+  const std::string file = this->dataPtr->CacheFile(resolved, _variant);
+  derived->mesh.reset(file.empty() ? nullptr : readMesh(file, dir));
+  if (nullptr != derived->mesh)
+  {
+    touch(file);
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    ++this->dataPtr->stats.cacheHits;
+  }
+  else if (auto *mesh = this->Load(_path))
+  {
+    derived->mesh = _derive(*mesh);
+    if (nullptr != derived->mesh)
+    {
+      bool written = !file.empty() && writeMesh(*derived->mesh, file, dir);
+      if (written)
+        this->dataPtr->AddToCache(file);
+
+      std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+      ++this->dataPtr->stats.derived;
+      if (written)
+        ++this->dataPtr->stats.cacheWrites;
+    }
+  }
+
+  if (nullptr != derived->mesh)
+    derived->mesh->SetPath(dir);
+  pending.second->set_value(derived);
+  return this->dataPtr->Register(pending.first, *derived);
+}
+
+//////////////////////////////////////////////////
+uint64_t MeshAssets::Preload(const std::set<std::string> &_paths)
+{
+  std::lock_guard<std::mutex> workersLock(this->dataPtr->workersMutex);
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  const uint64_t request = this->dataPtr->nextRequest++;
+  std::size_t queued{0};
+  for (const auto &path : _paths)
+  {
+    if (path.empty())
+      continue;
+
+    auto resolved = MeshAssetsPrivate::Resolve(path);
+    if (this->dataPtr->meshes.find(resolved) != this->dataPtr->meshes.end())
+    {
+      // Preloaded by another request, keep it until both are canceled
+      auto it = this->dataPtr->unclaimed.find(resolved);
+      if (it != this->dataPtr->unclaimed.end())
+        it->second.insert(request);
+      continue;
+    }
+
+    auto promise =
+        std::make_shared<std::promise<std::shared_ptr<DecodedMesh>>>();
+    this->dataPtr->meshes[resolved] = promise->get_future().share();
+    this->dataPtr->queue.emplace_back(resolved, promise);
+    this->dataPtr->unclaimed[resolved].insert(request);
+    ++queued;
+  }
+
+  if (queued == 0)
+    return request;
+
+  igndbg << "Preloading [" << queued << "] meshes." << std::endl;
+
+  // Threads are kept until FinishPreload, so later calls reuse them
+  const std::size_t threadCount = std::min<std::size_t>(
+      this->dataPtr->queue.size(),
+      std::max(1u, std::thread::hardware_concurrency()));
+  while (this->dataPtr->workers.size() < threadCount)
+  {
+    this->dataPtr->workers.emplace_back(
+        &MeshAssetsPrivate::Work, this->dataPtr.get());
+  }
+  this->dataPtr->queueCondition.notify_all();
+  return request;
+}
+
+//////////////////////////////////////////////////
+void MeshAssets::CancelPreload(uint64_t _request)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  std::size_t evicted{0};
+  for (auto it = this->dataPtr->unclaimed.begin();
+      it != this->dataPtr->unclaimed.end();)
+  {
+    it->second.erase(_request);
+    if (!it->second.empty())
+    {
+      ++it;
+      continue;
+    }
+
+    // Nobody loaded it, so nobody waits for it either
+    const std::string &path = it->first;
+    auto &queue = this->dataPtr->queue;
+    queue.erase(std::remove_if(queue.begin(), queue.end(),
+        [&path](const PendingMesh &_pending)
+        {
+          return _pending.first == path;
+        }), queue.end());
+    this->dataPtr->meshes.erase(path);
+    it = this->dataPtr->unclaimed.erase(it);
+    ++evicted;
+  }
+
+  if (evicted > 0)
+  {
+    igndbg << "Dropped [" << evicted << "] preloaded meshes which weren't "
+           << "loaded." << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+void MeshAssets::FinishPreload()
+{
+  std::lock_guard<std::mutex> workersLock(this->dataPtr->workersMutex);
+  std::vector<std::thread> workers;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stopWorkers = true;
+    workers.swap(this->dataPtr->workers);
+  }
+  this->dataPtr->queueCondition.notify_all();
+
+  for (auto &worker : workers)
+  {
+    if (worker.joinable())
+      worker.join();
+  }
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->stopWorkers = false;
+}
+
+//////////////////////////////////////////////////
+uint64_t MeshAssets::PreloadWorld(const sdf::World &_world,
+    bool _collisions, bool _visuals)
+{
+  std::set<std::string> paths;
+  auto addGeometry = [&paths](const sdf::Geometry *_geom)
+  {
+    if (nullptr == _geom || _geom->Type() != sdf::GeometryType::MESH ||
+        nullptr == _geom->MeshShape())
+    {
+      return;
+    }
+    auto path = asFullPath(_geom->MeshShape()->Uri(),
+        _geom->MeshShape()->FilePath());
+    if (!path.empty())
+      paths.insert(path);
+  };
+
+  std::function<void(const sdf::Model *)> addModel =
+      [&](const sdf::Model *_model)
+  {
+    for (uint64_t l = 0; l < _model->LinkCount(); ++l)
+    {
+      auto link = _model->LinkByIndex(l);
+      for (uint64_t v = 0; _visuals && v < link->VisualCount(); ++v)
+        addGeometry(link->VisualByIndex(v)->Geom());
+      for (uint64_t c = 0; _collisions && c < link->CollisionCount(); ++c)
+        addGeometry(link->CollisionByIndex(c)->Geom());
+    }
+    for (uint64_t m = 0; m < _model->ModelCount(); ++m)
+      addModel(_model->ModelByIndex(m));
+  };
+
+  for (uint64_t m = 0; m < _world.ModelCount(); ++m)
+    addModel(_world.ModelByIndex(m));
+
+  return this->Preload(paths);
+}
+
+//////////////////////////////////////////////////
+void MeshAssets::SetCachePath(const std::string &_path)
+{
+  if (!_path.empty() && !common::isDirectory(_path) &&
+      !common::createDirectories(_path))
+  {
+    ignwarn << "Failed to create mesh cache directory [" << _path
+            << "], meshes won't be cached on disk." << std::endl;
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->cachePath.clear();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> cacheLock(this->dataPtr->cacheMutex);
+    this->dataPtr->cacheSizeKnown = false;
+  }
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->cachePath = _path;
+}
+
+//////////////////////////////////////////////////
+std::string MeshAssets::CachePath() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->cachePath;
+}
+
+//////////////////////////////////////////////////
+void MeshAssets::SetCacheSizeLimit(uint64_t _bytes)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->cacheSizeLimit = _bytes;
+}
+
+//////////////////////////////////////////////////
+uint64_t MeshAssets::CacheSizeLimit() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->cacheSizeLimit;
+}
+
+//////////////////////////////////////////////////
+MeshAssetStatistics MeshAssets::Statistics() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->stats;
+}
@@ -0,0 +1,400 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/SubMesh.hh>
+#include <ignition/common/Util.hh>
+
+#include "ignition/gazebo/MeshAssets.hh"
+#include "ignition/gazebo/test_config.hh"
+
+#include "helpers/EnvTestFixture.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Test fixture which caches meshes in the build directory.
+class MeshAssetsTest : public InternalFixture<::testing::Test>
+{
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    InternalFixture::SetUp();
+
+    this->cachePath = common::joinPaths(PROJECT_BINARY_PATH,
+        "MeshAssets_TEST_cache");
+    common::removeAll(this->cachePath);
+    MeshAssets::Instance().SetCachePath(this->cachePath);
+  }
+
+  // Documentation inherited
+  protected: void TearDown() override
+  {
+    common::removeAll(this->cachePath);
+    InternalFixture::TearDown();
+  }
+
+  /// \brief Decode a mesh into the disk cache without keeping it in
+  /// memory, so the next load reads it from the disk cache.
+  /// \param[in] _path Path to the mesh file.
+  public: void Cache(const std::string &_path)
+  {
+    auto &assets = MeshAssets::Instance();
+    auto request = assets.Preload({_path});
+    assets.FinishPreload();
+    assets.CancelPreload(request);
+  }
+
+  /// \brief Get the files in the disk cache.
+  /// \return Paths to the files.
+  public: std::vector<std::string> CacheFiles() const
+  {
+    std::vector<std::string> files;
+    for (common::DirIter file(this->cachePath); file != common::DirIter();
+        ++file)
+    {
+      const std::string path = *file;
+      if (common::isFile(path) && path.size() > 5 &&
+          path.substr(path.size() - 5) == ".mesh")
+      {
+        files.push_back(path);
+      }
+    }
+    return files;
+  }
+
+  /// \brief Directory of the disk cache.
+  public: std::string cachePath;
+};
+
+/////////////////////////////////////////////////
+TEST_F(MeshAssetsTest, CacheRoundTrip)
+{
+  auto &assets = MeshAssets::Instance();
+  EXPECT_EQ(this->cachePath, assets.CachePath());
+  EXPECT_TRUE(common::isDirectory(this->cachePath));
+
+  const std::string path = common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "duck.dae");
+  auto before = assets.Statistics();
+  auto *mesh = assets.Load(path);
+  ASSERT_NE(nullptr, mesh);
+  auto after = assets.Statistics();
+  EXPECT_EQ(before.decoded + 1, after.decoded);
+  EXPECT_EQ(before.cacheWrites + 1, after.cacheWrites);
+
+  // Loading again returns the same mesh, shared through the mesh manager
+  EXPECT_EQ(mesh, assets.Load(path));
+  EXPECT_EQ(mesh, common::MeshManager::Instance()->MeshByName(path));
+  EXPECT_EQ(after.decoded, assets.Statistics().decoded);
+
+  // A copy of the file which was cached but dropped from memory is read
+  // from the cache
+  const std::string copyDir = common::joinPaths(this->cachePath, "copy");
+  ASSERT_TRUE(common::createDirectories(copyDir));
+  const std::string copy = common::joinPaths(copyDir, "duck.dae");
+  ASSERT_TRUE(common::copyFile(path, copy));
+  ASSERT_TRUE(common::copyFile(common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "duck.png"), common::joinPaths(copyDir, "duck.png")));
+  this->Cache(copy);
+  after = assets.Statistics();
+  auto *cached = assets.Load(copy);
+  ASSERT_NE(nullptr, cached);
+  EXPECT_NE(mesh, cached);
+  EXPECT_EQ(after.cacheHits + 1, assets.Statistics().cacheHits);
+  EXPECT_EQ(after.decoded, assets.Statistics().decoded);
+
+  ASSERT_EQ(mesh->SubMeshCount(), cached->SubMeshCount());
+  ASSERT_EQ(mesh->MaterialCount(), cached->MaterialCount());
+  for (unsigned int i = 0; i < mesh->SubMeshCount(); ++i)
+  {
+    auto original = mesh->SubMeshByIndex(i).lock();
+    auto fromCache = cached->SubMeshByIndex(i).lock();
+    EXPECT_EQ(original->Name(), fromCache->Name());
+    EXPECT_EQ(original->MaterialIndex(), fromCache->MaterialIndex());
+    ASSERT_EQ(original->VertexCount(), fromCache->VertexCount());
+    ASSERT_EQ(original->IndexCount(), fromCache->IndexCount());
+    for (unsigned int v = 0; v < original->VertexCount(); ++v)
+      EXPECT_EQ(original->Vertex(v), fromCache->Vertex(v));
+    for (unsigned int n = 0; n < original->IndexCount(); ++n)
+      EXPECT_EQ(original->Index(n), fromCache->Index(n));
+  }
+  // Textures are found next to the copy, not next to the original
+  bool hasTexture{false};
+  for (unsigned int i = 0; i < mesh->MaterialCount(); ++i)
+  {
+    auto original = mesh->MaterialByIndex(i);
+    auto fromCache = cached->MaterialByIndex(i);
+    EXPECT_EQ(original->Diffuse(), fromCache->Diffuse());
+    if (original->TextureImage().empty())
+    {
+      EXPECT_TRUE(fromCache->TextureImage().empty());
+      continue;
+    }
+    hasTexture = true;
+    EXPECT_EQ(common::joinPaths(copyDir,
+        common::basename(original->TextureImage())),
+        fromCache->TextureImage());
+  }
+  EXPECT_TRUE(hasTexture);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshAssetsTest, CorruptCache)
+{
+  auto &assets = MeshAssets::Instance();
+
+  const std::string path = common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "duck_collider.dae");
+
+  // Copy which wasn't loaded yet in this process
+  const std::string dir = common::joinPaths(this->cachePath, "copy");
+  ASSERT_TRUE(common::createDirectories(dir));
+  const std::string copy = common::joinPaths(dir, "duck_collider.dae");
+  ASSERT_TRUE(common::copyFile(path, copy));
+
+  this->Cache(copy);
+  auto files = this->CacheFiles();
+  ASSERT_EQ(1u, files.size());
+  const std::string entry = files[0];
+
+  // Keep the header of the entry, followed by a submesh count and a name
+  // size which don't fit in the file
+  std::string header(12, '\0');
+  {
+    std::ifstream entryIn(entry, std::ios::binary);
+    entryIn.read(&header[0], header.size());
+    ASSERT_TRUE(entryIn.good());
+  }
+  {
+    std::ofstream entryOut(entry, std::ios::binary | std::ios::trunc);
+    entryOut.write(header.data(), header.size());
+    const uint32_t values[] = {0u, 1u, 0xFFFFFFFFu};
+    entryOut.write(reinterpret_cast<const char *>(values), sizeof(values));
+  }
+
+  // The corrupt entry is a miss, the mesh is decoded and cached again
+  auto before = assets.Statistics();
+  auto *mesh = assets.Load(copy);
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_GT(mesh->SubMeshCount(), 0u);
+  auto after = assets.Statistics();
+  EXPECT_EQ(before.cacheHits, after.cacheHits);
+  EXPECT_EQ(before.decoded + 1, after.decoded);
+  EXPECT_EQ(before.cacheWrites + 1, after.cacheWrites);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshAssetsTest, Preload)
+{
+  auto &assets = MeshAssets::Instance();
+
+  const std::string path = common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "duck_collider.dae");
+  assets.Preload({path, ""});
+
+  // Waits for the preloaded mesh
+  auto *mesh = assets.Load(path);
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(mesh, common::MeshManager::Instance()->MeshByName(path));
+  EXPECT_GT(mesh->SubMeshCount(), 0u);
+
+  // Meshes which were preloaded but not loaded yet are registered by Load,
+  // after the preload threads are gone
+  const std::string other = common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "duck.dae");
+  assets.Preload({other});
+  assets.FinishPreload();
+  auto *otherMesh = assets.Load(other);
+  ASSERT_NE(nullptr, otherMesh);
+  EXPECT_EQ(otherMesh, common::MeshManager::Instance()->MeshByName(other));
+
+  // Preloading works again
+  const std::string copy = common::joinPaths(this->cachePath, "duck.dae");
+  ASSERT_TRUE(common::copyFile(other, copy));
+  assets.Preload({copy});
+  EXPECT_NE(nullptr, assets.Load(copy));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshAssetsTest, Derived)
+{
+  auto &assets = MeshAssets::Instance();
+
+  const std::string path = common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "duck_collider.dae");
+  int calls{0};
+  auto firstSubMesh = [&](const common::Mesh &_mesh)
+  {
+    ++calls;
+    auto derived = std::make_unique<common::Mesh>();
+    derived->AddSubMesh(*_mesh.SubMeshByIndex(0).lock());
+    return derived;
+  };
+
+  auto before = assets.Statistics();
+  auto *derived = assets.LoadDerived(path, "first", firstSubMesh);
+  ASSERT_NE(nullptr, derived);
+  EXPECT_EQ(1, calls);
+  EXPECT_EQ(1u, derived->SubMeshCount());
+  EXPECT_NE(assets.Load(path), derived);
+  EXPECT_EQ(before.derived + 1, assets.Statistics().derived);
+
+  // Cached in memory
+  EXPECT_EQ(derived, assets.LoadDerived(path, "first", firstSubMesh));
+  EXPECT_EQ(1, calls);
+
+  // A copy of the file is another file, so it's derived again and written
+  // to the disk cache
+  const std::string copy = common::joinPaths(this->cachePath,
+      "duck_collider.dae");
+  ASSERT_TRUE(common::copyFile(path, copy));
+  auto writes = assets.Statistics().cacheWrites;
+  auto *copyDerived = assets.LoadDerived(copy, "first", firstSubMesh);
+  ASSERT_NE(nullptr, copyDerived);
+  EXPECT_EQ(2, calls);
+  EXPECT_LT(writes, assets.Statistics().cacheWrites);
+  EXPECT_EQ(1u, copyDerived->SubMeshCount());
+
+  // Failing to derive isn't remembered
+  auto fail = [&](const common::Mesh &)
+  {
+    ++calls;
+    return std::unique_ptr<common::Mesh>();
+  };
+  EXPECT_EQ(nullptr, assets.LoadDerived(path, "fail", fail));
+  EXPECT_EQ(nullptr, assets.LoadDerived(path, "fail", fail));
+  EXPECT_EQ(4, calls);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshAssetsTest, CancelPreload)
+{
+  auto &assets = MeshAssets::Instance();
+
+  const std::string path = common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "duck_collider.dae");
+  const std::string first = common::joinPaths(this->cachePath, "first.dae");
+  const std::string second = common::joinPaths(this->cachePath, "second.dae");
+  ASSERT_TRUE(common::copyFile(path, first));
+  ASSERT_TRUE(common::copyFile(path, second));
+
+  // Both requests preload the first file, only one preloads the second
+  auto before = assets.Statistics();
+  auto request = assets.Preload({first, second});
+  auto otherRequest = assets.Preload({first});
+  EXPECT_NE(request, otherRequest);
+  assets.FinishPreload();
+  EXPECT_EQ(before.decoded + 2, assets.Statistics().decoded);
+
+  // The second file wasn't loaded and nobody else wants it, so it's dropped
+  // from memory and read from the disk cache when it's loaded
+  assets.CancelPreload(request);
+  auto hits = assets.Statistics().cacheHits;
+  EXPECT_NE(nullptr, assets.Load(second));
+  EXPECT_EQ(hits + 1, assets.Statistics().cacheHits);
+
+  // The first file is still preloaded for the other request
+  EXPECT_NE(nullptr, assets.Load(first));
+  EXPECT_EQ(hits + 1, assets.Statistics().cacheHits);
+
+  // Loaded meshes are kept
+  assets.CancelPreload(otherRequest);
+  auto *mesh = assets.Load(first);
+  EXPECT_NE(nullptr, mesh);
+  EXPECT_EQ(mesh, common::MeshManager::Instance()->MeshByName(first));
+  EXPECT_EQ(hits + 1, assets.Statistics().cacheHits);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshAssetsTest, EditedFile)
+{
+  auto &assets = MeshAssets::Instance();
+
+  const std::string path = common::joinPaths(this->cachePath, "edited.dae");
+  ASSERT_TRUE(common::copyFile(common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "duck_collider.dae"), path));
+  this->Cache(path);
+  EXPECT_EQ(1u, this->CacheFiles().size());
+
+  // Changing the size changes the key, so the stale entry isn't read
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    out << "\n";
+  }
+  auto before = assets.Statistics();
+  EXPECT_NE(nullptr, assets.Load(path));
+  EXPECT_EQ(before.cacheHits, assets.Statistics().cacheHits);
+  EXPECT_EQ(before.decoded + 1, assets.Statistics().decoded);
+  EXPECT_EQ(2u, this->CacheFiles().size());
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshAssetsTest, CacheSizeLimit)
+{
+  auto &assets = MeshAssets::Instance();
+  const auto defaultLimit = assets.CacheSizeLimit();
+  EXPECT_EQ(1024ull * 1024 * 1024, defaultLimit);
+
+  const std::string path = common::joinPaths(PROJECT_SOURCE_PATH, "test",
+      "media", "duck_collider.dae");
+  const std::string first = common::joinPaths(this->cachePath, "first.dae");
+  ASSERT_TRUE(common::copyFile(path, first));
+  this->Cache(first);
+  auto files = this->CacheFiles();
+  ASSERT_EQ(1u, files.size());
+  std::ifstream entry(files[0], std::ios::binary | std::ios::ate);
+  const uint64_t entrySize = static_cast<uint64_t>(entry.tellg());
+  ASSERT_GT(entrySize, 0u);
+
+  // Room for a single entry, writing another one removes the older one
+  assets.SetCacheSizeLimit(entrySize + entrySize / 2);
+  EXPECT_EQ(entrySize + entrySize / 2, assets.CacheSizeLimit());
+
+  const std::string second = common::joinPaths(this->cachePath, "second.dae");
+  ASSERT_TRUE(common::copyFile(path, second));
+  auto before = assets.Statistics();
+  this->Cache(second);
+  EXPECT_EQ(before.cacheEvictions + 1, assets.Statistics().cacheEvictions);
+
+  files = this->CacheFiles();
+  ASSERT_EQ(1u, files.size());
+  EXPECT_NE(nullptr, assets.Load(second));
+  EXPECT_EQ(before.cacheHits + 1, assets.Statistics().cacheHits);
+
+  assets.SetCacheSizeLimit(defaultLimit);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MeshAssetsTest, Invalid)
+{
+  auto &assets = MeshAssets::Instance();
+  EXPECT_EQ(nullptr, assets.Load(""));
+  EXPECT_EQ(nullptr, assets.Load("missing_mesh.dae"));
+
+  // Disabling the cache
+  assets.SetCachePath("");
+  EXPECT_TRUE(assets.CachePath().empty());
+}
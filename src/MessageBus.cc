@@ -0,0 +1,537 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/gazebo/MessageBus.hh"
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/transport/NodeShared.hh>
+#include <ignition/transport/TopicUtils.hh>
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Type-erased subscriber callback
+using MessageCallback = std::function<void(const google::protobuf::Message &)>;
+
+/// \brief A topic of the bus
+class ignition::gazebo::MessageBusTopic
+{
+  /// \brief Validated topic name
+  public: std::string name;
+
+  /// \brief Name of the message type
+  public: std::string msgType;
+
+  /// \brief Subscriber callbacks. The vector is replaced, never modified, so
+  /// the dispatch can keep using a snapshot while someone subscribes.
+  public: std::shared_ptr<const std::vector<MessageCallback>> callbacks{
+      std::make_shared<const std::vector<MessageCallback>>()};
+
+  /// \brief Publisher used to forward bus messages to ign-transport. Set
+  /// before the first bus publisher of the topic is handed out, and never
+  /// changed afterwards.
+  public: transport::Node::Publisher transportPub;
+
+  /// \brief Whether the bus is subscribed to the topic on ign-transport.
+  /// Read when publishing, without locks.
+  public: std::atomic<bool> transportSub{false};
+
+  /// \brief Whether anyone but the bus subscribes to the topic on
+  /// ign-transport. Refreshed on dispatch and read when publishing, without
+  /// locks.
+  public: std::atomic<bool> transportSubscribers{false};
+};
+
+namespace
+{
+/// \brief Intrusive lock-free multi-producer single-consumer queue, after
+/// Dmitry Vyukov's design. Any thread can push; only the dispatching thread
+/// pops.
+class MessageQueue
+{
+  /// \brief Queue element
+  public: class Node
+  {
+    /// \brief Next element
+    public: std::atomic<Node *> next{nullptr};
+
+    /// \brief Topic the message was published on
+    public: MessageBusTopic *topic{nullptr};
+
+    /// \brief Message
+    public: std::shared_ptr<const google::protobuf::Message> msg;
+  };
+
+  /// \brief Constructor
+  public: MessageQueue()
+    : head(&this->stub), tail(&this->stub)
+  {
+  }
+
+  /// \brief Destructor, deletes the elements that weren't popped
+  public: ~MessageQueue()
+  {
+    while (auto node = this->Pop())
+      delete node;
+  }
+
+  /// \brief Push an element. Wait-free, can be called from any thread.
+  /// \param[in] _node Element, ownership is transferred to the queue until
+  /// it's popped.
+  public: void Push(Node *_node)
+  {
+    _node->next.store(nullptr, std::memory_order_relaxed);
+    Node *prev = this->head.exchange(_node, std::memory_order_acq_rel);
+    prev->next.store(_node, std::memory_order_release);
+  }
+
+  /// \brief Pop the oldest element. Must only be called from one thread at a
+  /// time.
+  /// \return The element, or nullptr if the queue is empty. Also nullptr if
+  /// the oldest element is still being pushed; it will be returned by a later
+  /// call.
+  public: Node *Pop()
+  {
+    Node *first = this->tail;
+    Node *next = first->next.load(std::memory_order_acquire);
+    if (first == &this->stub)
+    {
+      if (nullptr == next)
+        return nullptr;
+      this->tail = next;
+      first = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (nullptr != next)
+    {
+      this->tail = next;
+      return first;
+    }
+
+    // A producer is between the exchange and the link of the next element
+    if (first != this->head.load(std::memory_order_acquire))
+      return nullptr;
+
+    // Re-insert the stub so the last element can be unlinked
+    this->Push(&this->stub);
+    next = first->next.load(std::memory_order_acquire);
+    if (nullptr != next)
+    {
+      this->tail = next;
+      return first;
+    }
+    return nullptr;
+  }
+
+  /// \brief Most recently pushed element
+  private: std::atomic<Node *> head;
+
+  /// \brief Oldest element, only accessed by the consumer
+  private: Node *tail;
+
+  /// \brief Placeholder element that keeps the queue non-empty
+  private: Node stub;
+};
+}
+
+/// \brief Private data for MessageBus
+class ignition::gazebo::MessageBusPrivate
+{
+  /// \brief Queue a message for delivery
+  /// \param[in] _topic Topic
+  /// \param[in] _msg Message
+  /// \param[in] _bridge Whether to forward the message to ign-transport
+  /// \return True if queued
+  public: bool Enqueue(MessageBusTopic *_topic,
+      const std::shared_ptr<const google::protobuf::Message> &_msg,
+      bool _bridge);
+
+  /// \brief Update whether anyone but the bus subscribes to a topic on
+  /// ign-transport. transport::Node::Publisher::HasConnections can't tell,
+  /// since it counts the subscription of the bus itself. The caller must
+  /// hold the NodeShared mutex.
+  /// \param[in] _shared Transport state of the process
+  /// \param[in] _topic Topic
+  public: void RefreshTransportSubscribers(transport::NodeShared &_shared,
+      MessageBusTopic &_topic);
+
+  /// \brief Update whether anyone but the bus subscribes to each topic
+  /// advertised on ign-transport. Must be called with topicsMutex locked.
+  public: void RefreshTransportSubscribers();
+
+  /// \brief Get a topic, creating it if needed. Must be called with
+  /// topicsMutex locked.
+  /// \param[in] _topic Topic name, as given by the user
+  /// \param[in] _msgType Message type name
+  /// \param[in] _action Verb used in error messages
+  /// \return The topic, or nullptr if the name is invalid or the topic has
+  /// another type
+  public: MessageBusTopic *Topic(const std::string &_topic,
+      const std::string &_msgType, const std::string &_action);
+
+  /// \brief Node used to bridge topics to ign-transport. Reset when the bus
+  /// is destroyed, so transport callbacks don't outlive it.
+  public: std::unique_ptr<transport::Node> node{
+      std::make_unique<transport::Node>()};
+
+  /// \brief All topics, by name. Elements of an unordered map aren't moved
+  /// on insertion, so publishers and queued messages can point to them.
+  public: std::unordered_map<std::string, MessageBusTopic> topics;
+
+  /// \brief Topics advertised on ign-transport, whose subscribers are
+  /// refreshed on dispatch.
+  public: std::vector<MessageBusTopic *> bridgedTopics;
+
+  /// \brief Protects topics and bridgedTopics. Not taken when publishing.
+  public: std::mutex topicsMutex;
+
+  /// \brief Messages waiting to be dispatched, in publication order
+  public: MessageQueue queue;
+
+  /// \brief Messages being dispatched. Only used by the dispatching thread.
+  public: std::vector<MessageQueue::Node *> dispatchNodes;
+
+  /// \brief Set to false when the bus is destroyed
+  public: std::atomic<bool> alive{true};
+};
+
+namespace
+{
+/// \brief Bus whose message the current thread forwards to ign-transport.
+/// ign-transport delivers to subscribers of the same process synchronously,
+/// so the copy received back by that bus can be identified, while other
+/// buses of the process still receive it.
+thread_local const MessageBusPrivate *tlsBridgingBus{nullptr};
+
+/// \brief Buses of each event manager
+std::map<const EventManager *, std::weak_ptr<MessageBus>> gBuses;
+
+/// \brief Protects gBuses
+std::mutex gBusesMutex;
+}
+
+//////////////////////////////////////////////////
+bool MessageBus::Publisher::Publish(const google::protobuf::Message &_msg)
+{
+  if (!this->bus)
+    return false;
+
+  std::shared_ptr<google::protobuf::Message> copy(_msg.New());
+  copy->CopyFrom(_msg);
+  return this->Publish(
+      std::shared_ptr<const google::protobuf::Message>(std::move(copy)));
+}
+
+//////////////////////////////////////////////////
+bool MessageBus::Publisher::Publish(
+    const std::shared_ptr<const google::protobuf::Message> &_msg)
+{
+  if (!this->bus || !_msg)
+    return false;
+
+  return this->bus->Enqueue(this->topic, _msg, true);
+}
+
+//////////////////////////////////////////////////
+bool MessageBus::Publisher::Valid() const
+{
+  return this->bus != nullptr;
+}
+
+//////////////////////////////////////////////////
+bool MessageBus::Publisher::HasConnections() const
+{
+  if (!this->bus)
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(this->bus->topicsMutex);
+    if (!this->topic->callbacks->empty())
+      return true;
+  }
+  return this->topic->transportSubscribers;
+}
+
+//////////////////////////////////////////////////
+bool MessageBus::Publisher::HasTransportConnections() const
+{
+  if (!this->bus)
+    return false;
+
+  return this->topic->transportSubscribers;
+}
+
+//////////////////////////////////////////////////
+MessageBus::Publisher::operator bool() const
+{
+  return this->Valid();
+}
+
+//////////////////////////////////////////////////
+MessageBus::MessageBus()
+  : dataPtr(std::make_shared<MessageBusPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+MessageBus::~MessageBus()
+{
+  // Publishers may outlive the bus, but the transport subscriptions point to
+  // it, so they must go now.
+  this->dataPtr->alive = false;
+  this->dataPtr->node.reset();
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<MessageBus> MessageBus::Instance(const EventManager &_eventMgr)
+{
+  std::lock_guard<std::mutex> lock(gBusesMutex);
+
+  // Drop buses of worlds that are gone
+  for (auto it = gBuses.begin(); it != gBuses.end();)
+  {
+    if (it->second.expired())
+      it = gBuses.erase(it);
+    else
+      ++it;
+  }
+
+  auto &weak = gBuses[&_eventMgr];
+  auto bus = weak.lock();
+  if (!bus)
+  {
+    bus = std::make_shared<MessageBus>();
+    weak = bus;
+  }
+  return bus;
+}
+
+//////////////////////////////////////////////////
+void MessageBus::Dispatch()
+{
+  IGN_PROFILE("MessageBus::Dispatch");
+
+  // Look up transport subscribers once per dispatch, instead of on every
+  // publication
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->topicsMutex);
+    this->dataPtr->RefreshTransportSubscribers();
+  }
+
+  // Take everything that has been published so far. Messages published by
+  // the callbacks below are left for the next dispatch.
+  auto &nodes = this->dataPtr->dispatchNodes;
+  while (auto node = this->dataPtr->queue.Pop())
+    nodes.push_back(node);
+
+  if (nodes.empty())
+    return;
+
+  for (auto node : nodes)
+  {
+    std::shared_ptr<const std::vector<MessageCallback>> callbacks;
+    {
+      std::lock_guard<std::mutex> lock(this->dataPtr->topicsMutex);
+      callbacks = node->topic->callbacks;
+    }
+
+    for (const auto &cb : *callbacks)
+      cb(*node->msg);
+
+    delete node;
+  }
+  nodes.clear();
+}
+
+//////////////////////////////////////////////////
+MessageBus::Publisher MessageBus::AdvertiseImpl(const std::string &_topic,
+    const std::string &_msgType,
+    const std::function<transport::Node::Publisher(const std::string &)>
+        &_advertise)
+{
+  Publisher pub;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->topicsMutex);
+  auto topicData = this->dataPtr->Topic(_topic, _msgType, "advertise");
+  if (nullptr == topicData)
+    return pub;
+
+  if (!topicData->transportPub)
+  {
+    topicData->transportPub = _advertise(topicData->name);
+    if (topicData->transportPub)
+    {
+      this->dataPtr->bridgedTopics.push_back(topicData);
+      auto shared = transport::NodeShared::Instance();
+      std::lock_guard<std::recursive_mutex> sharedLock(shared->mutex);
+      this->dataPtr->RefreshTransportSubscribers(*shared, *topicData);
+    }
+  }
+
+  pub.bus = this->dataPtr;
+  pub.topic = topicData;
+  return pub;
+}
+
+//////////////////////////////////////////////////
+bool MessageBus::SubscribeImpl(const std::string &_topic,
+    const std::string &_msgType,
+    const std::function<void(const google::protobuf::Message &)> &_callback,
+    const std::function<bool(const std::string &, const EnqueueFn &)>
+        &_subscribe)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->topicsMutex);
+  auto topicData = this->dataPtr->Topic(_topic, _msgType, "subscribe to");
+  if (nullptr == topicData)
+    return false;
+
+  if (!topicData->transportSub)
+  {
+    // The transport node is destroyed before the private data, so the raw
+    // pointers stay valid for as long as the callback can be called.
+    auto priv = this->dataPtr.get();
+    EnqueueFn enqueue =
+        [priv, topicData](
+            const std::shared_ptr<const google::protobuf::Message> &_msg)
+        {
+          if (tlsBridgingBus != priv)
+            priv->Enqueue(topicData, _msg, false);
+        };
+    topicData->transportSub = _subscribe(topicData->name, enqueue);
+    if (!topicData->transportSub)
+    {
+      ignwarn << "Failed to subscribe to topic [" << topicData->name
+              << "] on ign-transport. Only messages published on the message "
+              << "bus will be received." << std::endl;
+    }
+    else if (topicData->transportPub)
+    {
+      // The new subscription of the bus itself must not count
+      auto shared = transport::NodeShared::Instance();
+      std::lock_guard<std::recursive_mutex> sharedLock(shared->mutex);
+      this->dataPtr->RefreshTransportSubscribers(*shared, *topicData);
+    }
+  }
+
+  auto callbacks =
+      std::make_shared<std::vector<MessageCallback>>(*topicData->callbacks);
+  callbacks->push_back(_callback);
+  topicData->callbacks = std::move(callbacks);
+  return true;
+}
+
+//////////////////////////////////////////////////
+transport::Node &MessageBus::Node()
+{
+  return *this->dataPtr->node;
+}
+
+//////////////////////////////////////////////////
+MessageBusTopic *MessageBusPrivate::Topic(const std::string &_topic,
+    const std::string &_msgType, const std::string &_action)
+{
+  auto validTopic = transport::TopicUtils::AsValidTopic(_topic);
+  if (validTopic.empty())
+  {
+    ignerr << "Failed to " << _action << " invalid topic [" << _topic
+           << "] on the message bus." << std::endl;
+    return nullptr;
+  }
+
+  auto &topicData = this->topics[validTopic];
+  if (topicData.msgType.empty())
+  {
+    topicData.name = validTopic;
+    topicData.msgType = _msgType;
+  }
+  else if (topicData.msgType != _msgType)
+  {
+    ignerr << "Failed to " << _action << " topic [" << validTopic
+           << "] with type [" << _msgType
+           << "] on the message bus, it already has type ["
+           << topicData.msgType << "]." << std::endl;
+    return nullptr;
+  }
+  return &topicData;
+}
+
+//////////////////////////////////////////////////
+bool MessageBusPrivate::Enqueue(MessageBusTopic *_topic,
+    const std::shared_ptr<const google::protobuf::Message> &_msg,
+    bool _bridge)
+{
+  if (!this->alive)
+    return false;
+
+  auto node = new MessageQueue::Node;
+  node->topic = _topic;
+  node->msg = _msg;
+  this->queue.Push(node);
+
+  // Forward to ign-transport only if someone listens there
+  if (_bridge && _topic->transportSubscribers)
+  {
+    auto prevBus = tlsBridgingBus;
+    tlsBridgingBus = this;
+    _topic->transportPub.Publish(*_msg);
+    tlsBridgingBus = prevBus;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void MessageBusPrivate::RefreshTransportSubscribers(
+    transport::NodeShared &_shared, MessageBusTopic &_topic)
+{
+  auto info = _shared.CheckSubscriberInfo(_topic.name, _topic.msgType);
+  if (info.haveRemote)
+  {
+    _topic.transportSubscribers = true;
+    return;
+  }
+
+  // The bus has one handler per topic it's subscribed to
+  std::size_t handlers{0};
+  for (const auto &node : info.localHandlers)
+    handlers += node.second.size();
+  for (const auto &node : info.rawHandlers)
+    handlers += node.second.size();
+  _topic.transportSubscribers = handlers > (_topic.transportSub ? 1u : 0u);
+}
+
+//////////////////////////////////////////////////
+void MessageBusPrivate::RefreshTransportSubscribers()
+{
+  if (this->bridgedTopics.empty())
+    return;
+
+  // A single lock for all topics
+  auto shared = transport::NodeShared::Instance();
+  std::lock_guard<std::recursive_mutex> lock(shared->mutex);
+  for (auto topic : this->bridgedTopics)
+    this->RefreshTransportSubscribers(*shared, *topic);
+}
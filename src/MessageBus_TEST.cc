@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <ignition/msgs/double.pb.h>
+#include <ignition/msgs/int32.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gazebo/EventManager.hh"
+#include "ignition/gazebo/MessageBus.hh"
+
+#include "../test/helpers/EnvTestFixture.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Test MessageBus
+class MessageBusTest : public InternalFixture<::testing::Test>
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(MessageBusTest, Instance)
+{
+  EventManager eventMgr1;
+  EventManager eventMgr2;
+
+  auto bus1 = MessageBus::Instance(eventMgr1);
+  auto bus2 = MessageBus::Instance(eventMgr2);
+  ASSERT_NE(nullptr, bus1);
+  ASSERT_NE(nullptr, bus2);
+  EXPECT_NE(bus1, bus2);
+
+  // Same event manager, same bus
+  EXPECT_EQ(bus1, MessageBus::Instance(eventMgr1));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MessageBusTest, DispatchInOrder)
+{
+  MessageBus bus;
+
+  std::vector<double> received;
+  std::function<void(const msgs::Double &)> cb =
+      [&received](const msgs::Double &_msg)
+      {
+        received.push_back(_msg.data());
+      };
+  EXPECT_TRUE(bus.Subscribe("/bus_test/dispatch", cb));
+
+  auto pub = bus.Advertise<msgs::Double>("/bus_test/dispatch");
+  ASSERT_TRUE(pub.Valid());
+  EXPECT_TRUE(pub.HasConnections());
+
+  msgs::Double msg;
+  for (int i = 0; i < 3; ++i)
+  {
+    msg.set_data(i);
+    EXPECT_TRUE(pub.Publish(msg));
+  }
+
+  // Nothing is delivered until dispatch
+  EXPECT_TRUE(received.empty());
+
+  bus.Dispatch();
+  ASSERT_EQ(3u, received.size());
+  EXPECT_DOUBLE_EQ(0.0, received[0]);
+  EXPECT_DOUBLE_EQ(1.0, received[1]);
+  EXPECT_DOUBLE_EQ(2.0, received[2]);
+
+  // Messages are delivered once
+  bus.Dispatch();
+  EXPECT_EQ(3u, received.size());
+}
+
+/////////////////////////////////////////////////
+TEST_F(MessageBusTest, SharedMessage)
+{
+  MessageBus bus;
+
+  std::vector<const msgs::Double *> received;
+  std::function<void(const msgs::Double &)> cb =
+      [&received](const msgs::Double &_msg)
+      {
+        received.push_back(&_msg);
+      };
+  EXPECT_TRUE(bus.Subscribe("/bus_test/shared", cb));
+  EXPECT_TRUE(bus.Subscribe("/bus_test/shared", cb));
+
+  auto pub = bus.Advertise<msgs::Double>("/bus_test/shared");
+  auto msg = std::make_shared<msgs::Double>();
+  msg->set_data(1.0);
+  EXPECT_TRUE(pub.Publish(msg));
+
+  bus.Dispatch();
+
+  // Both subscribers got the published object itself
+  ASSERT_EQ(2u, received.size());
+  EXPECT_EQ(msg.get(), received[0]);
+  EXPECT_EQ(msg.get(), received[1]);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MessageBusTest, TypeMismatch)
+{
+  MessageBus bus;
+
+  auto pub = bus.Advertise<msgs::Double>("/bus_test/type");
+  EXPECT_TRUE(pub.Valid());
+
+  std::function<void(const msgs::Int32 &)> cb = [](const msgs::Int32 &){};
+  EXPECT_FALSE(bus.Subscribe("/bus_test/type", cb));
+  EXPECT_FALSE(bus.Advertise<msgs::Int32>("/bus_test/type").Valid());
+
+  EXPECT_FALSE(bus.Advertise<msgs::Double>("").Valid());
+
+  MessageBus::Publisher invalid;
+  EXPECT_FALSE(invalid.Valid());
+  EXPECT_FALSE(invalid.Publish(msgs::Double()));
+}
+
+/////////////////////////////////////////////////
+TEST_F(MessageBusTest, TransportBridge)
+{
+  MessageBus bus;
+
+  int busCount{0};
+  std::function<void(const msgs::Double &)> busCb =
+      [&busCount](const msgs::Double &)
+      {
+        ++busCount;
+      };
+  EXPECT_TRUE(bus.Subscribe("/bus_test/bridge", busCb));
+  auto busPub = bus.Advertise<msgs::Double>("/bus_test/bridge");
+
+  std::atomic<int> transportCount{0};
+  std::function<void(const msgs::Double &)> transportCb =
+      [&transportCount](const msgs::Double &)
+      {
+        ++transportCount;
+      };
+  transport::Node node;
+  EXPECT_TRUE(node.Subscribe("/bus_test/bridge", transportCb));
+  auto transportPub = node.Advertise<msgs::Double>("/bus_test/bridge");
+
+  // The transport subscriber is seen on dispatch
+  bus.Dispatch();
+
+  // Bus messages reach transport subscribers, and are not received back by
+  // the bus
+  EXPECT_TRUE(busPub.Publish(msgs::Double()));
+  bus.Dispatch();
+  EXPECT_EQ(1, busCount);
+
+  int sleep{0};
+  int maxSleep{30};
+  for (; transportCount < 1 && sleep < maxSleep; ++sleep)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(1, transportCount);
+
+  // Transport messages reach bus subscribers on dispatch
+  EXPECT_TRUE(transportPub.Publish(msgs::Double()));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(1, busCount);
+  bus.Dispatch();
+  EXPECT_EQ(2, busCount);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MessageBusTest, BridgeOnlyToOutsideSubscribers)
+{
+  MessageBus bus;
+
+  int busCount{0};
+  std::function<void(const msgs::Double &)> busCb =
+      [&busCount](const msgs::Double &)
+      {
+        ++busCount;
+      };
+  EXPECT_TRUE(bus.Subscribe("/bus_test/outside", busCb));
+  auto busPub = bus.Advertise<msgs::Double>("/bus_test/outside");
+
+  // The transport subscription of the bus itself doesn't count, so bus
+  // messages aren't sent over transport
+  EXPECT_TRUE(busPub.HasConnections());
+  EXPECT_FALSE(busPub.HasTransportConnections());
+  EXPECT_TRUE(busPub.Publish(msgs::Double()));
+  bus.Dispatch();
+  EXPECT_EQ(1, busCount);
+
+  // Messages published before an outside subscriber shows up aren't sent to
+  // it
+  std::atomic<int> transportCount{0};
+  std::function<void(const msgs::Double &)> transportCb =
+      [&transportCount](const msgs::Double &)
+      {
+        ++transportCount;
+      };
+  {
+    transport::Node node;
+    EXPECT_TRUE(node.Subscribe("/bus_test/outside", transportCb));
+    EXPECT_FALSE(busPub.HasTransportConnections());
+    bus.Dispatch();
+    EXPECT_TRUE(busPub.HasTransportConnections());
+    EXPECT_EQ(0, transportCount);
+
+    EXPECT_TRUE(busPub.Publish(msgs::Double()));
+    bus.Dispatch();
+    EXPECT_EQ(2, busCount);
+
+    int sleep{0};
+    int maxSleep{30};
+    for (; transportCount < 1 && sleep < maxSleep; ++sleep)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(1, transportCount);
+  }
+
+  // The outside subscriber is gone
+  bus.Dispatch();
+  EXPECT_FALSE(busPub.HasTransportConnections());
+  EXPECT_TRUE(busPub.Publish(msgs::Double()));
+  bus.Dispatch();
+  EXPECT_EQ(3, busCount);
+  EXPECT_EQ(1, transportCount);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MessageBusTest, TwoBuses)
+{
+  MessageBus bus1;
+  MessageBus bus2;
+
+  int count1{0};
+  std::function<void(const msgs::Double &)> cb1 =
+      [&count1](const msgs::Double &)
+      {
+        ++count1;
+      };
+  int count2{0};
+  std::function<void(const msgs::Double &)> cb2 =
+      [&count2](const msgs::Double &)
+      {
+        ++count2;
+      };
+  EXPECT_TRUE(bus1.Subscribe("/bus_test/two_buses", cb1));
+  EXPECT_TRUE(bus2.Subscribe("/bus_test/two_buses", cb2));
+  auto pub1 = bus1.Advertise<msgs::Double>("/bus_test/two_buses");
+  auto pub2 = bus2.Advertise<msgs::Double>("/bus_test/two_buses");
+
+  // Each bus is the other's subscriber on transport
+  EXPECT_TRUE(pub1.HasTransportConnections());
+  EXPECT_TRUE(pub2.HasTransportConnections());
+
+  // Each bus receives its own message once, and the other bus' message over
+  // transport, on the same thread
+  EXPECT_TRUE(pub1.Publish(msgs::Double()));
+  bus1.Dispatch();
+  bus2.Dispatch();
+  EXPECT_EQ(1, count1);
+  EXPECT_EQ(1, count2);
+
+  EXPECT_TRUE(pub2.Publish(msgs::Double()));
+  bus1.Dispatch();
+  bus2.Dispatch();
+  EXPECT_EQ(2, count1);
+  EXPECT_EQ(2, count2);
+}
+
+/////////////////////////////////////////////////
+TEST_F(MessageBusTest, ConcurrentPublishers)
+{
+  MessageBus bus;
+
+  std::vector<int> received;
+  std::function<void(const msgs::Int32 &)> cb =
+      [&received](const msgs::Int32 &_msg)
+      {
+        received.push_back(_msg.data());
+      };
+  EXPECT_TRUE(bus.Subscribe("/bus_test/concurrent", cb));
+
+  const int threadCount{4};
+  const int msgCount{1000};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threadCount; ++t)
+  {
+    threads.emplace_back([&bus, t, msgCount]()
+    {
+      auto pub = bus.Advertise<msgs::Int32>("/bus_test/concurrent");
+      msgs::Int32 msg;
+      for (int i = 0; i < msgCount; ++i)
+      {
+        msg.set_data(t * msgCount + i);
+        EXPECT_TRUE(pub.Publish(msg));
+      }
+    });
+  }
+
+  // Dispatch while publishing
+  bus.Dispatch();
+
+  for (auto &thread : threads)
+    thread.join();
+  bus.Dispatch();
+
+  // Every message is delivered once, and messages of each publisher keep
+  // their order
+  ASSERT_EQ(static_cast<size_t>(threadCount * msgCount), received.size());
+  std::vector<int> last(threadCount, -1);
+  for (auto value : received)
+  {
+    int t = value / msgCount;
+    EXPECT_LT(last[t], value);
+    last[t] = value;
+  }
+}
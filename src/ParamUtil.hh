@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_GAZEBO_PARAMUTIL_HH_
+#define IGNITION_GAZEBO_PARAMUTIL_HH_
+
+#include <ignition/msgs/param.pb.h>
+
+#include <string>
+
+#include <ignition/gazebo/config.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    /// \brief Set a parameter of a message, replacing any parameter with the
+    /// same name.
+    /// \param[in, out] _msg Message.
+    /// \param[in] _key Parameter name.
+    /// \param[in] _value Parameter value, stored as a string.
+    inline void setParam(msgs::Param &_msg, const std::string &_key,
+        const std::string &_value)
+    {
+      auto &param = (*_msg.mutable_params())[_key];
+      param.set_type(msgs::Any::STRING);
+      param.set_string_value(_value);
+    }
+
+    /// \brief Set a string parameter of a message. Keeps string literals
+    /// from being converted to bool.
+    /// \param[in, out] _msg Message.
+    /// \param[in] _key Parameter name.
+    /// \param[in] _value Parameter value, stored as a string.
+    inline void setParam(msgs::Param &_msg, const std::string &_key,
+        const char *_value)
+    {
+      setParam(_msg, _key, std::string(_value));
+    }
+
+    /// \brief Set a double parameter of a message.
+    /// \param[in, out] _msg Message.
+    /// \param[in] _key Parameter name.
+    /// \param[in] _value Parameter value.
+    inline void setParam(msgs::Param &_msg, const std::string &_key,
+        double _value)
+    {
+      auto &param = (*_msg.mutable_params())[_key];
+      param.set_type(msgs::Any::DOUBLE);
+      param.set_double_value(_value);
+    }
+
+    /// \brief Set an integer parameter of a message.
+    /// \param[in, out] _msg Message.
+    /// \param[in] _key Parameter name.
+    /// \param[in] _value Parameter value.
+    inline void setParam(msgs::Param &_msg, const std::string &_key,
+        int _value)
+    {
+      auto &param = (*_msg.mutable_params())[_key];
+      param.set_type(msgs::Any::INT32);
+      param.set_int_value(_value);
+    }
+
+    /// \brief Set a boolean parameter of a message.
+    /// \param[in, out] _msg Message.
+    /// \param[in] _key Parameter name.
+    /// \param[in] _value Parameter value.
+    inline void setParam(msgs::Param &_msg, const std::string &_key,
+        bool _value)
+    {
+      auto &param = (*_msg.mutable_params())[_key];
+      param.set_type(msgs::Any::BOOLEAN);
+      param.set_boolean_value(_value);
+    }
+    }  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
+  }  // namespace gazebo
+}  // namespace ignition
+
+#endif  // IGNITION_GAZEBO_PARAMUTIL_HH_
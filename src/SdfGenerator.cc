@@ -18,12 +18,18 @@
 #include "SdfGenerator.hh"
 
 #include <ctype.h>
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <string>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include <sdf/sdf.hh>
 
 #include <ignition/common/URI.hh>
+#include <ignition/common/WorkerPool.hh>
 
 #include "ignition/gazebo/Util.hh"
 #include "ignition/gazebo/components/AirPressureSensor.hh"
@@ -269,17 +275,252 @@ namespace sdf_generator
     }
   }
 
+  /////////////////////////////////////////////////
+  /// \brief Find a child entity by name. Unlike
+  /// EntityComponentManager::EntityByComponents, this only reads the entity
+  /// graph and doesn't create views, so it can be called from multiple
+  /// threads.
+  /// \param[in] _ecm Immutable reference to the Entity Component Manager
+  /// \param[in] _parent Parent entity
+  /// \param[in] _name Name of the child
+  /// \returns Child entity, or kNullEntity if there's no child with that name
+  static Entity childByName(const EntityComponentManager &_ecm,
+                            const Entity _parent, const std::string &_name)
+  {
+    for (const auto &vertex : _ecm.Entities().AdjacentsFrom(_parent))
+    {
+      auto *nameComp = _ecm.Component<components::Name>(vertex.first);
+      if (nullptr != nameComp && nameComp->Data() == _name)
+        return vertex.first;
+    }
+    return kNullEntity;
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Types of the components the generator reads from the ECM on the
+  /// entities of a top level model's subtree. The DOM components (ModelSdf,
+  /// ContactSensor, LogicalCamera) aren't included, as they're not updated
+  /// during simulation.
+  /// \returns The component types
+  static const std::vector<ComponentTypeId> &exportedComponentTypes()
+  {
+    static const std::vector<ComponentTypeId> types{
+      components::Name::typeId,
+      components::Pose::typeId,
+      components::Static::typeId,
+      components::SelfCollide::typeId,
+      components::SourceFilePath::typeId,
+      components::Inertial::typeId,
+      components::WindMode::typeId,
+      components::Light::typeId,
+      components::Camera::typeId,
+      components::DepthCamera::typeId,
+      components::ThermalCamera::typeId,
+      components::SegmentationCamera::typeId,
+      components::GpuLidar::typeId,
+      components::Altimeter::typeId,
+      components::AirPressureSensor::typeId,
+      components::ForceTorque::typeId,
+      components::Imu::typeId,
+      components::Magnetometer::typeId,
+      components::JointType::typeId,
+      components::ParentLinkName::typeId,
+      components::ChildLinkName::typeId,
+      components::ThreadPitch::typeId,
+      components::JointAxis::typeId,
+      components::JointAxis2::typeId,
+    };
+    return types;
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Workers shared by all exports, so threads aren't started for
+  /// every export. Created by the first export with more than one model to
+  /// generate.
+  /// \returns The worker pool
+  static common::WorkerPool &exportWorkers()
+  {
+    static common::WorkerPool pool;
+    return pool;
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Create a child element from its description in the parent, the
+  /// same way sdf::Element::AddElement does, but without adding it to the
+  /// parent. This lets child elements be created concurrently.
+  /// \param[in] _parent Parent element
+  /// \param[in] _name Name of the child element
+  /// \returns The new element, or nullptr if the parent has no description
+  /// for it
+  static sdf::ElementPtr newChildElement(const sdf::ElementPtr &_parent,
+                                         const std::string &_name)
+  {
+    auto desc = _parent->GetElementDescription(_name);
+    if (nullptr == desc)
+      return nullptr;
+
+    auto elem = desc->Clone();
+    elem->SetParent(_parent);
+    for (std::size_t i = 0; i < elem->GetElementDescriptionCount(); ++i)
+    {
+      auto childDesc = elem->GetElementDescription(i);
+      if (childDesc->GetRequired() == "1")
+        elem->AddElement(childDesc->GetName());
+    }
+    return elem;
+  }
+
+  /////////////////////////////////////////////////
+  /// \brief Generate the element of a top level model, which is either an
+  /// expanded <model> or an <include>. The element is not added to the world
+  /// element, so models can be generated concurrently.
+  /// \param[in] _worldElem World element
+  /// \param[in] _ecm Immutable reference to the Entity Component Manager
+  /// \param[in] _modelEntity Model entity
+  /// \param[in] _modelDir Directory containing the model
+  /// \param[in] _modelFromInclude True if the model was included into the
+  /// world
+  /// \param[in] _includeUriMap Map from file paths to URIs used to preserve
+  /// included Fuel models
+  /// \param[in] _modelConfig Configuration of the generator for this model
+  /// \returns The model element
+  static sdf::ElementPtr generateModelElement(
+      const sdf::ElementPtr &_worldElem, const EntityComponentManager &_ecm,
+      const Entity _modelEntity, const std::string &_modelDir,
+      const bool _modelFromInclude, const IncludeUriMap &_includeUriMap,
+      const msgs::SdfGeneratorConfig::EntityGeneratorConfig &_modelConfig)
+  {
+    auto uriMapIt = _includeUriMap.find(_modelDir);
+
+    if (_modelConfig.expand_include_tags().data() || !_modelFromInclude)
+    {
+      auto modelElem = newChildElement(_worldElem, "model");
+      updateModelElement(modelElem, _ecm, _modelEntity);
+
+      // Check & update possible //model/include(s)
+      if (!_modelConfig.expand_include_tags().data())
+      {
+        updateModelElementWithNestedInclude(modelElem,
+              _modelConfig.save_fuel_version().data(), _includeUriMap);
+      }
+      return modelElem;
+    }
+    else if (uriMapIt != _includeUriMap.end())
+    {
+      // The fuel URI might have a version number. If it does, we remove
+      // it unless saveFuelModelVersion is set to true.
+      // Check if this is a fuel URI. We assume that it is a fuel URI if
+      // the scheme is http or https.
+      common::URI uri(uriMapIt->second);
+      if (uri.Scheme() == "http" || uri.Scheme() == "https")
+      {
+        removeVersionFromUri(uri);
+      }
+
+      if (_modelConfig.save_fuel_version().data())
+      {
+        // Find out the model version from the file path. Note that we
+        // do this from the file path instead of the Fuel URI because the
+        // URI may not contain version information.
+        //
+        // We are assuming here that, for Fuel models, the directory
+        // containing the sdf file has the same name as the model version.
+        // For example, if the uri is
+        // https://example.org/1.0/test/models/Backpack
+        // the path to the directory containing the sdf file (modelDir)
+        // will be:
+        // $HOME/.ignition/fuel/example.org/test/models/Backpack/2/
+        // and the basename of the directory is "1", which is the model
+        // version.
+        //
+        // However, if symlinks (or other types of indirection) are used,
+        // the pattern of modelDir will be different. The assumption here
+        // is that regardless of the indirection, the name of the
+        // directory containing the sdf file can be used as the version
+        // number
+        //
+        uri.Path() /= common::basename(_modelDir);
+      }
+
+      auto includeElem = newChildElement(_worldElem, "include");
+      updateIncludeElement(includeElem, _ecm, _modelEntity, uri.Str());
+      return includeElem;
+    }
+
+    // The model is not in the includeUriMap, but expandIncludeTags =
+    // false, so we will assume that its uri is the file path of the
+    // model on the local machine
+    auto includeElem = newChildElement(_worldElem, "include");
+    const std::string uri = "file://" + _modelDir;
+    updateIncludeElement(includeElem, _ecm, _modelEntity, uri);
+    return includeElem;
+  }
+
+  /////////////////////////////////////////////////
+  void invalidateExportCache(ExportCache &_cache,
+      const EntityComponentManager &_ecm)
+  {
+    // Remove the entry of the top level model an entity belongs to
+    auto invalidate = [&](Entity _entity)
+    {
+      for (Entity entity = _entity; kNullEntity != entity;
+           entity = _ecm.ParentEntity(entity))
+      {
+        if (_cache.erase(entity) > 0)
+          return;
+      }
+    };
+
+    if (_ecm.HasOneTimeComponentChanges() ||
+        _ecm.HasPeriodicComponentChanges() || _ecm.HasRemovedComponents())
+    {
+      for (const auto typeId : exportedComponentTypes())
+      {
+        if (_cache.empty())
+          return;
+        for (const auto entity : _ecm.EntitiesWithComponentChanges(typeId))
+          invalidate(entity);
+        for (const auto entity : _ecm.EntitiesWithRemovedComponent(typeId))
+          invalidate(entity);
+      }
+    }
+
+    if (!_cache.empty() && _ecm.HasNewEntities())
+    {
+      _ecm.EachNew<components::ParentEntity>(
+          [&](const Entity &_entity, const components::ParentEntity *)
+          {
+            invalidate(_entity);
+            return !_cache.empty();
+          });
+    }
+
+    if (!_cache.empty() && _ecm.HasEntitiesMarkedForRemoval())
+    {
+      _ecm.EachRemoved<components::ParentEntity>(
+          [&](const Entity &_entity, const components::ParentEntity *)
+          {
+            invalidate(_entity);
+            return !_cache.empty();
+          });
+    }
+  }
+
   /////////////////////////////////////////////////
   std::optional<std::string> generateWorld(
       const EntityComponentManager &_ecm, const Entity &_entity,
       const IncludeUriMap &_includeUriMap,
-      const msgs::SdfGeneratorConfig &_config)
+      const msgs::SdfGeneratorConfig &_config,
+      ExportCache *_cache)
   {
     sdf::ElementPtr elem = std::make_shared<sdf::Element>();
     sdf::initFile("root.sdf", elem);
     auto worldElem = elem->AddElement("world");
-    if (!updateWorldElement(worldElem, _ecm, _entity, _includeUriMap, _config))
+    if (!updateWorldElement(worldElem, _ecm, _entity, _includeUriMap, _config,
+          _cache))
+    {
       return std::nullopt;
+    }
 
     return elem->ToString("");
   }
@@ -289,7 +530,8 @@ namespace sdf_generator
                           const EntityComponentManager &_ecm,
                           const Entity &_entity,
                           const IncludeUriMap &_includeUriMap,
-                          const msgs::SdfGeneratorConfig &_config)
+                          const msgs::SdfGeneratorConfig &_config,
+                          ExportCache *_cache)
   {
     const auto *worldSdf = _ecm.Component<components::WorldSdf>(_entity);
 
@@ -329,6 +571,19 @@ namespace sdf_generator
     auto worldDir = common::parentPath(worldSdf->Data().Element()->FilePath());
 
     // models
+    // Top level models are collected first, so their elements can be
+    // generated in parallel and then added in the order they were found.
+    struct TopLevelModel
+    {
+      Entity entity;
+      std::string modelDir;
+      bool fromInclude;
+      msgs::SdfGeneratorConfig::EntityGeneratorConfig config;
+      std::string options;
+      sdf::ElementPtr elem;
+    };
+    std::vector<TopLevelModel> models;
+
     _ecm.Each<components::Model, components::ModelSdf>(
         [&](const Entity &_modelEntity, const components::Model *,
             const components::ModelSdf *_modelSdf)
@@ -339,88 +594,125 @@ namespace sdf_generator
           if (parentComp && parentComp->Data() != _entity)
             return true;
 
-          auto modelDir =
+          TopLevelModel model;
+          model.entity = _modelEntity;
+          model.modelDir =
               common::parentPath(_modelSdf->Data().Element()->FilePath());
+          model.fromInclude = isModelFromInclude(model.modelDir, worldDir);
 
           const std::string modelName =
               scopedName(_modelEntity, _ecm, "::", false);
 
-          bool modelFromInclude = isModelFromInclude(modelDir, worldDir);
-
-          auto uriMapIt = _includeUriMap.find(modelDir);
-
-          auto modelConfig = _config.global_entity_gen_config();
+          model.config = _config.global_entity_gen_config();
           auto modelConfigIt =
               _config.override_entity_gen_configs().find(modelName);
           if (modelConfigIt != _config.override_entity_gen_configs().end())
           {
-            mergeWithOverride(modelConfig, modelConfigIt->second);
+            mergeWithOverride(model.config, modelConfigIt->second);
           }
 
-          if (modelConfig.expand_include_tags().data() || !modelFromInclude)
-          {
-            auto modelElem = _elem->AddElement("model");
-            updateModelElement(modelElem, _ecm, _modelEntity);
-
-            // Check & update possible //model/include(s)
-            if (!modelConfig.expand_include_tags().data())
-            {
-              updateModelElementWithNestedInclude(modelElem,
-                    modelConfig.save_fuel_version().data(), _includeUriMap);
-            }
-          }
-          else if (uriMapIt != _includeUriMap.end())
-          {
-            // The fuel URI might have a version number. If it does, we remove
-            // it unless saveFuelModelVersion is set to true.
-            // Check if this is a fuel URI. We assume that it is a fuel URI if
-            // the scheme is http or https.
-            common::URI uri(uriMapIt->second);
-            if (uri.Scheme() == "http" || uri.Scheme() == "https")
-            {
-              removeVersionFromUri(uri);
-            }
-
-            if (modelConfig.save_fuel_version().data())
-            {
-              // Find out the model version from the file path. Note that we
-              // do this from the file path instead of the Fuel URI because the
-              // URI may not contain version information.
-              //
-              // We are assuming here that, for Fuel models, the directory
-              // containing the sdf file has the same name as the model version.
-              // For example, if the uri is
-              // https://example.org/1.0/test/models/Backpack
-              // the path to the directory containing the sdf file (modelDir)
-              // will be:
-              // $HOME/.ignition/fuel/example.org/test/models/Backpack/2/
-              // and the basename of the directory is "1", which is the model
-              // version.
-              //
-              // However, if symlinks (or other types of indirection) are used,
-              // the pattern of modelDir will be different. The assumption here
-              // is that regardless of the indirection, the name of the
-              // directory containing the sdf file can be used as the version
-              // number
-              //
-              uri.Path() /= common::basename(modelDir);
-            }
-
-            auto includeElem = _elem->AddElement("include");
-            updateIncludeElement(includeElem, _ecm, _modelEntity, uri.Str());
-          }
-          else
-          {
-            // The model is not in the includeUriMap, but expandIncludeTags =
-            // false, so we will assume that its uri is the file path of the
-            // model on the local machine
-            auto includeElem = _elem->AddElement("include");
-            const std::string uri = "file://" + modelDir;
-            updateIncludeElement(includeElem, _ecm, _modelEntity, uri);
-          }
+          models.push_back(std::move(model));
           return true;
         });
 
+    // Everything the generated elements depend on besides the components of
+    // each model
+    std::string options;
+    if (nullptr != _cache)
+    {
+      std::map<std::string, std::string> sortedUriMap(
+          _includeUriMap.begin(), _includeUriMap.end());
+      for (const auto &[path, uri] : sortedUriMap)
+        options += path + ' ' + uri + '\n';
+    }
+
+    // Reuse the elements of models which haven't changed since they were
+    // cached
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < models.size(); ++i)
+    {
+      auto &model = models[i];
+      if (nullptr != _cache)
+      {
+        model.options = options + model.modelDir + '\n' +
+            std::to_string(model.fromInclude) + '\n' +
+            model.config.SerializeAsString();
+
+        auto cacheIt = _cache->find(model.entity);
+        if (cacheIt != _cache->end() &&
+            cacheIt->second.options == model.options)
+        {
+          model.elem = cacheIt->second.elem;
+          continue;
+        }
+      }
+      pending.push_back(i);
+    }
+
+    auto generateModels = [&](std::size_t _begin, std::size_t _end)
+    {
+      for (std::size_t i = _begin; i < _end; ++i)
+      {
+        auto &model = models[pending[i]];
+        model.elem = generateModelElement(_elem, _ecm, model.entity,
+            model.modelDir, model.fromInclude, _includeUriMap, model.config);
+      }
+    };
+
+    std::size_t numThreads = std::min<std::size_t>(pending.size(),
+        std::max(1u, std::thread::hardware_concurrency()));
+    if (numThreads <= 1)
+    {
+      generateModels(0, pending.size());
+    }
+    else
+    {
+      std::size_t modelsPerThread =
+          (pending.size() + numThreads - 1) / numThreads;
+      auto &workers = exportWorkers();
+      for (std::size_t begin = 0; begin < pending.size();
+           begin += modelsPerThread)
+      {
+        const std::size_t end =
+            std::min(begin + modelsPerThread, pending.size());
+        workers.AddWork([&generateModels, begin, end]()
+        {
+          generateModels(begin, end);
+        });
+      }
+      workers.WaitForResults();
+    }
+
+    std::unordered_set<Entity> exported;
+    for (auto &model : models)
+    {
+      if (nullptr == model.elem)
+        continue;
+
+      model.elem->SetParent(_elem);
+      _elem->InsertElement(model.elem);
+
+      if (nullptr != _cache)
+      {
+        exported.insert(model.entity);
+        auto &cached = (*_cache)[model.entity];
+        cached.options = std::move(model.options);
+        cached.elem = model.elem;
+      }
+    }
+
+    // Forget models that were removed
+    if (nullptr != _cache)
+    {
+      for (auto it = _cache->begin(); it != _cache->end();)
+      {
+        if (exported.find(it->first) == exported.end())
+          it = _cache->erase(it);
+        else
+          ++it;
+      }
+    }
+
     // lights
     _ecm.Each<components::Light, components::ParentEntity>(
         [&](const Entity &_lightEntity,
@@ -501,8 +793,7 @@ namespace sdf_generator
       while (linkElem)
       {
         std::string linkName = linkElem->Get<std::string>("name");
-        auto linkEnt = _ecm.EntityByComponents(
-            components::ParentEntity(_entity), components::Name(linkName));
+        auto linkEnt = childByName(_ecm, _entity, linkName);
         if (linkEnt != kNullEntity)
           updateLinkElement(linkElem, _ecm, linkEnt);
         linkElem = linkElem->GetNextElement("link");
@@ -516,8 +807,7 @@ namespace sdf_generator
       while (jointElem)
       {
         std::string jointName = jointElem->Get<std::string>("name");
-        auto jointEnt = _ecm.EntityByComponents(
-            components::ParentEntity(_entity), components::Name(jointName));
+        auto jointEnt = childByName(_ecm, _entity, jointName);
         if (jointEnt != kNullEntity)
           updateJointElement(jointElem, _ecm, jointEnt);
         jointElem = jointElem->GetNextElement("joint");
@@ -591,8 +881,7 @@ namespace sdf_generator
       while (sensorElem)
       {
         std::string sensorName = sensorElem->Get<std::string>("name");
-        auto sensorEnt = _ecm.EntityByComponents(
-            components::ParentEntity(_entity), components::Name(sensorName));
+        auto sensorEnt = childByName(_ecm, _entity, sensorName);
         if (sensorEnt != kNullEntity)
           updateSensorElement(sensorElem, _ecm, sensorEnt);
         sensorElem = sensorElem->GetNextElement("sensor");
@@ -606,8 +895,7 @@ namespace sdf_generator
       while (lightElem)
       {
         std::string lightName = lightElem->Get<std::string>("name");
-        auto lightEnt = _ecm.EntityByComponents(
-            components::ParentEntity(_entity), components::Name(lightName));
+        auto lightEnt = childByName(_ecm, _entity, lightName);
         if (lightEnt != kNullEntity)
           updateLightElement(lightElem, _ecm, lightEnt);
         lightElem = lightElem->GetNextElement("light");
@@ -918,11 +1206,14 @@ namespace sdf_generator
       _elem->RemoveChild(e);
     }
 
-    auto sensorEntities = _ecm.EntitiesByComponents(
-        components::ParentEntity(_entity), components::Sensor());
-
-    for (const auto &sensorEnt : sensorEntities)
+    // Go through the entity graph instead of EntitiesByComponents so joints
+    // can be updated from multiple threads
+    for (const auto &vertex : _ecm.Entities().AdjacentsFrom(_entity))
     {
+      const Entity sensorEnt = vertex.first;
+      if (nullptr == _ecm.Component<components::Sensor>(sensorEnt))
+        continue;
+
       sdf::ElementPtr sensorElem = _elem->AddElement("sensor");
       updateSensorElement(sensorElem, _ecm, sensorEnt);
     }
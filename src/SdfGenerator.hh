@@ -37,19 +37,53 @@ namespace sdf_generator
 {
   using IncludeUriMap = std::unordered_map<std::string, std::string>;
 
+  /// \brief Element generated for a top level model during a previous export,
+  /// along with the generator options it was generated with.
+  struct CachedModelElement
+  {
+    /// \brief Serialized generator options that were used.
+    std::string options;
+
+    /// \brief Generated <model> or <include> element.
+    sdf::ElementPtr elem;
+  };
+
+  /// \brief Cache of the elements generated for top level models, keyed by
+  /// model entity. Passing the same cache to consecutive exports of a world
+  /// lets models whose components haven't changed reuse their previous
+  /// element instead of being generated again. Changes are detected by
+  /// invalidateExportCache, which must be called on every simulation step
+  /// while the cache is kept.
+  using ExportCache = std::unordered_map<Entity, CachedModelElement>;
+
+  /// \brief Remove the cached elements of top level models whose subtree
+  /// changed during the current simulation step, according to the change
+  /// tracking of the ECM: components the generator reads which were changed
+  /// or removed, and entities which were created or marked for removal. Must
+  /// be called before the changes are cleared at the end of the step.
+  /// \input[in, out] _cache Cache to update
+  /// \input[in] _ecm Immutable reference to the Entity Component Manager
+  IGNITION_GAZEBO_VISIBLE
+  void invalidateExportCache(ExportCache &_cache,
+      const EntityComponentManager &_ecm);
+
   /// \brief Generate the SDFormat representation of a world
   /// \input[in] _ecm Immutable reference to the Entity Component Manager
   /// \input[in] _entity World entity
   /// \input[in] _includeUriMap Map from file paths to URIs used to preserve
   /// included Fuel models
   /// \input[in] _config Configuration for the world generator
+  /// \input[in, out] _cache Optional cache of previously generated models.
+  /// It's updated with the models of this export, and must not be used
+  /// concurrently by other exports.
   /// \returns Generated world string if generation succeeded.
   /// Otherwise, nullopt
   IGNITION_GAZEBO_VISIBLE
   std::optional<std::string> generateWorld(
       const EntityComponentManager &_ecm, const Entity &_entity,
       const IncludeUriMap &_includeUriMap = IncludeUriMap(),
-      const msgs::SdfGeneratorConfig &_config = msgs::SdfGeneratorConfig());
+      const msgs::SdfGeneratorConfig &_config = msgs::SdfGeneratorConfig(),
+      ExportCache *_cache = nullptr);
 
   /// \brief Update a sdf::Element of a world. Intended for internal use.
   /// \input[in, out] _elem sdf::Element to update
@@ -58,12 +92,19 @@ namespace sdf_generator
   /// \input[in] _includeUriMap Map from file paths to URIs used to preserve
   /// included Fuel models
   /// \input[in] _config Configuration for the world generator
+  /// \input[in, out] _cache Optional cache of previously generated models.
+  /// Top level models which are still cached with the same options reuse the
+  /// cached element, which is shared with the cache, so the resulting model
+  /// elements must not be modified. The other models are generated in
+  /// parallel and cached. Models that no longer exist are removed from the
+  /// cache.
   IGNITION_GAZEBO_VISIBLE
   bool updateWorldElement(
       sdf::ElementPtr _elem,
       const EntityComponentManager &_ecm, const Entity &_entity,
       const IncludeUriMap &_includeUriMap = IncludeUriMap(),
-      const msgs::SdfGeneratorConfig &_config = msgs::SdfGeneratorConfig());
+      const msgs::SdfGeneratorConfig &_config = msgs::SdfGeneratorConfig(),
+      ExportCache *_cache = nullptr);
 
   /// \brief Update a sdf::Element of an inlined model.
   /// Intended for internal use.
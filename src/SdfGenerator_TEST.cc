@@ -245,6 +245,17 @@ TEST(CompareElements, CompareWithDuplicateElements)
   EXPECT_FALSE(isSubset(m1CompTest, m1));
 }
 
+/////////////////////////////////////////////////
+/// \brief ECM which can end a simulation step, clearing its changes.
+class EntityCompMgrTest : public EntityComponentManager
+{
+  public: void EndStep()
+  {
+    this->ClearNewlyCreatedEntities();
+    this->SetAllComponentsUnchanged();
+  }
+};
+
 /////////////////////////////////////////////////
 class ElementUpdateFixture : public InternalFixture<::testing::Test>
 {
@@ -305,7 +316,7 @@ class ElementUpdateFixture : public InternalFixture<::testing::Test>
     return nullptr;
   }
 
-  public: EntityComponentManager ecm;
+  public: EntityCompMgrTest ecm;
   public: EventManager evm;
   public: sdf::Root root;
   public: const sdf::World *world{nullptr};
@@ -1048,6 +1059,97 @@ TEST_F(GenerateWorldFixture, PoseWithAttributes)
   }
 }
 
+/////////////////////////////////////////////////
+TEST_F(GenerateWorldFixture, ExportCache)
+{
+  this->LoadWorld("test/worlds/shapes.sdf");
+  Entity worldEntity = this->ecm.EntityByComponents(components::World());
+
+  sdf_generator::ExportCache cache;
+  auto worldStr = sdf_generator::generateWorld(this->ecm, worldEntity,
+      this->includeUriMap, this->sdfGenConfig, &cache);
+  ASSERT_TRUE(worldStr.has_value());
+
+  // Same result as without a cache
+  auto uncachedStr = sdf_generator::generateWorld(this->ecm, worldEntity,
+      this->includeUriMap, this->sdfGenConfig);
+  ASSERT_TRUE(uncachedStr.has_value());
+  EXPECT_EQ(*uncachedStr, *worldStr);
+
+  // All top level models are cached
+  std::size_t topLevelModels{0};
+  this->ecm.Each<components::Model, components::ParentEntity>(
+      [&](const Entity &_entity, const components::Model *,
+          const components::ParentEntity *_parent)
+      {
+        if (_parent->Data() == worldEntity)
+        {
+          ++topLevelModels;
+          EXPECT_EQ(1u, cache.count(_entity));
+        }
+        return true;
+      });
+  EXPECT_LT(0u, topLevelModels);
+  EXPECT_EQ(topLevelModels, cache.size());
+
+  std::unordered_map<Entity, sdf::ElementPtr> cachedElems;
+  for (const auto &[entity, cached] : cache)
+    cachedElems[entity] = cached.elem;
+
+  // Nothing changed, all models are reused
+  auto reusedStr = sdf_generator::generateWorld(this->ecm, worldEntity,
+      this->includeUriMap, this->sdfGenConfig, &cache);
+  ASSERT_TRUE(reusedStr.has_value());
+  EXPECT_EQ(*worldStr, *reusedStr);
+  for (const auto &[entity, cached] : cache)
+    EXPECT_EQ(cachedElems[entity], cached.elem);
+
+  // Loading the world is a change of every model
+  sdf_generator::ExportCache loadedCache = cache;
+  sdf_generator::invalidateExportCache(loadedCache, this->ecm);
+  EXPECT_TRUE(loadedCache.empty());
+  this->ecm.EndStep();
+
+  // Steps without changes keep the cache
+  sdf_generator::invalidateExportCache(cache, this->ecm);
+  EXPECT_EQ(topLevelModels, cache.size());
+
+  // Moving a model only regenerates that model
+  Entity boxEntity = this->ecm.EntityByComponents(
+      components::Model(), components::Name("box"));
+  ASSERT_NE(kNullEntity, boxEntity);
+  math::Pose3d newPose{0.1, 0.2, 0.3, 0, 0, 0};
+  this->ecm.Component<components::Pose>(boxEntity)->Data() = newPose;
+  this->ecm.SetChanged(boxEntity, components::Pose::typeId,
+      ComponentState::PeriodicChange);
+  sdf_generator::invalidateExportCache(cache, this->ecm);
+  EXPECT_EQ(topLevelModels - 1, cache.size());
+  EXPECT_EQ(0u, cache.count(boxEntity));
+
+  auto updatedStr = sdf_generator::generateWorld(this->ecm, worldEntity,
+      this->includeUriMap, this->sdfGenConfig, &cache);
+  ASSERT_TRUE(updatedStr.has_value());
+  EXPECT_EQ(topLevelModels, cache.size());
+  for (const auto &[entity, cached] : cache)
+  {
+    if (entity == boxEntity)
+    {
+      EXPECT_NE(cachedElems[entity], cached.elem);
+      EXPECT_EQ(newPose, cached.elem->Get<math::Pose3d>("pose"));
+    }
+    else
+    {
+      EXPECT_EQ(cachedElems[entity], cached.elem);
+    }
+  }
+
+  uncachedStr = sdf_generator::generateWorld(this->ecm, worldEntity,
+      this->includeUriMap, this->sdfGenConfig);
+  ASSERT_TRUE(uncachedStr.has_value());
+  EXPECT_EQ(*uncachedStr, *updatedStr);
+  EXPECT_NE(*worldStr, *updatedStr);
+}
+
 /////////////////////////////////////////////////
 /// Main
 int main(int _argc, char **_argv)
@@ -25,10 +25,12 @@
 
 #include "ignition/gazebo/config.hh"
 #include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/ThreadRegistry.hh"
 #include "ignition/gazebo/Util.hh"
 
 #include "ServerPrivate.hh"
 #include "SimulationRunner.hh"
+#include "WorldCheckpoint.hh"
 
 using namespace ignition;
 using namespace gazebo;
@@ -57,6 +59,10 @@ Server::Server(const ServerConfig &_config)
 {
   this->dataPtr->config = _config;
 
+  // Place simulation threads on the configured cores
+  for (const auto &[threadClass, cores] : _config.ThreadAffinities())
+    ThreadRegistry::Instance().SetAffinity(threadClass, cores);
+
   // Configure the fuel client
   fuel_tools::ClientConfig config;
   if (!_config.ResourceCache().empty())
@@ -122,6 +128,26 @@ Server::Server(const ServerConfig &_config)
       break;
     }
 
+    case ServerConfig::SourceType::kCheckpoint:
+    {
+      msgs::WorldStatistics stats;
+      if (!readCheckpointHeader(_config.CheckpointRestorePath(), stats))
+        return;
+
+      ignmsg << "Restoring world from checkpoint ["
+             << _config.CheckpointRestorePath() << "].\n";
+
+      // Only an empty world with the original name is loaded, the simulation
+      // runner restores everything else from the checkpoint.
+      errors = this->dataPtr->sdfRoot.LoadSdfString(
+          std::string("<?xml version='1.0'?>"
+            "<sdf version='1.6'>"
+              "<world name='") + checkpointWorldName(stats) + "'>"
+              "</world>"
+            "</sdf>");
+      break;
+    }
+
     case ServerConfig::SourceType::kNone:
     default:
     {
@@ -378,6 +404,23 @@ bool Server::RequestRemoveEntity(const Entity _entity,
   return false;
 }
 
+//////////////////////////////////////////////////
+std::optional<std::vector<unsigned int>> Server::ForkWorld(
+    const unsigned int _count, const unsigned int _worldIndex)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->runMutex);
+  if (this->dataPtr->running)
+  {
+    ignerr << "Cannot fork a world while the server is running.\n";
+    return std::nullopt;
+  }
+
+  if (_worldIndex >= this->dataPtr->simRunners.size())
+    return std::nullopt;
+
+  return this->dataPtr->ForkWorld(_count, _worldIndex);
+}
+
 //////////////////////////////////////////////////
 void Server::Stop()
 {
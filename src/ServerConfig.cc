@@ -271,6 +271,7 @@ class ignition::gazebo::ServerConfigPrivate
             logRecordPath(_cfg->logRecordPath),
             logRecordPeriod(_cfg->logRecordPeriod),
             logPlaybackPath(_cfg->logPlaybackPath),
+            checkpointRestorePath(_cfg->checkpointRestorePath),
             logRecordResources(_cfg->logRecordResources),
             logRecordCompressPath(_cfg->logRecordCompressPath),
             resourceCache(_cfg->resourceCache),
@@ -282,7 +283,8 @@ class ignition::gazebo::ServerConfigPrivate
             networkSecondaries(_cfg->networkSecondaries),
             seed(_cfg->seed),
             logRecordTopics(_cfg->logRecordTopics),
-            isHeadlessRendering(_cfg->isHeadlessRendering) { }
+            isHeadlessRendering(_cfg->isHeadlessRendering),
+            threadAffinity(_cfg->threadAffinity) { }
 
   // \brief The SDF file that the server should load
   public: std::string sdfFile = "";
@@ -308,6 +310,9 @@ class ignition::gazebo::ServerConfigPrivate
   /// \brief Path to recorded states to play back using logging system
   public: std::string logPlaybackPath = "";
 
+  /// \brief Path to a checkpoint to restore the world from
+  public: std::string checkpointRestorePath = "";
+
   /// \brief Record meshes and material files
   public: bool logRecordResources{false};
 
@@ -350,6 +355,9 @@ class ignition::gazebo::ServerConfigPrivate
   /// \brief is the headless mode active.
   public: bool isHeadlessRendering{false};
 
+  /// \brief Cores of each class of simulation threads.
+  public: std::map<ThreadClass, std::set<unsigned int>> threadAffinity;
+
   /// \brief Optional SDF root object.
   public: std::optional<sdf::Root> sdfRoot;
 
@@ -382,6 +390,7 @@ bool ServerConfig::SetSdfFile(const std::string &_file)
   this->dataPtr->sdfFile = _file;
   this->dataPtr->sdfString = "";
   this->dataPtr->sdfRoot = std::nullopt;
+  this->dataPtr->checkpointRestorePath = "";
   return true;
 }
 
@@ -398,6 +407,7 @@ bool ServerConfig::SetSdfString(const std::string &_sdfString)
   this->dataPtr->sdfFile = "";
   this->dataPtr->sdfString = _sdfString;
   this->dataPtr->sdfRoot = std::nullopt;
+  this->dataPtr->checkpointRestorePath = "";
   return true;
 }
 
@@ -527,6 +537,26 @@ void ServerConfig::SetLogPlaybackPath(const std::string &_playbackPath)
   this->dataPtr->logPlaybackPath = _playbackPath;
 }
 
+/////////////////////////////////////////////////
+bool ServerConfig::SetCheckpointRestorePath(const std::string &_path)
+{
+  if (_path.empty())
+    return false;
+
+  this->dataPtr->source = ServerConfig::SourceType::kCheckpoint;
+  this->dataPtr->checkpointRestorePath = _path;
+  this->dataPtr->sdfFile = "";
+  this->dataPtr->sdfString = "";
+  this->dataPtr->sdfRoot = std::nullopt;
+  return true;
+}
+
+/////////////////////////////////////////////////
+const std::string &ServerConfig::CheckpointRestorePath() const
+{
+  return this->dataPtr->checkpointRestorePath;
+}
+
 /////////////////////////////////////////////////
 bool ServerConfig::LogRecordResources() const
 {
@@ -624,6 +654,32 @@ void ServerConfig::SetRenderEngineGui(const std::string &_renderEngineGui)
   this->dataPtr->renderEngineGui = _renderEngineGui;
 }
 
+/////////////////////////////////////////////////
+void ServerConfig::SetThreadAffinity(ThreadClass _class,
+    const std::set<unsigned int> &_cores)
+{
+  if (_cores.empty())
+    this->dataPtr->threadAffinity.erase(_class);
+  else
+    this->dataPtr->threadAffinity[_class] = _cores;
+}
+
+/////////////////////////////////////////////////
+std::set<unsigned int> ServerConfig::ThreadAffinity(ThreadClass _class) const
+{
+  auto it = this->dataPtr->threadAffinity.find(_class);
+  if (it == this->dataPtr->threadAffinity.end())
+    return {};
+  return it->second;
+}
+
+/////////////////////////////////////////////////
+const std::map<ThreadClass, std::set<unsigned int>> &
+ServerConfig::ThreadAffinities() const
+{
+  return this->dataPtr->threadAffinity;
+}
+
 /////////////////////////////////////////////////
 void ServerConfig::AddPlugin(const ServerConfig::PluginInfo &_info)
 {
@@ -778,6 +834,7 @@ void ServerConfig::SetSdfRoot(const sdf::Root &_root) const
 
   this->dataPtr->sdfFile = "";
   this->dataPtr->sdfString = "";
+  this->dataPtr->checkpointRestorePath = "";
 }
 
 /////////////////////////////////////////////////
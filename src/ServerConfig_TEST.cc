@@ -276,3 +276,53 @@ TEST(ServerConfig, SdfRoot)
   EXPECT_TRUE(config.SdfString().empty());
   EXPECT_EQ(ServerConfig::SourceType::kSdfRoot, config.Source());
 }
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, CheckpointRestorePath)
+{
+  ServerConfig config;
+  EXPECT_TRUE(config.CheckpointRestorePath().empty());
+
+  config.SetSdfFile("file");
+  EXPECT_TRUE(config.SetCheckpointRestorePath("checkpoint.ckpt"));
+  EXPECT_EQ("checkpoint.ckpt", config.CheckpointRestorePath());
+  EXPECT_FALSE(config.SdfRoot());
+  EXPECT_TRUE(config.SdfFile().empty());
+  EXPECT_TRUE(config.SdfString().empty());
+  EXPECT_EQ(ServerConfig::SourceType::kCheckpoint, config.Source());
+
+  // Copies keep the path
+  ServerConfig copy(config);
+  EXPECT_EQ("checkpoint.ckpt", copy.CheckpointRestorePath());
+
+  config.SetSdfString("string");
+  EXPECT_TRUE(config.CheckpointRestorePath().empty());
+  EXPECT_EQ(ServerConfig::SourceType::kSdfString, config.Source());
+}
+
+//////////////////////////////////////////////////
+TEST(ServerConfig, ThreadAffinity)
+{
+  ServerConfig config;
+  EXPECT_TRUE(config.ThreadAffinities().empty());
+  EXPECT_TRUE(config.ThreadAffinity(ThreadClass::kSimulation).empty());
+
+  config.SetThreadAffinity(ThreadClass::kSimulation, {0, 1});
+  config.SetThreadAffinity(ThreadClass::kPostUpdate, {2, 3});
+  EXPECT_EQ(std::set<unsigned int>({0, 1}),
+      config.ThreadAffinity(ThreadClass::kSimulation));
+  EXPECT_EQ(std::set<unsigned int>({2, 3}),
+      config.ThreadAffinity(ThreadClass::kPostUpdate));
+  EXPECT_TRUE(config.ThreadAffinity(ThreadClass::kRendering).empty());
+  EXPECT_EQ(2u, config.ThreadAffinities().size());
+
+  // Copies keep the cores
+  ServerConfig copy(config);
+  EXPECT_EQ(std::set<unsigned int>({0, 1}),
+      copy.ThreadAffinity(ThreadClass::kSimulation));
+
+  // No cores means any core
+  config.SetThreadAffinity(ThreadClass::kSimulation, {});
+  EXPECT_TRUE(config.ThreadAffinity(ThreadClass::kSimulation).empty());
+  EXPECT_EQ(1u, config.ThreadAffinities().size());
+}
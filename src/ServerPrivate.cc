@@ -18,15 +18,23 @@
 
 #include <tinyxml2.h>
 
+#include <algorithm>
+#include <chrono>
+#include <string>
+
 #include <sdf/Root.hh>
 #include <sdf/World.hh>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/StringUtils.hh>
 #include <ignition/common/Util.hh>
 
 #include <ignition/fuel_tools/Interface.hh>
 
+#include "ignition/gazebo/MeshAssets.hh"
+#include "ignition/gazebo/ThreadRegistry.hh"
 #include "ignition/gazebo/Util.hh"
+#include "ParamUtil.hh"
 #include "SimulationRunner.hh"
 
 using namespace ignition;
@@ -102,6 +110,9 @@ ServerPrivate::~ServerPrivate()
   {
     this->stopThread->join();
   }
+  // Other servers in the process may still use their preloaded meshes
+  for (auto request : this->meshPreloads)
+    MeshAssets::Instance().CancelPreload(request);
 }
 
 //////////////////////////////////////////////////
@@ -129,6 +140,10 @@ bool ServerPrivate::Run(const uint64_t _iterations,
   this->running = true;
   if (_cond)
     _cond.value()->notify_all();
+
+  // Blocking runs step on the caller's thread, which is left alone. Only
+  // threads created by the server are renamed and pinned.
+  const bool ownThread = this->runThread.get_id() == std::this_thread::get_id();
   this->runMutex.unlock();
 
   bool result = true;
@@ -161,23 +176,40 @@ bool ServerPrivate::Run(const uint64_t _iterations,
   }
 
   // Minor performance tweak. In many situations there will only be one
-  // simulation runner, and we can avoid using the thread pool.
+  // simulation runner, and we can avoid spawning a thread per world.
   if (this->simRunners.size() == 1)
   {
+    std::optional<ScopedThreadRegistration> registration;
+    if (ownThread)
+    {
+      registration.emplace(ThreadClass::kSimulation,
+          "sim_" + this->simRunners[0]->WorldName());
+    }
     result = this->simRunners[0]->Run(_iterations);
   }
   else
   {
-    for (std::unique_ptr<SimulationRunner> &runner : this->simRunners)
+    // Each world gets its own thread, so all worlds keep stepping
+    // concurrently no matter how many there are.
+    std::vector<std::thread> worldThreads;
+    std::vector<char> worldResults(this->simRunners.size(), true);
+    worldThreads.reserve(this->simRunners.size());
+    for (std::size_t i = 0; i < this->simRunners.size(); ++i)
     {
-      this->workerPool.AddWork([&runner, &_iterations] ()
+      worldThreads.emplace_back([this, i, &worldResults, &_iterations] ()
         {
-          runner->Run(_iterations);
+          ScopedThreadRegistration registration(ThreadClass::kSimulation,
+              "sim_" + this->simRunners[i]->WorldName());
+          worldResults[i] = this->simRunners[i]->Run(_iterations);
         });
     }
 
-    // Wait for the runner to complete.
-    result = this->workerPool.WaitForResults();
+    // Wait for the runners to complete.
+    for (auto &thread : worldThreads)
+      thread.join();
+
+    result = std::all_of(worldResults.begin(), worldResults.end(),
+        [](char _result) { return _result; });
   }
 
   this->running = false;
@@ -275,6 +307,50 @@ void ServerPrivate::AddRecordPlugin(const ServerConfig &_config)
   }
 }
 
+//////////////////////////////////////////////////
+/// \brief Find out which meshes of a world are used by the systems loaded
+/// into it: collisions by physics, visuals by sensors and other rendering
+/// systems. Systems come from the world and the server configuration, or
+/// from the default configuration if neither has any.
+/// \param[in] _world The world.
+/// \param[in] _config Server configuration.
+/// \param[out] _collisions True if collision meshes are used.
+/// \param[out] _visuals True if visual meshes are used.
+static void meshConsumers(const sdf::World &_world,
+    const ServerConfig &_config, bool &_collisions, bool &_visuals)
+{
+  std::vector<std::string> names;
+  for (const auto &plugin : _world.Plugins())
+  {
+    names.push_back(plugin.Filename());
+    names.push_back(plugin.Name());
+  }
+  for (const auto &plugin : _config.Plugins())
+  {
+    names.push_back(plugin.Plugin().Filename());
+    names.push_back(plugin.Plugin().Name());
+  }
+  if (names.empty())
+  {
+    for (const auto &plugin :
+        loadPluginInfo(!_config.LogPlaybackPath().empty()))
+    {
+      names.push_back(plugin.Plugin().Filename());
+      names.push_back(plugin.Plugin().Name());
+    }
+  }
+
+  _collisions = false;
+  _visuals = false;
+  for (const auto &name : names)
+  {
+    const auto lower = common::lowercase(name);
+    _collisions |= lower.find("physics") != std::string::npos;
+    _visuals |= lower.find("sensors") != std::string::npos ||
+        lower.find("rendering") != std::string::npos;
+  }
+}
+
 //////////////////////////////////////////////////
 void ServerPrivate::CreateEntities()
 {
@@ -284,6 +360,17 @@ void ServerPrivate::CreateEntities()
   {
     auto world = this->sdfRoot.WorldByIndex(worldIndex);
 
+    // Decode the meshes used by the world's systems in the background while
+    // the world is being loaded
+    bool collisions{false};
+    bool visuals{false};
+    meshConsumers(*world, this->config, collisions, visuals);
+    if (collisions || visuals)
+    {
+      this->meshPreloads.push_back(
+          MeshAssets::Instance().PreloadWorld(*world, collisions, visuals));
+    }
+
     {
       std::lock_guard<std::mutex> lock(this->worldsMutex);
       this->worldNames.push_back(world->Name());
@@ -295,6 +382,72 @@ void ServerPrivate::CreateEntities()
   }
 }
 
+//////////////////////////////////////////////////
+std::optional<std::vector<unsigned int>> ServerPrivate::ForkWorld(
+    const unsigned int _count, const unsigned int _worldIndex)
+{
+  if (this->config.UseLogRecord() || !this->config.LogPlaybackPath().empty() ||
+      this->config.UseDistributedSimulation())
+  {
+    ignerr << "Worlds being recorded, played back or distributed can't be "
+           << "forked." << std::endl;
+    return std::nullopt;
+  }
+
+  // All forks are restored from the same snapshot, and share its components
+  // until they modify them
+  const auto snapshot = this->simRunners[_worldIndex]->Snapshot();
+
+  std::vector<unsigned int> indices;
+  for (unsigned int i = 0; i < _count; ++i)
+  {
+    std::string name;
+    {
+      std::lock_guard<std::mutex> lock(this->worldsMutex);
+      do
+      {
+        name = snapshot.worldName + "_fork_" +
+            std::to_string(this->forkCount++);
+      }
+      while (std::find(this->worldNames.begin(), this->worldNames.end(),
+          name) != this->worldNames.end());
+    }
+
+    // Start from an empty world, which the runner replaces with the snapshot
+    this->forkRoots.emplace_back();
+    auto errors = this->forkRoots.back().LoadSdfString(
+        std::string("<?xml version='1.0'?>"
+          "<sdf version='1.6'>"
+            "<world name='") + name + "'>"
+            "</world>"
+          "</sdf>");
+    if (!errors.empty())
+    {
+      for (auto &err : errors)
+        ignerr << err << "\n";
+      this->forkRoots.pop_back();
+      return std::nullopt;
+    }
+
+    auto runner = std::make_unique<SimulationRunner>(
+        this->forkRoots.back().WorldByIndex(0), this->systemLoader,
+        this->config, &snapshot);
+    {
+      std::lock_guard<std::mutex> lock(this->fetchMutex);
+      runner->SetFuelUriMap(this->fuelUriMap);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(this->worldsMutex);
+      this->worldNames.push_back(name);
+    }
+    indices.push_back(static_cast<unsigned int>(this->simRunners.size()));
+    this->simRunners.push_back(std::move(runner));
+  }
+
+  return indices;
+}
+
 //////////////////////////////////////////////////
 void ServerPrivate::SetupTransport()
 {
@@ -366,6 +519,19 @@ void ServerPrivate::SetupTransport()
            << "]" << std::endl;
   }
 
+  std::string threadsService{"/gazebo/threads"};
+  if (this->node.Advertise(threadsService, &ServerPrivate::ThreadsService,
+      this))
+  {
+    ignmsg << "Thread statistics service on [" << threadsService << "]."
+           << std::endl;
+  }
+  else
+  {
+    ignerr << "Something went wrong, failed to advertise [" << threadsService
+           << "]" << std::endl;
+  }
+
   std::string serverControlService{"/server_control"};
   if (this->node.Advertise(serverControlService,
                            &ServerPrivate::ServerControlService, this))
@@ -395,6 +561,34 @@ bool ServerPrivate::WorldsService(ignition::msgs::StringMsg_V &_res)
   return true;
 }
 
+//////////////////////////////////////////////////
+bool ServerPrivate::ThreadsService(ignition::msgs::Param_V &_res)
+{
+  _res.Clear();
+
+  auto &registry = ThreadRegistry::Instance();
+  for (const auto &stats : registry.Statistics())
+  {
+    auto *param = _res.add_param();
+    setParam(*param, "name", stats.name);
+    setParam(*param, "class", threadClassName(stats.threadClass));
+    setParam(*param, "id", static_cast<int>(stats.id));
+    setParam(*param, "cpu_time",
+        std::chrono::duration<double>(stats.cpuTime).count());
+    setParam(*param, "migrations", static_cast<int>(stats.migrations));
+    setParam(*param, "involuntary_switches",
+        static_cast<int>(stats.involuntarySwitches));
+    setParam(*param, "last_core", stats.lastCore);
+
+    std::string cores;
+    for (auto core : registry.Affinity(stats.threadClass))
+      cores += (cores.empty() ? "" : ",") + std::to_string(core);
+    setParam(*param, "cores", cores);
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 bool ServerPrivate::ServerControlService(
   const ignition::msgs::ServerControl &_req, msgs::Boolean &_res)
@@ -542,11 +736,21 @@ bool ServerPrivate::ResourcePathsResolveService(
 //////////////////////////////////////////////////
 std::string ServerPrivate::FetchResource(const std::string &_uri)
 {
+  // All worlds share the resources fetched by any of them
+  {
+    std::lock_guard<std::mutex> lock(this->fetchMutex);
+    auto it = this->fetchedResources.find(_uri);
+    if (it != this->fetchedResources.end())
+      return it->second;
+  }
+
   auto path =
       fuel_tools::fetchResourceWithClient(_uri, *this->fuelClient.get());
 
   if (!path.empty())
   {
+    std::lock_guard<std::mutex> lock(this->fetchMutex);
+    this->fetchedResources[_uri] = path;
     for (auto &runner : this->simRunners)
     {
       runner->AddToFuelUriMap(path, _uri);
@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -34,12 +35,12 @@
 
 #include <ignition/common/SignalHandler.hh>
 #include <ignition/common/URI.hh>
-#include <ignition/common/WorkerPool.hh>
 
 #include <ignition/fuel_tools/FuelClient.hh>
 
 #include <ignition/transport/Node.hh>
 
+#include <ignition/msgs/param_v.pb.h>
 #include <ignition/msgs/server_control.pb.h>
 
 #include "ignition/gazebo/config.hh"
@@ -83,6 +84,15 @@ namespace ignition
       /// \brief Stop server.
       public: void Stop();
 
+      /// \brief Fork a world into new worlds, each with a simulation runner
+      /// restored from a snapshot of the original. The server must not be
+      /// running.
+      /// \param[in] _count Number of copies.
+      /// \param[in] _worldIndex Index of a valid world to fork.
+      /// \return Indices of the new worlds, or std::nullopt on error.
+      public: std::optional<std::vector<unsigned int>> ForkWorld(
+                  const unsigned int _count, const unsigned int _worldIndex);
+
       /// \brief Sets up all transport.
       /// \detail Future publishers and subscribers should be created within
       /// this function.
@@ -139,6 +149,12 @@ namespace ignition
                    const ignition::msgs::StringMsg &_req,
                    ignition::msgs::StringMsg &_res);
 
+      /// \brief Callback for the thread statistics service.
+      /// \param[out] _res Response containing one set of parameters per
+      /// registered simulation thread.
+      /// \return True if successful.
+      private: bool ThreadsService(ignition::msgs::Param_V &_res);
+
       /// \brief Callback for server control service.
       /// \param[out] _req The control request.
       /// \param[out] _res Whether the request was successfully fullfilled.
@@ -146,9 +162,6 @@ namespace ignition
       private: bool ServerControlService(
         const ignition::msgs::ServerControl &_req, msgs::Boolean &_res);
 
-      /// \brief A pool of worker threads.
-      public: common::WorkerPool workerPool{2};
-
       /// \brief All the simulation runners.
       public: std::vector<std::unique_ptr<SimulationRunner>> simRunners;
 
@@ -162,6 +175,10 @@ namespace ignition
       /// \brief Thread that executes systems.
       public: std::thread runThread;
 
+      /// \brief Meshes preloaded for the worlds of this server, canceled
+      /// when the server is destroyed.
+      public: std::vector<uint64_t> meshPreloads;
+
       /// \brief Thread that shuts down the system.
       public: std::shared_ptr<std::thread> stopThread;
 
@@ -176,6 +193,13 @@ namespace ignition
       /// pointer to child nodes of the root
       public: sdf::Root sdfRoot;
 
+      /// \brief Empty worlds the forked worlds were created from. Kept for
+      /// the same reason as sdfRoot.
+      public: std::list<sdf::Root> forkRoots;
+
+      /// \brief Number of worlds forked so far, used to name them.
+      public: unsigned int forkCount{0};
+
       /// \brief The server configuration.
       public: ServerConfig config;
 
@@ -186,6 +210,14 @@ namespace ignition
       /// Server. It is used in the SDFormat world generator when saving worlds
       public: std::unordered_map<std::string, std::string> fuelUriMap;
 
+      /// \brief Map from URIs to the paths they were fetched to, shared by
+      /// all worlds so each resource is only looked up once.
+      private: std::unordered_map<std::string, std::string> fetchedResources;
+
+      /// \brief Protects fetchedResources and fuelUriMap, which may be
+      /// updated by several worlds at once.
+      private: std::mutex fetchMutex;
+
       /// \brief List of names for all worlds loaded in this server.
       private: std::vector<std::string> worldNames;
 
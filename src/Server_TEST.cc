@@ -17,22 +17,30 @@
 
 #include <gtest/gtest.h>
 #include <csignal>
+#include <set>
 #include <vector>
 #include <ignition/common/StringUtils.hh>
 #include <ignition/common/Util.hh>
+#include <ignition/math/Pose3.hh>
 #include <ignition/math/Rand.hh>
+#include <ignition/msgs/param_v.pb.h>
+#include <ignition/msgs/stringmsg_v.pb.h>
 #include <ignition/transport/Node.hh>
 #include <ignition/utilities/ExtraTestMacros.hh>
 #include <sdf/Mesh.hh>
 
 #include "ignition/gazebo/components/AxisAlignedBox.hh"
 #include "ignition/gazebo/components/Geometry.hh"
+#include "ignition/gazebo/components/Link.hh"
 #include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/Entity.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/System.hh"
 #include "ignition/gazebo/SystemLoader.hh"
 #include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/ThreadRegistry.hh"
 #include "ignition/gazebo/Types.hh"
 #include "ignition/gazebo/Util.hh"
 #include "ignition/gazebo/test_config.hh"
@@ -710,6 +718,236 @@ TEST_P(ServerFixture, RunNonBlockingMultiple)
   EXPECT_FALSE(*server.Running(0));
 }
 
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(RunMultipleWorlds))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "multiple_worlds.sdf"));
+
+  gazebo::Server server(serverConfig);
+  EXPECT_FALSE(server.Running());
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    EXPECT_FALSE(*server.Running(i)) << i;
+    EXPECT_EQ(0u, *server.IterationCount(i)) << i;
+    server.SetUpdatePeriod(1ns, i);
+  }
+
+  // All worlds step at the same time, even when they run forever
+  server.Run(false, 0, false);
+
+  int sleep{0};
+  auto allStepped = [&server]()
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      if (*server.IterationCount(i) < 10u)
+        return false;
+    }
+    return true;
+  };
+  while (!allStepped() && sleep++ < 100)
+    IGN_SLEEP_MS(100);
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    EXPECT_TRUE(*server.Running(i)) << i;
+    EXPECT_LE(10u, *server.IterationCount(i)) << i;
+  }
+
+  server.Stop();
+  EXPECT_FALSE(server.Running());
+}
+
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(ForkWorld))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "shapes.sdf"));
+
+  gazebo::Server server(serverConfig);
+  server.Run(true, 100, false);
+  EXPECT_EQ(100u, *server.IterationCount());
+
+  // Invalid world
+  EXPECT_FALSE(server.ForkWorld(2, 1).has_value());
+
+  auto forks = server.ForkWorld(2);
+  ASSERT_TRUE(forks.has_value());
+  ASSERT_EQ(2u, forks->size());
+  EXPECT_EQ(1u, (*forks)[0]);
+  EXPECT_EQ(2u, (*forks)[1]);
+
+  // Forks start where the original world is
+  for (auto fork : *forks)
+  {
+    EXPECT_EQ(100u, *server.IterationCount(fork)) << fork;
+    EXPECT_EQ(*server.EntityCount(), *server.EntityCount(fork)) << fork;
+    EXPECT_EQ(*server.SystemCount(), *server.SystemCount(fork)) << fork;
+    EXPECT_TRUE(server.HasEntity("box", fork)) << fork;
+    EXPECT_EQ(*server.EntityByName("box"), *server.EntityByName("box", fork))
+        << fork;
+  }
+
+  // Forks diverge independently
+  EXPECT_TRUE(server.RequestRemoveEntity("box", true, (*forks)[0]));
+
+  // Record the poses of the sphere in all worlds
+  std::vector<test::Relay> relays(3);
+  std::vector<math::Pose3d> poses(3);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    relays[i].OnPostUpdate([&poses, i](const UpdateInfo &,
+                                       const EntityComponentManager &_ecm)
+        {
+          auto sphere = _ecm.EntityByComponents(components::Model(),
+              components::Name("sphere"));
+          auto pose = _ecm.Component<components::Pose>(sphere);
+          ASSERT_NE(nullptr, pose);
+          poses[i] = pose->Data();
+        });
+    EXPECT_TRUE(*server.AddSystem(relays[i].systemPtr, i));
+  }
+
+  server.Run(true, 100, false);
+
+  for (unsigned int i = 0; i < 3; ++i)
+    EXPECT_EQ(200u, *server.IterationCount(i)) << i;
+
+  EXPECT_TRUE(server.HasEntity("box"));
+  EXPECT_FALSE(server.HasEntity("box", (*forks)[0]));
+  EXPECT_TRUE(server.HasEntity("box", (*forks)[1]));
+
+  // Forks have the same state and systems, so the same motion
+  EXPECT_GT(1e-6, poses[1].Pos().Distance(poses[2].Pos()));
+  EXPECT_NE(poses[0], math::Pose3d::Zero);
+
+  // Forks can be forked too, and get unique names
+  forks = server.ForkWorld(1, 2);
+  ASSERT_TRUE(forks.has_value());
+  ASSERT_EQ(1u, forks->size());
+  EXPECT_EQ(200u, *server.IterationCount((*forks)[0]));
+
+  transport::Node node;
+  msgs::StringMsg_V res;
+  bool result{false};
+  EXPECT_TRUE(node.Request("/gazebo/worlds", 5000, res, result));
+  EXPECT_TRUE(result);
+  ASSERT_EQ(4, res.data_size());
+  EXPECT_EQ("default", res.data(0));
+  EXPECT_EQ("default_fork_0", res.data(1));
+  EXPECT_EQ("default_fork_1", res.data(2));
+  EXPECT_EQ("default_fork_1_fork_2", res.data(3));
+}
+
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(ForkTrajectory))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(common::joinPaths(PROJECT_SOURCE_PATH,
+      "test", "worlds", "double_pendulum.sdf"));
+
+  gazebo::Server server(serverConfig);
+
+  // Fork while the pendulums are swinging
+  server.Run(true, 300, false);
+  auto forks = server.ForkWorld(1);
+  ASSERT_TRUE(forks.has_value());
+  ASSERT_EQ(1u, forks->size());
+
+  // Record the world poses of the lower links in both worlds
+  std::vector<test::Relay> relays(2);
+  std::vector<std::vector<math::Pose3d>> poses(2);
+  const std::vector<unsigned int> worlds{0, (*forks)[0]};
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    relays[i].OnPostUpdate([&poses, i](const UpdateInfo &_info,
+                                       const EntityComponentManager &_ecm)
+        {
+          if (_info.paused)
+            return;
+
+          _ecm.Each<components::Link, components::Name>(
+              [&](const Entity &_entity, const components::Link *,
+                  const components::Name *_name) -> bool
+              {
+                if (_name->Data() == "lower_link")
+                  poses[i].push_back(worldPose(_entity, _ecm));
+                return true;
+              });
+        });
+    EXPECT_TRUE(*server.AddSystem(relays[i].systemPtr, worlds[i]));
+  }
+
+  server.Run(true, 500, false);
+
+  // The fork starts with the velocities of the original world, so it keeps
+  // following the same trajectory
+  ASSERT_FALSE(poses[0].empty());
+  ASSERT_EQ(poses[0].size(), poses[1].size());
+  for (std::size_t j = 0; j < poses[0].size(); ++j)
+  {
+    EXPECT_GT(1e-3, poses[0][j].Pos().Distance(poses[1][j].Pos())) << j;
+  }
+  EXPECT_LT(1e-2, poses[0].front().Pos().Distance(poses[0].back().Pos()));
+}
+
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(ThreadStatistics))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetThreadAffinity(ThreadClass::kSimulation, {0});
+
+  gazebo::Server server(serverConfig);
+  EXPECT_EQ(std::set<unsigned int>({0}),
+      ThreadRegistry::Instance().Affinity(ThreadClass::kSimulation));
+
+  server.SetUpdatePeriod(1ns);
+  server.Run(false, 0, false);
+  while (*server.IterationCount() < 10)
+    IGN_SLEEP_MS(10);
+
+  transport::Node node;
+  msgs::Param_V res;
+  bool result{false};
+  EXPECT_TRUE(node.Request("/gazebo/threads", 5000, res, result));
+  EXPECT_TRUE(result);
+
+  bool found{false};
+  for (const auto &param : res.param())
+  {
+    const auto &params = param.params();
+    if (params.at("name").string_value() != "sim_default")
+      continue;
+
+    found = true;
+    EXPECT_EQ("simulation", params.at("class").string_value());
+    EXPECT_EQ("0", params.at("cores").string_value());
+    EXPECT_NE(0, params.at("id").int_value());
+  }
+  EXPECT_TRUE(found);
+
+  // The registry is shared by all servers in the process
+  ThreadRegistry::Instance().SetAffinity(ThreadClass::kSimulation, {});
+}
+
+/////////////////////////////////////////////////
+// Blocking runs step on the caller's thread, which isn't registered
+TEST_P(ServerFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(BlockingRunThread))
+{
+  gazebo::Server server;
+  EXPECT_TRUE(server.RunOnce(true));
+  EXPECT_TRUE(server.Run(true, 2, false));
+
+  for (const auto &stats : ThreadRegistry::Instance().Statistics())
+  {
+    EXPECT_NE("sim_default", stats.name);
+  }
+}
+
 /////////////////////////////////////////////////
 TEST_P(ServerFixture, SigInt)
 {
@@ -18,10 +18,12 @@
 #include "SimulationRunner.hh"
 
 #include <algorithm>
+#include <sstream>
 
 #include <sdf/Root.hh>
 
 #include "ignition/common/Profiler.hh"
+#include "ignition/gazebo/components/Factory.hh"
 #include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/Sensor.hh"
@@ -31,8 +33,10 @@
 #include "ignition/gazebo/components/Physics.hh"
 #include "ignition/gazebo/components/PhysicsCmd.hh"
 #include "ignition/gazebo/components/Recreate.hh"
+#include "ignition/gazebo/components/SystemPluginInfo.hh"
 #include "ignition/gazebo/Events.hh"
 #include "ignition/gazebo/SdfEntityCreator.hh"
+#include "ignition/gazebo/ThreadRegistry.hh"
 #include "ignition/gazebo/Util.hh"
 
 #include "network/NetworkManagerPrimary.hh"
@@ -47,7 +51,8 @@ using StringSet = std::unordered_set<std::string>;
 //////////////////////////////////////////////////
 SimulationRunner::SimulationRunner(const sdf::World *_world,
                                    const SystemLoaderPtr &_systemLoader,
-                                   const ServerConfig &_config)
+                                   const ServerConfig &_config,
+                                   const CheckpointSnapshot *_fork)
     // \todo(nkoenig) Either copy the world, or add copy constructor to the
     // World and other elements.
     : sdfWorld(_world), serverConfig(_config)
@@ -131,6 +136,9 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
 
   this->node = std::make_unique<transport::Node>(opts);
 
+  // Create the message bus before any system can look it up
+  this->msgBus = MessageBus::Instance(this->eventMgr);
+
   // Create the system manager
   this->systemMgr = std::make_unique<SystemManager>(_systemLoader,
       &this->entityCompMgr, &this->eventMgr, validNs);
@@ -188,8 +196,22 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
   // Load the active levels
   this->levelMgr->UpdateLevelsState();
 
-  // Load any additional plugins from the Server Configuration
-  this->LoadServerPlugins(this->serverConfig.Plugins());
+  // Replace the empty world with the one in the checkpoint or the one being
+  // forked, before loading any other system
+  bool restored{false};
+  if (nullptr != _fork)
+    restored = this->RestoreSnapshot(*_fork);
+  else if (!this->serverConfig.CheckpointRestorePath().empty())
+  {
+    restored =
+        this->RestoreCheckpoint(this->serverConfig.CheckpointRestorePath());
+  }
+
+  // Load any additional plugins from the Server Configuration. A restored or
+  // forked world already has all systems it had, including those that came
+  // from the Server Configuration.
+  if (!restored)
+    this->LoadServerPlugins(this->serverConfig.Plugins());
 
   // If we have reached this point and no world systems have been loaded, then
   // load a default set of systems.
@@ -237,6 +259,13 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
 
   ignmsg << "Serving world SDF generation service on [" << opts.NameSpace()
          << "/" << genWorldSdfService << "]" << std::endl;
+
+  std::string checkpointService{"checkpoint"};
+  this->node->Advertise(
+      checkpointService, &SimulationRunner::CheckpointService, this);
+
+  ignmsg << "Serving world checkpoint service on [" << opts.NameSpace()
+         << "/" << checkpointService << "]" << std::endl;
 }
 
 //////////////////////////////////////////////////
@@ -491,8 +520,16 @@ void SimulationRunner::ProcessSystemQueue()
   igndbg << "Creating PostUpdate worker threads: "
     << threadCount << std::endl;
 
-  this->postUpdateStartBarrier = std::make_unique<Barrier>(threadCount);
-  this->postUpdateStopBarrier = std::make_unique<Barrier>(threadCount);
+  // Spinning before blocking saves waking threads up on every step, but only
+  // pays off if every thread has a core to spin on.
+  auto policy = Barrier::WaitPolicy::PARK;
+  if (threadCount <= std::thread::hardware_concurrency())
+    policy = Barrier::WaitPolicy::SPIN_THEN_PARK;
+
+  this->postUpdateStartBarrier = std::make_unique<Barrier>(threadCount,
+      policy);
+  this->postUpdateStopBarrier = std::make_unique<Barrier>(threadCount,
+      policy);
 
   this->postUpdateThreadsRunning = true;
   int id = 0;
@@ -506,6 +543,8 @@ void SimulationRunner::ProcessSystemQueue()
       std::stringstream ss;
       ss << "PostUpdateThread: " << id;
       IGN_PROFILE_THREAD_NAME(ss.str().c_str());
+      ScopedThreadRegistration registration(ThreadClass::kPostUpdate,
+          "post_" + std::to_string(id) + "_" + this->worldName);
       while (this->postUpdateThreadsRunning)
       {
         this->postUpdateStartBarrier->Wait();
@@ -810,6 +849,10 @@ void SimulationRunner::Step(const UpdateInfo &_info)
   // handle systems that need to be added
   this->systemMgr->ProcessPendingEntitySystems();
 
+  // Deliver the messages that were published on the message bus since the
+  // last step.
+  this->msgBus->Dispatch();
+
   // Update all the systems.
   this->UpdateSystems();
 
@@ -837,6 +880,14 @@ void SimulationRunner::Step(const UpdateInfo &_info)
   // Process world control messages.
   this->ProcessMessages();
 
+  // Forget the exported models that changed during this step, while the
+  // changes are still tracked
+  {
+    std::lock_guard<std::mutex> lock(this->sdfExportCacheMutex);
+    sdf_generator::invalidateExportCache(this->sdfExportCache,
+        this->entityCompMgr);
+  }
+
   // Clear all new entities
   this->entityCompMgr.ClearNewlyCreatedEntities();
 
@@ -852,6 +903,9 @@ void SimulationRunner::Step(const UpdateInfo &_info)
   // Process components removals
   this->entityCompMgr.ClearRemovedComponents();
 
+  // Take checkpoints once the step is complete
+  this->ProcessCheckpointRequests();
+
   // Each network manager takes care of marking its components as unchanged
   if (!this->networkMgr)
     this->entityCompMgr.SetAllComponentsUnchanged();
@@ -1017,6 +1071,12 @@ uint64_t SimulationRunner::IterationCount() const
   return this->currentInfo.iterations;
 }
 
+/////////////////////////////////////////////////
+const std::string &SimulationRunner::WorldName() const
+{
+  return this->worldName;
+}
+
 /////////////////////////////////////////////////
 size_t SimulationRunner::EntityCount() const
 {
@@ -1430,8 +1490,10 @@ bool SimulationRunner::GenerateWorldSdf(const msgs::SdfGeneratorConfig &_req,
   // TODO(addisu) This is not thread-safe. Wait until it is safe to access the
   // ECM.
   Entity world = this->entityCompMgr.EntityByComponents(components::World());
+  std::lock_guard<std::mutex> lock(this->sdfExportCacheMutex);
   std::optional<std::string> genString = sdf_generator::generateWorld(
-      this->entityCompMgr, world, this->fuelUriMap, _req);
+      this->entityCompMgr, world, this->fuelUriMap, _req,
+      &this->sdfExportCache);
   if (genString.has_value())
   {
     _res.set_data(*genString);
@@ -1441,6 +1503,298 @@ bool SimulationRunner::GenerateWorldSdf(const msgs::SdfGeneratorConfig &_req,
 }
 
 //////////////////////////////////////////////////
+bool SimulationRunner::CheckpointService(const msgs::StringMsg &_req,
+                                         msgs::Boolean &_res)
+{
+  if (_req.data().empty())
+  {
+    ignerr << "Missing path of the checkpoint file." << std::endl;
+    _res.set_data(false);
+    return true;
+  }
+
+  std::lock_guard<std::mutex> lock(this->checkpointMutex);
+  this->checkpointRequests.push_back(_req.data());
+  _res.set_data(true);
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::ProcessCheckpointRequests()
+{
+  std::vector<std::string> paths;
+  {
+    std::lock_guard<std::mutex> lock(this->checkpointMutex);
+    paths.swap(this->checkpointRequests);
+  }
+
+  if (paths.empty())
+    return;
+
+  IGN_PROFILE("SimulationRunner::ProcessCheckpointRequests");
+
+  for (const auto &path : paths)
+  {
+    // Copying is all that's done here, serialization happens on the
+    // writer's thread.
+    auto snapshot = this->Snapshot();
+    snapshot.path = path;
+
+    if (!this->checkpointWriter)
+      this->checkpointWriter = std::make_unique<CheckpointWriter>();
+    this->checkpointWriter->Write(std::move(snapshot));
+  }
+}
+
+/////////////////////////////////////////////////
+CheckpointSnapshot SimulationRunner::Snapshot()
+{
+  IGN_PROFILE("SimulationRunner::Snapshot");
+
+  this->eventMgr.Emit<events::BeforeSnapshot>(this->entityCompMgr);
+
+  // Order entities so parents come before their children, starting with the
+  // world, followed by any other entity without a parent.
+  const auto &graph = this->entityCompMgr.Entities();
+  const Entity world = worldEntity(this->entityCompMgr);
+  std::vector<Entity> entities;
+  entities.reserve(graph.Vertices().size());
+  if (kNullEntity != world)
+    entities.push_back(world);
+  for (const auto &vertex : graph.Vertices())
+  {
+    if (vertex.first != world &&
+        kNullEntity == this->entityCompMgr.ParentEntity(vertex.first))
+    {
+      entities.push_back(vertex.first);
+    }
+  }
+  for (std::size_t i = 0; i < entities.size(); ++i)
+  {
+    for (const auto &child : graph.AdjacentsFrom(entities[i]))
+      entities.push_back(child.first);
+  }
+
+  CheckpointSnapshot snapshot;
+  snapshot.worldName = this->worldName;
+  snapshot.stats.mutable_sim_time()->CopyFrom(
+      convert<msgs::Time>(this->currentInfo.simTime));
+  snapshot.stats.mutable_real_time()->CopyFrom(
+      convert<msgs::Time>(this->currentInfo.realTime));
+  snapshot.stats.set_iterations(this->currentInfo.iterations);
+  snapshot.stats.set_paused(this->currentInfo.paused);
+
+  snapshot.entities.reserve(entities.size());
+  for (const Entity entity : entities)
+  {
+    CheckpointEntity checkpointEntity;
+    checkpointEntity.entity = entity;
+    for (const auto type : this->entityCompMgr.ComponentTypes(entity))
+    {
+      auto comp = this->entityCompMgr.ShareComponent(entity, type);
+      if (nullptr != comp)
+        checkpointEntity.components.push_back(std::move(comp));
+    }
+    snapshot.entities.push_back(std::move(checkpointEntity));
+  }
+  return snapshot;
+}
+
+/////////////////////////////////////////////////
+bool SimulationRunner::RestoreCheckpoint(const std::string &_path)
+{
+  IGN_PROFILE("SimulationRunner::RestoreCheckpoint");
+
+  msgs::WorldStatistics stats;
+  msgs::SerializedState state;
+  if (!readCheckpoint(_path, stats, state))
+    return false;
+
+  // The world is the first entity created, both when the checkpoint was
+  // taken and now, so its components are replaced with the checkpoint's.
+  const Entity world = worldEntity(this->entityCompMgr);
+  if (state.entities_size() == 0 || state.entities(0).id() != world)
+  {
+    ignerr << "Checkpoint [" << _path << "] doesn't start with world entity ["
+           << world << "], it can't be restored." << std::endl;
+    return false;
+  }
+
+  // Systems are recorded on the entities they're attached to. Loading them
+  // again records them again, so the recorded info isn't restored.
+  std::vector<std::pair<Entity, msgs::Plugin_V>> systems;
+
+  // SetState skips empty payloads, components without data are created
+  // separately
+  std::vector<std::pair<Entity, ComponentTypeId>> emptyComponents;
+
+  Entity lastEntity{kNullEntity};
+  for (auto &entityMsg : *state.mutable_entities())
+  {
+    lastEntity = std::max<Entity>(lastEntity, entityMsg.id());
+
+    auto *comps = entityMsg.mutable_components();
+    for (auto it = comps->begin(); it != comps->end();)
+    {
+      if (it->component().empty())
+      {
+        emptyComponents.emplace_back(entityMsg.id(), it->type());
+        it = comps->erase(it);
+        continue;
+      }
+
+      if (it->type() != components::SystemPluginInfo::typeId)
+      {
+        ++it;
+        continue;
+      }
+
+      components::SystemPluginInfo info;
+      std::istringstream istr(it->component());
+      info.Deserialize(istr);
+      systems.emplace_back(entityMsg.id(), info.Data());
+      it = comps->erase(it);
+    }
+  }
+
+  const auto createdEntities = this->entityCompMgr.EntityCount();
+  this->entityCompMgr.SetState(state);
+
+  for (const auto &[entity, type] : emptyComponents)
+  {
+    if (nullptr != this->entityCompMgr.ComponentImplementation(entity, type))
+      continue;
+
+    auto comp = components::Factory::Instance()->New(type);
+    if (nullptr != comp)
+    {
+      this->entityCompMgr.CreateComponentImplementation(entity, type,
+          comp.get());
+    }
+  }
+
+  // Don't reuse the ids of restored entities
+  if (lastEntity > createdEntities)
+    this->entityCompMgr.SetEntityCreateOffset(lastEntity);
+
+  this->ResumeRestoredWorld(stats, systems);
+
+  ignmsg << "Restored [" << state.entities_size() << "] entities of world ["
+         << this->worldName << "] from checkpoint [" << _path
+         << "] at iteration [" << this->currentInfo.iterations << "]."
+         << std::endl;
+  return true;
+}
+
+/////////////////////////////////////////////////
+bool SimulationRunner::RestoreSnapshot(const CheckpointSnapshot &_snapshot)
+{
+  IGN_PROFILE("SimulationRunner::RestoreSnapshot");
+
+  const Entity world = worldEntity(this->entityCompMgr);
+  if (_snapshot.entities.empty() || _snapshot.entities[0].entity != world)
+  {
+    ignerr << "Snapshot of world [" << _snapshot.worldName
+           << "] doesn't start with world entity [" << world
+           << "], it can't be restored." << std::endl;
+    return false;
+  }
+
+  // Create all entities first, so their ids are taken before anything else
+  // is created. Components are left out of the message, they're shared
+  // below without going through serialization.
+  msgs::SerializedState state;
+  Entity lastEntity{kNullEntity};
+  for (const auto &snapshotEntity : _snapshot.entities)
+  {
+    lastEntity = std::max<Entity>(lastEntity, snapshotEntity.entity);
+    if (!this->entityCompMgr.HasEntity(snapshotEntity.entity))
+      state.add_entities()->set_id(snapshotEntity.entity);
+  }
+  const auto createdEntities = this->entityCompMgr.EntityCount();
+  this->entityCompMgr.SetState(state);
+
+  // Don't reuse the ids of restored entities
+  if (lastEntity > createdEntities)
+    this->entityCompMgr.SetEntityCreateOffset(lastEntity);
+
+  std::vector<std::pair<Entity, msgs::Plugin_V>> systems;
+  for (const auto &snapshotEntity : _snapshot.entities)
+  {
+    const Entity entity = snapshotEntity.entity;
+    for (const auto &comp : snapshotEntity.components)
+    {
+      const auto type = comp->TypeId();
+
+      // Systems are recorded again as they're loaded
+      if (type == components::SystemPluginInfo::typeId)
+      {
+        systems.emplace_back(entity,
+            static_cast<const components::SystemPluginInfo *>(
+            comp.get())->Data());
+        continue;
+      }
+
+      // The world keeps its own name, everything else is replaced
+      if (entity == world && type == components::Name::typeId)
+        continue;
+
+      // Components are shared with the snapshot and the other forks until
+      // they're modified. Parents come first, so parent components can be
+      // attached right away.
+      this->entityCompMgr.AddSharedComponent(entity, comp);
+    }
+  }
+
+  this->ResumeRestoredWorld(_snapshot.stats, systems);
+
+  ignmsg << "Forked world [" << this->worldName << "] from world ["
+         << _snapshot.worldName << "] with [" << _snapshot.entities.size()
+         << "] entities at iteration [" << this->currentInfo.iterations
+         << "]." << std::endl;
+  return true;
+}
+
+/////////////////////////////////////////////////
+void SimulationRunner::ResumeRestoredWorld(
+    const msgs::WorldStatistics &_stats,
+    const std::vector<std::pair<Entity, msgs::Plugin_V>> &_systems)
+{
+  const Entity world = worldEntity(this->entityCompMgr);
+
+  // Physics profile of the restored world
+  auto physicsComp =
+      this->entityCompMgr.Component<components::Physics>(world);
+  if (nullptr != physicsComp)
+  {
+    this->SetStepSize(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(physicsComp->Data().MaxStepSize())));
+    this->desiredRtf = physicsComp->Data().RealTimeFactor();
+    if (this->desiredRtf < 1e-9)
+    {
+      this->updatePeriod = 0ms;
+    }
+    else
+    {
+      this->updatePeriod = std::chrono::nanoseconds(
+          static_cast<int>(this->stepSize.count() / this->desiredRtf));
+    }
+  }
+
+  // Resume from the time it was saved at
+  this->currentInfo.simTime =
+      convert<std::chrono::steady_clock::duration>(_stats.sim_time());
+  this->currentInfo.iterations = _stats.iterations();
+
+  for (const auto &[entity, plugins] : _systems)
+  {
+    for (const auto &plugin : plugins.plugins())
+      this->LoadPlugin(entity, convert<sdf::Plugin>(plugin));
+  }
+}
+
+/////////////////////////////////////////////////
 void SimulationRunner::SetFuelUriMap(
     const std::unordered_map<std::string, std::string> &_map)
 {
@@ -26,9 +26,11 @@
 #include <functional>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -47,15 +49,18 @@
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/EventManager.hh"
 #include "ignition/gazebo/Export.hh"
+#include "ignition/gazebo/MessageBus.hh"
 #include "ignition/gazebo/ServerConfig.hh"
 #include "ignition/gazebo/SystemLoader.hh"
 #include "ignition/gazebo/Types.hh"
 
 #include "network/NetworkManager.hh"
 #include "LevelManager.hh"
+#include "SdfGenerator.hh"
 #include "SystemManager.hh"
 #include "Barrier.hh"
 #include "WorldControl.hh"
+#include "WorldCheckpoint.hh"
 
 using namespace std::chrono_literals;
 
@@ -74,9 +79,14 @@ namespace ignition
       /// \param[in] _world Pointer to the SDF world.
       /// \param[in] _systemLoader Reference to system manager.
       /// \param[in] _useLevels Whether to use levles or not. False by default.
+      /// \param[in] _fork Snapshot of the world this one is forked from, or
+      /// nullptr. A fork starts from the snapshot's entities, components,
+      /// time and systems instead of the ones in _world, which should be
+      /// empty.
       public: explicit SimulationRunner(const sdf::World *_world,
                                 const SystemLoaderPtr &_systemLoader,
-                                const ServerConfig &_config = ServerConfig());
+                                const ServerConfig &_config = ServerConfig(),
+                                const CheckpointSnapshot *_fork = nullptr);
 
       /// \brief Destructor.
       public: virtual ~SimulationRunner();
@@ -174,6 +184,10 @@ namespace ignition
       /// \return The current iteration count.
       public: uint64_t IterationCount() const;
 
+      /// \brief Get the name of the world being simulated.
+      /// \return The world name.
+      public: const std::string &WorldName() const;
+
       /// \brief Get the number of entities on the runner.
       /// \return Entity count.
       public: size_t EntityCount() const;
@@ -265,6 +279,15 @@ namespace ignition
       public: bool RequestRemoveEntity(const Entity _entity,
           bool _recursive = true);
 
+      /// \brief Take all entities and components, and the current time.
+      /// Components are shared with the snapshot rather than copied, and
+      /// copied on their next modification. Systems are first given a chance
+      /// to store their internal state, see events::BeforeSnapshot. This
+      /// must not be called while the runner is stepping.
+      /// \return Snapshot of the world, ordered so parents come before their
+      /// children, starting with the world entity. The path is left empty.
+      public: CheckpointSnapshot Snapshot();
+
       /// \brief Get the EventManager
       /// \return Reference to the event manager.
       public: EventManager &EventMgr();
@@ -377,6 +400,43 @@ namespace ignition
       /// See the newWorldControlState variable below.
       private: void ProcessNewWorldControlState();
 
+      /// \brief Callback for the checkpoint service. The checkpoint is taken
+      /// at the end of the current step, and written to the requested file
+      /// in the background.
+      /// \param[in] _req Path of the checkpoint file.
+      /// \param[out] _res True if the checkpoint was requested.
+      /// \return True if the request was received.
+      private: bool CheckpointService(const msgs::StringMsg &_req,
+                                      msgs::Boolean &_res);
+
+      /// \brief Take the checkpoints requested through the checkpoint
+      /// service. This copies all entities and components, which are then
+      /// serialized and written by the checkpoint writer.
+      private: void ProcessCheckpointRequests();
+
+      /// \brief Restore the world from a checkpoint. This replaces the
+      /// components of the empty world created when the runner was
+      /// constructed, recreates all other entities, and loads the systems
+      /// which were loaded when the checkpoint was taken.
+      /// \param[in] _path Path of the checkpoint file.
+      /// \return True if successful.
+      private: bool RestoreCheckpoint(const std::string &_path);
+
+      /// \brief Restore the world from a snapshot of another world in this
+      /// process. Like RestoreCheckpoint, but components are copied instead
+      /// of deserialized, and the world keeps its own name.
+      /// \param[in] _snapshot Snapshot of the other world.
+      /// \return True if successful.
+      private: bool RestoreSnapshot(const CheckpointSnapshot &_snapshot);
+
+      /// \brief Resume a restored world from the time it was saved at, with
+      /// its physics profile and systems.
+      /// \param[in] _stats Statistics of the world when it was saved.
+      /// \param[in] _systems Systems to load, with the entities they're
+      /// attached to.
+      private: void ResumeRestoredWorld(const msgs::WorldStatistics &_stats,
+          const std::vector<std::pair<Entity, msgs::Plugin_V>> &_systems);
+
       /// \brief This is used to indicate that a stop event has been received.
       private: std::atomic<bool> stopReceived{false};
 
@@ -399,6 +459,10 @@ namespace ignition
       /// \brief Manager of all components.
       private: EntityComponentManager entityCompMgr;
 
+      /// \brief Message bus shared by the systems of this world. Delivered
+      /// at the beginning of each step.
+      private: std::shared_ptr<MessageBus> msgBus;
+
       /// \brief Manager of all levels.
       private: std::unique_ptr<LevelManager> levelMgr;
 
@@ -513,6 +577,25 @@ namespace ignition
       /// \brief Map from file paths to Fuel URIs.
       private: std::unordered_map<std::string, std::string> fuelUriMap;
 
+      /// \brief Models generated by previous world SDF exports, reused by
+      /// the next export for models that haven't changed. Invalidated at the
+      /// end of every step.
+      private: sdf_generator::ExportCache sdfExportCache;
+
+      /// \brief Mutex to protect sdfExportCache, since exports are requested
+      /// from service callbacks.
+      private: std::mutex sdfExportCacheMutex;
+
+      /// \brief Files of the checkpoints requested since the last step.
+      private: std::vector<std::string> checkpointRequests;
+
+      /// \brief Mutex to protect checkpointRequests.
+      private: std::mutex checkpointMutex;
+
+      /// \brief Writes checkpoints in the background. Created with the
+      /// first checkpoint.
+      private: std::unique_ptr<CheckpointWriter> checkpointWriter;
+
       /// \brief True if Server::RunOnce triggered a blocking paused step
       private: bool blockingPausedStepPending{false};
 
@@ -15,8 +15,10 @@
  *
 */
 
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include <ignition/gazebo/SystemLoader.hh>
@@ -44,18 +46,10 @@ class ignition::gazebo::SystemLoaderPrivate
   public: bool InstantiateSystemPlugin(const sdf::Plugin &_sdfPlugin,
               ignition::plugin::PluginPtr &_gzPlugin)
   {
-    ignition::common::SystemPaths systemPaths;
-    systemPaths.SetPluginPathEnv(pluginPathEnv);
-
-    for (const auto &path : this->systemPluginPaths)
-      systemPaths.AddPluginPaths(path);
+    // Several worlds may load plugins at once
+    std::lock_guard<std::mutex> lock(this->mutex);
 
-    std::string homePath;
-    ignition::common::env(IGN_HOMEDIR, homePath);
-    systemPaths.AddPluginPaths(homePath + "/.ignition/gazebo/plugins");
-    systemPaths.AddPluginPaths(IGN_GAZEBO_PLUGIN_INSTALL_DIR);
-
-    auto pathToLib = systemPaths.FindSharedLibrary(_sdfPlugin.Filename());
+    auto pathToLib = this->FindLibrary(_sdfPlugin.Filename());
     if (pathToLib.empty())
     {
       // We assume ignition::gazebo corresponds to the levels feature
@@ -67,22 +61,29 @@ class ignition::gazebo::SystemLoaderPrivate
       return false;
     }
 
-    auto pluginNames = this->loader.LoadLib(pathToLib);
-    if (pluginNames.empty())
+    // Each library only needs to be loaded once, then all its plugins can be
+    // instantiated any number of times.
+    if (this->loadedLibraries.find(pathToLib) == this->loadedLibraries.end())
     {
-      ignerr << "Failed to load system plugin [" << _sdfPlugin.Filename() <<
-                "] : couldn't load library on path [" << pathToLib <<
-                "]." << std::endl;
-      return false;
-    }
+      auto pluginNames = this->loader.LoadLib(pathToLib);
+      if (pluginNames.empty())
+      {
+        ignerr << "Failed to load system plugin [" << _sdfPlugin.Filename() <<
+                  "] : couldn't load library on path [" << pathToLib <<
+                  "]." << std::endl;
+        return false;
+      }
 
-    auto pluginName = *pluginNames.begin();
-    if (pluginName.empty())
-    {
-      ignerr << "Failed to load system plugin [" << _sdfPlugin.Filename() <<
-                "] : couldn't load library on path [" << pathToLib <<
-                "]." << std::endl;
-      return false;
+      auto pluginName = *pluginNames.begin();
+      if (pluginName.empty())
+      {
+        ignerr << "Failed to load system plugin [" << _sdfPlugin.Filename() <<
+                  "] : couldn't load library on path [" << pathToLib <<
+                  "]." << std::endl;
+        return false;
+      }
+
+      this->loadedLibraries.insert(pathToLib);
     }
 
     _gzPlugin = this->loader.Instantiate(_sdfPlugin.Name());
@@ -107,6 +108,45 @@ class ignition::gazebo::SystemLoaderPrivate
     return true;
   }
 
+  //////////////////////////////////////////////////
+  /// \brief Find the shared library for a plugin. Must be called with the
+  /// mutex locked.
+  /// \param[in] _filename Library file name, as given in SDF.
+  /// \return Full path to the library, empty if not found.
+  public: std::string FindLibrary(const std::string &_filename)
+  {
+    // Searching the file system is slow, and worlds tend to use the same
+    // plugins, so found libraries are remembered until the search paths
+    // change.
+    std::string envPaths;
+    ignition::common::env(this->pluginPathEnv, envPaths);
+    if (envPaths != this->cachedEnvPaths)
+    {
+      this->libraryPaths.clear();
+      this->cachedEnvPaths = envPaths;
+    }
+
+    auto it = this->libraryPaths.find(_filename);
+    if (it != this->libraryPaths.end())
+      return it->second;
+
+    ignition::common::SystemPaths systemPaths;
+    systemPaths.SetPluginPathEnv(pluginPathEnv);
+
+    for (const auto &path : this->systemPluginPaths)
+      systemPaths.AddPluginPaths(path);
+
+    std::string homePath;
+    ignition::common::env(IGN_HOMEDIR, homePath);
+    systemPaths.AddPluginPaths(homePath + "/.ignition/gazebo/plugins");
+    systemPaths.AddPluginPaths(IGN_GAZEBO_PLUGIN_INSTALL_DIR);
+
+    auto pathToLib = systemPaths.FindSharedLibrary(_filename);
+    if (!pathToLib.empty())
+      this->libraryPaths[_filename] = pathToLib;
+    return pathToLib;
+  }
+
   // Default plugin search path environment variable
   public: std::string pluginPathEnv{"IGN_GAZEBO_SYSTEM_PLUGIN_PATH"};
 
@@ -118,6 +158,19 @@ class ignition::gazebo::SystemLoaderPrivate
 
   /// \brief System plugins that have instances loaded via the manager.
   public: std::unordered_set<SystemPluginPtr> systemPluginsAdded;
+
+  /// \brief Full paths of libraries found so far, keyed by file name.
+  public: std::unordered_map<std::string, std::string> libraryPaths;
+
+  /// \brief Value of the plugin path environment variable when
+  /// libraryPaths was filled.
+  public: std::string cachedEnvPaths;
+
+  /// \brief Full paths of libraries already loaded by the loader.
+  public: std::unordered_set<std::string> loadedLibraries;
+
+  /// \brief Protects all members, the loader is shared by all worlds.
+  public: std::mutex mutex;
 };
 
 //////////////////////////////////////////////////
@@ -132,7 +185,9 @@ SystemLoader::~SystemLoader() = default;
 //////////////////////////////////////////////////
 void SystemLoader::AddSystemPluginPath(const std::string &_path)
 {
-  this->dataPtr->systemPluginPaths.insert(_path);
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->systemPluginPaths.insert(_path).second)
+    this->dataPtr->libraryPaths.clear();
 }
 
 //////////////////////////////////////////////////
@@ -193,6 +248,7 @@ std::optional<SystemPluginPtr> SystemLoader::LoadPlugin(
 //////////////////////////////////////////////////
 std::string SystemLoader::PrettyStr() const
 {
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   return this->dataPtr->loader.PrettyStr();
 }
 
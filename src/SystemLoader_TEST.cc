@@ -67,3 +67,33 @@ TEST(SystemLoader, EmptyNames)
   auto system = sm.LoadPlugin(plugin);
   ASSERT_FALSE(system.has_value());
 }
+
+/////////////////////////////////////////////////
+TEST(SystemLoader, LoadTwice)
+{
+  gazebo::SystemLoader sm;
+
+  // Add test plugin to path (referenced in config)
+  auto testBuildPath = ignition::common::joinPaths(
+      std::string(PROJECT_BINARY_PATH), "lib");
+  sm.AddSystemPluginPath(testBuildPath);
+
+  sdf::Plugin plugin;
+  plugin.SetFilename(std::string("libignition-gazebo") +
+      IGNITION_GAZEBO_MAJOR_VERSION_STR + "-physics-system.so");
+  plugin.SetName("ignition::gazebo::systems::Physics");
+
+  // The library is only searched for and loaded once, but each load creates
+  // a new instance
+  auto system1 = sm.LoadPlugin(plugin);
+  ASSERT_TRUE(system1.has_value());
+  auto system2 = sm.LoadPlugin(plugin);
+  ASSERT_TRUE(system2.has_value());
+  EXPECT_NE(system1.value(), system2.value());
+  EXPECT_NE(system1.value()->QueryInterface<gazebo::System>(),
+      system2.value()->QueryInterface<gazebo::System>());
+
+  // Unknown plugins in a loaded library still fail
+  plugin.SetName("ignition::gazebo::systems::NotAPlugin");
+  EXPECT_FALSE(sm.LoadPlugin(plugin).has_value());
+}
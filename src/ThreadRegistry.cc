@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "ignition/gazebo/ThreadRegistry.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief A registered thread.
+struct RegisteredThread
+{
+  /// \brief Name of the thread.
+  std::string name;
+
+  /// \brief Class of the thread.
+  ThreadClass threadClass{ThreadClass::kSimulation};
+
+  /// \brief Operating system id of the thread.
+  uint64_t id{0};
+
+#ifdef __linux__
+  /// \brief Handle used to change the affinity of the thread.
+  pthread_t handle;
+
+  /// \brief Affinity of the thread before it was registered.
+  cpu_set_t previous;
+
+  /// \brief Whether previous holds a valid mask.
+  bool hasPrevious{false};
+
+  /// \brief Name of the thread before it was registered, empty if it
+  /// couldn't be read.
+  std::string previousName;
+#endif
+};
+
+/// \brief Private data for ThreadRegistry
+class ignition::gazebo::ThreadRegistryPrivate
+{
+  /// \brief Place a thread on the cores of its class. Must be called with
+  /// the mutex locked.
+  /// \param[in] _thread The thread.
+  public: void ApplyLocked(const RegisteredThread &_thread) const;
+
+  /// \brief Cores of each class of threads. Classes without cores run
+  /// anywhere.
+  public: std::map<ThreadClass, std::set<unsigned int>> affinity;
+
+  /// \brief Registered threads, keyed by their id.
+  public: std::map<uint64_t, RegisteredThread> threads;
+
+  /// \brief Protects affinity and threads.
+  public: mutable std::mutex mutex;
+};
+
+namespace
+{
+/// \brief Get the operating system id of the calling thread.
+/// \return Thread id.
+uint64_t currentThreadId()
+{
+#ifdef __linux__
+  return static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+  return std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+}
+
+#ifdef __linux__
+/// \brief Read the statistics of a thread from /proc.
+/// \param[in, out] _stats Statistics, with the id already set.
+void readProcStatistics(ThreadStatistics &_stats)
+{
+  const std::string dir = "/proc/self/task/" + std::to_string(_stats.id);
+
+  // The thread name in the stat file may contain spaces and parentheses,
+  // so fields are counted from the last closing parenthesis.
+  std::ifstream statFile(dir + "/stat");
+  std::string line;
+  if (std::getline(statFile, line))
+  {
+    auto end = line.rfind(')');
+    if (end != std::string::npos)
+    {
+      // The first field after the name is the 3rd field of the file.
+      std::istringstream fields(line.substr(end + 1));
+      std::vector<std::string> values;
+      std::string value;
+      while (fields >> value)
+        values.push_back(value);
+
+      const std::size_t kUtime = 14 - 3;
+      const std::size_t kStime = 15 - 3;
+      const std::size_t kProcessor = 39 - 3;
+      if (values.size() > kProcessor)
+      {
+        static const long ticksPerSecond = sysconf(_SC_CLK_TCK);
+        const auto ticks = std::stoull(values[kUtime]) +
+            std::stoull(values[kStime]);
+        if (ticksPerSecond > 0)
+        {
+          _stats.cpuTime = std::chrono::duration_cast<
+              std::chrono::steady_clock::duration>(
+              std::chrono::duration<double>(
+              static_cast<double>(ticks) / ticksPerSecond));
+        }
+        _stats.lastCore = std::stoi(values[kProcessor]);
+      }
+    }
+  }
+
+  std::ifstream statusFile(dir + "/status");
+  while (std::getline(statusFile, line))
+  {
+    const std::string key = "nonvoluntary_ctxt_switches:";
+    if (line.compare(0, key.size(), key) == 0)
+      _stats.involuntarySwitches = std::stoull(line.substr(key.size()));
+  }
+
+  // Only available on kernels with scheduler debugging
+  std::ifstream schedFile(dir + "/sched");
+  while (std::getline(schedFile, line))
+  {
+    const std::string key = "se.nr_migrations";
+    if (line.compare(0, key.size(), key) == 0)
+    {
+      auto colon = line.find(':');
+      if (colon != std::string::npos)
+        _stats.migrations = std::stoull(line.substr(colon + 1));
+    }
+  }
+}
+#endif
+}
+
+//////////////////////////////////////////////////
+void ThreadRegistryPrivate::ApplyLocked(const RegisteredThread &_thread) const
+{
+#ifdef __linux__
+  cpu_set_t mask;
+  auto it = this->affinity.find(_thread.threadClass);
+  if (it == this->affinity.end() || it->second.empty())
+  {
+    if (!_thread.hasPrevious)
+      return;
+    mask = _thread.previous;
+  }
+  else
+  {
+    CPU_ZERO(&mask);
+    for (auto core : it->second)
+    {
+      if (core < CPU_SETSIZE)
+        CPU_SET(core, &mask);
+    }
+  }
+
+  int result = pthread_setaffinity_np(_thread.handle, sizeof(mask), &mask);
+  if (result != 0)
+  {
+    ignwarn << "Failed to set the affinity of thread [" << _thread.name
+            << "]: " << strerror(result) << std::endl;
+  }
+#else
+  (void)_thread;
+#endif
+}
+
+//////////////////////////////////////////////////
+ThreadRegistry::ThreadRegistry()
+  : dataPtr(std::make_unique<ThreadRegistryPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+ThreadRegistry::~ThreadRegistry() = default;
+
+//////////////////////////////////////////////////
+ThreadRegistry &ThreadRegistry::Instance()
+{
+  static ThreadRegistry instance;
+  return instance;
+}
+
+//////////////////////////////////////////////////
+void ThreadRegistry::SetAffinity(ThreadClass _class,
+    const std::set<unsigned int> &_cores)
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto &cores = this->dataPtr->affinity[_class];
+  if (cores == _cores)
+    return;
+  cores = _cores;
+
+  for (const auto &thread : this->dataPtr->threads)
+  {
+    if (thread.second.threadClass == _class)
+      this->dataPtr->ApplyLocked(thread.second);
+  }
+}
+
+//////////////////////////////////////////////////
+std::set<unsigned int> ThreadRegistry::Affinity(ThreadClass _class) const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto it = this->dataPtr->affinity.find(_class);
+  if (it == this->dataPtr->affinity.end())
+    return {};
+  return it->second;
+}
+
+//////////////////////////////////////////////////
+void ThreadRegistry::Register(ThreadClass _class, const std::string &_name)
+{
+  RegisteredThread thread;
+  thread.name = _name;
+  thread.threadClass = _class;
+  thread.id = currentThreadId();
+
+#ifdef __linux__
+  thread.handle = pthread_self();
+  thread.hasPrevious = pthread_getaffinity_np(thread.handle,
+      sizeof(thread.previous), &thread.previous) == 0;
+
+  // Names are limited to 16 bytes, including the terminator
+  char previousName[16];
+  if (pthread_getname_np(thread.handle, previousName,
+      sizeof(previousName)) == 0)
+  {
+    thread.previousName = previousName;
+  }
+  pthread_setname_np(thread.handle, _name.substr(0, 15).c_str());
+#endif
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->ApplyLocked(thread);
+  this->dataPtr->threads[thread.id] = thread;
+}
+
+//////////////////////////////////////////////////
+void ThreadRegistry::Unregister()
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  auto it = this->dataPtr->threads.find(currentThreadId());
+  if (it == this->dataPtr->threads.end())
+    return;
+
+#ifdef __linux__
+  if (it->second.hasPrevious)
+  {
+    pthread_setaffinity_np(it->second.handle, sizeof(it->second.previous),
+        &it->second.previous);
+  }
+  if (!it->second.previousName.empty())
+  {
+    pthread_setname_np(it->second.handle,
+        it->second.previousName.c_str());
+  }
+#endif
+  this->dataPtr->threads.erase(it);
+}
+
+//////////////////////////////////////////////////
+std::vector<ThreadStatistics> ThreadRegistry::Statistics() const
+{
+  std::vector<ThreadStatistics> result;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    for (const auto &thread : this->dataPtr->threads)
+    {
+      ThreadStatistics stats;
+      stats.name = thread.second.name;
+      stats.threadClass = thread.second.threadClass;
+      stats.id = thread.second.id;
+      result.push_back(stats);
+    }
+  }
+
+#ifdef __linux__
+  // Read files without the lock, threads registering shouldn't wait on it
+  for (auto &stats : result)
+    readProcStatistics(stats);
+#endif
+  return result;
+}
+
+//////////////////////////////////////////////////
+ScopedThreadRegistration::ScopedThreadRegistration(ThreadClass _class,
+    const std::string &_name)
+{
+  ThreadRegistry::Instance().Register(_class, _name);
+}
+
+//////////////////////////////////////////////////
+ScopedThreadRegistration::~ScopedThreadRegistration()
+{
+  ThreadRegistry::Instance().Unregister();
+}
+
+//////////////////////////////////////////////////
+std::string ignition::gazebo::threadClassName(ThreadClass _class)
+{
+  switch (_class)
+  {
+    case ThreadClass::kSimulation:
+      return "simulation";
+    case ThreadClass::kPostUpdate:
+      return "post_update";
+    case ThreadClass::kState:
+      return "state";
+    case ThreadClass::kRendering:
+      return "rendering";
+    default:
+      return "unknown";
+  }
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "ignition/gazebo/ThreadRegistry.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/////////////////////////////////////////////////
+/// \brief Get a core the process is allowed to run on.
+/// \return Core index.
+unsigned int allowedCore()
+{
+#ifdef __linux__
+  cpu_set_t mask;
+  if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+  {
+    for (unsigned int core = 0; core < CPU_SETSIZE; ++core)
+    {
+      if (CPU_ISSET(core, &mask))
+        return core;
+    }
+  }
+#endif
+  return 0;
+}
+
+/////////////////////////////////////////////////
+TEST(ThreadRegistry, Affinity)
+{
+  auto &registry = ThreadRegistry::Instance();
+  EXPECT_TRUE(registry.Affinity(ThreadClass::kState).empty());
+
+  registry.SetAffinity(ThreadClass::kState, {0});
+  EXPECT_EQ(std::set<unsigned int>({0}),
+      registry.Affinity(ThreadClass::kState));
+  EXPECT_TRUE(registry.Affinity(ThreadClass::kRendering).empty());
+
+  registry.SetAffinity(ThreadClass::kState, {});
+  EXPECT_TRUE(registry.Affinity(ThreadClass::kState).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(ThreadRegistry, RegisterAndStatistics)
+{
+  const unsigned int core = allowedCore();
+  auto &registry = ThreadRegistry::Instance();
+  registry.SetAffinity(ThreadClass::kPostUpdate, {core});
+
+  std::atomic<bool> registered{false};
+  std::atomic<bool> done{false};
+  std::thread thread([&]()
+  {
+    ScopedThreadRegistration registration(ThreadClass::kPostUpdate,
+        "test_thread_with_a_long_name");
+
+#ifdef __linux__
+    cpu_set_t mask;
+    ASSERT_EQ(0, pthread_getaffinity_np(pthread_self(), sizeof(mask), &mask));
+    EXPECT_EQ(1, CPU_COUNT(&mask));
+    EXPECT_TRUE(CPU_ISSET(core, &mask));
+
+    char name[16];
+    ASSERT_EQ(0, pthread_getname_np(pthread_self(), name, sizeof(name)));
+    EXPECT_EQ("test_thread_wit", std::string(name));
+#endif
+
+    // Spin for a while so there's some CPU time
+    volatile unsigned int count = 0;
+    while (count < 10000000u)
+      count = count + 1;
+
+    registered = true;
+    while (!done)
+      std::this_thread::yield();
+  });
+
+  while (!registered)
+    std::this_thread::yield();
+
+  auto stats = registry.Statistics();
+  auto it = std::find_if(stats.begin(), stats.end(),
+      [](const ThreadStatistics &_stats)
+      {
+        return _stats.name == "test_thread_with_a_long_name";
+      });
+  ASSERT_NE(stats.end(), it);
+  EXPECT_EQ(ThreadClass::kPostUpdate, it->threadClass);
+  EXPECT_NE(0u, it->id);
+#ifdef __linux__
+  EXPECT_GT(it->cpuTime.count(), 0);
+  EXPECT_EQ(static_cast<int>(core), it->lastCore);
+#endif
+
+  done = true;
+  thread.join();
+
+  // Unregistered when the registration went out of scope
+  stats = registry.Statistics();
+  EXPECT_TRUE(std::none_of(stats.begin(), stats.end(),
+      [](const ThreadStatistics &_stats)
+      {
+        return _stats.name == "test_thread_with_a_long_name";
+      }));
+
+  registry.SetAffinity(ThreadClass::kPostUpdate, {});
+}
+
+/////////////////////////////////////////////////
+TEST(ThreadRegistry, UnregisterRestoresAffinityAndName)
+{
+#ifdef __linux__
+  cpu_set_t before;
+  ASSERT_EQ(0, pthread_getaffinity_np(pthread_self(), sizeof(before),
+      &before));
+
+  char nameBefore[16];
+  ASSERT_EQ(0, pthread_getname_np(pthread_self(), nameBefore,
+      sizeof(nameBefore)));
+#endif
+
+  auto &registry = ThreadRegistry::Instance();
+  registry.SetAffinity(ThreadClass::kRendering, {allowedCore()});
+  registry.Register(ThreadClass::kRendering, "test_restore");
+
+#ifdef __linux__
+  cpu_set_t during;
+  ASSERT_EQ(0, pthread_getaffinity_np(pthread_self(), sizeof(during),
+      &during));
+  EXPECT_EQ(1, CPU_COUNT(&during));
+#endif
+
+  registry.Unregister();
+  registry.SetAffinity(ThreadClass::kRendering, {});
+
+#ifdef __linux__
+  cpu_set_t after;
+  ASSERT_EQ(0, pthread_getaffinity_np(pthread_self(), sizeof(after),
+      &after));
+  EXPECT_TRUE(CPU_EQUAL(&before, &after));
+
+  char nameAfter[16];
+  ASSERT_EQ(0, pthread_getname_np(pthread_self(), nameAfter,
+      sizeof(nameAfter)));
+  EXPECT_EQ(std::string(nameBefore), std::string(nameAfter));
+#endif
+}
+
+/////////////////////////////////////////////////
+TEST(ThreadRegistry, ClassName)
+{
+  EXPECT_EQ("simulation", threadClassName(ThreadClass::kSimulation));
+  EXPECT_EQ("post_update", threadClassName(ThreadClass::kPostUpdate));
+  EXPECT_EQ("state", threadClassName(ThreadClass::kState));
+  EXPECT_EQ("rendering", threadClassName(ThreadClass::kRendering));
+}
@@ -179,6 +179,24 @@ void View::Reset()
   this->missingCompTracker.clear();
 }
 
+//////////////////////////////////////////////////
+void View::ReplaceComponent(const Entity _entity, const std::size_t _index,
+    components::BaseComponent *_comp)
+{
+  auto replace = [&](auto &_data, auto *_ptr)
+  {
+    auto it = _data.find(_entity);
+    if (it != _data.end() && _index < it->second.size())
+      it->second[_index] = _ptr;
+  };
+  replace(this->validData, _comp);
+  replace(this->invalidData, _comp);
+  replace(this->validConstData,
+      static_cast<const components::BaseComponent *>(_comp));
+  replace(this->invalidConstData,
+      static_cast<const components::BaseComponent *>(_comp));
+}
+
 }  // namespace detail
 }  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
 }  // namespace gazebo
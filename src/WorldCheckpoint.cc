@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "WorldCheckpoint.hh"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Profiler.hh>
+
+#include "ignition/gazebo/components/Factory.hh"
+
+class ignition::gazebo::CheckpointWriterPrivate
+{
+  /// \brief Write queued snapshots until stopped.
+  public: void Run();
+
+  /// \brief Snapshots waiting to be written.
+  public: std::deque<CheckpointSnapshot> queue;
+
+  /// \brief True while a snapshot is being written.
+  public: bool writing{false};
+
+  /// \brief Set to stop the thread once the queue is empty.
+  public: bool stop{false};
+
+  /// \brief Protects queue, writing and stop.
+  public: std::mutex mutex;
+
+  /// \brief Signals changes to queue, writing and stop.
+  public: std::condition_variable cv;
+
+  /// \brief Writing thread.
+  public: std::thread thread;
+};
+
+using namespace ignition;
+using namespace gazebo;
+
+namespace
+{
+/// \brief Starts every checkpoint file, the last character is the version
+/// of the format.
+const std::string kCheckpointMagic{"IGNCKPT1"};
+
+/// \brief Key of the world name in the header of the world statistics.
+const std::string kWorldNameKey{"world_name"};
+
+//////////////////////////////////////////////////
+/// \brief Write a message prefixed by its size.
+/// \param[in] _msg Message to write.
+/// \param[in] _out Stream to write to.
+/// \return True if successful.
+bool writeDelimited(const google::protobuf::MessageLite &_msg,
+    google::protobuf::io::CodedOutputStream &_out)
+{
+  const auto size = _msg.ByteSizeLong();
+  if (size > static_cast<size_t>(std::numeric_limits<int>::max()))
+    return false;
+
+  _out.WriteVarint32(static_cast<uint32_t>(size));
+  _msg.SerializeWithCachedSizes(&_out);
+  return !_out.HadError();
+}
+
+//////////////////////////////////////////////////
+/// \brief Read a message prefixed by its size. A size of zero marks the end
+/// of the file.
+/// \param[out] _msg Message to read.
+/// \param[in] _in Stream to read from.
+/// \param[out] _end Set to true if the end of the file was reached instead.
+/// \return True if successful.
+bool readDelimited(google::protobuf::MessageLite &_msg,
+    google::protobuf::io::ZeroCopyInputStream &_in, bool &_end)
+{
+  // One coded stream per message, so that protobuf's limit on the number of
+  // bytes read applies to each message and not to the whole file.
+  google::protobuf::io::CodedInputStream coded(&_in);
+
+  uint32_t size;
+  if (!coded.ReadVarint32(&size))
+    return false;
+
+  _end = size == 0;
+  if (_end)
+    return true;
+
+  auto limit = coded.PushLimit(static_cast<int>(size));
+  if (!_msg.ParseFromCodedStream(&coded) || !coded.ConsumedEntireMessage())
+    return false;
+  coded.PopLimit(limit);
+  return true;
+}
+
+//////////////////////////////////////////////////
+/// \brief Read a checkpoint file.
+/// \param[in] _path Path to the file.
+/// \param[out] _stats World statistics.
+/// \param[out] _state Entities, or nullptr to only read the statistics.
+/// \return True if successful.
+bool readCheckpointFile(const std::string &_path,
+    msgs::WorldStatistics &_stats, msgs::SerializedState *_state)
+{
+  IGN_PROFILE("readCheckpoint");
+
+  std::ifstream file(_path, std::ios::binary);
+  if (!file)
+  {
+    ignerr << "Failed to open checkpoint [" << _path << "]." << std::endl;
+    return false;
+  }
+
+  std::string magic(kCheckpointMagic.size(), '\0');
+  file.read(&magic[0], magic.size());
+  if (!file || magic != kCheckpointMagic)
+  {
+    ignerr << "File [" << _path << "] is not a checkpoint, or it was written "
+           << "by an incompatible version." << std::endl;
+    return false;
+  }
+
+  google::protobuf::io::IstreamInputStream zeroCopy(&file);
+
+  bool end{false};
+  if (!readDelimited(_stats, zeroCopy, end) || end)
+  {
+    ignerr << "Failed to read the header of checkpoint [" << _path << "]."
+           << std::endl;
+    return false;
+  }
+
+  if (nullptr == _state)
+    return true;
+
+  _state->Clear();
+  _state->mutable_header()->CopyFrom(_stats.header());
+  std::unordered_set<ComponentTypeId> unknownTypes;
+  while (true)
+  {
+    msgs::SerializedEntity entityMsg;
+    if (!readDelimited(entityMsg, zeroCopy, end))
+    {
+      ignerr << "Checkpoint [" << _path << "] is truncated or corrupt, read ["
+             << _state->entities_size() << "] entities." << std::endl;
+      return false;
+    }
+    if (end)
+      break;
+
+    // Components registered by plugins which aren't loaded in this process
+    // can't be restored
+    auto *comps = entityMsg.mutable_components();
+    for (auto it = comps->begin(); it != comps->end();)
+    {
+      if (components::Factory::Instance()->HasType(it->type()))
+      {
+        ++it;
+        continue;
+      }
+
+      if (unknownTypes.insert(it->type()).second)
+      {
+        ignwarn << "Component type [" << it->type() << "] of checkpoint ["
+                << _path << "] has not been registered in this process, so "
+                << "it won't be restored." << std::endl;
+      }
+      it = comps->erase(it);
+    }
+
+    _state->add_entities()->Swap(&entityMsg);
+  }
+
+  return true;
+}
+}
+
+//////////////////////////////////////////////////
+void CheckpointWriterPrivate::Run()
+{
+  while (true)
+  {
+    CheckpointSnapshot snapshot;
+    {
+      std::unique_lock<std::mutex> lock(this->mutex);
+      this->cv.wait(lock, [this]
+      {
+        return this->stop || !this->queue.empty();
+      });
+
+      // Only stop once everything was written
+      if (this->queue.empty())
+        return;
+
+      snapshot = std::move(this->queue.front());
+      this->queue.pop_front();
+      this->writing = true;
+    }
+
+    if (writeCheckpoint(snapshot))
+    {
+      ignmsg << "Saved checkpoint of world [" << snapshot.worldName
+             << "] to [" << snapshot.path << "]." << std::endl;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->writing = false;
+    }
+    this->cv.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+CheckpointWriter::CheckpointWriter()
+  : dataPtr(std::make_unique<CheckpointWriterPrivate>())
+{
+  this->dataPtr->thread =
+      std::thread(&CheckpointWriterPrivate::Run, this->dataPtr.get());
+}
+
+//////////////////////////////////////////////////
+CheckpointWriter::~CheckpointWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->cv.notify_all();
+  this->dataPtr->thread.join();
+}
+
+//////////////////////////////////////////////////
+void CheckpointWriter::Write(CheckpointSnapshot &&_snapshot)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->queue.push_back(std::move(_snapshot));
+  }
+  this->dataPtr->cv.notify_all();
+}
+
+//////////////////////////////////////////////////
+void CheckpointWriter::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->cv.wait(lock, [this]
+  {
+    return this->dataPtr->queue.empty() && !this->dataPtr->writing;
+  });
+}
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE
+{
+//////////////////////////////////////////////////
+bool writeCheckpoint(const CheckpointSnapshot &_snapshot)
+{
+  IGN_PROFILE("writeCheckpoint");
+
+  // Write next to the destination, and move once complete
+  const std::string tmpPath = _snapshot.path + ".tmp";
+
+  std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+  if (!file)
+  {
+    ignerr << "Failed to open [" << tmpPath << "] to write checkpoint."
+           << std::endl;
+    return false;
+  }
+  file.write(kCheckpointMagic.data(), kCheckpointMagic.size());
+
+  bool success{true};
+  {
+    google::protobuf::io::OstreamOutputStream zeroCopy(&file);
+    google::protobuf::io::CodedOutputStream coded(&zeroCopy);
+
+    msgs::WorldStatistics stats(_snapshot.stats);
+    auto data = stats.mutable_header()->add_data();
+    data->set_key(kWorldNameKey);
+    data->add_value(_snapshot.worldName);
+    success = writeDelimited(stats, coded);
+
+    msgs::SerializedEntity entityMsg;
+    for (const auto &entity : _snapshot.entities)
+    {
+      if (!success)
+        break;
+
+      entityMsg.Clear();
+      entityMsg.set_id(entity.entity);
+      for (const auto &comp : entity.components)
+      {
+        // Components without data, such as tags, have an empty payload
+        std::ostringstream ostr;
+        comp->Serialize(ostr);
+
+        auto compMsg = entityMsg.add_components();
+        compMsg->set_type(comp->TypeId());
+        compMsg->set_component(ostr.str());
+      }
+      success = writeDelimited(entityMsg, coded);
+    }
+
+    // End of the file
+    coded.WriteVarint32(0);
+    success = success && !coded.HadError();
+  }
+
+  file.close();
+  if (!success || file.fail())
+  {
+    ignerr << "Failed to write checkpoint to [" << tmpPath << "]."
+           << std::endl;
+    common::removeFile(tmpPath);
+    return false;
+  }
+
+  if (!common::moveFile(tmpPath, _snapshot.path))
+  {
+    ignerr << "Failed to move checkpoint from [" << tmpPath << "] to ["
+           << _snapshot.path << "]." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool readCheckpointHeader(const std::string &_path,
+                          msgs::WorldStatistics &_stats)
+{
+  return readCheckpointFile(_path, _stats, nullptr);
+}
+
+//////////////////////////////////////////////////
+bool readCheckpoint(const std::string &_path,
+                    msgs::WorldStatistics &_stats,
+                    msgs::SerializedState &_state)
+{
+  return readCheckpointFile(_path, _stats, &_state);
+}
+
+//////////////////////////////////////////////////
+std::string checkpointWorldName(const msgs::WorldStatistics &_stats)
+{
+  for (const auto &data : _stats.header().data())
+  {
+    if (data.key() == kWorldNameKey && data.value_size() > 0)
+      return data.value(0);
+  }
+  return std::string();
+}
+}
+}  // namespace gazebo
+}  // namespace ignition
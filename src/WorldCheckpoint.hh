@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_WORLDCHECKPOINT_HH_
+#define IGNITION_GAZEBO_WORLDCHECKPOINT_HH_
+
+#include <ignition/msgs/serialized.pb.h>
+#include <ignition/msgs/world_stats.pb.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+#include <ignition/gazebo/Entity.hh>
+#include <ignition/gazebo/components/Component.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class CheckpointWriterPrivate;
+
+    /// \brief Components of an entity, taken from the entity component
+    /// manager when a checkpoint is taken.
+    struct CheckpointEntity
+    {
+      /// \brief Entity id.
+      Entity entity{kNullEntity};
+
+      /// \brief All the components of the entity. They're shared with the
+      /// entity component manager, which copies them before modifying them.
+      std::vector<std::shared_ptr<const components::BaseComponent>>
+          components;
+    };
+
+    /// \brief Copy of a world taken between two simulation steps. Taking the
+    /// copy is all that happens on the simulation thread, serializing and
+    /// writing it is left to CheckpointWriter.
+    struct CheckpointSnapshot
+    {
+      /// \brief File to write the checkpoint to.
+      std::string path;
+
+      /// \brief Name of the world.
+      std::string worldName;
+
+      /// \brief Simulation time, real time, iterations and paused state at
+      /// the time of the checkpoint.
+      msgs::WorldStatistics stats;
+
+      /// \brief All entities, with parents before their children so they
+      /// can be recreated in order.
+      std::vector<CheckpointEntity> entities;
+    };
+
+    /// \class CheckpointWriter WorldCheckpoint.hh
+    /// \brief Writes checkpoint snapshots to files on a background thread,
+    /// in the order they're queued.
+    class IGNITION_GAZEBO_VISIBLE CheckpointWriter
+    {
+      /// \brief Constructor. Starts the writing thread.
+      public: CheckpointWriter();
+
+      /// \brief Destructor. Writes all queued snapshots before returning.
+      public: ~CheckpointWriter();
+
+      /// \brief Queue a snapshot to be written.
+      /// \param[in] _snapshot Snapshot to write.
+      public: void Write(CheckpointSnapshot &&_snapshot);
+
+      /// \brief Block until all queued snapshots have been written.
+      public: void Flush();
+
+      /// \brief Pointer to private data.
+      private: std::unique_ptr<CheckpointWriterPrivate> dataPtr;
+    };
+
+    /// \brief Write a checkpoint file.
+    ///
+    /// The file holds the world statistics followed by one
+    /// msgs::SerializedEntity per entity, each prefixed by its size, so it's
+    /// written one entity at a time and never held in memory at once.
+    /// Components are serialized with their own serializers. Components
+    /// whose serializers write nothing, such as tags, are written with an
+    /// empty payload and restored with their default value. The file is
+    /// first written next to its destination and then moved, so an
+    /// interrupted write doesn't destroy a previous checkpoint.
+    /// \param[in] _snapshot Snapshot to write.
+    /// \return True if the file was written.
+    IGNITION_GAZEBO_VISIBLE
+    bool writeCheckpoint(const CheckpointSnapshot &_snapshot);
+
+    /// \brief Read the world statistics of a checkpoint file, without
+    /// reading its entities.
+    /// \param[in] _path Path to the checkpoint file.
+    /// \param[out] _stats World statistics at the time of the checkpoint.
+    /// \return True if the file is a checkpoint and it could be read.
+    IGNITION_GAZEBO_VISIBLE
+    bool readCheckpointHeader(const std::string &_path,
+                              msgs::WorldStatistics &_stats);
+
+    /// \brief Read a checkpoint file.
+    /// \param[in] _path Path to the checkpoint file.
+    /// \param[out] _stats World statistics at the time of the checkpoint.
+    /// \param[out] _state All entities and their components, with parents
+    /// before their children. Components of types which aren't registered in
+    /// this process are left out.
+    /// \return True if the whole file could be read.
+    IGNITION_GAZEBO_VISIBLE
+    bool readCheckpoint(const std::string &_path,
+                        msgs::WorldStatistics &_stats,
+                        msgs::SerializedState &_state);
+
+    /// \brief Get the name of the world a checkpoint was taken from.
+    /// \param[in] _stats World statistics read from the checkpoint.
+    /// \return Name of the world, empty if it's missing.
+    IGNITION_GAZEBO_VISIBLE
+    std::string checkpointWorldName(const msgs::WorldStatistics &_stats);
+    }  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
+  }  // namespace gazebo
+}  // namespace ignition
+
+#endif  // IGNITION_GAZEBO_WORLDCHECKPOINT_HH_
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/World.hh"
+#include "ignition/gazebo/test_config.hh"
+
+#include "helpers/EnvTestFixture.hh"
+
+#include "WorldCheckpoint.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Component which isn't registered with the factory, like those of
+/// plugins which aren't loaded.
+using UnregisteredComponent =
+    components::Component<int, class UnregisteredComponentTag>;
+
+/// \brief Test fixture which writes checkpoints to the build directory.
+class WorldCheckpointTest : public InternalFixture<::testing::Test>
+{
+  // Documentation inherited
+  protected: void SetUp() override
+  {
+    InternalFixture::SetUp();
+
+    this->path = common::joinPaths(PROJECT_BINARY_PATH,
+        "WorldCheckpoint_TEST.ckpt");
+    common::removeFile(this->path);
+  }
+
+  // Documentation inherited
+  protected: void TearDown() override
+  {
+    common::removeFile(this->path);
+  }
+
+  /// \brief Snapshot of a world with a single model.
+  /// \return The snapshot.
+  public: CheckpointSnapshot Snapshot() const
+  {
+    CheckpointSnapshot snapshot;
+    snapshot.path = this->path;
+    snapshot.worldName = "checkpoint_world";
+    snapshot.stats.set_iterations(1234);
+    snapshot.stats.set_paused(true);
+    snapshot.stats.mutable_sim_time()->set_sec(1);
+    snapshot.stats.mutable_sim_time()->set_nsec(234000000);
+
+    CheckpointEntity world;
+    world.entity = 1;
+    world.components.push_back(std::make_unique<components::World>());
+    world.components.push_back(
+        std::make_unique<components::Name>("checkpoint_world"));
+    snapshot.entities.push_back(std::move(world));
+
+    CheckpointEntity model;
+    model.entity = 5;
+    model.components.push_back(std::make_unique<components::Model>());
+    model.components.push_back(std::make_unique<components::Name>("box"));
+    model.components.push_back(std::make_unique<components::Pose>(
+        math::Pose3d(1, 2, 3, 0, 0, 0.5)));
+    model.components.push_back(std::make_unique<components::ParentEntity>(1));
+    model.components.push_back(std::make_unique<UnregisteredComponent>(7));
+    snapshot.entities.push_back(std::move(model));
+
+    return snapshot;
+  }
+
+  /// \brief Path to the checkpoint file.
+  public: std::string path;
+};
+
+/////////////////////////////////////////////////
+TEST_F(WorldCheckpointTest, WriteRead)
+{
+  ASSERT_TRUE(writeCheckpoint(this->Snapshot()));
+  EXPECT_TRUE(common::exists(this->path));
+  EXPECT_FALSE(common::exists(this->path + ".tmp"));
+
+  // Header only
+  msgs::WorldStatistics headerStats;
+  ASSERT_TRUE(readCheckpointHeader(this->path, headerStats));
+  EXPECT_EQ(1234u, headerStats.iterations());
+  EXPECT_TRUE(headerStats.paused());
+  EXPECT_EQ(1, headerStats.sim_time().sec());
+  EXPECT_EQ(234000000, headerStats.sim_time().nsec());
+  EXPECT_EQ("checkpoint_world", checkpointWorldName(headerStats));
+
+  // Whole file
+  msgs::WorldStatistics stats;
+  msgs::SerializedState state;
+  ASSERT_TRUE(readCheckpoint(this->path, stats, state));
+  EXPECT_EQ(1234u, stats.iterations());
+  EXPECT_EQ("checkpoint_world", checkpointWorldName(stats));
+
+  ASSERT_EQ(2, state.entities_size());
+  EXPECT_EQ(1u, state.entities(0).id());
+  EXPECT_EQ(5u, state.entities(1).id());
+
+  // Components without data, such as World and Model, have an empty
+  // payload. Unregistered components are left out.
+  const auto &modelMsg = state.entities(1);
+  EXPECT_EQ(4, modelMsg.components_size());
+  bool foundModel{false};
+  bool foundPose{false};
+  bool foundName{false};
+  bool foundParent{false};
+  for (const auto &compMsg : modelMsg.components())
+  {
+    std::istringstream istr(compMsg.component());
+    if (compMsg.type() == components::Model::typeId)
+    {
+      EXPECT_TRUE(compMsg.component().empty());
+      foundModel = true;
+    }
+    else if (compMsg.type() == components::Pose::typeId)
+    {
+      components::Pose pose;
+      pose.Deserialize(istr);
+      EXPECT_EQ(math::Pose3d(1, 2, 3, 0, 0, 0.5), pose.Data());
+      foundPose = true;
+    }
+    else if (compMsg.type() == components::Name::typeId)
+    {
+      components::Name name;
+      name.Deserialize(istr);
+      EXPECT_EQ("box", name.Data());
+      foundName = true;
+    }
+    else if (compMsg.type() == components::ParentEntity::typeId)
+    {
+      components::ParentEntity parent;
+      parent.Deserialize(istr);
+      EXPECT_EQ(1u, parent.Data());
+      foundParent = true;
+    }
+  }
+  EXPECT_TRUE(foundModel);
+  EXPECT_TRUE(foundPose);
+  EXPECT_TRUE(foundName);
+  EXPECT_TRUE(foundParent);
+}
+
+/////////////////////////////////////////////////
+TEST_F(WorldCheckpointTest, Invalid)
+{
+  msgs::WorldStatistics stats;
+  msgs::SerializedState state;
+
+  // Missing file
+  EXPECT_FALSE(readCheckpointHeader(this->path, stats));
+  EXPECT_FALSE(readCheckpoint(this->path, stats, state));
+
+  // Not a checkpoint
+  {
+    std::ofstream file(this->path);
+    file << "<?xml version='1.0'?><sdf version='1.6'></sdf>";
+  }
+  EXPECT_FALSE(readCheckpointHeader(this->path, stats));
+  EXPECT_FALSE(readCheckpoint(this->path, stats, state));
+
+  // Truncated, the header can still be read but not the entities
+  ASSERT_TRUE(writeCheckpoint(this->Snapshot()));
+  std::string contents;
+  {
+    std::ifstream file(this->path, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+  }
+  ASSERT_GT(contents.size(), 10u);
+  {
+    std::ofstream file(this->path, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size() - 10);
+  }
+  EXPECT_TRUE(readCheckpointHeader(this->path, stats));
+  EXPECT_FALSE(readCheckpoint(this->path, stats, state));
+
+  // Unwritable destination
+  auto snapshot = this->Snapshot();
+  snapshot.path = common::joinPaths(PROJECT_BINARY_PATH, "missing_directory",
+      "checkpoint.ckpt");
+  EXPECT_FALSE(writeCheckpoint(snapshot));
+}
+
+/////////////////////////////////////////////////
+TEST_F(WorldCheckpointTest, Writer)
+{
+  const auto otherPath = this->path + ".other";
+
+  CheckpointWriter writer;
+  writer.Write(this->Snapshot());
+
+  auto snapshot = this->Snapshot();
+  snapshot.path = otherPath;
+  snapshot.stats.set_iterations(5678);
+  writer.Write(std::move(snapshot));
+
+  writer.Flush();
+
+  msgs::WorldStatistics stats;
+  EXPECT_TRUE(readCheckpointHeader(this->path, stats));
+  EXPECT_EQ(1234u, stats.iterations());
+  EXPECT_TRUE(readCheckpointHeader(otherPath, stats));
+  EXPECT_EQ(5678u, stats.iterations());
+
+  common::removeFile(otherPath);
+}
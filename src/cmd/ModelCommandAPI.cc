@@ -30,6 +30,7 @@
 #include <sdf/Noise.hh>
 #include <sdf/Sensor.hh>
 
+#include <ignition/msgs/param.pb.h>
 #include <ignition/msgs/serialized.pb.h>
 #include <ignition/msgs/stringmsg.pb.h>
 
@@ -40,6 +41,7 @@
 #include <ignition/gazebo/components/Altimeter.hh>
 #include <ignition/gazebo/components/Camera.hh>
 #include <ignition/gazebo/components/ChildLinkName.hh>
+#include <ignition/gazebo/components/Factory.hh>
 #include <ignition/gazebo/components/GpuLidar.hh>
 #include <ignition/gazebo/components/Imu.hh>
 #include <ignition/gazebo/components/Inertial.hh>
@@ -535,10 +537,35 @@ void printMagnetometer(const uint64_t _entity,
 }
 
 //////////////////////////////////////////////////
-// \brief Set the state of a ECM instance with a world snapshot.
+// \brief Get the names of component types, as expected by the filtered
+// state service.
+// \param[in] _types Component type IDs.
+// \return Comma separated type names.
+std::string componentTypeNames(const std::vector<ComponentTypeId> &_types)
+{
+  std::string names;
+  for (const auto type : _types)
+  {
+    if (!names.empty())
+      names += ",";
+    names += components::Factory::Instance()->Name(type);
+  }
+  return names;
+}
+
+//////////////////////////////////////////////////
+// \brief Set the state of a ECM instance with a snapshot of part of the
+// world. Only the requested entities and components are transferred, so the
+// cost doesn't depend on the size of the world.
 // \param _ecm ECM instance to be populated.
+// \param[in] _name Scoped name of the root entity, relative to the world.
+// Empty for the world itself.
+// \param[in] _depth Levels of descendants to include under the root, -1
+// for all.
+// \param[in] _types Component types to include, empty for all.
 // \return boolean indicating if it was able to populate the ECM.
-bool populateECM(EntityComponentManager &_ecm)
+bool populateECM(EntityComponentManager &_ecm, const std::string &_name,
+    int _depth, const std::vector<ComponentTypeId> &_types = {})
 {
   const std::string world = getWorldName();
   if (world.empty())
@@ -551,15 +578,24 @@ bool populateECM(EntityComponentManager &_ecm)
   transport::Node node;
   bool result{false};
   const unsigned int timeout{5000};
-  const std::string service{"/world/" + world + "/state"};
+  const std::string service{"/world/" + world + "/state/filtered"};
 
   std::cout << std::endl << "Requesting state for world [" << world
             << "]..." << std::endl << std::endl;
 
+  msgs::Param req;
+  auto &params = *req.mutable_params();
+  params["name"].set_type(msgs::Any::STRING);
+  params["name"].set_string_value(_name);
+  params["depth"].set_type(msgs::Any::INT32);
+  params["depth"].set_int_value(_depth);
+  params["components"].set_type(msgs::Any::STRING);
+  params["components"].set_string_value(componentTypeNames(_types));
+
   // Request and block
   msgs::SerializedStepMap res;
 
-  if (!node.Request(service, timeout, res, result))
+  if (!node.Request(service, req, timeout, res, result))
   {
     std::cerr << std::endl << "Service call to [" << service << "] timed out"
               << std::endl;
@@ -780,8 +816,11 @@ void printJoints(const uint64_t _modelEntity,
 //////////////////////////////////////////////////
 extern "C" void cmdModelList()
 {
+  // Only the world and its children are needed
   EntityComponentManager ecm{};
-  if (!populateECM(ecm))
+  if (!populateECM(ecm, "", 1, {components::World::typeId,
+      components::Model::typeId, components::Name::typeId,
+      components::ParentEntity::typeId}))
   {
     return;
   }
@@ -835,8 +874,20 @@ extern "C" void cmdModelInfo(
     return;
   }
 
+  // Request the model's subtree down to its sensors, or just the model for
+  // its pose
   EntityComponentManager ecm{};
-  if (!populateECM(ecm))
+  bool populated{false};
+  if (!printAll && !_linkName && !_jointName && !_sensorName)
+  {
+    populated = populateECM(ecm, _modelName, 0, {components::Model::typeId,
+        components::Name::typeId, components::Pose::typeId});
+  }
+  else
+  {
+    populated = populateECM(ecm, _modelName, 2);
+  }
+  if (!populated)
     return;
 
   // Get the desired model entity.
@@ -318,7 +318,7 @@ void GuiRunner::OnStateQt(const msgs::SerializedStepMap &_msg)
   this->dataPtr->ecm.SetState(_msg.state());
 
   // Update all plugins
-  this->dataPtr->updateInfo = convert<UpdateInfo>(_msg.stats());
+  set(&this->dataPtr->updateInfo, _msg.stats());
   this->UpdatePlugins();
 }
 
@@ -338,6 +338,10 @@ void GuiRunner::UpdatePlugins()
   // ign-gazebo systems
   this->LoadSystems();
   this->UpdateSystems();
+
+  // Changes have been seen by all plugins and systems, so the next update
+  // only reports changes from newer states
+  this->dataPtr->ecm.SetAllComponentsUnchanged();
 }
 
 /////////////////////////////////////////////////
@@ -130,7 +130,8 @@ bool NetworkManagerPrimary::Step(const UpdateInfo &_info)
   }
 
   private_msgs::SimulationStep step;
-  step.mutable_stats()->CopyFrom(convert<msgs::WorldStatistics>(_info));
+  set(step.mutable_stats(), _info);
+  step.set_primary_id(this->dataPtr->peerInfo.id);
 
   // Affinities that changed this step
   this->PopulateAffinities(step);
@@ -199,6 +200,13 @@ std::map<std::string, SecondaryControl::Ptr>
 //////////////////////////////////////////////////
 void NetworkManagerPrimary::OnStepAck(const msgs::SerializedStateMap &_msg)
 {
+  // Acknowledgements count as heartbeats from secondaries
+  for (const auto &data : _msg.header().data())
+  {
+    if (data.key() == "peer_id" && data.value_size() > 0)
+      this->dataPtr->tracker->PeerSeen(data.value(0));
+  }
+
   this->secondaryStates.push_back(_msg);
   if (this->secondaryStates.size() == this->secondaries.size())
   {
@@ -102,6 +102,9 @@ void NetworkManagerSecondary::OnStep(
 {
   IGN_PROFILE("NetworkManagerSecondary::OnStep");
 
+  // Steps count as heartbeats from the primary
+  this->dataPtr->tracker->PeerSeen(_msg.primary_id());
+
   // Throttle the number of step messages going to the debug output.
   if (!_msg.stats().paused() && _msg.stats().iterations() % 1000 == 0)
   {
@@ -141,7 +144,8 @@ void NetworkManagerSecondary::OnStep(
   }
 
   // Update info
-  auto info = convert<UpdateInfo>(_msg.stats());
+  UpdateInfo info;
+  set(&info, _msg.stats());
 
   // Step runner
   this->dataPtr->stepFunction(info);
@@ -170,7 +174,13 @@ void NetworkManagerSecondary::OnStep(
   stateMsg.set_has_one_time_component_changes(
     this->dataPtr->ecm->HasOneTimeComponentChanges());
 
+  // The acknowledgement stands in for this peer's heartbeat
+  auto peerId = stateMsg.mutable_header()->add_data();
+  peerId->set_key("peer_id");
+  peerId->add_value(this->dataPtr->peerInfo.id);
+
   this->stepAckPub.Publish(stateMsg);
+  this->dataPtr->tracker->HeartbeatSent();
 
   this->dataPtr->ecm->SetAllComponentsUnchanged();
 }
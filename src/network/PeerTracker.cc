@@ -31,13 +31,25 @@ PeerTracker::PeerTracker(
   eventMgr(_eventMgr),
   node(_options)
 {
-  this->heartbeatPub =
-      this->node.Advertise<private_msgs::PeerInfo>("heartbeat");
   this->announcePub =
       this->node.Advertise<private_msgs::PeerAnnounce>("announce");
-  this->node.Subscribe("heartbeat", &PeerTracker::OnPeerHeartbeat, this);
   this->node.Subscribe("announce", &PeerTracker::OnPeerAnnounce, this);
 
+  // Only primaries receive individual heartbeats, everyone else receives
+  // them through the primaries.
+  if (this->info.role == NetworkRole::SimulationPrimary)
+  {
+    this->heartbeatsPub =
+        this->node.Advertise<private_msgs::PeerHeartbeats>("heartbeats");
+    this->node.Subscribe("heartbeat", &PeerTracker::OnPeerHeartbeat, this);
+  }
+  else
+  {
+    this->heartbeatPub =
+        this->node.Advertise<private_msgs::PeerInfo>("heartbeat");
+  }
+  this->node.Subscribe("heartbeats", &PeerTracker::OnPeerHeartbeats, this);
+
   private_msgs::PeerAnnounce msg;
   *msg.mutable_info() = toProto(this->info);
   msg.set_state(private_msgs::PeerAnnounce::CONNECTING);
@@ -53,7 +65,9 @@ PeerTracker::PeerTracker(
 /////////////////////////////////////////////////
 PeerTracker::~PeerTracker()
 {
-  this->node.Unsubscribe("heartbeat");
+  if (this->info.role == NetworkRole::SimulationPrimary)
+    this->node.Unsubscribe("heartbeat");
+  this->node.Unsubscribe("heartbeats");
   this->node.Unsubscribe("announce");
 
   this->heartbeatRunning = false;
@@ -72,24 +86,28 @@ PeerTracker::~PeerTracker()
 /////////////////////////////////////////////////
 void PeerTracker::SetHeartbeatPeriod(const Duration &_period)
 {
+  auto lock = PeerLock(this->peersMutex);
   this->heartbeatPeriod = _period;
 }
 
 /////////////////////////////////////////////////
 PeerTracker::Duration PeerTracker::HeartbeatPeriod() const
 {
+  auto lock = PeerLock(this->peersMutex);
   return this->heartbeatPeriod;
 }
 
 /////////////////////////////////////////////////
 void PeerTracker::SetStaleMultiplier(const size_t &_multiplier)
 {
+  auto lock = PeerLock(this->peersMutex);
   this->staleMultiplier = _multiplier;
 }
 
 /////////////////////////////////////////////////
 size_t PeerTracker::StaleMultiplier() const
 {
+  auto lock = PeerLock(this->peersMutex);
   return this->staleMultiplier;
 }
 
@@ -116,6 +134,23 @@ size_t PeerTracker::NumPeers(const NetworkRole &_role) const
   return count;
 }
 
+/////////////////////////////////////////////////
+void PeerTracker::PeerSeen(const std::string &_id)
+{
+  auto lock = PeerLock(this->peersMutex);
+
+  auto iter = this->peers.find(_id);
+  if (iter != this->peers.end())
+    iter->second.lastSeen = std::chrono::steady_clock::now();
+}
+
+/////////////////////////////////////////////////
+void PeerTracker::HeartbeatSent()
+{
+  auto lock = PeerLock(this->peersMutex);
+  this->lastHeartbeatSent = std::chrono::steady_clock::now();
+}
+
 /////////////////////////////////////////////////
 void PeerTracker::HeartbeatLoop()
 {
@@ -125,20 +160,10 @@ void PeerTracker::HeartbeatLoop()
   while (this->heartbeatRunning)
   {
     lastUpdateTime = Clock::now();
-    this->heartbeatPub.Publish(toProto(this->info));
-
-    std::vector<PeerInfo> toRemove;
-    for (auto peer : this->peers)
-    {
-      auto age = Clock::now() - peer.second.lastSeen;
-      if (age > (this->staleMultiplier * this->heartbeatPeriod))
-      {
-        toRemove.push_back(peer.second.info);
-      }
-    }
+    this->PublishHeartbeat();
 
     // Remove peers that were marked as stale.
-    for (const auto &peer : toRemove)
+    for (const auto &peer : this->CheckStalePeers())
     {
       this->OnPeerStale(peer);
     }
@@ -146,7 +171,7 @@ void PeerTracker::HeartbeatLoop()
     // Compute sleep time to keep update loop as close to
     // heartbeatPeriod as possible.
     auto sleepTime = std::max(std::chrono::nanoseconds(0),
-          lastUpdateTime + this->heartbeatPeriod - Clock::now());
+          lastUpdateTime + this->HeartbeatPeriod() - Clock::now());
 
     if (sleepTime > std::chrono::nanoseconds(0))
     {
@@ -155,6 +180,106 @@ void PeerTracker::HeartbeatLoop()
   }
 }
 
+/////////////////////////////////////////////////
+void PeerTracker::PublishHeartbeat()
+{
+  // Messages are published without holding the lock, because subscribers
+  // in the same process are called from Publish.
+  if (this->info.role != NetworkRole::SimulationPrimary)
+  {
+    {
+      // Another message already stood in for this heartbeat
+      auto lock = PeerLock(this->peersMutex);
+      auto now = std::chrono::steady_clock::now();
+      if (now - this->lastHeartbeatSent < this->heartbeatPeriod)
+        return;
+    }
+
+    this->heartbeatPub.Publish(toProto(this->info));
+    return;
+  }
+
+  private_msgs::PeerHeartbeats msg;
+  *msg.mutable_source() = toProto(this->info);
+  {
+    auto lock = PeerLock(this->peersMutex);
+    for (const auto &peer : this->peers)
+      *msg.add_peers() = toProto(peer.second.info);
+  }
+  this->heartbeatsPub.Publish(msg);
+}
+
+/////////////////////////////////////////////////
+std::vector<PeerInfo> PeerTracker::CheckStalePeers()
+{
+  auto lock = PeerLock(this->peersMutex);
+
+  // The wheel spans the stale time, rebuild it if that changed.
+  const size_t wheelSize = this->staleMultiplier + 2;
+  const auto now = std::chrono::steady_clock::now();
+  if (this->staleWheel.size() != wheelSize)
+  {
+    this->staleWheel.clear();
+    this->staleWheel.resize(wheelSize);
+    this->staleWheelSlot = 0;
+    for (auto &peer : this->peers)
+      this->ScheduleStaleCheck(peer.first, peer.second, now);
+  }
+
+  this->staleWheelSlot = (this->staleWheelSlot + 1) % wheelSize;
+  std::vector<std::string> due;
+  due.swap(this->staleWheel[this->staleWheelSlot]);
+
+  std::vector<PeerInfo> stale;
+  const Duration staleTime = this->heartbeatPeriod *
+      static_cast<Duration::rep>(this->staleMultiplier);
+  for (const auto &id : due)
+  {
+    // Skip peers which were removed, or rescheduled since
+    auto iter = this->peers.find(id);
+    if (iter == this->peers.end() ||
+        iter->second.staleSlot != this->staleWheelSlot)
+    {
+      continue;
+    }
+
+    if (now - iter->second.lastSeen > staleTime)
+    {
+      iter->second.staleSlot = wheelSize;
+      stale.push_back(iter->second.info);
+    }
+    else
+    {
+      this->ScheduleStaleCheck(id, iter->second, now);
+    }
+  }
+  return stale;
+}
+
+/////////////////////////////////////////////////
+void PeerTracker::ScheduleStaleCheck(const std::string &_id,
+    PeerState &_state, const std::chrono::steady_clock::time_point &_now)
+{
+  // The wheel is created by the heartbeat loop
+  if (this->staleWheel.empty())
+    return;
+
+  // Number of heartbeats until the peer becomes stale, if it isn't seen
+  // again before that.
+  const Duration staleTime = this->heartbeatPeriod *
+      static_cast<Duration::rep>(this->staleMultiplier);
+  const auto remaining = _state.lastSeen + staleTime - _now;
+  size_t periods{1};
+  if (remaining > Duration::zero() && this->heartbeatPeriod > Duration::zero())
+  {
+    periods = static_cast<size_t>(remaining / this->heartbeatPeriod) + 1;
+  }
+  periods = std::min(periods, this->staleWheel.size() - 1);
+
+  _state.staleSlot = (this->staleWheelSlot + periods) % this->staleWheel.size();
+  this->staleWheel[_state.staleSlot].push_back(_id);
+}
+
 /////////////////////////////////////////////////
 bool PeerTracker::RemovePeer(const PeerInfo &_info)
 {
@@ -196,6 +321,25 @@ void PeerTracker::OnPeerAnnounce(const private_msgs::PeerAnnounce &_announce)
 
 /////////////////////////////////////////////////
 void PeerTracker::OnPeerHeartbeat(const private_msgs::PeerInfo &_info)
+{
+  this->RefreshPeer(_info);
+}
+
+/////////////////////////////////////////////////
+void PeerTracker::OnPeerHeartbeats(const private_msgs::PeerHeartbeats &_msg)
+{
+  // Skip our own aggregate.
+  if (_msg.source().id() == this->info.id)
+    return;
+
+  auto lock = PeerLock(this->peersMutex);
+  this->RefreshPeer(_msg.source());
+  for (const auto &peer : _msg.peers())
+    this->RefreshPeer(peer);
+}
+
+/////////////////////////////////////////////////
+void PeerTracker::RefreshPeer(const private_msgs::PeerInfo &_info)
 {
   auto peer = fromProto(_info);
 
@@ -229,7 +373,9 @@ void PeerTracker::OnPeerAdded(const PeerInfo &_info)
   auto peerState = PeerState();
   peerState.info = _info;
   peerState.lastSeen = std::chrono::steady_clock::now();
-  this->peers[_info.id] = peerState;
+  auto &newState = this->peers[_info.id];
+  newState = peerState;
+  this->ScheduleStaleCheck(_info.id, newState, newState.lastSeen);
 
   // Emit event for any consumers
   if (eventMgr)
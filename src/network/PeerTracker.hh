@@ -17,6 +17,7 @@
 #ifndef IGNITION_GAZEBO_NETWORK_PEERTRACKER_HH_
 #define IGNITION_GAZEBO_NETWORK_PEERTRACKER_HH_
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -53,6 +54,13 @@ namespace ignition
     ///
     /// It is used to both announce the existence of a peer, as well as track
     /// announcements and heartbeats from other peers.
+    ///
+    /// Heartbeats are aggregated by primaries: other peers send their
+    /// heartbeats to primaries only, and each primary publishes a single
+    /// message with the heartbeats of all the peers it knows about. Messages
+    /// which are already exchanged while simulation is stepping, such as
+    /// steps and their acknowledgements, can stand in for heartbeats, see
+    /// `PeerSeen` and `HeartbeatSent`.
     class IGNITION_GAZEBO_VISIBLE PeerTracker {
       /// \brief Convenience type alias for NodeOptions
       public: using NodeOptions = ignition::transport::NodeOptions;
@@ -125,6 +133,17 @@ namespace ignition
                 return NumPeers(NetworkRole::ReadOnly);
               }
 
+      /// \brief Refresh a peer as if a heartbeat had been received from it.
+      /// Used when another message from the peer was received, such as a
+      /// step or its acknowledgement.
+      /// \param[in] _id Id of the peer, unknown peers are ignored.
+      public: void PeerSeen(const std::string &_id);
+
+      /// \brief Notify that a message which other peers count as a
+      /// heartbeat from this peer was just sent. The next heartbeat is
+      /// skipped if it would be sent less than a heartbeat period later.
+      public: void HeartbeatSent();
+
       /// \brief Retrieve the ids of discovered peers.
       public: std::vector<std::string> SecondaryPeers() const
               {
@@ -152,6 +171,24 @@ namespace ignition
       /// \param[in] _info Heartbeat from another peer.
       private: void OnPeerHeartbeat(const private_msgs::PeerInfo &_info);
 
+      /// \brief Callback for the heartbeats aggregated by a primary.
+      /// \param[in] _msg Heartbeats of the primary and all its peers.
+      private: void OnPeerHeartbeats(const private_msgs::PeerHeartbeats &_msg);
+
+      /// \brief Add a peer if it's unknown and update the last time it was
+      /// seen.
+      /// \param[in] _info Heartbeat of the peer.
+      private: void RefreshPeer(const private_msgs::PeerInfo &_info);
+
+      /// \brief Publish this peer's heartbeat. Primaries publish the
+      /// heartbeats of all their peers along with their own.
+      private: void PublishHeartbeat();
+
+      /// \brief Check the peers due on this heartbeat, and return the ones
+      /// which are stale.
+      /// \return Stale peers.
+      private: std::vector<PeerInfo> CheckStalePeers();
+
       /// \brief Callback for when a peer is added.
       /// \param[in] _info Info from peer which was added.
       private: void OnPeerAdded(const PeerInfo &_info);
@@ -175,8 +212,20 @@ namespace ignition
 
         /// \brief Keep last time heartbeat was received
         std::chrono::steady_clock::time_point lastSeen;
+
+        /// \brief Slot of the stale wheel the peer is scheduled in
+        size_t staleSlot{0};
       };
 
+      /// \brief Schedule the next stale check of a peer, based on the last
+      /// time it was seen. Requires peersMutex to be locked.
+      /// \param[in] _id Id of the peer.
+      /// \param[in] _state State of the peer.
+      /// \param[in] _now Current time.
+      private: void ScheduleStaleCheck(const std::string &_id,
+                   PeerState &_state,
+                   const std::chrono::steady_clock::time_point &_now);
+
       /// \brief Convenience type alias
       private: using PeerMutex = std::recursive_mutex;
 
@@ -190,6 +239,19 @@ namespace ignition
       /// \brief Information about discovered peers
       private: std::map<std::string, PeerState> peers;
 
+      /// \brief Timer wheel for stale checks. Each slot holds the ids of the
+      /// peers to check on one heartbeat, so that each heartbeat only checks
+      /// the peers which may have become stale since then instead of all of
+      /// them. Peers are rescheduled according to the last time they were
+      /// seen when they're checked.
+      private: std::vector<std::vector<std::string>> staleWheel;
+
+      /// \brief Slot of the stale wheel checked on the latest heartbeat.
+      private: size_t staleWheelSlot{0};
+
+      /// \brief Last time a message standing in for a heartbeat was sent.
+      private: std::chrono::steady_clock::time_point lastHeartbeatSent;
+
       /// \brief Thread for executing heartbeat loop
       private: std::thread heartbeatThread;
 
@@ -214,6 +276,9 @@ namespace ignition
       /// \brief Heartbeat publisher
       private: ignition::transport::Node::Publisher heartbeatPub;
 
+      /// \brief Aggregated heartbeats publisher, only used by primaries
+      private: ignition::transport::Node::Publisher heartbeatsPub;
+
       /// \brief Announcement publisher
       private: ignition::transport::Node::Publisher announcePub;
     };
@@ -187,6 +187,63 @@ TEST(PeerTracker, IGN_UTILS_TEST_DISABLED_ON_MAC(PeerTrackerStale))
   // received from stale peer
 }
 
+//////////////////////////////////////////////////
+TEST(PeerTracker, IGN_UTILS_TEST_DISABLED_ON_MAC(PeerSeen))
+{
+  ignition::common::Console::SetVerbosity(4);
+  EventManager eventMgr;
+
+  std::atomic<int> stalePeers = 0;
+  auto stale = eventMgr.Connect<PeerStale>([&](PeerInfo)
+  {
+    stalePeers++;
+  });
+
+  // Tracker with artificially short timeout.
+  auto tracker1 = std::make_shared<PeerTracker>(
+      PeerInfo(NetworkRole::SimulationPrimary), &eventMgr);
+  tracker1->SetHeartbeatPeriod(std::chrono::milliseconds(10));
+  tracker1->SetStaleMultiplier(5);
+
+  // Peer which stops sending heartbeats, as if it was sending step
+  // acknowledgements instead.
+  auto info2 = PeerInfo(NetworkRole::SimulationSecondary);
+  auto tracker2 = std::make_shared<PeerTracker>(info2);
+  tracker2->SetHeartbeatPeriod(std::chrono::milliseconds(10));
+  tracker2->HeartbeatSent();
+
+  int maxSleep{100};
+  int sleep{0};
+  for (; sleep < maxSleep && tracker1->NumPeers() == 0; ++sleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_LT(sleep, maxSleep);
+
+  // The peer is kept alive while it's seen through other messages
+  for (int i = 0; i < 30; ++i)
+  {
+    tracker2->HeartbeatSent();
+    tracker1->PeerSeen(info2.id);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(0, stalePeers);
+  EXPECT_EQ(1u, tracker1->NumPeers());
+
+  // Secondaries see the primary through its aggregated heartbeats
+  EXPECT_EQ(1u, tracker2->NumPrimary());
+
+  // And goes stale once it isn't
+  for (sleep = 0; sleep < maxSleep && stalePeers == 0; ++sleep)
+  {
+    tracker2->HeartbeatSent();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_LT(sleep, maxSleep);
+  EXPECT_EQ(1, stalePeers);
+  EXPECT_EQ(0u, tracker1->NumPeers());
+}
+
 //////////////////////////////////////////////////
 TEST(PeerTracker, Partitioned)
 {
@@ -15,6 +15,9 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <stack>
 #include <string>
@@ -100,11 +103,304 @@
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief Append the elements of a vector to another one.
+/// \param[in, out] _to Vector to append to.
+/// \param[in, out] _from Vector whose elements are moved.
+template <typename T>
+static void append(std::vector<T> &_to, std::vector<T> &_from)
+{
+  _to.insert(_to.end(), std::make_move_iterator(_from.begin()),
+      std::make_move_iterator(_from.end()));
+}
+
+/// \brief Set values in a map, replacing the values of existing keys.
+/// \param[in, out] _to Map to set values in.
+/// \param[in, out] _from Map whose values are moved.
+template <typename M>
+static void assign(M &_to, M &_from)
+{
+  for (auto &item : _from)
+    _to[item.first] = std::move(item.second);
+}
+
+/// \brief Append the vectors of a map to the vectors with the same keys in
+/// another map.
+/// \param[in, out] _to Map to append to.
+/// \param[in, out] _from Map whose vectors' elements are moved.
+template <typename M>
+static void appendEach(M &_to, M &_from)
+{
+  for (auto &item : _from)
+    append(_to[item.first], item.second);
+}
+
+/// \brief Set values in the maps of a map, replacing the values of existing
+/// keys.
+/// \param[in, out] _to Map of maps to set values in.
+/// \param[in, out] _from Map of maps whose values are moved.
+template <typename M>
+static void assignEach(M &_to, M &_from)
+{
+  for (auto &item : _from)
+    assign(_to[item.first], item.second);
+}
+
+/// \brief Data extracted from the ECM by RenderUtil::UpdateFromECM and
+/// applied to the scene by RenderUtil::Update. The ECM side fills one
+/// instance while the render thread applies another, and they're exchanged
+/// without locks.
+class SceneUpdateData
+{
+  /// \brief Add newer data to this one, as if both had been extracted into
+  /// this instance.
+  /// \param[in, out] _newer Data extracted after this one. Its elements are
+  /// moved, so it must be cleared before it's reused.
+  public: void Merge(SceneUpdateData &_newer)
+  {
+    append(this->newScenes, _newer.newScenes);
+    append(this->newModels, _newer.newModels);
+    append(this->newLinks, _newer.newLinks);
+    append(this->newVisuals, _newer.newVisuals);
+    append(this->newActors, _newer.newActors);
+    append(this->newLights, _newer.newLights);
+    append(this->newSensors, _newer.newSensors);
+    append(this->newParticleEmitters, _newer.newParticleEmitters);
+    append(this->newTransparentVisualLinks, _newer.newTransparentVisualLinks);
+    append(this->newInertiaLinks, _newer.newInertiaLinks);
+    append(this->newJointModels, _newer.newJointModels);
+    append(this->newCOMLinks, _newer.newCOMLinks);
+    append(this->newWireframeVisualLinks, _newer.newWireframeVisualLinks);
+    append(this->newCollisionLinks, _newer.newCollisionLinks);
+
+    // Newer values replace older ones
+    assign(this->newParticleEmittersCmds, _newer.newParticleEmittersCmds);
+    assign(this->removeEntities, _newer.removeEntities);
+    assign(this->entityPoses, _newer.entityPoses);
+    assign(this->entityLights, _newer.entityLights);
+    assign(this->entityVisuals, _newer.entityVisuals);
+    assign(this->actorTransforms, _newer.actorTransforms);
+    assign(this->entityTemp, _newer.entityTemp);
+    assign(this->entityLabel, _newer.entityLabel);
+    assign(this->trajectoryPoses, _newer.trajectoryPoses);
+    assign(this->actorAnimationData, _newer.actorAnimationData);
+    assign(this->thermalCameraData, _newer.thermalCameraData);
+    assign(this->entityInertials, _newer.entityInertials);
+    assign(this->entityCollisions, _newer.entityCollisions);
+    assign(this->entityJoints, _newer.entityJoints);
+    assignEach(this->matchLinksWithEntities, _newer.matchLinksWithEntities);
+
+    // Children are added to the lists of their parents
+    appendEach(this->modelToModelEntities, _newer.modelToModelEntities);
+    appendEach(this->modelToLinkEntities, _newer.modelToLinkEntities);
+    appendEach(this->modelToJointEntities, _newer.modelToJointEntities);
+    appendEach(this->linkToVisualEntities, _newer.linkToVisualEntities);
+    appendEach(this->linkToCollisionEntities, _newer.linkToCollisionEntities);
+
+    this->simTime = _newer.simTime;
+  }
+
+  /// \brief Clear all data, keeping allocated memory for reuse.
+  public: void Clear()
+  {
+    this->newScenes.clear();
+    this->newModels.clear();
+    this->newLinks.clear();
+    this->newVisuals.clear();
+    this->newActors.clear();
+    this->newLights.clear();
+    this->newSensors.clear();
+    this->newParticleEmitters.clear();
+    this->newParticleEmittersCmds.clear();
+    this->removeEntities.clear();
+    this->entityPoses.clear();
+    this->entityLights.clear();
+    this->entityVisuals.clear();
+    this->actorTransforms.clear();
+    this->entityTemp.clear();
+    this->entityLabel.clear();
+    this->trajectoryPoses.clear();
+    this->actorAnimationData.clear();
+    this->newTransparentVisualLinks.clear();
+    this->newInertiaLinks.clear();
+    this->newJointModels.clear();
+    this->newCOMLinks.clear();
+    this->newWireframeVisualLinks.clear();
+    this->newCollisionLinks.clear();
+    this->thermalCameraData.clear();
+    this->entityInertials.clear();
+    this->entityCollisions.clear();
+    this->entityJoints.clear();
+    this->matchLinksWithEntities.clear();
+    this->modelToModelEntities.clear();
+    this->modelToLinkEntities.clear();
+    this->modelToJointEntities.clear();
+    this->linkToVisualEntities.clear();
+    this->linkToCollisionEntities.clear();
+  }
+
+  /// \brief Sim time when the data was extracted.
+  public: std::chrono::steady_clock::duration simTime{0};
+
+  /// \brief New scenes to be created
+  public: std::vector<sdf::Scene> newScenes;
+
+  /// \brief New models to be created. The elements in the tuple are:
+  /// [0] entity id, [1], SDF DOM, [2] parent entity id, [3] sim iteration
+  public: std::vector<std::tuple<Entity, sdf::Model, Entity, uint64_t>>
+      newModels;
+
+  /// \brief New links to be created. The elements in the tuple are:
+  /// [0] entity id, [1] SDF DOM, [2] parent entity id
+  public: std::vector<std::tuple<Entity, sdf::Link, Entity>> newLinks;
+
+  /// \brief New visuals to be created. The elements in the tuple are:
+  /// [0] entity id, [1] SDF DOM, [2] parent entity id
+  public: std::vector<std::tuple<Entity, sdf::Visual, Entity>> newVisuals;
+
+  /// \brief New actors to be created. The elements in the tuple are:
+  /// [0] entity id, [1] SDF DOM, [2] actor name, [3] parent entity id
+  public: std::vector<std::tuple<Entity, sdf::Actor, std::string, Entity>>
+          newActors;
+
+  /// \brief New lights to be created. The elements in the tuple are:
+  /// [0] entity id, [1] SDF DOM, [2] light name, [3] parent entity id
+  public: std::vector<std::tuple<Entity, sdf::Light, std::string, Entity>>
+          newLights;
+
+  /// \brief New sensors to be created. The elements in the tuple are:
+  /// [0] entity id, [1] SDF DOM, [2] parent entity id
+  public: std::vector<std::tuple<Entity, sdf::Sensor, Entity>>
+      newSensors;
+
+  /// \brief New particle emitter to be created. The elements in the tuple are:
+  /// [0] entity id, [1] particle emitter, [2] parent entity id
+  public: std::vector<std::tuple<Entity, msgs::ParticleEmitter, Entity>>
+      newParticleEmitters;
+
+  /// \brief New particle emitter commands to be requested.
+  /// The map key and value are: entity id of the particle emitter to
+  /// update, and particle emitter msg
+  public: std::unordered_map<Entity, msgs::ParticleEmitter>
+      newParticleEmittersCmds;
+
+  /// \brief Map of ids of entites to be removed and sim iteration when the
+  /// remove request is received
+  public: std::unordered_map<Entity, uint64_t> removeEntities;
+
+  /// \brief A map of entity ids and pose updates. Only holds poses which
+  /// changed since the last render update.
+  public: std::unordered_map<Entity, math::Pose3d> entityPoses;
+
+  /// \brief A map of entity ids and light updates.
+  public: std::unordered_map<Entity, msgs::Light> entityLights;
+
+  /// \brief A map of entity ids and visual updates.
+  public: std::map<Entity, msgs::Visual> entityVisuals;
+
+  /// \brief A map of entity ids and actor transforms.
+  public: std::map<Entity, std::map<std::string, math::Matrix4d>>
+                          actorTransforms;
+
+  /// \brief A map of entity ids and temperature data.
+  /// The value of this map (tuple) represents either a single (uniform)
+  /// temperature, or a heat signature with a min/max temperature. If the string
+  /// in the tuple is empty, then this entity has a uniform temperature across
+  /// its surface, and this uniform temperature is stored in the first float of
+  /// the tuple (the second float and string are unused for uniform temperature
+  /// entities). If the string in the tuple is not empty, then the string
+  /// represents the entity's heat signature (a path to a heat signature texture
+  /// file), and the floats represent the min/max temperatures of the heat
+  /// signature, respectively.
+  ///
+  /// All temperatures are in Kelvin.
+  public: std::map<Entity, std::tuple<float, float, std::string>> entityTemp;
+
+  /// \brief A map of entity ids and label data for datasets annotations
+  public: std::unordered_map<Entity, int> entityLabel;
+
+  /// \brief A map of entity ids and trajectory pose updates.
+  public: std::unordered_map<Entity, math::Pose3d> trajectoryPoses;
+
+  /// \brief A map of entity ids and actor animation info.
+  public: std::unordered_map<Entity, AnimationUpdateData> actorAnimationData;
+
+  /// \brief A list of links used to toggle transparent mode for visuals
+  public: std::vector<Entity> newTransparentVisualLinks;
+
+  /// \brief A list of links used to create new inertia visuals
+  public: std::vector<Entity> newInertiaLinks;
+
+  /// \brief A list of models used to create new joint visuals
+  public: std::vector<Entity> newJointModels;
+
+  /// \brief A list of links used to create new center of mass visuals
+  public: std::vector<Entity> newCOMLinks;
+
+  /// \brief A list of links used to toggle wireframe mode for visuals
+  public: std::vector<Entity> newWireframeVisualLinks;
+
+  /// \brief A list of links used to create new collision visuals
+  public: std::vector<Entity> newCollisionLinks;
+
+  /// \brief A map of entity id to thermal camera sensor configuration
+  /// properties. The elements in the tuple are:
+  /// <resolution, temperature range (min, max)>
+  public: std::unordered_map<Entity,
+      std::tuple<double, components::TemperatureRangeInfo>> thermalCameraData;
+
+  /// \brief New inertials, by entity id
+  public: std::map<Entity, math::Inertiald> entityInertials;
+
+  /// \brief New collisions' SDF DOM, by entity id
+  public: std::map<Entity, sdf::Collision> entityCollisions;
+
+  /// \brief New joints' SDF DOM, by entity id
+  public: std::map<Entity, sdf::Joint> entityJoints;
+
+  /// \brief New links, by parent model and link name
+  public: std::map<Entity, std::map<std::string, Entity>>
+      matchLinksWithEntities;
+
+  /// \brief New models, by parent model
+  public: std::map<Entity, std::vector<Entity>> modelToModelEntities;
+
+  /// \brief New links, by parent model
+  public: std::map<Entity, std::vector<Entity>> modelToLinkEntities;
+
+  /// \brief New joints, by parent model
+  public: std::map<Entity, std::vector<Entity>> modelToJointEntities;
+
+  /// \brief New visuals, by parent link
+  public: std::map<Entity, std::vector<Entity>> linkToVisualEntities;
+
+  /// \brief New collisions, by parent link
+  public: std::map<Entity, std::vector<Entity>> linkToCollisionEntities;
+};
+
 // Private data class.
 class ignition::gazebo::RenderUtilPrivate
 {
-  /// True if the rendering component is initialized
-  public: bool initialized = false;
+  /// \brief Destructor
+  public: ~RenderUtilPrivate();
+
+  /// True if the rendering component is initialized. Set by the ECM side
+  /// and read by the render thread.
+  public: std::atomic<bool> initialized{false};
+
+  /// \brief Hand the data extracted so far to the render thread. If the
+  /// render thread hasn't taken the previous data yet, the new data is
+  /// merged into it. Must be called with updateMutex locked.
+  public: void PublishUpdate();
+
+  /// \brief Add the entities described by data taken from the ECM side to
+  /// the maps kept by the render thread.
+  /// \param[in, out] _data Data being applied. Its maps are moved.
+  public: void AddEntityData(SceneUpdateData &_data);
+
+  /// \brief Erase a removed entity from the maps kept by the render thread,
+  /// and remove the inertia, center of mass and light visuals created for it.
+  /// \param[in] _entity Removed entity.
+  public: void RemoveEntityData(const Entity &_entity);
 
   /// \brief Create rendering entities
   /// \param[in] _ecm The entity-component manager
@@ -133,7 +429,7 @@ class ignition::gazebo::RenderUtilPrivate
   public: void RemoveRenderingEntities(const EntityComponentManager &_ecm,
       const UpdateInfo &_info);
 
-  /// \brief Update rendering entities
+  /// \brief Update rendering entities whose pose changed, and actors
   /// \param[in] _ecm The entity-component manager
   public: void UpdateRenderingEntities(const EntityComponentManager &_ecm);
 
@@ -200,7 +496,30 @@ class ignition::gazebo::RenderUtilPrivate
 
   /// \brief Total time elapsed in simulation. This will not increase while
   /// paused.
-  public: std::chrono::steady_clock::duration simTime{0};
+  public: std::atomic<std::chrono::steady_clock::duration> simTime{
+      std::chrono::steady_clock::duration::zero()};
+
+  /// \brief Data being extracted from the ECM. Only accessed by the ECM
+  /// side, with updateMutex locked.
+  public: std::unique_ptr<SceneUpdateData> extracting{
+      std::make_unique<SceneUpdateData>()};
+
+  /// \brief Data being applied to the scene. Only accessed by the render
+  /// thread.
+  public: std::unique_ptr<SceneUpdateData> applying{
+      std::make_unique<SceneUpdateData>()};
+
+  /// \brief Data published by the ECM side which the render thread hasn't
+  /// taken yet. Whoever exchanges it with null owns it.
+  public: std::atomic<SceneUpdateData *> ready{nullptr};
+
+  /// \brief Data already applied by the render thread, handed back to the
+  /// ECM side so it can be reused without allocating.
+  public: std::atomic<SceneUpdateData *> spare{nullptr};
+
+  /// \brief Number of sensors published to the render thread which haven't
+  /// been created yet.
+  public: std::atomic<int> pendingSensors{0};
 
   /// \brief Name of rendering engine
   public: std::string engineName = "ogre2";
@@ -240,73 +559,22 @@ class ignition::gazebo::RenderUtilPrivate
   /// \brief Window ID handle
   public: std::string winID = "";
 
-  /// \brief New scenes to be created
-  public: std::vector<sdf::Scene> newScenes;
-
   /// \brief is headless mode active
   public: bool isHeadlessRendering = false;
 
-  /// \brief New models to be created. The elements in the tuple are:
-  /// [0] entity id, [1], SDF DOM, [2] parent entity id, [3] sim iteration
-  public: std::vector<std::tuple<Entity, sdf::Model, Entity, uint64_t>>
-      newModels;
-
-  /// \brief New links to be created. The elements in the tuple are:
-  /// [0] entity id, [1] SDF DOM, [2] parent entity id
-  public: std::vector<std::tuple<Entity, sdf::Link, Entity>> newLinks;
-
-  /// \brief New visuals to be created. The elements in the tuple are:
-  /// [0] entity id, [1] SDF DOM, [2] parent entity id
-  public: std::vector<std::tuple<Entity, sdf::Visual, Entity>> newVisuals;
-
-  /// \brief New actors to be created. The elements in the tuple are:
-  /// [0] entity id, [1] SDF DOM, [2] actor name, [3] parent entity id
-  public: std::vector<std::tuple<Entity, sdf::Actor, std::string, Entity>>
-          newActors;
-
-  /// \brief New lights to be created. The elements in the tuple are:
-  /// [0] entity id, [1] SDF DOM, [2] light name, [3] parent entity id
-  public: std::vector<std::tuple<Entity, sdf::Light, std::string, Entity>>
-          newLights;
-
   /// \brief A map of entity light ids and light visuals
   public: std::map<Entity, Entity> matchLightWithVisuals;
 
-  /// \brief New sensors to be created. The elements in the tuple are:
-  /// [0] entity id, [1] SDF DOM, [2] parent entity id
-  public: std::vector<std::tuple<Entity, sdf::Sensor, Entity>>
-      newSensors;
-
-  /// \brief New particle emitter to be created. The elements in the tuple are:
-  /// [0] entity id, [1] particle emitter, [2] parent entity id
-  public: std::vector<std::tuple<Entity, msgs::ParticleEmitter, Entity>>
-      newParticleEmitters;
-
-  /// \brief New particle emitter commands to be requested.
-  /// The map key and value are: entity id of the particle emitter to
-  /// update, and particle emitter msg
-  public: std::unordered_map<Entity, msgs::ParticleEmitter>
-      newParticleEmittersCmds;
-
   /// \brief A list of entities with particle emitter cmds to remove
   public: std::vector<Entity> particleCmdsToRemove;
 
-  /// \brief Map of ids of entites to be removed and sim iteration when the
-  /// remove request is received
-  public: std::unordered_map<Entity, uint64_t> removeEntities;
-
-  /// \brief A map of entity ids and pose updates.
-  public: std::unordered_map<Entity, math::Pose3d> entityPoses;
-
-  /// \brief A map of entity ids and light updates.
-  public: std::unordered_map<Entity, msgs::Light> entityLights;
+  /// \brief Poses which weren't applied on the last render update because
+  /// their nodes were being manipulated. Only accessed by the render thread.
+  public: std::unordered_map<Entity, math::Pose3d> skippedPoses;
 
   /// \brief A map of entity ids and light updates.
   public: std::vector<Entity> entityLightsCmdToDelete;
 
-  /// \brief A map of entity ids and visual updates.
-  public: std::map<Entity, msgs::Visual> entityVisuals;
-
   /// \brief A vector of entity ids of VisualCmds to delete
   public: std::vector<Entity> entityVisualsCmdToDelete;
 
@@ -323,43 +591,24 @@ class ignition::gazebo::RenderUtilPrivate
                 _a.Emissive() == _b.Emissive();
             }};
 
-  /// \brief A map of entity ids and actor transforms.
-  public: std::map<Entity, std::map<std::string, math::Matrix4d>>
-                          actorTransforms;
-
-  /// \brief A map of entity ids and temperature data.
-  /// The value of this map (tuple) represents either a single (uniform)
-  /// temperature, or a heat signature with a min/max temperature. If the string
-  /// in the tuple is empty, then this entity has a uniform temperature across
-  /// its surface, and this uniform temperature is stored in the first float of
-  /// the tuple (the second float and string are unused for uniform temperature
-  /// entities). If the string in the tuple is not empty, then the string
-  /// represents the entity's heat signature (a path to a heat signature texture
-  /// file), and the floats represent the min/max temperatures of the heat
-  /// signature, respectively.
-  ///
-  /// All temperatures are in Kelvin.
-  public: std::map<Entity, std::tuple<float, float, std::string>> entityTemp;
-
-  /// \brief A map of entity ids and label data for datasets annotations
-  public: std::unordered_map<Entity, int> entityLabel;
-
   /// \brief A map of entity ids and wire boxes
   public: std::unordered_map<Entity, ignition::rendering::WireBoxPtr> wireBoxes;
 
-  /// \brief A map of entity ids and trajectory pose updates.
-  public: std::unordered_map<Entity, math::Pose3d> trajectoryPoses;
-
-  /// \brief A map of entity ids and actor animation info.
-  public: std::unordered_map<Entity, AnimationUpdateData> actorAnimationData;
-
   /// \brief True to update skeletons manually using bone poses
   /// (see actorTransforms). False to let render engine update animation
   /// based on sim time.
   /// \todo(anyone) Let this be turned on from a component
   public: bool actorManualSkeletonUpdate = false;
 
-  /// \brief Mutex to protect updates
+  /// \brief Mutex to serialize the ECM side updates and the requests queued
+  /// by the View* functions, such as newInertias. The render thread doesn't
+  /// lock it while updating the scene, it takes the extracted data through
+  /// `ready` instead.
+  ///
+  /// The maps describing entities and their visuals, such as entityInertials,
+  /// linkToVisualEntities, viewingJoints and matchLightWithVisuals, are only
+  /// accessed by the render thread. The ECM side sends additions to them in
+  /// SceneUpdateData, and they're erased when entities are removed.
   public: std::mutex updateMutex;
 
   //// \brief Flag to indicate whether to create sensors
@@ -434,9 +683,6 @@ class ignition::gazebo::RenderUtilPrivate
   /// \param[in] _ecm The entity-component manager
   public: void FindJointModels(const EntityComponentManager &_ecm);
 
-  /// \brief A list of models used to create new joint visuals
-  public: std::vector<Entity> newJointModels;
-
   /// \brief A map of joint entity ids and their SDF DOM
   public: std::map<Entity, sdf::Joint> entityJoints;
 
@@ -459,9 +705,6 @@ class ignition::gazebo::RenderUtilPrivate
   /// \brief New center of mass visuals to be created
   public: std::vector<Entity> newCOMVisuals;
 
-  /// \brief A list of links used to create new center of mass visuals
-  public: std::vector<Entity> newCOMLinks;
-
   /// \brief A map of link entities and if their center of mass visuals
   /// are currently visible
   public: std::map<Entity, bool> viewingCOM;
@@ -484,9 +727,6 @@ class ignition::gazebo::RenderUtilPrivate
   /// \param[in] _ecm The entity-component manager
   public: void FindInertialLinks(const EntityComponentManager &_ecm);
 
-  /// \brief A list of links used to create new inertia visuals
-  public: std::vector<Entity> newInertiaLinks;
-
   /// \brief A map of entity ids and their inertials
   public: std::map<Entity, math::Inertiald> entityInertials;
 
@@ -508,12 +748,6 @@ class ignition::gazebo::RenderUtilPrivate
   /// \param[in] _ecm The entity-component manager
   public: void PopulateViewModeVisualLinks(const EntityComponentManager &_ecm);
 
-  /// \brief A list of links used to toggle wireframe mode for visuals
-  public: std::vector<Entity> newWireframeVisualLinks;
-
-  /// \brief A list of links used to toggle transparent mode for visuals
-  public: std::vector<Entity> newTransparentVisualLinks;
-
   /// \brief A map of link entities and their corresponding children visuals
   public: std::map<Entity, std::vector<Entity>> linkToVisualEntities;
 
@@ -533,9 +767,6 @@ class ignition::gazebo::RenderUtilPrivate
   /// \param[in] _ecm The entity-component manager
   public: void FindCollisionLinks(const EntityComponentManager &_ecm);
 
-  /// \brief A list of links used to create new collision visuals
-  public: std::vector<Entity> newCollisionLinks;
-
   /// \brief A map of collision entity ids and their SDF DOM
   public: std::map<Entity, sdf::Collision> entityCollisions;
 
@@ -552,12 +783,6 @@ class ignition::gazebo::RenderUtilPrivate
   /// \brief A map of model entities and their corresponding children models
   public: std::map<Entity, std::vector<Entity>> modelToModelEntities;
 
-  /// \brief A map of entity id to thermal camera sensor configuration
-  /// properties. The elements in the tuple are:
-  /// <resolution, temperature range (min, max)>
-  public: std::unordered_map<Entity,
-      std::tuple<double, components::TemperatureRangeInfo>> thermalCameraData;
-
   /// \brief Update the visuals with label user data
   /// \param[in] _entityLabel Map with key visual entity id and value label
   public: void UpdateVisualLabels(
@@ -638,7 +863,7 @@ void RenderUtil::UpdateECM(const UpdateInfo &/*_info*/,
           const components::ParticleEmitterCmd *_emitterCmd) -> bool
       {
         // store emitter properties and update them in rendering thread
-        this->dataPtr->newParticleEmittersCmds[_entity] =
+        this->dataPtr->extracting->newParticleEmittersCmds[_entity] =
         _emitterCmd->Data();
 
         // update pose comp here
@@ -663,7 +888,7 @@ void RenderUtil::UpdateECM(const UpdateInfo &/*_info*/,
       [&](const Entity &_entity,
           const components::LightCmd * _lightCmd) -> bool
       {
-        this->dataPtr->entityLights[_entity] = _lightCmd->Data();
+        this->dataPtr->extracting->entityLights[_entity] = _lightCmd->Data();
         this->dataPtr->entityLightsCmdToDelete.push_back(_entity);
 
         auto lightComp = _ecm.Component<components::Light>(_entity);
@@ -719,7 +944,7 @@ void RenderUtil::UpdateECM(const UpdateInfo &/*_info*/,
 
         if (resolutionComp || tempRangeComp)
         {
-          this->dataPtr->thermalCameraData[_entity] =
+          this->dataPtr->extracting->thermalCameraData[_entity] =
               std::make_tuple(resolution, range);
         }
         return true;
@@ -737,7 +962,7 @@ void RenderUtil::UpdateECM(const UpdateInfo &/*_info*/,
       [&](const Entity &_entity,
           const components::VisualCmd *_visualCmd) -> bool
       {
-        this->dataPtr->entityVisuals[_entity] = _visualCmd->Data();
+        this->dataPtr->extracting->entityVisuals[_entity] = _visualCmd->Data();
         this->dataPtr->entityVisualsCmdToDelete.push_back(_entity);
 
         auto materialComp = _ecm.Component<components::Material>(_entity);
@@ -768,6 +993,7 @@ void RenderUtil::UpdateFromECM(const UpdateInfo &_info,
   IGN_PROFILE("RenderUtil::UpdateFromECM");
   std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
   this->dataPtr->simTime = _info.simTime;
+  this->dataPtr->extracting->simTime = _info.simTime;
 
   this->dataPtr->CreateRenderingEntities(_ecm, _info);
   this->dataPtr->UpdateRenderingEntities(_ecm);
@@ -777,6 +1003,95 @@ void RenderUtil::UpdateFromECM(const UpdateInfo &_info,
   this->dataPtr->FindInertialLinks(_ecm);
   this->dataPtr->FindJointModels(_ecm);
   this->dataPtr->FindCollisionLinks(_ecm);
+  this->dataPtr->PublishUpdate();
+}
+
+//////////////////////////////////////////////////
+RenderUtilPrivate::~RenderUtilPrivate()
+{
+  delete this->ready.exchange(nullptr);
+  delete this->spare.exchange(nullptr);
+}
+
+//////////////////////////////////////////////////
+void RenderUtilPrivate::PublishUpdate()
+{
+  this->pendingSensors +=
+      static_cast<int>(this->extracting->newSensors.size());
+
+  // If the render thread hasn't taken the previous data yet, take it back
+  // and merge the new data into it, so nothing is lost. Otherwise publish
+  // the new data and start extracting into a spare instance.
+  SceneUpdateData *previous = this->ready.exchange(nullptr);
+  if (previous)
+  {
+    previous->Merge(*this->extracting);
+    this->extracting->Clear();
+    this->ready.store(previous);
+    return;
+  }
+
+  this->ready.store(this->extracting.release());
+  this->extracting.reset(this->spare.exchange(nullptr));
+  if (!this->extracting)
+    this->extracting = std::make_unique<SceneUpdateData>();
+}
+
+//////////////////////////////////////////////////
+void RenderUtilPrivate::AddEntityData(SceneUpdateData &_data)
+{
+  assign(this->entityInertials, _data.entityInertials);
+  assign(this->entityCollisions, _data.entityCollisions);
+  assign(this->entityJoints, _data.entityJoints);
+  assignEach(this->matchLinksWithEntities, _data.matchLinksWithEntities);
+  appendEach(this->modelToModelEntities, _data.modelToModelEntities);
+  appendEach(this->modelToLinkEntities, _data.modelToLinkEntities);
+  appendEach(this->modelToJointEntities, _data.modelToJointEntities);
+  appendEach(this->linkToVisualEntities, _data.linkToVisualEntities);
+  appendEach(this->linkToCollisionEntities, _data.linkToCollisionEntities);
+}
+
+//////////////////////////////////////////////////
+void RenderUtilPrivate::RemoveEntityData(const Entity &_entity)
+{
+  auto inertiaIt = this->linkToInertiaVisuals.find(_entity);
+  if (inertiaIt != this->linkToInertiaVisuals.end())
+  {
+    this->sceneManager.RemoveEntity(inertiaIt->second);
+    this->linkToInertiaVisuals.erase(inertiaIt);
+  }
+
+  auto comIt = this->linkToCOMVisuals.find(_entity);
+  if (comIt != this->linkToCOMVisuals.end())
+  {
+    this->sceneManager.RemoveEntity(comIt->second);
+    this->linkToCOMVisuals.erase(comIt);
+  }
+
+  auto lightIt = this->matchLightWithVisuals.find(_entity);
+  if (lightIt != this->matchLightWithVisuals.end())
+  {
+    this->sceneManager.RemoveEntity(lightIt->second);
+    this->matchLightWithVisuals.erase(lightIt);
+  }
+
+  // Entity ids are unique, so the entity is erased from the maps of all
+  // types instead of checking what it was
+  this->entityInertials.erase(_entity);
+  this->entityCollisions.erase(_entity);
+  this->entityJoints.erase(_entity);
+  this->matchLinksWithEntities.erase(_entity);
+  this->modelToModelEntities.erase(_entity);
+  this->modelToLinkEntities.erase(_entity);
+  this->modelToJointEntities.erase(_entity);
+  this->linkToVisualEntities.erase(_entity);
+  this->linkToCollisionEntities.erase(_entity);
+  this->viewingInertias.erase(_entity);
+  this->viewingCOM.erase(_entity);
+  this->viewingJoints.erase(_entity);
+  this->viewingWireframes.erase(_entity);
+  this->viewingTransparent.erase(_entity);
+  this->viewingCollisions.erase(_entity);
 }
 
 //////////////////////////////////////////////////
@@ -840,7 +1155,8 @@ void RenderUtilPrivate::FindInertialLinks(const EntityComponentManager &_ecm)
       continue;
     }
 
-    this->newInertiaLinks.insert(this->newInertiaLinks.end(),
+    this->extracting->newInertiaLinks.insert(
+        this->extracting->newInertiaLinks.end(),
         links.begin(),
         links.end());
   }
@@ -864,7 +1180,7 @@ void RenderUtilPrivate::FindInertialLinks(const EntityComponentManager &_ecm)
       continue;
     }
 
-    this->newCOMLinks.insert(this->newCOMLinks.end(),
+    this->extracting->newCOMLinks.insert(this->extracting->newCOMLinks.end(),
         links.begin(),
         links.end());
   }
@@ -912,7 +1228,8 @@ void RenderUtilPrivate::FindJointModels(const EntityComponentManager &_ecm)
       continue;
     }
 
-    this->newJointModels.insert(this->newJointModels.end(),
+    this->extracting->newJointModels.insert(
+        this->extracting->newJointModels.end(),
         models.begin(),
         models.end());
   }
@@ -942,7 +1259,8 @@ void RenderUtilPrivate::PopulateViewModeVisualLinks(
       continue;
     }
 
-    this->newWireframeVisualLinks.insert(this->newWireframeVisualLinks.end(),
+    this->extracting->newWireframeVisualLinks.insert(
+        this->extracting->newWireframeVisualLinks.end(),
         links.begin(),
         links.end());
   }
@@ -967,8 +1285,8 @@ void RenderUtilPrivate::PopulateViewModeVisualLinks(
       continue;
     }
 
-    this->newTransparentVisualLinks.insert(
-        this->newTransparentVisualLinks.end(),
+    this->extracting->newTransparentVisualLinks.insert(
+        this->extracting->newTransparentVisualLinks.end(),
         links.begin(),
         links.end());
   }
@@ -999,7 +1317,8 @@ void RenderUtilPrivate::FindCollisionLinks(const EntityComponentManager &_ecm)
       continue;
     }
 
-    this->newCollisionLinks.insert(this->newCollisionLinks.end(),
+    this->extracting->newCollisionLinks.insert(
+        this->extracting->newCollisionLinks.end(),
         links.begin(),
         links.end());
   }
@@ -1015,10 +1334,7 @@ int RenderUtil::PendingSensors() const
   if (!this->dataPtr->scene)
     return -1;
 
-  this->dataPtr->updateMutex.lock();
-  int nSensors = this->dataPtr->newSensors.size();
-  this->dataPtr->updateMutex.unlock();
-  return nSensors;
+  return this->dataPtr->pendingSensors;
 }
 
 //////////////////////////////////////////////////
@@ -1031,74 +1347,64 @@ void RenderUtil::Update()
   if (!this->dataPtr->scene)
     return;
 
-  this->dataPtr->updateMutex.lock();
-
-  this->dataPtr->scene->SetTime(this->dataPtr->simTime);
-  auto newScenes = std::move(this->dataPtr->newScenes);
-  auto newModels = std::move(this->dataPtr->newModels);
-  auto newLinks = std::move(this->dataPtr->newLinks);
-  auto newVisuals = std::move(this->dataPtr->newVisuals);
-  auto newActors = std::move(this->dataPtr->newActors);
-  auto newLights = std::move(this->dataPtr->newLights);
-  auto newParticleEmitters = std::move(this->dataPtr->newParticleEmitters);
-  auto newParticleEmittersCmds =
-    std::move(this->dataPtr->newParticleEmittersCmds);
-  auto removeEntities = std::move(this->dataPtr->removeEntities);
-  auto entityPoses = std::move(this->dataPtr->entityPoses);
-  auto entityLights = std::move(this->dataPtr->entityLights);
-  auto entityVisuals = std::move(this->dataPtr->entityVisuals);
+  // Take the latest extracted data, if any, and hand the previously applied
+  // one back to the ECM side for reuse. This never waits on the ECM side.
+  SceneUpdateData *data = this->dataPtr->ready.exchange(nullptr);
+  if (data)
+  {
+    this->dataPtr->applying->Clear();
+    delete this->dataPtr->spare.exchange(this->dataPtr->applying.release());
+    this->dataPtr->applying.reset(data);
+    this->dataPtr->scene->SetTime(data->simTime);
+    this->dataPtr->pendingSensors -=
+        static_cast<int>(data->newSensors.size());
+  }
+  else
+  {
+    this->dataPtr->applying->Clear();
+  }
+
+  auto &newScenes = this->dataPtr->applying->newScenes;
+  auto &newModels = this->dataPtr->applying->newModels;
+  auto &newLinks = this->dataPtr->applying->newLinks;
+  auto &newVisuals = this->dataPtr->applying->newVisuals;
+  auto &newActors = this->dataPtr->applying->newActors;
+  auto &newLights = this->dataPtr->applying->newLights;
+  auto &newParticleEmitters = this->dataPtr->applying->newParticleEmitters;
+  auto &newParticleEmittersCmds =
+    this->dataPtr->applying->newParticleEmittersCmds;
+  auto &removeEntities = this->dataPtr->applying->removeEntities;
+  auto &entityPoses = this->dataPtr->applying->entityPoses;
+  auto &entityLights = this->dataPtr->applying->entityLights;
+  auto &entityVisuals = this->dataPtr->applying->entityVisuals;
   auto updateJointParentPoses =
     std::move(this->dataPtr->updateJointParentPoses);
-  auto trajectoryPoses = std::move(this->dataPtr->trajectoryPoses);
-  auto actorTransforms = std::move(this->dataPtr->actorTransforms);
-  auto actorAnimationData = std::move(this->dataPtr->actorAnimationData);
-  auto entityTemp = std::move(this->dataPtr->entityTemp);
-  auto entityLabel = std::move(this->dataPtr->entityLabel);
-  auto newTransparentVisualLinks =
-    std::move(this->dataPtr->newTransparentVisualLinks);
-  auto newInertiaLinks = std::move(this->dataPtr->newInertiaLinks);
-  auto newJointModels = std::move(this->dataPtr->newJointModels);
-  auto newCOMLinks = std::move(this->dataPtr->newCOMLinks);
-  auto newWireframeVisualLinks =
-    std::move(this->dataPtr->newWireframeVisualLinks);
-  auto newCollisionLinks = std::move(this->dataPtr->newCollisionLinks);
-  auto thermalCameraData = std::move(this->dataPtr->thermalCameraData);
-
-  this->dataPtr->newScenes.clear();
-  this->dataPtr->newModels.clear();
-  this->dataPtr->newLinks.clear();
-  this->dataPtr->newVisuals.clear();
-  this->dataPtr->newActors.clear();
-  this->dataPtr->newLights.clear();
-  this->dataPtr->newParticleEmitters.clear();
-  this->dataPtr->newParticleEmittersCmds.clear();
-  this->dataPtr->removeEntities.clear();
-  this->dataPtr->entityPoses.clear();
-  this->dataPtr->entityLights.clear();
-  this->dataPtr->entityVisuals.clear();
+  auto &trajectoryPoses = this->dataPtr->applying->trajectoryPoses;
+  auto &actorTransforms = this->dataPtr->applying->actorTransforms;
+  auto &actorAnimationData = this->dataPtr->applying->actorAnimationData;
+  auto &entityTemp = this->dataPtr->applying->entityTemp;
+  auto &entityLabel = this->dataPtr->applying->entityLabel;
+  auto &newTransparentVisualLinks =
+    this->dataPtr->applying->newTransparentVisualLinks;
+  auto &newInertiaLinks = this->dataPtr->applying->newInertiaLinks;
+  auto &newJointModels = this->dataPtr->applying->newJointModels;
+  auto &newCOMLinks = this->dataPtr->applying->newCOMLinks;
+  auto &newWireframeVisualLinks =
+    this->dataPtr->applying->newWireframeVisualLinks;
+  auto &newCollisionLinks = this->dataPtr->applying->newCollisionLinks;
+  auto &thermalCameraData = this->dataPtr->applying->thermalCameraData;
+
   this->dataPtr->updateJointParentPoses.clear();
-  this->dataPtr->trajectoryPoses.clear();
-  this->dataPtr->actorTransforms.clear();
-  this->dataPtr->actorAnimationData.clear();
-  this->dataPtr->entityTemp.clear();
-  this->dataPtr->entityLabel.clear();
-  this->dataPtr->newTransparentVisualLinks.clear();
-  this->dataPtr->newInertiaLinks.clear();
-  this->dataPtr->newJointModels.clear();
-  this->dataPtr->newCOMLinks.clear();
-  this->dataPtr->newWireframeVisualLinks.clear();
-  this->dataPtr->newCollisionLinks.clear();
-  this->dataPtr->thermalCameraData.clear();
+
+  // Added before removals are processed, so entities added and removed
+  // since the last update are forgotten
+  this->dataPtr->AddEntityData(*this->dataPtr->applying);
 
   this->dataPtr->markerManager.Update();
 
   std::vector<std::tuple<Entity, sdf::Sensor, Entity>> newSensors;
   if (this->dataPtr->enableSensors)
-  {
-    newSensors = std::move(this->dataPtr->newSensors);
-    this->dataPtr->newSensors.clear();
-  }
-  this->dataPtr->updateMutex.unlock();
+    newSensors = std::move(this->dataPtr->applying->newSensors);
 
   // scene - only one scene is supported for now
   // extend the sensor system to support mutliple scenes in the future
@@ -1139,6 +1445,7 @@ void RenderUtil::Update()
 
       this->dataPtr->RemoveSensor(entity.first);
       this->dataPtr->RemoveBoundingBox(entity.first);
+      this->dataPtr->RemoveEntityData(entity.first);
     }
   }
 
@@ -1166,20 +1473,34 @@ void RenderUtil::Update()
           entityId, std::get<1>(model), std::get<2>(model));
     }
 
+    // The data applied at once may have been extracted over several
+    // iterations. Entity ids aren't reused, so a new entity which is also
+    // being removed was removed after it was created, and is skipped.
+    auto isRemoved = [&removeEntities](const Entity &_entity)
+    {
+      return removeEntities.find(_entity) != removeEntities.end();
+    };
+
     for (const auto &link : newLinks)
     {
+      if (isRemoved(std::get<0>(link)))
+        continue;
       this->dataPtr->sceneManager.CreateLink(
           std::get<0>(link), std::get<1>(link), std::get<2>(link));
     }
 
     for (const auto &visual : newVisuals)
     {
+      if (isRemoved(std::get<0>(visual)))
+        continue;
       this->dataPtr->sceneManager.CreateVisual(
           std::get<0>(visual), std::get<1>(visual), std::get<2>(visual));
     }
 
     for (const auto &actor : newActors)
     {
+      if (isRemoved(std::get<0>(actor)))
+        continue;
       this->dataPtr->sceneManager.CreateActor(
           std::get<0>(actor), std::get<1>(actor), std::get<2>(actor),
           std::get<3>(actor));
@@ -1187,6 +1508,8 @@ void RenderUtil::Update()
 
     for (const auto &light : newLights)
     {
+      if (isRemoved(std::get<0>(light)))
+        continue;
       this->dataPtr->sceneManager.CreateLight(std::get<0>(light),
           std::get<1>(light), std::get<2>(light), std::get<3>(light));
 
@@ -1213,6 +1536,8 @@ void RenderUtil::Update()
 
     for (const auto &emitter : newParticleEmitters)
     {
+      if (isRemoved(std::get<0>(emitter)))
+        continue;
       this->dataPtr->sceneManager.CreateParticleEmitter(
           std::get<0>(emitter), std::get<1>(emitter), std::get<2>(emitter));
     }
@@ -1261,6 +1586,12 @@ void RenderUtil::Update()
   // update entities' pose
   {
     IGN_PROFILE("RenderUtil::Update Poses");
+
+    // Newer poses take precedence over skipped ones
+    auto skippedPoses = std::move(this->dataPtr->skippedPoses);
+    this->dataPtr->skippedPoses.clear();
+    entityPoses.insert(skippedPoses.begin(), skippedPoses.end());
+
     for (const auto &pose : entityPoses)
     {
       auto node = this->dataPtr->sceneManager.NodeById(pose.first);
@@ -1286,6 +1617,8 @@ void RenderUtil::Update()
           entityId == this->dataPtr->selectedEntities.back())) ||
           updateNode)
       {
+        // The pose may not change again, so retry on the next update
+        this->dataPtr->skippedPoses[pose.first] = pose.second;
         continue;
       }
 
@@ -1395,6 +1728,10 @@ void RenderUtil::Update()
   {
     for (const auto &link : newInertiaLinks)
     {
+      auto inertialIt = this->dataPtr->entityInertials.find(link);
+      if (inertialIt == this->dataPtr->entityInertials.end())
+        continue;
+
       // create a new id for the inertia visual
       auto attempts = 100000u;
       for (auto i = 0u; i < attempts; ++i)
@@ -1405,7 +1742,7 @@ void RenderUtil::Update()
         {
           rendering::VisualPtr inrVisual =
             this->dataPtr->sceneManager.CreateInertiaVisual(
-              id, this->dataPtr->entityInertials[link], link);
+              id, inertialIt->second, link);
           this->dataPtr->viewingInertias[link] = true;
           this->dataPtr->linkToInertiaVisuals[link] = id;
           break;
@@ -1423,19 +1760,17 @@ void RenderUtil::Update()
 
       for (const auto &jointEntity : jointEntities)
       {
-        if (!this->dataPtr->sceneManager.HasEntity(jointEntity))
+        auto jointIt = this->dataPtr->entityJoints.find(jointEntity);
+        if (jointIt != this->dataPtr->entityJoints.end() &&
+            !this->dataPtr->sceneManager.HasEntity(jointEntity))
         {
-          std::string childLinkName =
-              this->dataPtr->entityJoints[jointEntity].ChildLinkName();
+          const auto &joint = jointIt->second;
           Entity childId =
-              this->dataPtr->matchLinksWithEntities[model][childLinkName];
-
-          std::string parentLinkName =
-              this->dataPtr->entityJoints[jointEntity].ParentLinkName();
+              this->dataPtr->matchLinksWithEntities[model][
+              joint.ChildLinkName()];
           Entity parentId =
-              this->dataPtr->matchLinksWithEntities[model][parentLinkName];
-
-          auto joint = this->dataPtr->entityJoints[jointEntity];
+              this->dataPtr->matchLinksWithEntities[model][
+              joint.ParentLinkName()];
 
           auto vis = this->dataPtr->sceneManager.CreateJointVisual(
               jointEntity, joint, childId, parentId);
@@ -1455,6 +1790,10 @@ void RenderUtil::Update()
   {
     for (const auto &link : newCOMLinks)
     {
+      auto inertialIt = this->dataPtr->entityInertials.find(link);
+      if (inertialIt == this->dataPtr->entityInertials.end())
+        continue;
+
       // create a new id for the center of mass visual
       auto attempts = 100000u;
       for (auto i = 0u; i < attempts; ++i)
@@ -1465,7 +1804,7 @@ void RenderUtil::Update()
         {
           rendering::VisualPtr inrVisual =
             this->dataPtr->sceneManager.CreateCOMVisual(
-              id, this->dataPtr->entityInertials[link], link);
+              id, inertialIt->second, link);
           this->dataPtr->viewingCOM[link] = true;
           this->dataPtr->linkToCOMVisuals[link] = id;
           break;
@@ -1630,7 +1969,7 @@ void RenderUtilPrivate::AddNewSensor(const EntityComponentManager &_ecm,
   {
     sdfDataCopy.SetTopic(scopedName(_entity, _ecm) + _topicSuffix);
   }
-  this->newSensors.push_back(
+  this->extracting->newSensors.push_back(
       std::make_tuple(_entity, std::move(sdfDataCopy), _parent));
   this->sensorEntities.insert(_entity);
 }
@@ -1657,7 +1996,7 @@ void RenderUtilPrivate::CreateEntitiesFirstUpdate(
       {
         this->sceneManager.SetWorldId(_entity);
         const sdf::Scene &sceneSdf = _scene->Data();
-        this->newScenes.push_back(sceneSdf);
+        this->extracting->newScenes.push_back(sceneSdf);
         return true;
       });
 
@@ -1673,9 +2012,10 @@ void RenderUtilPrivate::CreateEntitiesFirstUpdate(
         sdf::Model model;
         model.SetName(_name->Data());
         model.SetRawPose(_pose->Data());
-        this->newModels.push_back(std::make_tuple(_entity, model,
+        this->extracting->newModels.push_back(std::make_tuple(_entity, model,
             _parent->Data(), _info.iterations));
-        this->modelToModelEntities[_parent->Data()].push_back(_entity);
+        this->extracting->modelToModelEntities[_parent->Data()].push_back(
+            _entity);
         return true;
       });
 
@@ -1720,14 +2060,14 @@ void RenderUtilPrivate::CreateEntitiesFirstUpdate(
           const components::Name *_name,
           const components::ParentEntity *_parent) -> bool
       {
-        this->newActors.push_back(std::make_tuple(_entity, _actor->Data(),
-            _name->Data(), _parent->Data()));
+        this->extracting->newActors.push_back(std::make_tuple(_entity,
+            _actor->Data(), _name->Data(), _parent->Data()));
 
         // set label
         auto label = _ecm.Component<components::SemanticLabel>(_entity);
         if (label != nullptr)
         {
-          this->entityLabel[_entity] = label->Data();
+          this->extracting->entityLabel[_entity] = label->Data();
         }
 
         return true;
@@ -1750,7 +2090,7 @@ void RenderUtilPrivate::CreateEntitiesFirstUpdate(
           const components::Inertial *_inrElement,
           const components::Pose *) -> bool
       {
-        this->entityInertials[_entity] = _inrElement->Data();
+        this->extracting->entityInertials[_entity] = _inrElement->Data();
         return true;
       });
 
@@ -1766,8 +2106,9 @@ void RenderUtilPrivate::CreateEntitiesFirstUpdate(
           const components::CollisionElement *_collElement,
           const components::ParentEntity *_parent) -> bool
       {
-        this->entityCollisions[_entity] = _collElement->Data();
-        this->linkToCollisionEntities[_parent->Data()].push_back(_entity);
+        this->extracting->entityCollisions[_entity] = _collElement->Data();
+        this->extracting->linkToCollisionEntities[_parent->Data()].push_back(
+            _entity);
         return true;
       });
 
@@ -1804,8 +2145,9 @@ void RenderUtilPrivate::CreateEntitiesFirstUpdate(
           joint.SetAxis(1, jointAxis2->Data());
         }
 
-        this->entityJoints[_entity] = joint;
-        this->modelToJointEntities[_parentModel->Data()].push_back(_entity);
+        this->extracting->entityJoints[_entity] = joint;
+        this->extracting->modelToJointEntities[_parentModel->Data()].push_back(
+            _entity);
         return true;
       });
 
@@ -1815,7 +2157,7 @@ void RenderUtilPrivate::CreateEntitiesFirstUpdate(
           const components::ParticleEmitter *_emitter,
           const components::ParentEntity *_parent) -> bool
       {
-        this->newParticleEmitters.push_back(
+        this->extracting->newParticleEmitters.push_back(
             std::make_tuple(_entity, _emitter->Data(), _parent->Data()));
         return true;
       });
@@ -1923,7 +2265,7 @@ void RenderUtilPrivate::CreateEntitiesRuntime(
       {
         this->sceneManager.SetWorldId(_entity);
         const sdf::Scene &sceneSdf = _scene->Data();
-        this->newScenes.push_back(sceneSdf);
+        this->extracting->newScenes.push_back(sceneSdf);
         return true;
       });
 
@@ -1938,9 +2280,10 @@ void RenderUtilPrivate::CreateEntitiesRuntime(
         sdf::Model model;
         model.SetName(_name->Data());
         model.SetRawPose(_pose->Data());
-        this->newModels.push_back(std::make_tuple(_entity, model,
+        this->extracting->newModels.push_back(std::make_tuple(_entity, model,
             _parent->Data(), _info.iterations));
-        this->modelToModelEntities[_parent->Data()].push_back(_entity);
+        this->extracting->modelToModelEntities[_parent->Data()].push_back(
+            _entity);
         return true;
       });
 
@@ -1985,7 +2328,7 @@ void RenderUtilPrivate::CreateEntitiesRuntime(
           const components::Name *_name,
           const components::ParentEntity *_parent) -> bool
       {
-        this->newActors.push_back(
+        this->extracting->newActors.push_back(
             std::make_tuple(_entity, _actor->Data(), _name->Data(),
               _parent->Data()));
 
@@ -1993,7 +2336,7 @@ void RenderUtilPrivate::CreateEntitiesRuntime(
         auto label = _ecm.Component<components::SemanticLabel>(_entity);
         if (label != nullptr)
         {
-          this->entityLabel[_entity] = label->Data();
+          this->extracting->entityLabel[_entity] = label->Data();
         }
 
         return true;
@@ -2016,7 +2359,7 @@ void RenderUtilPrivate::CreateEntitiesRuntime(
           const components::Inertial *_inrElement,
           const components::Pose *) -> bool
       {
-        this->entityInertials[_entity] = _inrElement->Data();
+        this->extracting->entityInertials[_entity] = _inrElement->Data();
         return true;
       });
 
@@ -2032,8 +2375,9 @@ void RenderUtilPrivate::CreateEntitiesRuntime(
           const components::CollisionElement *_collElement,
           const components::ParentEntity *_parent) -> bool
       {
-        this->entityCollisions[_entity] = _collElement->Data();
-        this->linkToCollisionEntities[_parent->Data()].push_back(_entity);
+        this->extracting->entityCollisions[_entity] = _collElement->Data();
+        this->extracting->linkToCollisionEntities[_parent->Data()].push_back(
+            _entity);
         return true;
       });
 
@@ -2070,8 +2414,9 @@ void RenderUtilPrivate::CreateEntitiesRuntime(
           joint.SetAxis(1, jointAxis2->Data());
         }
 
-        this->entityJoints[_entity] = joint;
-        this->modelToJointEntities[_parentModel->Data()].push_back(_entity);
+        this->extracting->entityJoints[_entity] = joint;
+        this->extracting->modelToJointEntities[_parentModel->Data()].push_back(
+            _entity);
         return true;
       });
 
@@ -2081,7 +2426,7 @@ void RenderUtilPrivate::CreateEntitiesRuntime(
           const components::ParticleEmitter *_emitter,
           const components::ParentEntity *_parent) -> bool
       {
-        this->newParticleEmitters.push_back(
+        this->extracting->newParticleEmitters.push_back(
             std::make_tuple(_entity, _emitter->Data(), _parent->Data()));
         return true;
       });
@@ -2172,42 +2517,48 @@ void RenderUtilPrivate::UpdateRenderingEntities(
     const EntityComponentManager &_ecm)
 {
   IGN_PROFILE("RenderUtilPrivate::UpdateRenderingEntities");
-  _ecm.Each<components::Model, components::Pose>(
-      [&](const Entity &_entity,
-        const components::Model *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
 
-  _ecm.Each<components::Link, components::Pose>(
-      [&](const Entity &_entity,
-        const components::Link *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
+  // Types of entities whose pose is rendered, other than actors
+  static const std::vector<ComponentTypeId> kPosedTypes{
+      components::Link::typeId,
+      components::Visual::typeId,
+      components::Model::typeId,
+      components::Light::typeId,
+      components::Camera::typeId,
+      components::DepthCamera::typeId,
+      components::RgbdCamera::typeId,
+      components::GpuLidar::typeId,
+      components::ThermalCamera::typeId,
+      components::SegmentationCamera::typeId,
+      components::BoundingBoxCamera::typeId};
+
+  // Only extract poses which changed since the last step. Static entities
+  // keep the pose their nodes were created with, or were last set to.
+  for (const auto &entity :
+      _ecm.EntitiesWithComponentChanges(components::Pose::typeId))
+  {
+    auto pose = _ecm.Component<components::Pose>(entity);
+    if (nullptr == pose)
+      continue;
 
-  // visuals
-  _ecm.Each<components::Visual, components::Pose >(
-      [&](const Entity &_entity,
-        const components::Visual *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
+    if (std::any_of(kPosedTypes.begin(), kPosedTypes.end(),
+        [&](const ComponentTypeId _type)
+        {
+          return _ecm.EntityHasComponentType(entity, _type);
+        }))
+    {
+      this->extracting->entityPoses[entity] = pose->Data();
+    }
+  }
 
-  // actors
+  // actors, which are updated every step because they're animated over time
   _ecm.Each<components::Actor, components::Pose>(
       [&](const Entity &_entity,
         const components::Actor *,
         const components::Pose *_pose)->bool
       {
         // Trajectory origin
-        this->entityPoses[_entity] = _pose->Data();
+        this->extracting->entityPoses[_entity] = _pose->Data();
 
         auto animTimeComp = _ecm.Component<components::AnimationTime>(_entity);
         auto animNameComp = _ecm.Component<components::AnimationName>(_entity);
@@ -2226,13 +2577,13 @@ void RenderUtilPrivate::UpdateRenderingEntities(
             animData.time = animTimeComp->Data();
             animData.rootTransform = skel->RootNode()->Transform();
             animData.valid = true;
-            this->actorAnimationData[_entity] = animData;
+            this->extracting->actorAnimationData[_entity] = animData;
           }
         }
         // Bone poses calculated by ign-common
         else if (this->actorManualSkeletonUpdate)
         {
-          this->actorTransforms[_entity] =
+          this->extracting->actorTransforms[_entity] =
               this->sceneManager.ActorSkeletonTransformsAt(
               _entity, this->simTime);
         }
@@ -2244,94 +2595,14 @@ void RenderUtilPrivate::UpdateRenderingEntities(
 
           if (animData.valid)
           {
-            this->actorAnimationData[_entity] = animData;
+            this->extracting->actorAnimationData[_entity] = animData;
           }
         }
 
         // Trajectory pose set by other systems
         auto trajPoseComp = _ecm.Component<components::TrajectoryPose>(_entity);
         if (trajPoseComp)
-          this->trajectoryPoses[_entity] = trajPoseComp->Data();
-        return true;
-      });
-
-  // update lights
-  _ecm.Each<components::Light, components::Pose>(
-      [&](const Entity &_entity,
-        const components::Light *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update cameras
-  _ecm.Each<components::Camera, components::Pose>(
-      [&](const Entity &_entity,
-        const components::Camera *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update depth cameras
-  _ecm.Each<components::DepthCamera, components::Pose>(
-      [&](const Entity &_entity,
-        const components::DepthCamera *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update RGBD cameras
-  _ecm.Each<components::RgbdCamera, components::Pose>(
-      [&](const Entity &_entity,
-        const components::RgbdCamera *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update gpu_lidar
-  _ecm.Each<components::GpuLidar, components::Pose>(
-      [&](const Entity &_entity,
-        const components::GpuLidar *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update thermal cameras
-  _ecm.Each<components::ThermalCamera, components::Pose>(
-      [&](const Entity &_entity,
-        const components::ThermalCamera *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update segmentation cameras
-  _ecm.Each<components::SegmentationCamera, components::Pose>(
-      [&](const Entity &_entity,
-        const components::SegmentationCamera *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
-        return true;
-      });
-
-  // Update bounding box cameras
-  _ecm.Each<components::BoundingBoxCamera, components::Pose>(
-      [&](const Entity &_entity,
-        const components::BoundingBoxCamera *,
-        const components::Pose *_pose)->bool
-      {
-        this->entityPoses[_entity] = _pose->Data();
+          this->extracting->trajectoryPoses[_entity] = trajPoseComp->Data();
         return true;
       });
 }
@@ -2344,39 +2615,14 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::Model>(
       [&](const Entity &_entity, const components::Model *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
-        this->modelToLinkEntities.erase(_entity);
-        this->modelToModelEntities.erase(_entity);
-        this->matchLinksWithEntities.erase(_entity);
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
   _ecm.EachRemoved<components::Link>(
       [&](const Entity &_entity, const components::Link *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
-        this->linkToVisualEntities.erase(_entity);
-        this->linkToCollisionEntities.erase(_entity);
-
-        if (this->linkToInertiaVisuals.find(_entity) !=
-            this->linkToInertiaVisuals.end())
-        {
-          this->removeEntities[this->linkToInertiaVisuals[_entity]] =
-            _info.iterations;
-        }
-
-        if (this->linkToCOMVisuals.find(_entity) !=
-            this->linkToCOMVisuals.end())
-        {
-          this->removeEntities[this->linkToCOMVisuals[_entity]] =
-            _info.iterations;
-        }
-
-        this->linkToInertiaVisuals.erase(_entity);
-        this->viewingInertias.erase(_entity);
-        this->linkToCOMVisuals.erase(_entity);
-        this->viewingCOM.erase(_entity);
-        this->entityInertials.erase(_entity);
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2384,7 +2630,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::Visual>(
       [&](const Entity &_entity, const components::Visual *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2392,10 +2638,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::Light>(
       [&](const Entity &_entity, const components::Light *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
-        this->removeEntities[matchLightWithVisuals[_entity]] =
-          _info.iterations;
-        matchLightWithVisuals.erase(_entity);
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2403,9 +2646,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::Joint>(
       [&](const Entity &_entity, const components::Joint *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
-        this->entityJoints.erase(_entity);
-        this->viewingJoints.erase(_entity);
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2413,7 +2654,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::ParticleEmitter>(
       [&](const Entity &_entity, const components::ParticleEmitter *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2421,7 +2662,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::Camera>(
     [&](const Entity &_entity, const components::Camera *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2429,7 +2670,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::DepthCamera>(
     [&](const Entity &_entity, const components::DepthCamera *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2437,7 +2678,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::RgbdCamera>(
     [&](const Entity &_entity, const components::RgbdCamera *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2445,7 +2686,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::GpuLidar>(
     [&](const Entity &_entity, const components::GpuLidar *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2453,7 +2694,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::ThermalCamera>(
     [&](const Entity &_entity, const components::ThermalCamera *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2461,7 +2702,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::SegmentationCamera>(
     [&](const Entity &_entity, const components::SegmentationCamera *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2469,7 +2710,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::BoundingBoxCamera>(
     [&](const Entity &_entity, const components::BoundingBoxCamera *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 
@@ -2477,9 +2718,7 @@ void RenderUtilPrivate::RemoveRenderingEntities(
   _ecm.EachRemoved<components::Collision>(
     [&](const Entity &_entity, const components::Collision *)->bool
       {
-        this->removeEntities[_entity] = _info.iterations;
-        this->viewingCollisions.erase(_entity);
-        this->entityCollisions.erase(_entity);
+        this->extracting->removeEntities[_entity] = _info.iterations;
         return true;
       });
 }
@@ -2694,7 +2933,6 @@ MarkerManager &RenderUtil::MarkerManager()
 //////////////////////////////////////////////////
 std::chrono::steady_clock::duration RenderUtil::SimTime() const
 {
-  std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
   return this->dataPtr->simTime;
 }
 
@@ -3219,6 +3457,7 @@ void RenderUtil::ViewInertia(const Entity &_entity)
     if (this->dataPtr->viewingInertias.find(inertiaLink) ==
         this->dataPtr->viewingInertias.end())
     {
+      std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
       this->dataPtr->newInertias.push_back(_entity);
       showInertiaInit = showInertia = true;
     }
@@ -3278,6 +3517,7 @@ void RenderUtil::ViewCOM(const Entity &_entity)
     if (this->dataPtr->viewingCOM.find(inertiaLink) ==
         this->dataPtr->viewingCOM.end())
     {
+      std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
       this->dataPtr->newCOMVisuals.push_back(_entity);
       showCOMInit = showCOM = true;
     }
@@ -3365,6 +3605,7 @@ void RenderUtil::ViewJoints(const Entity &_entity)
     if (this->dataPtr->viewingJoints.find(jointEntity) ==
         this->dataPtr->viewingJoints.end())
     {
+      std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
       this->dataPtr->newJoints.push_back(_entity);
       showJointInit = showJoint = true;
     }
@@ -3435,6 +3676,7 @@ void RenderUtil::ViewTransparent(const Entity &_entity)
     if (this->dataPtr->viewingTransparent.find(visEntity) ==
         this->dataPtr->viewingTransparent.end())
     {
+      std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
       this->dataPtr->newTransparentEntities.push_back(_entity);
       showTransparentInit = showTransparent = true;
     }
@@ -3507,6 +3749,7 @@ void RenderUtil::ViewWireframes(const Entity &_entity)
     if (this->dataPtr->viewingWireframes.find(visEntity) ==
         this->dataPtr->viewingWireframes.end())
     {
+      std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
       this->dataPtr->newWireframes.push_back(_entity);
       showWireframeInit = showWireframe = true;
     }
@@ -3577,6 +3820,7 @@ void RenderUtil::ViewCollisions(const Entity &_entity)
     if (this->dataPtr->viewingCollisions.find(colEntity) ==
         this->dataPtr->viewingCollisions.end())
     {
+      std::lock_guard<std::mutex> lock(this->dataPtr->updateMutex);
       this->dataPtr->newCollisions.push_back(_entity);
       showColInit = showCol = true;
     }
@@ -3669,12 +3913,12 @@ void RenderUtilPrivate::CreateLink(
    sdf::Link link;
    link.SetName(_name->Data());
    link.SetRawPose(_pose->Data());
-   this->newLinks.push_back(
+   this->extracting->newLinks.push_back(
        std::make_tuple(_entity, link, _parent->Data()));
    // used for collsions
-   this->modelToLinkEntities[_parent->Data()].push_back(_entity);
+   this->extracting->modelToLinkEntities[_parent->Data()].push_back(_entity);
    // used for joints
-   this->matchLinksWithEntities[_parent->Data()][_name->Data()] =
+   this->extracting->matchLinksWithEntities[_parent->Data()][_name->Data()] =
        _entity;
 }
 
@@ -3711,17 +3955,17 @@ void RenderUtilPrivate::CreateVisual(
     visual.SetLaserRetro(laserRetro->Data());
   }
 
-  // set label
-  auto label = _ecm.Component<components::SemanticLabel>(_entity);
+  // set label, which can be inherited from the model
+  auto label = _ecm.ComponentInherited<components::SemanticLabel>(_entity);
   if (label != nullptr)
   {
-    this->entityLabel[_entity] = label->Data();
+    this->extracting->entityLabel[_entity] = label->Data();
   }
 
   if (auto temp = _ecm.Component<components::Temperature>(_entity))
   {
     // get the uniform temperature for the entity
-    this->entityTemp[_entity] = std::make_tuple
+    this->extracting->entityTemp[_entity] = std::make_tuple
         <float, float, std::string>(temp->Data().Kelvin(), 0.0, "");
   }
   else
@@ -3734,7 +3978,7 @@ void RenderUtilPrivate::CreateVisual(
        _ecm.Component<components::TemperatureRange>(_entity);
     if (heatSignature && tempRange)
     {
-      this->entityTemp[_entity] =
+      this->extracting->entityTemp[_entity] =
         std::make_tuple<float, float, std::string>(
             tempRange->Data().min.Kelvin(),
             tempRange->Data().max.Kelvin(),
@@ -3742,10 +3986,10 @@ void RenderUtilPrivate::CreateVisual(
     }
   }
 
-  this->newVisuals.push_back(
+  this->extracting->newVisuals.push_back(
       std::make_tuple(_entity, visual, _parent->Data()));
 
-  this->linkToVisualEntities[_parent->Data()].push_back(_entity);
+  this->extracting->linkToVisualEntities[_parent->Data()].push_back(_entity);
 }
 
 /////////////////////////////////////////////////
@@ -3756,7 +4000,7 @@ void RenderUtilPrivate::CreateLight(
     const components::Name *_name,
     const components::ParentEntity *_parent)
 {
-  this->newLights.push_back(std::make_tuple(_entity, _light->Data(),
+  this->extracting->newLights.push_back(std::make_tuple(_entity, _light->Data(),
       _name->Data(), _parent->Data()));
 }
 
@@ -59,6 +59,7 @@
 #include <ignition/rendering/WireBox.hh>
 
 #include "ignition/gazebo/Conversions.hh"
+#include "ignition/gazebo/MeshAssets.hh"
 #include "ignition/gazebo/Util.hh"
 #include "ignition/gazebo/rendering/SceneManager.hh"
 
@@ -677,9 +678,7 @@ rendering::GeometryPtr SceneManager::LoadGeometry(const sdf::Geometry &_geom,
     descriptor.subMeshName = _geom.MeshShape()->Submesh();
     descriptor.centerSubMesh = _geom.MeshShape()->CenterSubmesh();
 
-    ignition::common::MeshManager *meshManager =
-        ignition::common::MeshManager::Instance();
-    descriptor.mesh = meshManager->Load(descriptor.meshName);
+    descriptor.mesh = MeshAssets::Instance().Load(descriptor.meshName);
     geom = this->dataPtr->scene->CreateMesh(descriptor);
     scale = _geom.MeshShape()->Scale();
   }
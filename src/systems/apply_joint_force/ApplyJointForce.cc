@@ -24,6 +24,7 @@
 #include <ignition/transport/Node.hh>
 
 #include "ignition/gazebo/components/JointForceCmd.hh"
+#include "ignition/gazebo/MessageBus.hh"
 #include "ignition/gazebo/Model.hh"
 #include "ignition/gazebo/Util.hh"
 
@@ -37,8 +38,8 @@ class ignition::gazebo::systems::ApplyJointForcePrivate
   /// \param[in] _msg Joint force message
   public: void OnCmdForce(const ignition::msgs::Double &_msg);
 
-  /// \brief Ignition communication node.
-  public: transport::Node node;
+  /// \brief Message bus on which commands are received
+  public: std::shared_ptr<MessageBus> bus;
 
   /// \brief Joint Entity
   public: Entity jointEntity;
@@ -47,10 +48,7 @@ class ignition::gazebo::systems::ApplyJointForcePrivate
   public: std::string jointName;
 
   /// \brief Commanded joint force
-  public: double jointForceCmd;
-
-  /// \brief mutex to protect jointForceCmd
-  public: std::mutex jointForceCmdMutex;
+  public: double jointForceCmd{0.0};
 
   /// \brief Model interface
   public: Model model{kNullEntity};
@@ -66,7 +64,7 @@ ApplyJointForce::ApplyJointForce()
 void ApplyJointForce::Configure(const Entity &_entity,
     const std::shared_ptr<const sdf::Element> &_sdf,
     EntityComponentManager &_ecm,
-    EventManager &/*_eventMgr*/)
+    EventManager &_eventMgr)
 {
   this->dataPtr->model = Model(_entity);
 
@@ -103,7 +101,8 @@ void ApplyJointForce::Configure(const Entity &_entity,
            << "]" << std::endl;
     return;
   }
-  this->dataPtr->node.Subscribe(topic, &ApplyJointForcePrivate::OnCmdForce,
+  this->dataPtr->bus = MessageBus::Instance(_eventMgr);
+  this->dataPtr->bus->Subscribe(topic, &ApplyJointForcePrivate::OnCmdForce,
                                 this->dataPtr.get());
 
   ignmsg << "ApplyJointForce subscribing to Double messages on [" << topic
@@ -142,8 +141,6 @@ void ApplyJointForce::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
   auto force = _ecm.Component<components::JointForceCmd>(
       this->dataPtr->jointEntity);
 
-  std::lock_guard<std::mutex> lock(this->dataPtr->jointForceCmdMutex);
-
   if (force == nullptr)
   {
     _ecm.CreateComponent(
@@ -159,7 +156,6 @@ void ApplyJointForce::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
 //////////////////////////////////////////////////
 void ApplyJointForcePrivate::OnCmdForce(const msgs::Double &_msg)
 {
-  std::lock_guard<std::mutex> lock(this->jointForceCmdMutex);
   this->jointForceCmd = _msg.data();
 }
 
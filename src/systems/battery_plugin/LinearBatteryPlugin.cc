@@ -555,8 +555,7 @@ void LinearBatteryPlugin::PostUpdate(const UpdateInfo &_info,
 
   // Publish battery state
   msgs::BatteryState msg;
-  msg.mutable_header()->mutable_stamp()->CopyFrom(
-      convert<msgs::Time>(_info.simTime));
+  set(msg.mutable_header()->mutable_stamp(), _info.simTime);
   msg.set_voltage(this->dataPtr->battery->Voltage());
   msg.set_current(this->dataPtr->ismooth);
   msg.set_charge(this->dataPtr->q);
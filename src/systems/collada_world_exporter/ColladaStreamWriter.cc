@@ -0,0 +1,858 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ColladaStreamWriter.hh"
+
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <fstream>
+#include <locale>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Quaternion.hh>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+using namespace collada_world_exporter;
+
+namespace
+{
+/// \brief Number of buffered submeshes which triggers a write.
+const std::size_t kMaxPendingSubMeshes = 256;
+
+/// \brief Number of buffered vertices which triggers a write. Bounds the
+/// memory used by formatted geometry.
+const std::size_t kMaxPendingVertices = 1u << 18;
+
+/// \brief Escape text for use in XML attributes and elements.
+/// \param[in] _text The text.
+/// \return Escaped text.
+std::string escape(const std::string &_text)
+{
+  std::string result;
+  result.reserve(_text.size());
+  for (char c : _text)
+  {
+    switch (c)
+    {
+      case '&': result += "&amp;"; break;
+      case '<': result += "&lt;"; break;
+      case '>': result += "&gt;"; break;
+      case '"': result += "&quot;"; break;
+      case '\'': result += "&apos;"; break;
+      default: result += c;
+    }
+  }
+  return result;
+}
+
+/// \brief Append a number followed by a space.
+/// \param[in, out] _out Text to append to.
+/// \param[in] _value The number.
+void appendNumber(std::string &_out, double _value)
+{
+  // COLLADA numbers always use a dot, whatever the locale of the process
+#if defined(__cpp_lib_to_chars)
+  char buffer[32];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), _value,
+      std::chars_format::general, 9);
+  *result.ptr++ = ' ';
+  _out.append(buffer, result.ptr);
+#else
+  thread_local std::ostringstream stream = []()
+  {
+    std::ostringstream classic;
+    classic.imbue(std::locale::classic());
+    classic.precision(9);
+    return classic;
+  }();
+  stream.str(std::string());
+  stream << _value << ' ';
+  _out += stream.str();
+#endif
+}
+
+/// \brief Append an index followed by a space.
+/// \param[in, out] _out Text to append to.
+/// \param[in] _value The index.
+void appendIndex(std::string &_out, unsigned int _value)
+{
+  char buffer[16];
+  auto result = std::to_chars(buffer, buffer + sizeof(buffer), _value);
+  *result.ptr++ = ' ';
+  _out.append(buffer, result.ptr);
+}
+
+/// \brief Remove the space after the last number of a list.
+/// \param[in, out] _out Text ending with a list of numbers.
+void trimList(std::string &_out)
+{
+  if (!_out.empty() && _out.back() == ' ')
+    _out.pop_back();
+}
+
+/// \brief Format a color.
+/// \param[in] _color The color.
+/// \return Red, green, blue and alpha separated by spaces.
+std::string colorText(const math::Color &_color)
+{
+  std::string result;
+  appendNumber(result, _color.R());
+  appendNumber(result, _color.G());
+  appendNumber(result, _color.B());
+  appendNumber(result, _color.A());
+  trimList(result);
+  return result;
+}
+
+/// \brief Format a matrix, row by row.
+/// \param[in] _matrix The matrix.
+/// \return The 16 elements separated by spaces.
+std::string matrixText(const math::Matrix4d &_matrix)
+{
+  std::string result;
+  for (unsigned int row = 0; row < 4; ++row)
+  {
+    for (unsigned int col = 0; col < 4; ++col)
+      appendNumber(result, _matrix(row, col));
+  }
+  trimList(result);
+  return result;
+}
+
+/// \brief Append the end of a float source.
+/// \param[in, out] _out Text to append to.
+/// \param[in] _id Identifier of the source.
+/// \param[in] _count Number of elements.
+/// \param[in] _params Names of the components of each element.
+void closeSource(std::string &_out, const std::string &_id,
+    unsigned int _count, const std::vector<const char *> &_params)
+{
+  trimList(_out);
+  _out += "</float_array>\n"
+          "          <technique_common>\n"
+          "            <accessor source=\"#" + _id + "-array\" count=\"" +
+          std::to_string(_count) + "\" stride=\"" +
+          std::to_string(_params.size()) + "\">\n";
+  for (const auto *param : _params)
+  {
+    _out += "              <param name=\"";
+    _out += param;
+    _out += "\" type=\"float\"/>\n";
+  }
+  _out += "            </accessor>\n"
+          "          </technique_common>\n"
+          "        </source>\n";
+}
+
+/// \brief Append the start of a float source.
+/// \param[in, out] _out Text to append to.
+/// \param[in] _id Identifier of the source.
+/// \param[in] _values Number of floats.
+void openSource(std::string &_out, const std::string &_id,
+    unsigned int _values)
+{
+  _out += "        <source id=\"" + _id + "\">\n"
+          "          <float_array id=\"" + _id + "-array\" count=\"" +
+          std::to_string(_values) + "\">";
+}
+
+/// \brief Transform a submesh to world coordinates and format it as a
+/// geometry element.
+/// \param[in] _placed The submesh and its placement.
+/// \param[in] _id Identifier of the geometry.
+/// \param[in] _material Symbol of the material of the triangles.
+/// \return The geometry element.
+std::string formatGeometry(const PlacedSubMesh &_placed,
+    const std::string &_id, const std::string &_material)
+{
+  const auto &subMesh = *_placed.subMesh;
+  const unsigned int vertexCount = subMesh.VertexCount();
+  const bool hasNormals = vertexCount > 0 &&
+      subMesh.NormalCount() == vertexCount;
+  const bool hasTexCoords = vertexCount > 0 &&
+      subMesh.TexCoordCount() == vertexCount;
+  const bool indexed = subMesh.IndexCount() > 0;
+  const unsigned int triangleCount =
+      (indexed ? subMesh.IndexCount() : vertexCount) / 3;
+
+  std::string out;
+  out.reserve(vertexCount * (hasNormals ? 64u : 32u) +
+      triangleCount * 24u + 2048u);
+  out += "    <geometry id=\"" + _id + "\" name=\"" +
+      escape(_placed.name) + "\">\n"
+      "      <mesh>\n";
+
+  openSource(out, _id + "-positions", vertexCount * 3);
+  for (unsigned int v = 0; v < vertexCount; ++v)
+  {
+    auto position = _placed.transform * (subMesh.Vertex(v) * _placed.scale);
+    appendNumber(out, position.X());
+    appendNumber(out, position.Y());
+    appendNumber(out, position.Z());
+  }
+  closeSource(out, _id + "-positions", vertexCount, {"X", "Y", "Z"});
+
+  if (hasNormals)
+  {
+    // Normals scale inversely to vertices
+    const auto rotation = _placed.transform.Rotation();
+    const bool invertible = _placed.scale.X() != 0 &&
+        _placed.scale.Y() != 0 && _placed.scale.Z() != 0;
+    openSource(out, _id + "-normals", vertexCount * 3);
+    for (unsigned int v = 0; v < vertexCount; ++v)
+    {
+      auto normal = subMesh.Normal(v);
+      if (invertible)
+        normal = normal / _placed.scale;
+      normal = rotation.RotateVector(normal).Normalized();
+      appendNumber(out, normal.X());
+      appendNumber(out, normal.Y());
+      appendNumber(out, normal.Z());
+    }
+    closeSource(out, _id + "-normals", vertexCount, {"X", "Y", "Z"});
+  }
+
+  if (hasTexCoords)
+  {
+    openSource(out, _id + "-texcoords", vertexCount * 2);
+    for (unsigned int v = 0; v < vertexCount; ++v)
+    {
+      // COLLADA's origin is at the bottom of the image
+      auto texCoord = subMesh.TexCoord(v);
+      appendNumber(out, texCoord.X());
+      appendNumber(out, 1.0 - texCoord.Y());
+    }
+    closeSource(out, _id + "-texcoords", vertexCount, {"S", "T"});
+  }
+
+  out += "        <vertices id=\"" + _id + "-vertices\">\n"
+         "          <input semantic=\"POSITION\" source=\"#" + _id +
+         "-positions\"/>\n"
+         "        </vertices>\n"
+         "        <triangles count=\"" + std::to_string(triangleCount) +
+         "\" material=\"" + _material + "\">\n"
+         "          <input semantic=\"VERTEX\" source=\"#" + _id +
+         "-vertices\" offset=\"0\"/>\n";
+  if (hasNormals)
+  {
+    out += "          <input semantic=\"NORMAL\" source=\"#" + _id +
+        "-normals\" offset=\"0\"/>\n";
+  }
+  if (hasTexCoords)
+  {
+    out += "          <input semantic=\"TEXCOORD\" source=\"#" + _id +
+        "-texcoords\" offset=\"0\" set=\"0\"/>\n";
+  }
+
+  out += "          <p>";
+  for (unsigned int i = 0; i < triangleCount * 3; ++i)
+  {
+    appendIndex(out, indexed ?
+        static_cast<unsigned int>(subMesh.Index(i)) : i);
+  }
+  trimList(out);
+  out += "</p>\n"
+         "        </triangles>\n"
+         "      </mesh>\n"
+         "    </geometry>\n";
+  return out;
+}
+}
+
+/// \brief Private data of ColladaStreamWriter.
+class ignition::gazebo::systems::collada_world_exporter::
+    ColladaStreamWriterPrivate
+{
+  /// \brief Format buffered submeshes in parallel and write them.
+  public: void Flush();
+
+  /// \brief Get the identifier of a material, adding it if needed.
+  /// \param[in] _material The material, may be null.
+  /// \return Identifier of the material.
+  public: std::string MaterialId(const common::MaterialPtr &_material);
+
+  /// \brief Write images, effects and materials.
+  public: void WriteMaterials();
+
+  /// \brief Write lights and the scene.
+  /// \param[in] _lights Lights of the scene.
+  public: void WriteScene(const std::vector<common::ColladaLight> &_lights);
+
+  /// \brief Close the file and remove it.
+  public: void Discard();
+
+  /// \brief A submesh waiting to be written.
+  public: struct Pending
+  {
+    /// \brief The submesh and its placement.
+    PlacedSubMesh placed;
+
+    /// \brief Identifier of the geometry.
+    std::string geometryId;
+
+    /// \brief Identifier of the material.
+    std::string materialId;
+  };
+
+  /// \brief A node of the scene, instancing a geometry.
+  public: struct Node
+  {
+    /// \brief Name of the node.
+    std::string name;
+
+    /// \brief Identifier of the geometry.
+    std::string geometryId;
+
+    /// \brief Identifier of the material.
+    std::string materialId;
+  };
+
+  /// \brief File being written, renamed to filePath once complete.
+  public: std::ofstream file;
+
+  /// \brief Path of the file being written.
+  public: std::string tempPath;
+
+  /// \brief Path of the COLLADA file.
+  public: std::string filePath;
+
+  /// \brief Directory textures are copied to.
+  public: std::string texturePath;
+
+  /// \brief Name of the scene.
+  public: std::string name;
+
+  /// \brief Number of threads formatting geometry, 0 for one per core.
+  public: unsigned int threads{0};
+
+  /// \brief Submeshes waiting to be written.
+  public: std::vector<Pending> pending;
+
+  /// \brief Number of vertices of the submeshes waiting to be written.
+  public: std::size_t pendingVertices{0};
+
+  /// \brief Nodes of the scene, one per submesh.
+  public: std::vector<Node> nodes;
+
+  /// \brief Materials, in the order of their identifiers.
+  public: std::vector<common::MaterialPtr> materials;
+
+  /// \brief Index of each material in materials.
+  public: std::unordered_map<const common::Material *, std::size_t>
+      materialIndices;
+
+  /// \brief Material of submeshes without one.
+  public: common::MaterialPtr defaultMaterial;
+
+  /// \brief Whether the geometry library was started.
+  public: bool geometriesOpen{false};
+
+  /// \brief Whether writing failed.
+  public: bool failed{false};
+};
+
+//////////////////////////////////////////////////
+void ColladaStreamWriterPrivate::Flush()
+{
+  if (this->pending.empty() || this->failed)
+    return;
+
+  std::size_t threadCount = this->threads > 0 ? this->threads :
+      std::max(1u, std::thread::hardware_concurrency());
+  threadCount = std::min(threadCount, this->pending.size());
+
+  std::vector<std::string> chunks(this->pending.size());
+  auto format = [&](std::size_t _first)
+  {
+    for (std::size_t i = _first; i < this->pending.size(); i += threadCount)
+    {
+      const auto &item = this->pending[i];
+      chunks[i] = formatGeometry(item.placed, item.geometryId,
+          item.materialId);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (std::size_t t = 1; t < threadCount; ++t)
+    workers.emplace_back(format, t);
+  format(0);
+  for (auto &worker : workers)
+    worker.join();
+
+  if (!this->geometriesOpen)
+  {
+    this->file << "  <library_geometries>\n";
+    this->geometriesOpen = true;
+  }
+  for (const auto &chunk : chunks)
+    this->file << chunk;
+
+  this->pending.clear();
+  this->pendingVertices = 0;
+
+  if (!this->file)
+  {
+    ignerr << "Failed to write [" << this->tempPath << "]." << std::endl;
+    this->failed = true;
+  }
+}
+
+//////////////////////////////////////////////////
+std::string ColladaStreamWriterPrivate::MaterialId(
+    const common::MaterialPtr &_material)
+{
+  auto material = _material;
+  if (!material)
+  {
+    if (!this->defaultMaterial)
+      this->defaultMaterial = std::make_shared<common::Material>();
+    material = this->defaultMaterial;
+  }
+
+  auto it = this->materialIndices.find(material.get());
+  if (it == this->materialIndices.end())
+  {
+    it = this->materialIndices.emplace(material.get(),
+        this->materials.size()).first;
+    this->materials.push_back(material);
+  }
+  return "material_" + std::to_string(it->second);
+}
+
+//////////////////////////////////////////////////
+void ColladaStreamWriterPrivate::WriteMaterials()
+{
+  // Copy textures, materials whose texture is missing keep their color.
+  // Each source file is copied once, over files left by earlier exports,
+  // and files with the same name from different directories are numbered.
+  std::vector<std::string> images(this->materials.size());
+  std::unordered_map<std::string, std::string> copies;
+  std::unordered_set<std::string> names;
+  for (std::size_t i = 0; i < this->materials.size(); ++i)
+  {
+    const auto texture = this->materials[i]->TextureImage();
+    if (texture.empty())
+      continue;
+
+    auto copied = copies.find(texture);
+    if (copied != copies.end())
+    {
+      images[i] = copied->second;
+      continue;
+    }
+
+    auto image = common::basename(texture);
+    const auto dot = image.rfind('.');
+    const auto stem = image.substr(0, dot);
+    const auto extension =
+        dot == std::string::npos ? std::string() : image.substr(dot);
+    for (unsigned int n = 1; names.count(image) > 0; ++n)
+      image = stem + "_" + std::to_string(n) + extension;
+
+    const auto copy = common::joinPaths(this->texturePath, image);
+    if ((common::exists(copy) && !common::removeFile(copy)) ||
+        !common::copyFile(texture, copy))
+    {
+      ignwarn << "Failed to copy texture [" << texture << "]." << std::endl;
+      copies[texture] = std::string();
+      continue;
+    }
+    names.insert(image);
+    copies[texture] = image;
+    images[i] = image;
+  }
+
+  if (std::any_of(images.begin(), images.end(),
+      [](const std::string &_image) {return !_image.empty();}))
+  {
+    this->file << "  <library_images>\n";
+    for (std::size_t i = 0; i < images.size(); ++i)
+    {
+      if (images[i].empty())
+        continue;
+      const auto id = "material_" + std::to_string(i);
+      this->file << "    <image id=\"" << id << "_image\">\n"
+                 << "      <init_from>../materials/textures/"
+                 << escape(images[i]) << "</init_from>\n"
+                 << "    </image>\n";
+    }
+    this->file << "  </library_images>\n";
+  }
+
+  if (this->materials.empty())
+    return;
+
+  this->file << "  <library_effects>\n";
+  for (std::size_t i = 0; i < this->materials.size(); ++i)
+  {
+    const auto &material = this->materials[i];
+    const auto id = "material_" + std::to_string(i);
+    this->file << "    <effect id=\"" << id << "_fx\">\n"
+               << "      <profile_COMMON>\n";
+    if (!images[i].empty())
+    {
+      this->file << "        <newparam sid=\"" << id << "_surface\">\n"
+                 << "          <surface type=\"2D\">\n"
+                 << "            <init_from>" << id << "_image</init_from>\n"
+                 << "          </surface>\n"
+                 << "        </newparam>\n"
+                 << "        <newparam sid=\"" << id << "_sampler\">\n"
+                 << "          <sampler2D>\n"
+                 << "            <source>" << id << "_surface</source>\n"
+                 << "          </sampler2D>\n"
+                 << "        </newparam>\n";
+    }
+    this->file << "        <technique sid=\"common\">\n"
+               << "          <phong>\n"
+               << "            <emission><color>"
+               << colorText(material->Emissive()) << "</color></emission>\n"
+               << "            <ambient><color>"
+               << colorText(material->Ambient()) << "</color></ambient>\n";
+    if (!images[i].empty())
+    {
+      this->file << "            <diffuse><texture texture=\"" << id
+                 << "_sampler\" texcoord=\"UVSET0\"/></diffuse>\n";
+    }
+    else
+    {
+      this->file << "            <diffuse><color>"
+                 << colorText(material->Diffuse()) << "</color></diffuse>\n";
+    }
+
+    // With A_ONE, opacity is the alpha of <transparent> times
+    // <transparency>
+    std::string shininess;
+    appendNumber(shininess, material->Shininess());
+    trimList(shininess);
+    std::string opacity;
+    appendNumber(opacity, 1.0 - material->Transparency());
+    trimList(opacity);
+    this->file << "            <specular><color>"
+               << colorText(material->Specular()) << "</color></specular>\n"
+               << "            <shininess><float>" << shininess
+               << "</float></shininess>\n"
+               << "            <transparent opaque=\"A_ONE\">"
+               << "<color>1 1 1 1</color></transparent>\n"
+               << "            <transparency><float>" << opacity
+               << "</float></transparency>\n"
+               << "          </phong>\n"
+               << "        </technique>\n"
+               << "      </profile_COMMON>\n"
+               << "    </effect>\n";
+  }
+  this->file << "  </library_effects>\n"
+             << "  <library_materials>\n";
+  for (std::size_t i = 0; i < this->materials.size(); ++i)
+  {
+    const auto id = "material_" + std::to_string(i);
+    this->file << "    <material id=\"" << id << "\" name=\"" << id << "\">\n"
+               << "      <instance_effect url=\"#" << id << "_fx\"/>\n"
+               << "    </material>\n";
+  }
+  this->file << "  </library_materials>\n";
+}
+
+//////////////////////////////////////////////////
+void ColladaStreamWriterPrivate::WriteScene(
+    const std::vector<common::ColladaLight> &_lights)
+{
+  std::vector<std::size_t> lights;
+  for (std::size_t i = 0; i < _lights.size(); ++i)
+  {
+    const auto &type = _lights[i].type;
+    if (type == "point" || type == "spot" || type == "directional")
+    {
+      lights.push_back(i);
+    }
+    else
+    {
+      ignwarn << "Skipping light [" << _lights[i].name << "] of unknown type."
+              << std::endl;
+    }
+  }
+
+  auto number = [](double _value)
+  {
+    std::string result;
+    appendNumber(result, _value);
+    trimList(result);
+    return result;
+  };
+
+  if (!lights.empty())
+  {
+    this->file << "  <library_lights>\n";
+    for (auto i : lights)
+    {
+      const auto &light = _lights[i];
+      auto color = colorText(light.diffuse);
+      // Lights have no alpha
+      color.erase(color.rfind(' '));
+
+      this->file << "    <light id=\"light_" << i << "\" name=\""
+                 << escape(light.name) << "\">\n"
+                 << "      <technique_common>\n"
+                 << "        <" << light.type << ">\n"
+                 << "          <color>" << color << "</color>\n";
+      if (light.type != "directional")
+      {
+        this->file << "          <constant_attenuation>"
+                   << number(light.constantAttenuation)
+                   << "</constant_attenuation>\n"
+                   << "          <linear_attenuation>"
+                   << number(light.linearAttenuation)
+                   << "</linear_attenuation>\n"
+                   << "          <quadratic_attenuation>"
+                   << number(light.quadraticAttenuation)
+                   << "</quadratic_attenuation>\n";
+      }
+      if (light.type == "spot")
+      {
+        this->file << "          <falloff_angle>"
+                   << number(light.falloffAngleDeg) << "</falloff_angle>\n"
+                   << "          <falloff_exponent>"
+                   << number(light.falloffExponent)
+                   << "</falloff_exponent>\n";
+      }
+      this->file << "        </" << light.type << ">\n"
+                 << "      </technique_common>\n"
+                 << "    </light>\n";
+    }
+    this->file << "  </library_lights>\n";
+  }
+
+  this->file << "  <library_visual_scenes>\n"
+             << "    <visual_scene id=\"scene\" name=\""
+             << escape(this->name) << "\">\n";
+  for (std::size_t i = 0; i < this->nodes.size(); ++i)
+  {
+    const auto &node = this->nodes[i];
+    this->file << "      <node id=\"node_" << i << "\" name=\""
+               << escape(node.name) << "\">\n"
+               << "        <instance_geometry url=\"#" << node.geometryId
+               << "\">\n"
+               << "          <bind_material>\n"
+               << "            <technique_common>\n"
+               << "              <instance_material symbol=\""
+               << node.materialId << "\" target=\"#" << node.materialId
+               << "\">\n"
+               << "                <bind_vertex_input semantic=\"UVSET0\" "
+               << "input_semantic=\"TEXCOORD\" input_set=\"0\"/>\n"
+               << "              </instance_material>\n"
+               << "            </technique_common>\n"
+               << "          </bind_material>\n"
+               << "        </instance_geometry>\n"
+               << "      </node>\n";
+  }
+
+  for (auto i : lights)
+  {
+    // Lights shine along -Z
+    const auto &light = _lights[i];
+    math::Quaterniond rotation;
+    if (light.direction.Length() > 0)
+    {
+      rotation.From2Axes(-math::Vector3d::UnitZ,
+          light.direction.Normalized());
+    }
+    math::Matrix4d matrix(math::Pose3d(light.position, rotation));
+
+    this->file << "      <node id=\"light_" << i << "_node\" name=\""
+               << escape(light.name) << "\">\n"
+               << "        <matrix>" << matrixText(matrix) << "</matrix>\n"
+               << "        <instance_light url=\"#light_" << i << "\"/>\n"
+               << "      </node>\n";
+  }
+
+  this->file << "    </visual_scene>\n"
+             << "  </library_visual_scenes>\n"
+             << "  <scene>\n"
+             << "    <instance_visual_scene url=\"#scene\"/>\n"
+             << "  </scene>\n"
+             << "</COLLADA>\n";
+}
+
+//////////////////////////////////////////////////
+void ColladaStreamWriterPrivate::Discard()
+{
+  if (this->file.is_open())
+    this->file.close();
+  if (!this->tempPath.empty())
+    common::removeFile(this->tempPath);
+  this->pending.clear();
+}
+
+//////////////////////////////////////////////////
+ColladaStreamWriter::ColladaStreamWriter()
+    : dataPtr(std::make_unique<ColladaStreamWriterPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+ColladaStreamWriter::~ColladaStreamWriter()
+{
+  if (this->dataPtr->file.is_open())
+    this->dataPtr->Discard();
+}
+
+//////////////////////////////////////////////////
+bool ColladaStreamWriter::Open(const std::string &_directory,
+    const std::string &_name)
+{
+  if (this->dataPtr->file.is_open())
+  {
+    ignerr << "Already writing [" << this->dataPtr->filePath << "]."
+           << std::endl;
+    return false;
+  }
+
+  const auto meshPath = common::joinPaths(_directory, "meshes");
+  this->dataPtr->texturePath = common::joinPaths(_directory, "materials",
+      "textures");
+  if (!common::createDirectories(meshPath) ||
+      !common::createDirectories(this->dataPtr->texturePath))
+  {
+    ignerr << "Failed to create directory [" << _directory << "]."
+           << std::endl;
+    return false;
+  }
+
+  this->dataPtr->name = _name;
+  this->dataPtr->filePath = common::joinPaths(meshPath, _name + ".dae");
+  this->dataPtr->tempPath = this->dataPtr->filePath + ".tmp";
+  this->dataPtr->file.open(this->dataPtr->tempPath,
+      std::ios::out | std::ios::trunc);
+  if (!this->dataPtr->file)
+  {
+    ignerr << "Failed to create [" << this->dataPtr->tempPath << "]."
+           << std::endl;
+    return false;
+  }
+
+  this->dataPtr->failed = false;
+  this->dataPtr->geometriesOpen = false;
+  this->dataPtr->nodes.clear();
+  this->dataPtr->materials.clear();
+  this->dataPtr->materialIndices.clear();
+
+  char date[32];
+  std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ",
+      std::gmtime(&now));
+
+  this->dataPtr->file
+      << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+      << "<COLLADA xmlns=\"http://www.collada.org/2005/11/COLLADASchema\" "
+      << "version=\"1.4.1\">\n"
+      << "  <asset>\n"
+      << "    <contributor>\n"
+      << "      <authoring_tool>Ignition Gazebo</authoring_tool>\n"
+      << "    </contributor>\n"
+      << "    <created>" << date << "</created>\n"
+      << "    <modified>" << date << "</modified>\n"
+      << "    <unit name=\"meter\" meter=\"1\"/>\n"
+      << "    <up_axis>Z_UP</up_axis>\n"
+      << "  </asset>\n";
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ColladaStreamWriter::Add(const PlacedSubMesh &_subMesh)
+{
+  if (!this->dataPtr->file.is_open() || this->dataPtr->failed ||
+      !_subMesh.subMesh)
+  {
+    return false;
+  }
+
+  if (_subMesh.subMesh->SubMeshPrimitiveType() != common::SubMesh::TRIANGLES)
+  {
+    ignwarn << "Skipping submesh of [" << _subMesh.name
+            << "] which isn't a triangle list." << std::endl;
+    return true;
+  }
+
+  ColladaStreamWriterPrivate::Pending item;
+  item.placed = _subMesh;
+  item.geometryId = "geometry_" + std::to_string(this->dataPtr->nodes.size());
+  item.materialId = this->dataPtr->MaterialId(_subMesh.material);
+  this->dataPtr->nodes.push_back({_subMesh.name, item.geometryId,
+      item.materialId});
+
+  this->dataPtr->pendingVertices += _subMesh.subMesh->VertexCount();
+  this->dataPtr->pending.push_back(std::move(item));
+  if (this->dataPtr->pending.size() >= kMaxPendingSubMeshes ||
+      this->dataPtr->pendingVertices >= kMaxPendingVertices)
+  {
+    this->dataPtr->Flush();
+  }
+  return !this->dataPtr->failed;
+}
+
+//////////////////////////////////////////////////
+bool ColladaStreamWriter::Close(
+    const std::vector<common::ColladaLight> &_lights)
+{
+  if (!this->dataPtr->file.is_open())
+    return false;
+
+  this->dataPtr->Flush();
+  if (this->dataPtr->geometriesOpen)
+    this->dataPtr->file << "  </library_geometries>\n";
+  this->dataPtr->WriteMaterials();
+  this->dataPtr->WriteScene(_lights);
+  this->dataPtr->file.close();
+
+  if (this->dataPtr->failed || this->dataPtr->file.fail())
+  {
+    ignerr << "Failed to write [" << this->dataPtr->tempPath << "]."
+           << std::endl;
+    this->dataPtr->Discard();
+    return false;
+  }
+
+  if (!common::moveFile(this->dataPtr->tempPath, this->dataPtr->filePath))
+  {
+    ignerr << "Failed to move [" << this->dataPtr->tempPath << "] to ["
+           << this->dataPtr->filePath << "]." << std::endl;
+    this->dataPtr->Discard();
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::string ColladaStreamWriter::FilePath() const
+{
+  return this->dataPtr->filePath;
+}
+
+//////////////////////////////////////////////////
+void ColladaStreamWriter::SetThreadCount(unsigned int _threads)
+{
+  this->dataPtr->threads = _threads;
+}
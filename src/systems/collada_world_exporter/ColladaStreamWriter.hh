@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_COLLADA_WORLD_EXPORTER_COLLADASTREAMWRITER_HH_
+#define IGNITION_GAZEBO_SYSTEMS_COLLADA_WORLD_EXPORTER_COLLADASTREAMWRITER_HH_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/ColladaExporter.hh>
+#include <ignition/common/Material.hh>
+#include <ignition/common/SubMesh.hh>
+#include <ignition/math/Matrix4.hh>
+#include <ignition/math/Vector3.hh>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/collada-world-exporter-system/Export.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+namespace collada_world_exporter
+{
+  // Forward declarations.
+  class ColladaStreamWriterPrivate;
+
+  /// \brief A submesh placed in the world.
+  struct PlacedSubMesh
+  {
+    /// \brief The submesh, which isn't modified.
+    std::shared_ptr<const common::SubMesh> subMesh;
+
+    /// \brief Name of the node of the submesh.
+    std::string name;
+
+    /// \brief Scale applied to the vertices before the transform.
+    math::Vector3d scale{math::Vector3d::One};
+
+    /// \brief Transform from the submesh to the world.
+    math::Matrix4d transform{math::Matrix4d::Identity};
+
+    /// \brief Material of the submesh, may be null.
+    common::MaterialPtr material;
+  };
+
+  /// \brief Writes a COLLADA file incrementally, so the merged geometry of
+  /// a world never needs to be held in memory.
+  ///
+  /// Submeshes are buffered in small batches. Each batch is transformed to
+  /// world coordinates and formatted in parallel, then appended to the file
+  /// in the order submeshes were added. Materials, lights and the scene,
+  /// which are small, are written when the file is closed.
+  ///
+  /// The output follows the layout of common::ColladaExporter:
+  /// `<directory>/meshes/<name>.dae`, with textures copied to
+  /// `<directory>/materials/textures`.
+  class IGNITION_GAZEBO_COLLADA_WORLD_EXPORTER_SYSTEM_VISIBLE
+      ColladaStreamWriter
+  {
+    /// \brief Constructor
+    public: ColladaStreamWriter();
+
+    /// \brief Destructor. Discards the file if it wasn't closed.
+    public: ~ColladaStreamWriter();
+
+    /// \brief Start writing a file.
+    /// \param[in] _directory Directory of the export, created if needed.
+    /// \param[in] _name Name of the scene and of the COLLADA file.
+    /// \return True if the file could be created.
+    public: bool Open(const std::string &_directory, const std::string &_name);
+
+    /// \brief Add a submesh. Only triangle lists are supported.
+    /// \param[in] _subMesh The submesh and its placement.
+    /// \return False if the file isn't open or couldn't be written.
+    public: bool Add(const PlacedSubMesh &_subMesh);
+
+    /// \brief Write what's left and finish the file.
+    /// \param[in] _lights Lights of the scene.
+    /// \return True if the whole file was written.
+    public: bool Close(const std::vector<common::ColladaLight> &_lights);
+
+    /// \brief Get the path of the COLLADA file.
+    /// \return Path, empty if no file was opened.
+    public: std::string FilePath() const;
+
+    /// \brief Set the number of threads formatting geometry.
+    /// \param[in] _threads Number of threads, 0 to use one per core.
+    public: void SetThreadCount(unsigned int _threads);
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<ColladaStreamWriterPrivate> dataPtr;
+  };
+}
+}
+}
+}
+}
+#endif
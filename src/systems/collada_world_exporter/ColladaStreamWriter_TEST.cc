@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <clocale>
+#include <fstream>
+#include <locale>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <ignition/common/ColladaLoader.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Mesh.hh>
+#include <ignition/math/Pose3.hh>
+
+#include "ignition/gazebo/test_config.hh"
+
+#include "ColladaStreamWriter.hh"
+
+using namespace ignition;
+using namespace gazebo::systems::collada_world_exporter;
+
+/////////////////////////////////////////////////
+TEST(ColladaStreamWriterTest, Write)
+{
+  const std::string directory = common::joinPaths(PROJECT_BINARY_PATH,
+      "ColladaStreamWriter_TEST");
+  common::removeAll(directory);
+
+  auto triangle = std::make_shared<common::SubMesh>();
+  triangle->SetPrimitiveType(common::SubMesh::TRIANGLES);
+  triangle->AddVertex(math::Vector3d(0, 0, 0));
+  triangle->AddVertex(math::Vector3d(1, 0, 0));
+  triangle->AddVertex(math::Vector3d(0, 1, 0));
+  for (int i = 0; i < 3; ++i)
+  {
+    triangle->AddNormal(math::Vector3d::UnitZ);
+    triangle->AddTexCoord(math::Vector2d(0, 0));
+  }
+  triangle->AddIndex(0);
+  triangle->AddIndex(1);
+  triangle->AddIndex(2);
+
+  auto lines = std::make_shared<common::SubMesh>();
+  lines->SetPrimitiveType(common::SubMesh::LINES);
+  lines->AddVertex(math::Vector3d::Zero);
+  lines->AddVertex(math::Vector3d::One);
+
+  auto red = std::make_shared<common::Material>();
+  red->SetDiffuse(math::Color::Red);
+
+  ColladaStreamWriter writer;
+  writer.SetThreadCount(4);
+  PlacedSubMesh placed;
+  EXPECT_FALSE(writer.Add(placed));
+
+  ASSERT_TRUE(writer.Open(directory, "stream_world"));
+  EXPECT_EQ(common::joinPaths(directory, "meshes", "stream_world.dae"),
+      writer.FilePath());
+
+  // More submeshes than are buffered, so they're written in several batches
+  const unsigned int count = 600;
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    placed.subMesh = triangle;
+    placed.name = "triangle_" + std::to_string(i);
+    placed.scale = math::Vector3d(2, 2, 2);
+    placed.transform = math::Matrix4d(math::Pose3d(i, 0, 0, 0, 0, 0));
+    placed.material = red;
+    EXPECT_TRUE(writer.Add(placed));
+  }
+
+  // Skipped
+  placed.subMesh = lines;
+  EXPECT_TRUE(writer.Add(placed));
+
+  common::ColladaLight sun;
+  sun.name = "sun";
+  sun.type = "directional";
+  sun.direction = -math::Vector3d::UnitZ;
+  sun.diffuse = math::Color::White;
+  ASSERT_TRUE(writer.Close({sun}));
+  EXPECT_TRUE(common::exists(writer.FilePath()));
+  EXPECT_FALSE(common::exists(writer.FilePath() + ".tmp"));
+
+  common::ColladaLoader loader;
+  std::unique_ptr<common::Mesh> mesh(loader.Load(writer.FilePath()));
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(count, mesh->SubMeshCount());
+  EXPECT_EQ(math::Vector3d(count - 1 + 2, 2, 0), mesh->Max());
+  EXPECT_EQ(math::Vector3d::Zero, mesh->Min());
+  auto first = mesh->SubMeshByIndex(0).lock();
+  ASSERT_NE(nullptr, first);
+  auto material = mesh->MaterialByIndex(first->MaterialIndex());
+  ASSERT_NE(nullptr, material);
+  EXPECT_EQ(math::Color::Red, material->Diffuse());
+
+  common::removeAll(directory);
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a whole file.
+/// \param[in] _path Path of the file.
+/// \return Contents of the file.
+std::string readFile(const std::string &_path)
+{
+  std::ifstream file(_path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+/////////////////////////////////////////////////
+/// \brief Numbers with a decimal comma.
+class CommaPunct : public std::numpunct<char>
+{
+  protected: char do_decimal_point() const override
+  {
+    return ',';
+  }
+};
+
+/////////////////////////////////////////////////
+TEST(ColladaStreamWriterTest, TexturesAndLocale)
+{
+  const std::string directory = common::joinPaths(PROJECT_BINARY_PATH,
+      "ColladaStreamWriter_TEST_textures");
+  common::removeAll(directory);
+
+  // Two textures with the same name in different directories
+  const auto dirA = common::joinPaths(directory, "a");
+  const auto dirB = common::joinPaths(directory, "b");
+  const auto textures = common::joinPaths(directory, "materials", "textures");
+  ASSERT_TRUE(common::createDirectories(dirA));
+  ASSERT_TRUE(common::createDirectories(dirB));
+  ASSERT_TRUE(common::createDirectories(textures));
+  std::ofstream(common::joinPaths(dirA, "texture.png")) << "a";
+  std::ofstream(common::joinPaths(dirB, "texture.png")) << "b";
+
+  // Left by an earlier export
+  std::ofstream(common::joinPaths(textures, "texture.png")) << "old";
+
+  auto triangle = std::make_shared<common::SubMesh>();
+  triangle->SetPrimitiveType(common::SubMesh::TRIANGLES);
+  triangle->AddVertex(math::Vector3d(0, 0, 0));
+  triangle->AddVertex(math::Vector3d(1, 0, 0));
+  triangle->AddVertex(math::Vector3d(0, 1, 0));
+  for (int i = 0; i < 3; ++i)
+  {
+    triangle->AddNormal(math::Vector3d::UnitZ);
+    triangle->AddTexCoord(math::Vector2d(0, 0));
+  }
+  triangle->AddIndex(0);
+  triangle->AddIndex(1);
+  triangle->AddIndex(2);
+
+  auto materialA = std::make_shared<common::Material>();
+  materialA->SetTextureImage(common::joinPaths(dirA, "texture.png"));
+  auto materialA2 = std::make_shared<common::Material>();
+  materialA2->SetTextureImage(common::joinPaths(dirA, "texture.png"));
+  materialA2->SetDiffuse(math::Color::Red);
+  auto materialB = std::make_shared<common::Material>();
+  materialB->SetTextureImage(common::joinPaths(dirB, "texture.png"));
+
+  // Numbers are written with a dot whatever the locale
+  const std::string previousCLocale = std::setlocale(LC_NUMERIC, nullptr);
+  std::setlocale(LC_NUMERIC, "de_DE.UTF-8");
+  const auto previousLocale = std::locale::global(
+      std::locale(std::locale::classic(), new CommaPunct));
+
+  ColladaStreamWriter writer;
+  ASSERT_TRUE(writer.Open(directory, "textures"));
+  for (const auto &material : {materialA, materialA2, materialB})
+  {
+    PlacedSubMesh placed;
+    placed.subMesh = triangle;
+    placed.name = "triangle";
+    placed.transform = math::Matrix4d(math::Pose3d(0.5, 0, 0, 0, 0, 0));
+    placed.material = material;
+    EXPECT_TRUE(writer.Add(placed));
+  }
+  EXPECT_TRUE(writer.Close({}));
+
+  std::locale::global(previousLocale);
+  std::setlocale(LC_NUMERIC, previousCLocale.c_str());
+
+  // The old file is replaced, and the texture from the other directory is
+  // renamed. Materials sharing a texture share the copy.
+  EXPECT_EQ("a", readFile(common::joinPaths(textures, "texture.png")));
+  EXPECT_EQ("b", readFile(common::joinPaths(textures, "texture_1.png")));
+  EXPECT_FALSE(common::exists(common::joinPaths(textures, "texture_2.png")));
+
+  const auto dae = readFile(writer.FilePath());
+  EXPECT_NE(std::string::npos, dae.find("0.5 0 0 1.5 0 0 0.5 1 0"));
+  EXPECT_EQ(std::string::npos, dae.find("0,5"));
+  EXPECT_NE(std::string::npos, dae.find("textures/texture_1.png"));
+
+  common::ColladaLoader loader;
+  std::unique_ptr<common::Mesh> mesh(loader.Load(writer.FilePath()));
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(3u, mesh->SubMeshCount());
+
+  common::removeAll(directory);
+}
@@ -32,6 +32,7 @@
 #include <ignition/gazebo/components/Visual.hh>
 #include <ignition/gazebo/components/World.hh>
 #include <ignition/gazebo/EntityComponentManager.hh>
+#include <ignition/gazebo/MeshAssets.hh>
 #include <ignition/gazebo/Util.hh>
 
 #include <sdf/Light.hh>
@@ -48,6 +49,7 @@
 
 #include <ignition/common/ColladaExporter.hh>
 
+#include "ColladaStreamWriter.hh"
 #include "ColladaWorldExporter.hh"
 
 using namespace ignition;
@@ -68,19 +70,25 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
   public: void Export(const EntityComponentManager &_ecm)
   {
     if (this->exported) return;
+    this->exported = true;
 
-    common::Mesh worldMesh;
-    std::vector<math::Matrix4d> subMeshMatrix;
-
+    std::string worldName;
     _ecm.Each<components::World, components::Name>(
       [&](const Entity /*& _entity*/,
         const components::World *,
         const components::Name * _name)->bool
     {
-      worldMesh.SetName(_name->Data());
+      worldName = _name->Data();
       return true;
     });
 
+    // Geometry is written as it's found, so the merged world is never held
+    // in memory
+    collada_world_exporter::ColladaStreamWriter writer;
+    const std::string directory = "./" + worldName;
+    if (!writer.Open(directory, worldName))
+      return;
+
     _ecm.Each<components::Visual,
             components::Name,
             components::Geometry,
@@ -108,32 +116,26 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
       mat->SetTransparency(_transparency->Data());
 
       const ignition::common::Mesh *mesh;
-      std::weak_ptr<ignition::common::SubMesh> subm;
       math::Vector3d scale;
       math::Matrix4d matrix(worldPose);
       ignition::common::MeshManager *meshManager =
           ignition::common::MeshManager::Instance();
 
-      auto addSubmeshFunc = [&](int _matIndex)
+      auto addSubmeshFunc = [&](
+          const std::shared_ptr<const common::SubMesh> &_subMesh,
+          int _matIndex)
       {
-        int newMatIndex = 0;
+        collada_world_exporter::PlacedSubMesh placed;
+        placed.subMesh = _subMesh;
+        placed.name = name;
+        placed.scale = scale;
+        placed.transform = matrix;
         if (_matIndex != -1)
-        {
-          auto m = mesh->MaterialByIndex(_matIndex);
-          newMatIndex = worldMesh.IndexOfMaterial(m.get());
-          if (newMatIndex < 0)
-          {
-            newMatIndex = worldMesh.AddMaterial(m);
-          }
-        }
-        else
-        {
-          newMatIndex = worldMesh.AddMaterial(mat);
-        }
+          placed.material = mesh->MaterialByIndex(_matIndex);
+        if (!placed.material)
+          placed.material = mat;
 
-        subm.lock()->SetMaterialIndex(newMatIndex);
-        subm.lock()->Scale(scale);
-        subMeshMatrix.push_back(matrix);
+        return writer.Add(placed);
       };
 
       if (_geom->Data().Type() == sdf::GeometryType::BOX)
@@ -142,10 +144,7 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
         {
           mesh = meshManager->MeshByName("unit_box");
           scale = _geom->Data().BoxShape()->Size();
-          subm = worldMesh.AddSubMesh(
-              *mesh->SubMeshByIndex(0).lock().get());
-
-          addSubmeshFunc(-1);
+          return addSubmeshFunc(mesh->SubMeshByIndex(0).lock(), -1);
         }
       }
       else if (_geom->Data().Type() == sdf::GeometryType::CYLINDER)
@@ -156,10 +155,7 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
           scale.X() = _geom->Data().CylinderShape()->Radius() * 2;
           scale.Y() = scale.X();
           scale.Z() = _geom->Data().CylinderShape()->Length();
-          subm = worldMesh.AddSubMesh(
-              *mesh->SubMeshByIndex(0).lock().get());
-
-          addSubmeshFunc(-1);
+          return addSubmeshFunc(mesh->SubMeshByIndex(0).lock(), -1);
         }
       }
       else if (_geom->Data().Type() == sdf::GeometryType::PLANE)
@@ -181,10 +177,7 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
           worldPose.Rot() = worldPose.Rot() * normalRot;
 
           matrix = math::Matrix4d(worldPose);
-          subm = worldMesh.AddSubMesh(
-              *mesh->SubMeshByIndex(0).lock().get());
-
-          addSubmeshFunc(-1);
+          return addSubmeshFunc(mesh->SubMeshByIndex(0).lock(), -1);
         }
       }
       else if (_geom->Data().Type() == sdf::GeometryType::SPHERE)
@@ -197,10 +190,7 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
           scale.Y() = scale.X();
           scale.Z() = scale.X();
 
-          subm = worldMesh.AddSubMesh(
-              *mesh->SubMeshByIndex(0).lock().get());
-
-          addSubmeshFunc(-1);
+          return addSubmeshFunc(mesh->SubMeshByIndex(0).lock(), -1);
         }
       }
       else if (_geom->Data().Type() == sdf::GeometryType::MESH)
@@ -213,7 +203,7 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
           ignerr << "Mesh geometry missing uri" << std::endl;
           return true;
         }
-        mesh = meshManager->Load(fullPath);
+        mesh = MeshAssets::Instance().Load(fullPath);
 
         if (!mesh) {
           ignerr << "mesh not found!" << std::endl;
@@ -227,15 +217,20 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
           for (unsigned int k = 0; k < mesh->SubMeshCount(); k++)
           {
             auto subMeshLock = mesh->SubMeshByIndex(k).lock();
-            subm = worldMesh.AddSubMesh(*subMeshLock.get());
-            addSubmeshFunc(subMeshLock->MaterialIndex());
+            if (!addSubmeshFunc(subMeshLock, subMeshLock->MaterialIndex()))
+              return false;
           }
         }
         else
         {
           auto subMeshLock = mesh->SubMeshByName(subMeshName).lock();
-          subm = worldMesh.AddSubMesh(*subMeshLock.get());
-          addSubmeshFunc(subMeshLock->MaterialIndex());
+          if (!subMeshLock)
+          {
+            ignerr << "Submesh [" << subMeshName << "] not found in ["
+                   << fullPath << "]." << std::endl;
+            return true;
+          }
+          return addSubmeshFunc(subMeshLock, subMeshLock->MaterialIndex());
         }
       }
       else
@@ -292,12 +287,14 @@ class ignition::gazebo::systems::ColladaWorldExporterPrivate
       return true;
     });
 
-    common::ColladaExporter exporter;
-    exporter.Export(&worldMesh, "./" + worldMesh.Name(), true,
-                    subMeshMatrix, lights);
+    if (!writer.Close(lights))
+    {
+      ignerr << "Failed to export the world into the " << directory
+             << " directory." << std::endl;
+      return;
+    }
     ignmsg << "The world has been exported into the "
-           << "./" + worldMesh.Name() << " directory." << std::endl;
-    this->exported = true;
+           << directory << " directory." << std::endl;
   }
 };
 
@@ -20,7 +20,6 @@
 #include <ignition/msgs/odometry.pb.h>
 
 #include <limits>
-#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -36,6 +35,7 @@
 #include "ignition/gazebo/components/JointPosition.hh"
 #include "ignition/gazebo/components/JointVelocityCmd.hh"
 #include "ignition/gazebo/Link.hh"
+#include "ignition/gazebo/MessageBus.hh"
 #include "ignition/gazebo/Model.hh"
 #include "ignition/gazebo/Util.hh"
 
@@ -82,6 +82,9 @@ class ignition::gazebo::systems::DiffDrivePrivate
   /// \brief Ignition communication node.
   public: transport::Node node;
 
+  /// \brief Message bus on which commands are received
+  public: std::shared_ptr<MessageBus> bus;
+
   /// \brief Entity of the left joint
   public: std::vector<Entity> leftJoints;
 
@@ -145,9 +148,6 @@ class ignition::gazebo::systems::DiffDrivePrivate
   /// \brief Enable/disable state of the controller.
   public: bool enabled;
 
-  /// \brief A mutex to protect the target velocity command.
-  public: std::mutex mutex;
-
   /// \brief frame_id from sdf.
   public: std::string sdfFrameId;
 
@@ -165,9 +165,10 @@ DiffDrive::DiffDrive()
 void DiffDrive::Configure(const Entity &_entity,
     const std::shared_ptr<const sdf::Element> &_sdf,
     EntityComponentManager &_ecm,
-    EventManager &/*_eventMgr*/)
+    EventManager &_eventMgr)
 {
   this->dataPtr->model = Model(_entity);
+  this->dataPtr->bus = MessageBus::Instance(_eventMgr);
 
   // Get the canonical link
   std::vector<Entity> links = _ecm.ChildrenByComponents(
@@ -340,7 +341,7 @@ void DiffDrive::Configure(const Entity &_entity,
   topics.push_back("/model/" + this->dataPtr->model.Name(_ecm) + "/cmd_vel");
   auto topic = validTopic(topics);
 
-  this->dataPtr->node.Subscribe(topic, &DiffDrivePrivate::OnCmdVel,
+  this->dataPtr->bus->Subscribe(topic, &DiffDrivePrivate::OnCmdVel,
       this->dataPtr.get());
 
   // Subscribe to enable/disable
@@ -351,7 +352,7 @@ void DiffDrive::Configure(const Entity &_entity,
 
   if (!enableTopic.empty())
   {
-    this->dataPtr->node.Subscribe(enableTopic, &DiffDrivePrivate::OnEnable,
+    this->dataPtr->bus->Subscribe(enableTopic, &DiffDrivePrivate::OnEnable,
         this->dataPtr.get());
   }
   this->dataPtr->enabled = true;
@@ -574,8 +575,7 @@ void DiffDrivePrivate::UpdateOdometry(const ignition::gazebo::UpdateInfo &_info,
   msg.mutable_twist()->mutable_angular()->set_z(*this->odom.AngularVelocity());
 
   // Set the time stamp in the header
-  msg.mutable_header()->mutable_stamp()->CopyFrom(
-      convert<msgs::Time>(_info.simTime));
+  set(msg.mutable_header()->mutable_stamp(), _info.simTime);
 
   // Set the frame id.
   auto frame = msg.mutable_header()->add_data();
@@ -624,13 +624,8 @@ void DiffDrivePrivate::UpdateVelocity(const ignition::gazebo::UpdateInfo &_info,
 {
   IGN_PROFILE("DiffDrive::UpdateVelocity");
 
-  double linVel;
-  double angVel;
-  {
-    std::lock_guard<std::mutex> lock(this->mutex);
-    linVel = this->targetVel.linear().x();
-    angVel = this->targetVel.angular().z();
-  }
+  double linVel = this->targetVel.linear().x();
+  double angVel = this->targetVel.angular().z();
 
   // Limit the target velocity if needed.
   this->limiterLin->Limit(
@@ -653,7 +648,6 @@ void DiffDrivePrivate::UpdateVelocity(const ignition::gazebo::UpdateInfo &_info,
 //////////////////////////////////////////////////
 void DiffDrivePrivate::OnCmdVel(const msgs::Twist &_msg)
 {
-  std::lock_guard<std::mutex> lock(this->mutex);
   if (this->enabled)
   {
     this->targetVel = _msg;
@@ -663,7 +657,6 @@ void DiffDrivePrivate::OnCmdVel(const msgs::Twist &_msg)
 //////////////////////////////////////////////////
 void DiffDrivePrivate::OnEnable(const msgs::Boolean &_msg)
 {
-  std::lock_guard<std::mutex> lock(this->mutex);
   this->enabled = _msg.data();
   if (!this->enabled)
   {
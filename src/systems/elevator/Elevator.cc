@@ -20,8 +20,9 @@
  * \date January 2021
  */
 
-#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <mutex>
 #include <regex>
 #include <string>
@@ -38,12 +39,15 @@
 #include <ignition/msgs/laserscan.pb.h>
 
 #include <ignition/common/Profiler.hh>
+#include <ignition/math/PID.hh>
 #include <ignition/plugin/Register.hh>
 #include <ignition/transport/Node.hh>
 
+#include "ignition/gazebo/MessageBus.hh"
 #include "ignition/gazebo/Model.hh"
 #include "ignition/gazebo/components/Joint.hh"
 #include "ignition/gazebo/components/JointAxis.hh"
+#include "ignition/gazebo/components/JointForceCmd.hh"
 #include "ignition/gazebo/components/JointPosition.hh"
 #include "ignition/gazebo/components/JointVelocity.hh"
 #include "ignition/gazebo/components/Link.hh"
@@ -59,6 +63,25 @@ inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE
 {
 namespace systems
 {
+/// \brief Position controller of a joint that the elevator commands directly
+/// through the entity component manager, instead of through a separate joint
+/// position controller system
+class DirectJointController
+{
+  /// \brief Controlled joint
+  public: Entity joint{kNullEntity};
+
+  /// \brief Position controller
+  public: math::PID pid;
+
+  /// \brief Joint position target
+  public: double target{0.0};
+
+  /// \brief Flag to indicate whether the target has been set. Until then, the
+  /// controller holds the joint at the position it has on the first update
+  public: bool hasTarget{false};
+};
+
 class ElevatorPrivate : public ElevatorCommonPrivate
 {
   /// \brief Destructor
@@ -68,22 +91,35 @@ class ElevatorPrivate : public ElevatorCommonPrivate
   /// \param[in] _cabinJointName Name of the cabin joint
   /// \param[in] _floorLinkPrefix Name prefix of the floor links
   /// \param[in] _topicPrefix Topic prefix for the command publisher
+  /// \param[in] _pid Position controller for the cabin joint, or nullptr to
+  /// command the cabin over transport
   /// \param[in] _ecm Entity component manager
   /// \return True on successful initialization, or false otherwise
   public: bool InitCabin(const std::string &_cabinJointName,
                          const std::string &_floorLinkPrefix,
                          const std::string &_topicPrefix,
+                         const math::PID *_pid,
                          EntityComponentManager &_ecm);
 
   /// \brief Initializes the doors of the elevator
   /// \param[in] _doorJointPrefix Name prefix of the door joints
   /// \param[in] _topicPrefix Topic prefix for the command publishers
+  /// \param[in] _pid Position controller for the door joints, or nullptr to
+  /// command the doors over transport
   /// \param[in] _ecm Entity component manager
   /// \return True on successful initialization, or false otherwise
   public: bool InitDoors(const std::string &_doorJointPrefix,
                          const std::string &_topicPrefix,
+                         const math::PID *_pid,
                          EntityComponentManager &_ecm);
 
+  // Documentation inherited
+  public: virtual void SendDoorCmd(int32_t _floorTarget,
+                                   double _jointTarget) override;
+
+  // Documentation inherited
+  public: virtual void SendCabinCmd(double _jointTarget) override;
+
   // Documentation inherited
   public: virtual void StartDoorTimer(
       int32_t _floorTarget,
@@ -99,8 +135,18 @@ class ElevatorPrivate : public ElevatorCommonPrivate
       int32_t _floorTarget, double _jointTarget, double _posEps, double _velEps,
       const std::function<void()> &_jointTargetReachedCallback) override;
 
+  /// \brief Applies the force that drives a directly commanded joint to its
+  /// target
+  /// \param[in] _controller Controller of the joint
+  /// \param[in] _info Current simulation step info
+  /// \param[in] _ecm Entity component manager
+  public: void UpdateController(DirectJointController &_controller,
+                                const ignition::gazebo::UpdateInfo &_info,
+                                EntityComponentManager &_ecm);
+
   /// \brief Updates the elevator state based on the current cabin position and
-  /// then publishes the new state
+  /// then publishes the new state. The cabin only moves while the cabin
+  /// monitor is active, so the position is not read otherwise
   /// \param[in] _info Current simulation step info
   /// \param[in] _ecm Entity component manager
   public: void UpdateState(const ignition::gazebo::UpdateInfo &_info,
@@ -127,6 +173,27 @@ class ElevatorPrivate : public ElevatorCommonPrivate
   /// \brief Joint of the cabin
   public: Entity cabinJoint;
 
+  /// \brief Message bus on which joint commands are published
+  public: std::shared_ptr<MessageBus> bus;
+
+  /// \brief Door joint command publishers. Empty when the doors are commanded
+  /// directly
+  public: std::vector<MessageBus::Publisher> doorJointCmdPubs;
+
+  /// \brief Cabin joint command publisher. Invalid when the cabin is commanded
+  /// directly
+  public: MessageBus::Publisher cabinJointCmdPub;
+
+  /// \brief Controllers of the door joints, when commanded directly
+  public: std::vector<DirectJointController> doorControllers;
+
+  /// \brief Controller of the cabin joint, when commanded directly
+  public: std::unique_ptr<DirectJointController> cabinController;
+
+  /// \brief Flag to indicate whether the state has been computed from the
+  /// cabin position at least once
+  public: bool stateInitialized{false};
+
   /// \brief State vector that identifies whether the doorway on each floor
   /// level is blocked
   public: std::vector<bool> isDoorwayBlockedStates;
@@ -164,6 +231,25 @@ class ElevatorPrivate : public ElevatorCommonPrivate
   public: std::unique_ptr<ElevatorStateMachine> stateMachine;
 };
 
+//////////////////////////////////////////////////
+/// \brief Reads the gains and limits of a position controller. The elements
+/// and their defaults are the same as in the JointPositionController system.
+/// \param[in] _sdf Element that contains the controller parameters
+/// \return Initialized controller
+static math::PID ParsePid(const sdf::ElementPtr &_sdf)
+{
+  math::PID pid;
+  pid.Init(_sdf->Get<double>("p_gain", 1.0).first,
+           _sdf->Get<double>("i_gain", 0.1).first,
+           _sdf->Get<double>("d_gain", 0.01).first,
+           _sdf->Get<double>("i_max", 1.0).first,
+           _sdf->Get<double>("i_min", -1.0).first,
+           _sdf->Get<double>("cmd_max", 1000.0).first,
+           _sdf->Get<double>("cmd_min", -1000.0).first,
+           _sdf->Get<double>("cmd_offset", 0.0).first);
+  return pid;
+}
+
 //////////////////////////////////////////////////
 Elevator::Elevator() : dataPtr(std::make_shared<ElevatorPrivate>()) {}
 
@@ -171,9 +257,10 @@ Elevator::Elevator() : dataPtr(std::make_shared<ElevatorPrivate>()) {}
 void Elevator::Configure(const Entity &_entity,
                          const std::shared_ptr<const sdf::Element> &_sdf,
                          EntityComponentManager &_ecm,
-                         EventManager & /*_eventMgr*/)
+                         EventManager &_eventMgr)
 {
   this->dataPtr->model = Model(_entity);
+  this->dataPtr->bus = MessageBus::Instance(_eventMgr);
 
   // Initialize system update period
   double rate = _sdf->Get<double>("update_rate", 10).first;
@@ -195,11 +282,27 @@ void Elevator::Configure(const Entity &_entity,
 
   std::string topicPrefix = "/model/" + this->dataPtr->model.Name(_ecm);
 
+  // Get optional in-process joint controllers
+  auto sdfClone = _sdf->Clone();
+  std::unique_ptr<math::PID> cabinPid;
+  if (sdfClone->HasElement("cabin_controller"))
+  {
+    cabinPid = std::make_unique<math::PID>(
+        ParsePid(sdfClone->GetElement("cabin_controller")));
+  }
+  std::unique_ptr<math::PID> doorPid;
+  if (sdfClone->HasElement("door_controller"))
+  {
+    doorPid = std::make_unique<math::PID>(
+        ParsePid(sdfClone->GetElement("door_controller")));
+  }
+
   if (!this->dataPtr->InitCabin(cabinJointName, floorLinkPrefix, topicPrefix,
-                                _ecm))
+                                cabinPid.get(), _ecm))
     return;
 
-  if (!this->dataPtr->InitDoors(doorJointPrefix, topicPrefix, _ecm))
+  if (!this->dataPtr->InitDoors(doorJointPrefix, topicPrefix, doorPid.get(),
+                                _ecm))
     return;
 
   // Initialize door timer
@@ -235,6 +338,25 @@ void Elevator::Configure(const Entity &_entity,
          << cmdTopicName << " for command messages" << std::endl;
 }
 
+//////////////////////////////////////////////////
+void Elevator::PreUpdate(const UpdateInfo &_info, EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("Elevator::PreUpdate");
+  if (_info.paused) return;
+
+  if (!this->dataPtr->cabinController && this->dataPtr->doorControllers.empty())
+    return;
+
+  std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->cabinController)
+  {
+    this->dataPtr->UpdateController(*this->dataPtr->cabinController, _info,
+                                    _ecm);
+  }
+  for (auto &controller : this->dataPtr->doorControllers)
+    this->dataPtr->UpdateController(controller, _info, _ecm);
+}
+
 //////////////////////////////////////////////////
 void Elevator::PostUpdate(const UpdateInfo &_info,
                           const EntityComponentManager &_ecm)
@@ -251,10 +373,18 @@ void Elevator::PostUpdate(const UpdateInfo &_info,
 
   std::lock_guard<std::recursive_mutex> lock(this->dataPtr->mutex);
   this->dataPtr->UpdateState(_info, _ecm);
-  this->dataPtr->doorTimer->Update(
-      _info, this->dataPtr->isDoorwayBlockedStates[this->dataPtr->state]);
-  this->dataPtr->doorJointMonitor.Update(_ecm);
-  this->dataPtr->cabinJointMonitor.Update(_ecm);
+
+  // Only the timer and monitors that the state machine is waiting on need to
+  // be checked; an idle elevator skips them altogether
+  if (this->dataPtr->doorTimer->IsActive())
+  {
+    this->dataPtr->doorTimer->Update(
+        _info, this->dataPtr->isDoorwayBlockedStates[this->dataPtr->state]);
+  }
+  if (this->dataPtr->doorJointMonitor.IsActive())
+    this->dataPtr->doorJointMonitor.Update(_ecm);
+  if (this->dataPtr->cabinJointMonitor.IsActive())
+    this->dataPtr->cabinJointMonitor.Update(_ecm);
 }
 
 //////////////////////////////////////////////////
@@ -266,6 +396,7 @@ ElevatorPrivate::~ElevatorPrivate()
 bool ElevatorPrivate::InitCabin(const std::string &_cabinJointName,
                                 const std::string &_floorLinkPrefix,
                                 const std::string &_topicPrefix,
+                                const math::PID *_pid,
                                 EntityComponentManager &_ecm)
 {
   // Validate and initialize cabin joint
@@ -305,11 +436,18 @@ bool ElevatorPrivate::InitCabin(const std::string &_cabinJointName,
     this->cabinTargets.push_back(z);
   }
 
-  // Initialize cabin joint command publisher
+  // Initialize cabin joint controller, or command publisher
+  if (_pid)
+  {
+    this->cabinController = std::make_unique<DirectJointController>();
+    this->cabinController->joint = this->cabinJoint;
+    this->cabinController->pid = *_pid;
+    return true;
+  }
   std::string cabinJointCmdTopicName =
       _topicPrefix + "/joint/" + _cabinJointName + "/0/cmd_pos";
   this->cabinJointCmdPub =
-      this->node.Advertise<msgs::Double>(cabinJointCmdTopicName);
+      this->bus->Advertise<msgs::Double>(cabinJointCmdTopicName);
 
   return true;
 }
@@ -317,6 +455,7 @@ bool ElevatorPrivate::InitCabin(const std::string &_cabinJointName,
 //////////////////////////////////////////////////
 bool ElevatorPrivate::InitDoors(const std::string &_doorJointPrefix,
                                 const std::string &_topicPrefix,
+                                const math::PID *_pid,
                                 EntityComponentManager &_ecm)
 {
   for (size_t i = 0; i < this->cabinTargets.size(); ++i)
@@ -341,9 +480,17 @@ bool ElevatorPrivate::InitDoors(const std::string &_doorJointPrefix,
     auto upper = _ecm.Component<components::JointAxis>(joint)->Data().Upper();
     this->doorTargets.push_back(upper);
 
-    // Initialize door joint command publisher
+    // Initialize door joint controller, or command publisher
+    if (_pid)
+    {
+      DirectJointController controller;
+      controller.joint = joint;
+      controller.pid = *_pid;
+      this->doorControllers.push_back(controller);
+      continue;
+    }
     std::string topicName = _topicPrefix + "/joint/" + name + "/0/cmd_pos";
-    auto pub = this->node.Advertise<msgs::Double>(topicName);
+    auto pub = this->bus->Advertise<msgs::Double>(topicName);
     this->doorJointCmdPubs.push_back(pub);
   }
 
@@ -364,6 +511,39 @@ bool ElevatorPrivate::InitDoors(const std::string &_doorJointPrefix,
   return true;
 }
 
+//////////////////////////////////////////////////
+void ElevatorPrivate::SendDoorCmd(int32_t _floorTarget, double _jointTarget)
+{
+  if (this->doorControllers.empty())
+  {
+    msgs::Double msg;
+    msg.set_data(_jointTarget);
+    this->doorJointCmdPubs[_floorTarget].Publish(msg);
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(this->mutex);
+  auto &controller = this->doorControllers[_floorTarget];
+  controller.target = _jointTarget;
+  controller.hasTarget = true;
+}
+
+//////////////////////////////////////////////////
+void ElevatorPrivate::SendCabinCmd(double _jointTarget)
+{
+  if (!this->cabinController)
+  {
+    msgs::Double msg;
+    msg.set_data(_jointTarget);
+    this->cabinJointCmdPub.Publish(msg);
+    return;
+  }
+
+  std::lock_guard<std::recursive_mutex> lock(this->mutex);
+  this->cabinController->target = _jointTarget;
+  this->cabinController->hasTarget = true;
+}
+
 //////////////////////////////////////////////////
 void ElevatorPrivate::StartDoorTimer(
     int32_t /*_floorTarget*/, const std::function<void()> &_timeoutCallback)
@@ -397,15 +577,25 @@ void ElevatorPrivate::SetCabinMonitor(
 void ElevatorPrivate::UpdateState(const ignition::gazebo::UpdateInfo &_info,
                                   const EntityComponentManager &_ecm)
 {
-  // Update state
-  double pos =
-      _ecm.ComponentData<components::JointPosition>(this->cabinJoint)->front();
-  std::vector<int32_t> diffs(this->cabinTargets.size());
-  std::transform(this->cabinTargets.begin(), this->cabinTargets.end(),
-                 diffs.begin(),
-                 [&pos](auto target) { return std::fabs(target - pos); });
-  auto it = std::min_element(diffs.begin(), diffs.end());
-  this->state = static_cast<int32_t>(std::distance(diffs.begin(), it));
+  // Update state to the floor closest to the cabin
+  if (!this->stateInitialized || this->cabinJointMonitor.IsActive())
+  {
+    auto pos = _ecm.ComponentData<components::JointPosition>(this->cabinJoint);
+    if (pos && !pos->empty())
+    {
+      double minDiff = std::numeric_limits<double>::max();
+      for (size_t i = 0; i < this->cabinTargets.size(); ++i)
+      {
+        double diff = std::fabs(this->cabinTargets[i] - pos->front());
+        if (diff < minDiff)
+        {
+          minDiff = diff;
+          this->state = static_cast<int32_t>(i);
+        }
+      }
+      this->stateInitialized = true;
+    }
+  }
 
   // Throttle publish rate
   auto elapsed = _info.simTime - this->lastStatePubTime;
@@ -418,6 +608,38 @@ void ElevatorPrivate::UpdateState(const ignition::gazebo::UpdateInfo &_info,
   this->statePub.Publish(this->stateMsg);
 }
 
+//////////////////////////////////////////////////
+void ElevatorPrivate::UpdateController(
+    DirectJointController &_controller,
+    const ignition::gazebo::UpdateInfo &_info, EntityComponentManager &_ecm)
+{
+  auto pos = _ecm.ComponentData<components::JointPosition>(_controller.joint);
+  if (!pos || pos->empty())
+    return;
+
+  if (!_controller.hasTarget)
+  {
+    _controller.target = pos->front();
+    _controller.hasTarget = true;
+  }
+
+  double force = _controller.pid.Update(pos->front() - _controller.target,
+                                        _info.dt);
+
+  auto forceComp = _ecm.Component<components::JointForceCmd>(
+      _controller.joint);
+  if (forceComp == nullptr)
+  {
+    _ecm.CreateComponent(_controller.joint,
+                         components::JointForceCmd({force}));
+  }
+  else
+  {
+    forceComp->Data().resize(1);
+    forceComp->Data()[0] = force;
+  }
+}
+
 //////////////////////////////////////////////////
 void ElevatorPrivate::OnLidarMsg(size_t _floorLevel,
                                  const msgs::LaserScan &_msg)
@@ -442,7 +664,7 @@ void ElevatorPrivate::OnCmdMsg(const msgs::Int32 &_msg)
 }
 
 IGNITION_ADD_PLUGIN(Elevator, System, Elevator::ISystemConfigure,
-                    Elevator::ISystemPostUpdate)
+                    Elevator::ISystemPreUpdate, Elevator::ISystemPostUpdate)
 
 IGNITION_ADD_PLUGIN_ALIAS(Elevator, "ignition::gazebo::systems::Elevator")
 
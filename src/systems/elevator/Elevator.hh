@@ -61,7 +61,9 @@ class ElevatorPrivate;
 ///
 /// Each cabin and door joint has an associated joint position controller
 /// system that listens for command to
-/// `/model/{model_name}/joint/{joint_name}/0/cmd_pos`
+/// `/model/{model_name}/joint/{joint_name}/0/cmd_pos`, unless the joint is
+/// commanded directly by this system through `<cabin_controller>` or
+/// `<door_controller>`
 ///
 /// Each door (optionally) has a lidar that, if intercepted, indicates that the
 /// doorway is blocked. The lidar publishes sensor data on topic
@@ -101,8 +103,20 @@ class ElevatorPrivate;
 ///
 /// `<open_door_wait_duration>`: Time to wait with a door open before the door
 /// closes. This element is optional and the default value is 5 sec.
+///
+/// `<cabin_controller>`: If present, this system drives the cabin joint
+/// itself by applying joint forces from a position controller, instead of
+/// publishing commands for a separate joint position controller system. The
+/// command then takes effect in the step it's issued. The element accepts
+/// `<p_gain>`, `<i_gain>`, `<d_gain>`, `<i_max>`, `<i_min>`, `<cmd_max>`,
+/// `<cmd_min>` and `<cmd_offset>`, with the same meaning and defaults as in
+/// the JointPositionController system. Until the first command, the joint is
+/// held at its initial position.
+///
+/// `<door_controller>`: Same as `<cabin_controller>`, for all door joints.
 class IGNITION_GAZEBO_VISIBLE Elevator : public System,
                                          public ISystemConfigure,
+                                         public ISystemPreUpdate,
                                          public ISystemPostUpdate
 {
   /// \brief Constructor
@@ -117,6 +131,10 @@ class IGNITION_GAZEBO_VISIBLE Elevator : public System,
                          EntityComponentManager &_ecm,
                          EventManager &_eventMgr) override;
 
+  // Documentation inherited
+  public: void PreUpdate(const UpdateInfo &_info,
+                         EntityComponentManager &_ecm) override;
+
   // Documentation inherited
   public: void PostUpdate(const UpdateInfo &_info,
                           const EntityComponentManager &_ecm) override;
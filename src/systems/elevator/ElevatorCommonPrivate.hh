@@ -27,8 +27,6 @@
 #include <mutex>
 #include <vector>
 
-#include <ignition/transport/Node.hh>
-
 namespace ignition
 {
 namespace gazebo
@@ -71,11 +69,15 @@ class ElevatorCommonPrivate
       int32_t _floorTarget, double _jointTarget, double _posEps, double _velEps,
       const std::function<void()> &_jointTargetReachedCallback) = 0;
 
-  /// \brief Door joint command publishers
-  public: std::vector<transport::Node::Publisher> doorJointCmdPubs;
+  /// \brief Commands the door joint at the given floor level
+  /// \param[in] _floorTarget Target floor level
+  /// \param[in] _jointTarget Joint position command
+  public: virtual void SendDoorCmd(int32_t _floorTarget,
+                                   double _jointTarget) = 0;
 
-  /// \brief Cabin joint command publisher
-  public: transport::Node::Publisher cabinJointCmdPub;
+  /// \brief Commands the cabin joint
+  /// \param[in] _jointTarget Joint position command
+  public: virtual void SendCabinCmd(double _jointTarget) = 0;
 
   /// \brief Joint commands for opening the door at each floor level
   public: std::vector<double> doorTargets;
@@ -52,11 +52,6 @@ class ElevatorStateMachinePrivate
   /// \param[in] _target Target to add to the queue
   public: void EnqueueNewTarget(double _target);
 
-  /// \brief Publishes a command message
-  /// \param[in] _pub Joint command publisher
-  /// \param[in] _cmd Joint command
-  public: void SendCmd(transport::Node::Publisher &_pub, double _cmd);
-
   /// \brief Data of the enclosing system
   public: std::shared_ptr<ElevatorCommonPrivate> system;
 
@@ -104,15 +99,6 @@ void ElevatorStateMachinePrivate::EnqueueNewTarget(double _target)
   ignmsg << ss.str() << "]" << std::endl;
 }
 
-//////////////////////////////////////////////////
-void ElevatorStateMachinePrivate::SendCmd(transport::Node::Publisher &_pub,
-                                          double _cmd)
-{
-  msgs::Double msg;
-  msg.set_data(_cmd);
-  _pub.Publish(msg);
-}
-
 //////////////////////////////////////////////////
 ElevatorStateMachineDef::ElevatorStateMachineDef(
     const std::shared_ptr<ElevatorCommonPrivate> &_system)
@@ -76,7 +76,7 @@ struct ElevatorStateMachineDef::DoorState : state<DoorState<E>>
     ignmsg << "The elevator is " << this->Report(data) << std::endl;
 
     double jointTarget = this->JointTarget(data, floorTarget);
-    data->SendCmd(data->system->doorJointCmdPubs[floorTarget], jointTarget);
+    data->system->SendDoorCmd(floorTarget, jointTarget);
     this->triggerEvent = [&_fsm] { _fsm.process_event(E()); };
     data->system->SetDoorMonitor(
         floorTarget, jointTarget, this->posEps, this->velEps,
@@ -218,7 +218,7 @@ struct ElevatorStateMachineDef::MoveCabinState : state<MoveCabinState>
            << " -> " << floorTarget << " ]" << std::endl;
 
     double jointTarget = data->system->cabinTargets[floorTarget];
-    data->SendCmd(data->system->cabinJointCmdPub, jointTarget);
+    data->system->SendCabinCmd(jointTarget);
     this->triggerEvent = [&_fsm] {
       _fsm.process_event(events::CabinAtTarget());
     };
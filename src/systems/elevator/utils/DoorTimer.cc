@@ -99,6 +99,12 @@ void DoorTimer::Update(const UpdateInfo &_info, bool _isDoorwayBlocked)
   this->dataPtr->timeoutCallback();
 }
 
+//////////////////////////////////////////////////
+bool DoorTimer::IsActive() const
+{
+  return this->dataPtr->isActive;
+}
+
 }  // namespace systems
 }  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
 }  // namespace gazebo
@@ -96,6 +96,12 @@ void JointMonitor::Update(const EntityComponentManager &_ecm)
   this->dataPtr->targetReachedCallback();
 }
 
+//////////////////////////////////////////////////
+bool JointMonitor::IsActive() const
+{
+  return this->dataPtr->isActive;
+}
+
 }  // namespace systems
 }  // namespace IGNITION_GAZEBO_VERSION_NAMESPACE
 }  // namespace gazebo
@@ -66,6 +66,11 @@ class JointMonitor
   /// \param[in] _ecm Entity component manager
   public: void Update(const EntityComponentManager &_ecm);
 
+  /// \brief Checks whether the monitor is waiting for its joint
+  /// \return True if the monitor has been configured and the joint has not
+  /// reached its target yet
+  public: bool IsActive() const;
+
   /// \brief Private data pointer
   private: std::unique_ptr<JointMonitorPrivate> dataPtr;
 };
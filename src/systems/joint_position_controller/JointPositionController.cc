@@ -30,6 +30,7 @@
 #include "ignition/gazebo/components/JointForceCmd.hh"
 #include "ignition/gazebo/components/JointVelocityCmd.hh"
 #include "ignition/gazebo/components/JointPosition.hh"
+#include "ignition/gazebo/MessageBus.hh"
 #include "ignition/gazebo/Model.hh"
 
 using namespace ignition;
@@ -42,8 +43,8 @@ class ignition::gazebo::systems::JointPositionControllerPrivate
   /// \param[in] _msg Position message
   public: void OnCmdPos(const ignition::msgs::Double &_msg);
 
-  /// \brief Ignition communication node.
-  public: transport::Node node;
+  /// \brief Message bus on which commands are received
+  public: std::shared_ptr<MessageBus> bus;
 
   /// \brief Joint Entity
   public: Entity jointEntity{kNullEntity};
@@ -54,9 +55,6 @@ class ignition::gazebo::systems::JointPositionControllerPrivate
   /// \brief Commanded joint position
   public: double jointPosCmd{0.0};
 
-  /// \brief mutex to protect joint commands
-  public: std::mutex jointCmdMutex;
-
   /// \brief Model interface
   public: Model model{kNullEntity};
 
@@ -90,7 +88,7 @@ JointPositionController::JointPositionController()
 void JointPositionController::Configure(const Entity &_entity,
     const std::shared_ptr<const sdf::Element> &_sdf,
     EntityComponentManager &_ecm,
-    EventManager &/*_eventMgr*/)
+    EventManager &_eventMgr)
 {
   this->dataPtr->model = Model(_entity);
 
@@ -199,7 +197,8 @@ void JointPositionController::Configure(const Entity &_entity,
       return;
     }
   }
-  this->dataPtr->node.Subscribe(
+  this->dataPtr->bus = MessageBus::Instance(_eventMgr);
+  this->dataPtr->bus->Subscribe(
       topic, &JointPositionControllerPrivate::OnCmdPos, this->dataPtr.get());
 
   igndbg << "[JointPositionController] system parameters:" << std::endl;
@@ -285,12 +284,8 @@ void JointPositionController::PreUpdate(
   }
 
   // Get error in position
-  double error;
-  {
-    std::lock_guard<std::mutex> lock(this->dataPtr->jointCmdMutex);
-    error = jointPosComp->Data().at(this->dataPtr->jointIndex) -
-            this->dataPtr->jointPosCmd;
-  }
+  double error = jointPosComp->Data().at(this->dataPtr->jointIndex) -
+      this->dataPtr->jointPosCmd;
 
   // Check if the mode is ABS
   if (this->dataPtr->mode ==
@@ -352,7 +347,6 @@ void JointPositionController::PreUpdate(
 //////////////////////////////////////////////////
 void JointPositionControllerPrivate::OnCmdPos(const msgs::Double &_msg)
 {
-  std::lock_guard<std::mutex> lock(this->jointCmdMutex);
   this->jointPosCmd = _msg.data();
 }
 
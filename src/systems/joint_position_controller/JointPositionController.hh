@@ -43,6 +43,10 @@ namespace systems
   /// you may use the `<topic>` parameter to specify which topic the plugin
   /// should listen on.
   ///
+  /// The topic is subscribed through the world's MessageBus, so commands
+  /// published by other systems of the same world are delivered directly, at
+  /// the beginning of the next simulation step.
+  ///
   /// ## System Parameters
   ///
   /// `<joint_name>` The name of the joint to control. Required parameter.
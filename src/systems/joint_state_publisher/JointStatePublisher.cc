@@ -185,8 +185,7 @@ void JointStatePublisher::PostUpdate(const UpdateInfo &_info,
 
   // Create the message
   msgs::Model msg;
-  msg.mutable_header()->mutable_stamp()->CopyFrom(
-      convert<msgs::Time>(_info.simTime));
+  set(msg.mutable_header()->mutable_stamp(), _info.simTime);
 
   // Set the name and ID.
   msg.set_name(this->model.Name(_ecm));
@@ -23,7 +23,6 @@
 
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/components/Actor.hh"
-#include "ignition/gazebo/components/Link.hh"
 #include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/SemanticLabel.hh"
 #include "ignition/gazebo/components/Visual.hh"
@@ -63,37 +62,16 @@ void Label::Configure(const Entity &_entity,
     return;
   }
 
-  // Attach a semantic label component to the visual.
-  // If the plugin is inside the <model> tag, get its visual child.
+  // Attach a semantic label component to the visual, actor or model. The
+  // label of a model is inherited by all its visuals, including those of
+  // nested models, unless they have a label of their own. Consumers resolve
+  // it with EntityComponentManager::ComponentInherited.
   if (_ecm.EntityHasComponentType(_entity, components::Visual::typeId) ||
-      _ecm.EntityHasComponentType(_entity, components::Actor::typeId))
+      _ecm.EntityHasComponentType(_entity, components::Actor::typeId) ||
+      _ecm.EntityHasComponentType(_entity, components::Model::typeId))
   {
     _ecm.CreateComponent(_entity, components::SemanticLabel(label));
   }
-  else if (_ecm.EntityHasComponentType(_entity, components::Model::typeId))
-  {
-    // TODO(anyone) add support for nested models. We will need to check for
-    // child models and their respective links/visuals
-    // https://github.com/ignitionrobotics/ign-gazebo/issues/1041
-
-    // Get link childern of parent model
-    auto links = _ecm.ChildrenByComponents<components::Link>(
-      _entity, components::Link());
-
-    for (auto linkEntity : links)
-    {
-      // get visual child of parent link
-      auto visuals = _ecm.ChildrenByComponents<components::Visual>(
-        linkEntity, components::Visual());
-
-      // Create label component to all visual childern
-      for (auto visualEntity : visuals)
-      {
-        _ecm.CreateComponent(visualEntity,
-          components::SemanticLabel(label));
-      }
-    }
-  }
   else
   {
     ignerr << "Entity [" << _entity << "] is not a visual, actor, or model. "
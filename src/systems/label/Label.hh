@@ -34,6 +34,9 @@ namespace systems
   /// for the parent entity's visuals. The plugin can be attached to models,
   /// visuals, or actors.
   ///
+  /// The label of a model applies to all the visuals in it, including those
+  /// of nested models, unless a visual or nested model has its own label.
+  ///
   /// Ex: "<label>1</label>" means the visual has a label of 1
   /// Label value must be in [0-255] range
   class Label:
@@ -20,9 +20,9 @@
 #include <ignition/msgs/odometry.pb.h>
 #include <ignition/msgs/odometry_with_covariance.pb.h>
 
+#include <array>
 #include <limits>
 #include <string>
-#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -30,7 +30,7 @@
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Quaternion.hh>
-#include <ignition/math/RollingMean.hh>
+#include <ignition/math/Rand.hh>
 #include <ignition/plugin/Register.hh>
 #include <ignition/transport/Node.hh>
 
@@ -43,6 +43,56 @@ using namespace ignition;
 using namespace gazebo;
 using namespace systems;
 
+/// \brief Moving window over the six velocity components (linear x, y, z
+/// followed by angular x, y, z). Samples are kept in a fixed-size ring buffer
+/// so that pushing never allocates, and the mean is a plain sum over
+/// contiguous memory.
+class VelocityWindow
+{
+  /// \brief Number of samples in the window.
+  public: static constexpr std::size_t kSize{10};
+
+  /// \brief A sample of all velocity components.
+  public: using Sample = std::array<double, 6>;
+
+  /// \brief Add a sample, replacing the oldest one if the window is full.
+  /// \param[in] _sample The new sample.
+  public: void Push(const Sample &_sample)
+  {
+    this->samples[this->next] = _sample;
+    this->next = (this->next + 1) % kSize;
+    if (this->count < kSize)
+      ++this->count;
+  }
+
+  /// \brief Mean of the samples in the window.
+  /// \return Mean of each component, zero if the window is empty.
+  public: Sample Mean() const
+  {
+    Sample sum{};
+    if (this->count == 0)
+      return sum;
+
+    for (std::size_t i = 0; i < this->count; ++i)
+    {
+      for (std::size_t c = 0; c < sum.size(); ++c)
+        sum[c] += this->samples[i][c];
+    }
+    for (auto &value : sum)
+      value /= static_cast<double>(this->count);
+    return sum;
+  }
+
+  /// \brief Ring buffer of samples.
+  private: std::array<Sample, kSize> samples{};
+
+  /// \brief Index where the next sample will be written.
+  private: std::size_t next{0};
+
+  /// \brief Number of valid samples.
+  private: std::size_t count{0};
+};
+
 class ignition::gazebo::systems::OdometryPublisherPrivate
 {
   /// \brief Calculates odometry and publishes an odometry message.
@@ -83,13 +133,18 @@ class ignition::gazebo::systems::OdometryPublisherPrivate
   /// \brief Pose vector (TF) message publisher.
   public: transport::Node::Publisher tfPub;
 
-  /// \brief Rolling mean accumulators for the linear velocity
-  public: std::tuple<math::RollingMean, math::RollingMean, math::RollingMean>
-    linearMean;
+  /// \brief Moving window of linear and angular velocity estimates.
+  public: VelocityWindow velocityWindow;
+
+  /// \brief Odometry message, reused across publications.
+  public: msgs::Odometry odomMsg;
+
+  /// \brief Odometry with covariance message, reused across publications.
+  /// The covariance matrices are filled once at configuration.
+  public: msgs::OdometryWithCovariance odomCovMsg;
 
-  /// \brief Rolling mean accumulators for the angular velocity
-  public: std::tuple<math::RollingMean, math::RollingMean, math::RollingMean>
-    angularMean;
+  /// \brief Pose vector (TF) message, reused across publications.
+  public: msgs::Pose_V tfMsg;
 
   /// \brief Initialized flag.
   public: bool initialized{false};
@@ -111,22 +166,6 @@ class ignition::gazebo::systems::OdometryPublisherPrivate
 OdometryPublisher::OdometryPublisher()
   : dataPtr(std::make_unique<OdometryPublisherPrivate>())
 {
-  std::get<0>(this->dataPtr->linearMean).SetWindowSize(10);
-  std::get<1>(this->dataPtr->linearMean).SetWindowSize(10);
-  std::get<2>(this->dataPtr->angularMean).SetWindowSize(10);
-  std::get<0>(this->dataPtr->linearMean).Clear();
-  std::get<1>(this->dataPtr->linearMean).Clear();
-  std::get<2>(this->dataPtr->angularMean).Clear();
-
-  if (this->dataPtr->dimensions == 3)
-  {
-    std::get<2>(this->dataPtr->linearMean).SetWindowSize(10);
-    std::get<0>(this->dataPtr->angularMean).SetWindowSize(10);
-    std::get<1>(this->dataPtr->angularMean).SetWindowSize(10);
-    std::get<2>(this->dataPtr->linearMean).Clear();
-    std::get<0>(this->dataPtr->angularMean).Clear();
-    std::get<1>(this->dataPtr->angularMean).Clear();
-  }
 }
 
 //////////////////////////////////////////////////
@@ -251,6 +290,28 @@ void OdometryPublisher::Configure(const Entity &_entity,
            << odomCovTopicValid << "]" << std::endl;
   }
 
+  // Fill the parts of the messages which don't change between publications.
+  msgs::Header header;
+  auto frame = header.add_data();
+  frame->set_key("frame_id");
+  frame->add_value(this->dataPtr->odomFrame);
+  auto childFrame = header.add_data();
+  childFrame->set_key("child_frame_id");
+  childFrame->add_value(this->dataPtr->robotBaseFrame);
+  this->dataPtr->odomMsg.mutable_header()->CopyFrom(header);
+  this->dataPtr->odomCovMsg.mutable_header()->CopyFrom(header);
+  this->dataPtr->tfMsg.add_pose()->mutable_header()->CopyFrom(header);
+
+  auto gn2 = this->dataPtr->gaussianNoise * this->dataPtr->gaussianNoise;
+  for (int i = 0; i < 36; i++)
+  {
+    const double value = (i % 7 == 0) ? gn2 : 0.0;
+    this->dataPtr->odomCovMsg.mutable_pose_with_covariance()->
+      mutable_covariance()->add_data(value);
+    this->dataPtr->odomCovMsg.mutable_twist_with_covariance()->
+      mutable_covariance()->add_data(value);
+  }
+
   std::string tfTopic{"/model/" + this->dataPtr->model.Name(_ecm) +
     "/pose"};
   if (_sdf->HasElement("tf_topic"))
@@ -320,9 +381,6 @@ void OdometryPublisherPrivate::UpdateOdometry(
     return;
   }
 
-  // Construct the odometry message and publish it.
-  msgs::Odometry msg;
-
   const std::chrono::duration<double> dt =
     std::chrono::steady_clock::time_point(_info.simTime) - lastUpdateTime;
   // We cannot estimate the speed if the time interval is zero (or near
@@ -330,16 +388,9 @@ void OdometryPublisherPrivate::UpdateOdometry(
   if (math::equal(0.0, dt.count()))
     return;
 
-  // Get and set robotBaseFrame to odom transformation.
+  // Get robotBaseFrame to odom transformation.
   const math::Pose3d rawPose = worldPose(this->model.Entity(), _ecm);
   math::Pose3d pose = rawPose * this->offset;
-  msg.mutable_pose()->mutable_position()->set_x(pose.Pos().X());
-  msg.mutable_pose()->mutable_position()->set_y(pose.Pos().Y());
-  msgs::Set(msg.mutable_pose()->mutable_orientation(), pose.Rot());
-  if (this->dimensions == 3)
-  {
-    msg.mutable_pose()->mutable_position()->set_z(pose.Pos().Z());
-  }
 
   // Get linear and angular displacements from last updated pose.
   double linearDisplacementX = pose.Pos().X() - this->lastUpdatePose.Pos().X();
@@ -351,28 +402,17 @@ void OdometryPublisherPrivate::UpdateOdometry(
   while (currentYaw > lastYaw + IGN_PI) currentYaw -= 2 * IGN_PI;
   const float yawDiff = currentYaw - lastYaw;
 
+  // Linear x, y, z followed by angular x, y, z. Components that don't apply
+  // to the configured dimensions are left at zero.
+  VelocityWindow::Sample sample{};
+
   // Get velocities assuming 2D
   if (this->dimensions == 2)
   {
-    double linearVelocityX = (cosf(currentYaw) * linearDisplacementX
+    sample[0] = (cosf(currentYaw) * linearDisplacementX
       + sinf(currentYaw) * linearDisplacementY) / dt.count();
-    double linearVelocityY = (cosf(currentYaw) * linearDisplacementY
+    sample[1] = (cosf(currentYaw) * linearDisplacementY
       - sinf(currentYaw) * linearDisplacementX) / dt.count();
-    std::get<0>(this->linearMean).Push(linearVelocityX);
-    std::get<1>(this->linearMean).Push(linearVelocityY);
-    msg.mutable_twist()->mutable_linear()->set_x(
-      std::get<0>(this->linearMean).Mean() +
-      ignition::math::Rand::DblNormal(0, this->gaussianNoise));
-    msg.mutable_twist()->mutable_linear()->set_y(
-      std::get<1>(this->linearMean).Mean() +
-      ignition::math::Rand::DblNormal(0, this->gaussianNoise));
-    msg.mutable_twist()->mutable_linear()->set_z(
-      ignition::math::Rand::DblNormal(0, this->gaussianNoise));
-
-    msg.mutable_twist()->mutable_angular()->set_x(
-      ignition::math::Rand::DblNormal(0, this->gaussianNoise));
-    msg.mutable_twist()->mutable_angular()->set_y(
-      ignition::math::Rand::DblNormal(0, this->gaussianNoise));
   }
   // Get velocities and roll/pitch rates assuming 3D
   else if (this->dimensions == 3)
@@ -395,52 +435,22 @@ void OdometryPublisherPrivate::UpdateOdometry(
       linearDisplacementZ);
     math::Vector3 linearVelocity =
       pose.Rot().RotateVectorReverse(linearDisplacement) / dt.count();
-    std::get<0>(this->linearMean).Push(linearVelocity.X());
-    std::get<1>(this->linearMean).Push(linearVelocity.Y());
-    std::get<2>(this->linearMean).Push(linearVelocity.Z());
-    std::get<0>(this->angularMean).Push(rollDiff / dt.count());
-    std::get<1>(this->angularMean).Push(pitchDiff / dt.count());
-    msg.mutable_twist()->mutable_linear()->set_x(
-      std::get<0>(this->linearMean).Mean() +
-      ignition::math::Rand::DblNormal(0, this->gaussianNoise));
-    msg.mutable_twist()->mutable_linear()->set_y(
-      std::get<1>(this->linearMean).Mean() +
-      ignition::math::Rand::DblNormal(0, this->gaussianNoise));
-    msg.mutable_twist()->mutable_linear()->set_z(
-      std::get<2>(this->linearMean).Mean() +
-      ignition::math::Rand::DblNormal(0, this->gaussianNoise));
-    msg.mutable_twist()->mutable_angular()->set_x(
-      std::get<0>(this->angularMean).Mean() +
-      ignition::math::Rand::DblNormal(0, this->gaussianNoise));
-    msg.mutable_twist()->mutable_angular()->set_y(
-      std::get<1>(this->angularMean).Mean() +
-      ignition::math::Rand::DblNormal(0, this->gaussianNoise));
+    sample[0] = linearVelocity.X();
+    sample[1] = linearVelocity.Y();
+    sample[2] = linearVelocity.Z();
+    sample[3] = rollDiff / dt.count();
+    sample[4] = pitchDiff / dt.count();
   }
 
   // Set yaw rate
-  std::get<2>(this->angularMean).Push(yawDiff / dt.count());
-  msg.mutable_twist()->mutable_angular()->set_z(
-    std::get<2>(this->angularMean).Mean() +
-    ignition::math::Rand::DblNormal(0, this->gaussianNoise));
-
-  // Set the time stamp in the header.
-  msgs::Header header;
-  header.mutable_stamp()->CopyFrom(convert<msgs::Time>(_info.simTime));
-
-  // Set the frame ids.
-  auto frame = header.add_data();
-  frame->set_key("frame_id");
-  frame->add_value(odomFrame);
-  auto childFrame = header.add_data();
-  childFrame->set_key("child_frame_id");
-  childFrame->add_value(robotBaseFrame);
-
-  msg.mutable_header()->CopyFrom(header);
+  sample[5] = yawDiff / dt.count();
+  this->velocityWindow.Push(sample);
 
   this->lastUpdatePose = pose;
   this->lastUpdateTime = std::chrono::steady_clock::time_point(_info.simTime);
 
-  // Throttle publishing.
+  // Throttle publishing. Velocities are estimated on every step, but the
+  // messages are only filled in at the publication rate.
   auto diff = _info.simTime - this->lastOdomPubTime;
   if (diff > std::chrono::steady_clock::duration::zero() &&
       diff < this->odomPubPeriod)
@@ -448,73 +458,67 @@ void OdometryPublisherPrivate::UpdateOdometry(
     return;
   }
   this->lastOdomPubTime = _info.simTime;
-  if (this->odomPub.Valid())
+
+  // Fill the odometry message.
+  auto &msg = this->odomMsg;
+  set(msg.mutable_header()->mutable_stamp(), _info.simTime);
+
+  msg.mutable_pose()->mutable_position()->set_x(pose.Pos().X());
+  msg.mutable_pose()->mutable_position()->set_y(pose.Pos().Y());
+  msgs::Set(msg.mutable_pose()->mutable_orientation(), pose.Rot());
+  if (this->dimensions == 3)
   {
-    this->odomPub.Publish(msg);
+    msg.mutable_pose()->mutable_position()->set_z(pose.Pos().Z());
   }
 
-  // Generate odometry with covariance message and publish it.
-  msgs::OdometryWithCovariance msgCovariance;
-
-  // Set the time stamp in the header.
-  msgCovariance.mutable_header()->CopyFrom(header);
-
-  // Copy position from odometry msg.
-  msgCovariance.mutable_pose_with_covariance()->
-    mutable_pose()->mutable_position()->set_x(msg.pose().position().x());
-  msgCovariance.mutable_pose_with_covariance()->
-    mutable_pose()->mutable_position()->set_y(msg.pose().position().y());
-  msgCovariance.mutable_pose_with_covariance()->
-    mutable_pose()->mutable_position()->set_z(msg.pose().position().z());
-
-  // Copy twist from odometry msg.
-  msgCovariance.mutable_twist_with_covariance()->
-    mutable_twist()->mutable_angular()->set_x(msg.twist().angular().x());
-  msgCovariance.mutable_twist_with_covariance()->
-    mutable_twist()->mutable_angular()->set_y(msg.twist().angular().y());
-  msgCovariance.mutable_twist_with_covariance()->
-    mutable_twist()->mutable_angular()->set_z(msg.twist().angular().z());
-
-  msgCovariance.mutable_twist_with_covariance()->
-    mutable_twist()->mutable_linear()->set_x(msg.twist().linear().x());
-  msgCovariance.mutable_twist_with_covariance()->
-    mutable_twist()->mutable_linear()->set_y(msg.twist().linear().y());
-  msgCovariance.mutable_twist_with_covariance()->
-    mutable_twist()->mutable_linear()->set_z(msg.twist().linear().z());
-
-  // Populate the covariance matrix.
-  // Should the matrix me populated for pose as well ?
-  auto gn2 = this->gaussianNoise * this->gaussianNoise;
-  for (int i = 0; i < 36; i++)
+  // In 2D, the out-of-plane components only carry noise.
+  const auto mean = this->velocityWindow.Mean();
+  msg.mutable_twist()->mutable_linear()->set_x(
+    mean[0] + ignition::math::Rand::DblNormal(0, this->gaussianNoise));
+  msg.mutable_twist()->mutable_linear()->set_y(
+    mean[1] + ignition::math::Rand::DblNormal(0, this->gaussianNoise));
+  msg.mutable_twist()->mutable_linear()->set_z(
+    mean[2] + ignition::math::Rand::DblNormal(0, this->gaussianNoise));
+  msg.mutable_twist()->mutable_angular()->set_x(
+    mean[3] + ignition::math::Rand::DblNormal(0, this->gaussianNoise));
+  msg.mutable_twist()->mutable_angular()->set_y(
+    mean[4] + ignition::math::Rand::DblNormal(0, this->gaussianNoise));
+  msg.mutable_twist()->mutable_angular()->set_z(
+    mean[5] + ignition::math::Rand::DblNormal(0, this->gaussianNoise));
+
+  if (this->odomPub.Valid())
   {
-    if (i % 7 == 0)
-    {
-      msgCovariance.mutable_pose_with_covariance()->
-        mutable_covariance()->add_data(gn2);
-      msgCovariance.mutable_twist_with_covariance()->
-        mutable_covariance()->add_data(gn2);
-    }
-    else
-    {
-      msgCovariance.mutable_pose_with_covariance()->
-        mutable_covariance()->add_data(0);
-      msgCovariance.mutable_twist_with_covariance()->
-        mutable_covariance()->add_data(0);
-    }
+    this->odomPub.Publish(msg);
   }
+
+  // Update the odometry with covariance message and publish it. The
+  // covariance matrices and frame ids were filled in at configuration.
   if (this->odomCovPub.Valid())
   {
+    auto &msgCovariance = this->odomCovMsg;
+    msgCovariance.mutable_header()->mutable_stamp()->CopyFrom(
+        msg.header().stamp());
+
+    // Copy position from odometry msg.
+    msgCovariance.mutable_pose_with_covariance()->
+      mutable_pose()->mutable_position()->CopyFrom(msg.pose().position());
+
+    // Copy twist from odometry msg.
+    msgCovariance.mutable_twist_with_covariance()->
+      mutable_twist()->CopyFrom(msg.twist());
+
     this->odomCovPub.Publish(msgCovariance);
   }
 
   if (this->tfPub.Valid())
   {
-    msgs::Pose_V tfMsg;
-    auto tfMsgPose = tfMsg.add_pose();
-    tfMsgPose->CopyFrom(msg.pose());
-    tfMsgPose->mutable_header()->CopyFrom(header);
+    auto tfMsgPose = this->tfMsg.mutable_pose(0);
+    tfMsgPose->mutable_header()->mutable_stamp()->CopyFrom(
+        msg.header().stamp());
+    tfMsgPose->mutable_position()->CopyFrom(msg.pose().position());
+    tfMsgPose->mutable_orientation()->CopyFrom(msg.pose().orientation());
 
-    this->tfPub.Publish(tfMsg);
+    this->tfPub.Publish(this->tfMsg);
   }
 }
 
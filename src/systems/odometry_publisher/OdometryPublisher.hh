@@ -47,7 +47,10 @@ namespace systems
   /// value is `{name_of_model}/base_footprint`.
   ///
   /// `<odom_publish_frequency>`: Odometry publication frequency. This
-  /// element is optional, and the default value is 50Hz.
+  /// element is optional, and the default value is 50Hz. Velocities are
+  /// estimated on every simulation step, averaged over the last 10 steps,
+  /// but messages are only generated at this frequency, independently of the
+  /// physics update rate.
   ///
   /// `<odom_topic>`: Custom topic on which this system will publish odometry
   /// messages. This element is optional, and the default value is
@@ -17,6 +17,13 @@
 
 #include <ignition/msgs/pose.pb.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+
 #include <ignition/common/Profiler.hh>
 #include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Vector3.hh>
@@ -41,6 +48,258 @@ using namespace ignition;
 using namespace gazebo;
 using namespace systems;
 
+/// \brief Uniform grid over the XY plane holding the volumes of all
+/// performers. One instance is shared by all detectors using the same
+/// EntityComponentManager, and it is rebuilt by the first detector to run
+/// on each iteration.
+class ignition::gazebo::systems::PerformerIndex
+{
+  /// \brief Data of one performer.
+  public: struct Performer
+  {
+    /// \brief Performer entity.
+    Entity entity;
+
+    /// \brief Name of the performer's parent model.
+    std::string name;
+
+    /// \brief Pose of the performer's parent model.
+    math::Pose3d pose;
+
+    /// \brief Volume of the performer.
+    math::AxisAlignedBox box;
+  };
+
+  /// \brief Get the index shared by all detectors of a simulation.
+  /// \param[in] _ecm The simulation's EntityComponentManager.
+  /// \return The shared index.
+  public: static std::shared_ptr<PerformerIndex> Instance(
+      const EntityComponentManager &_ecm);
+
+  /// \brief Rebuild the index if it hasn't been built on this iteration.
+  /// \param[in] _info Update information.
+  /// \param[in] _ecm The EntityComponentManager.
+  public: void Update(const UpdateInfo &_info,
+                      const EntityComponentManager &_ecm);
+
+  /// \brief Get the performers whose grid cells overlap with a region.
+  /// \param[in] _region Region to query.
+  /// \param[out] _result Indices into `performers`, without duplicates.
+  /// Candidates still need to be tested against the region.
+  public: void Query(const math::AxisAlignedBox &_region,
+                     std::vector<std::size_t> &_result) const;
+
+  /// \brief Find a performer by entity.
+  /// \param[in] _entity Performer entity.
+  /// \return The performer or nullptr if it's not in the index.
+  public: const Performer *Find(const Entity _entity) const;
+
+  /// \brief All performers.
+  public: std::vector<Performer> performers;
+
+  /// \brief Compute the key of a grid cell.
+  /// \param[in] _x Cell index along X.
+  /// \param[in] _y Cell index along Y.
+  /// \return The key.
+  private: static int64_t CellKey(int64_t _x, int64_t _y);
+
+  /// \brief Cell index of a coordinate.
+  /// \param[in] _value Coordinate.
+  /// \return Cell index.
+  private: int64_t CellIndex(double _value) const;
+
+  /// \brief Map from performer entity to index in `performers`.
+  private: std::unordered_map<Entity, std::size_t> performerIndices;
+
+  /// \brief Grid cells and the indices of performers overlapping them.
+  /// Only cells overlapped by at least one performer are kept.
+  private: std::unordered_map<int64_t, std::vector<std::size_t>> cells;
+
+  /// \brief Edge length of the grid cells. Set to the largest performer
+  /// extent, so each performer overlaps at most 4 cells.
+  private: double cellSize{1.0};
+
+  /// \brief Iteration at which the index was last built.
+  private: uint64_t builtIteration{std::numeric_limits<uint64_t>::max()};
+
+  /// \brief Protects rebuilding, since PostUpdates run in parallel.
+  private: std::mutex mutex;
+};
+
+//////////////////////////////////////////////////
+std::shared_ptr<PerformerIndex> PerformerIndex::Instance(
+    const EntityComponentManager &_ecm)
+{
+  static std::mutex instancesMutex;
+  static std::map<const EntityComponentManager *,
+      std::weak_ptr<PerformerIndex>> instances;
+
+  std::lock_guard<std::mutex> lock(instancesMutex);
+
+  // Forget the indices of simulations whose detectors are all gone
+  for (auto it = instances.begin(); it != instances.end();)
+  {
+    if (it->second.expired())
+      it = instances.erase(it);
+    else
+      ++it;
+  }
+
+  auto &weakInstance = instances[&_ecm];
+  auto instance = weakInstance.lock();
+  if (!instance)
+  {
+    instance = std::make_shared<PerformerIndex>();
+    weakInstance = instance;
+  }
+  return instance;
+}
+
+//////////////////////////////////////////////////
+void PerformerIndex::Update(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("PerformerIndex::Update");
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->builtIteration == _info.iterations)
+    return;
+  this->builtIteration = _info.iterations;
+
+  this->performers.clear();
+  this->performerIndices.clear();
+  for (auto &cell : this->cells)
+    cell.second.clear();
+
+  double maxExtent{0.0};
+  _ecm.Each<components::Performer, components::Geometry,
+            components::ParentEntity>(
+      [&](const Entity &_entity, const components::Performer *,
+          const components::Geometry *_geometry,
+          const components::ParentEntity *_parent) -> bool
+      {
+        // We assume the geometry contains a box.
+        auto perfBox = _geometry->Data().BoxShape();
+        if (nullptr == perfBox)
+        {
+          ignerr << "Internal error: geometry of performer [" << _entity
+                 << "] missing box." << std::endl;
+          return true;
+        }
+
+        Performer performer;
+        performer.entity = _entity;
+        performer.pose =
+            _ecm.Component<components::Pose>(_parent->Data())->Data();
+        performer.name =
+            _ecm.Component<components::Name>(_parent->Data())->Data();
+        performer.box = math::AxisAlignedBox(
+            performer.pose.Pos() - perfBox->Size() / 2,
+            performer.pose.Pos() + perfBox->Size() / 2);
+
+        maxExtent = std::max({maxExtent, performer.box.XLength(),
+            performer.box.YLength()});
+
+        this->performerIndices[_entity] = this->performers.size();
+        this->performers.push_back(std::move(performer));
+        return true;
+      });
+
+  // Keep the previous cell size if it's still large enough, so cell vectors
+  // can be reused.
+  if (maxExtent > this->cellSize)
+  {
+    this->cellSize = maxExtent;
+    this->cells.clear();
+  }
+
+  for (std::size_t i = 0; i < this->performers.size(); ++i)
+  {
+    const auto &box = this->performers[i].box;
+    const auto minX = this->CellIndex(box.Min().X());
+    const auto maxX = this->CellIndex(box.Max().X());
+    const auto minY = this->CellIndex(box.Min().Y());
+    const auto maxY = this->CellIndex(box.Max().Y());
+    for (auto x = minX; x <= maxX; ++x)
+    {
+      for (auto y = minY; y <= maxY; ++y)
+        this->cells[CellKey(x, y)].push_back(i);
+    }
+  }
+
+  // Drop the cells performers left, so the grid doesn't keep every cell
+  // that was ever visited
+  for (auto it = this->cells.begin(); it != this->cells.end();)
+  {
+    if (it->second.empty())
+      it = this->cells.erase(it);
+    else
+      ++it;
+  }
+}
+
+//////////////////////////////////////////////////
+void PerformerIndex::Query(const math::AxisAlignedBox &_region,
+    std::vector<std::size_t> &_result) const
+{
+  _result.clear();
+
+  const auto minX = this->CellIndex(_region.Min().X());
+  const auto maxX = this->CellIndex(_region.Max().X());
+  const auto minY = this->CellIndex(_region.Min().Y());
+  const auto maxY = this->CellIndex(_region.Max().Y());
+
+  // Regions much larger than the grid cells are cheaper to test against all
+  // performers directly.
+  const double cellCount = static_cast<double>(maxX - minX + 1) *
+      static_cast<double>(maxY - minY + 1);
+  if (cellCount >= static_cast<double>(this->performers.size()))
+  {
+    for (std::size_t i = 0; i < this->performers.size(); ++i)
+      _result.push_back(i);
+    return;
+  }
+
+  for (auto x = minX; x <= maxX; ++x)
+  {
+    for (auto y = minY; y <= maxY; ++y)
+    {
+      auto it = this->cells.find(CellKey(x, y));
+      if (it != this->cells.end())
+        _result.insert(_result.end(), it->second.begin(), it->second.end());
+    }
+  }
+
+  // Performers can overlap several cells
+  std::sort(_result.begin(), _result.end());
+  _result.erase(std::unique(_result.begin(), _result.end()), _result.end());
+}
+
+//////////////////////////////////////////////////
+const PerformerIndex::Performer *PerformerIndex::Find(
+    const Entity _entity) const
+{
+  auto it = this->performerIndices.find(_entity);
+  if (it == this->performerIndices.end())
+    return nullptr;
+  return &this->performers[it->second];
+}
+
+//////////////////////////////////////////////////
+int64_t PerformerIndex::CellKey(int64_t _x, int64_t _y)
+{
+  return (_x << 32) ^ (_y & 0xFFFFFFFF);
+}
+
+//////////////////////////////////////////////////
+int64_t PerformerIndex::CellIndex(double _value) const
+{
+  // Clamp to keep the index within 32 bits for CellKey
+  const double index = std::floor(_value / this->cellSize);
+  return static_cast<int64_t>(std::max(-2147483648.0,
+      std::min(2147483647.0, index)));
+}
+
 /////////////////////////////////////////////////
 void PerformerDetector::Configure(const Entity &_entity,
                const std::shared_ptr<const sdf::Element> &_sdf,
@@ -125,6 +384,7 @@ void PerformerDetector::Configure(const Entity &_entity,
 
   transport::Node node;
   this->pub = node.Advertise<msgs::Pose>(topic);
+  this->index = PerformerIndex::Instance(_ecm);
   this->initialized = true;
 }
 
@@ -159,45 +419,47 @@ void PerformerDetector::PostUpdate(
   auto region = this->detectorGeometry -
     (-(modelPose.Pos() + modelPose.Rot() * this->poseOffset.Pos()));
 
-  _ecm.Each<components::Performer, components::Geometry,
-            components::ParentEntity>(
-      [&](const Entity &_entity, const components::Performer *,
-          const components::Geometry *_geometry,
-          const components::ParentEntity *_parent) -> bool
-      {
-        auto pose = _ecm.Component<components::Pose>(_parent->Data())->Data();
-        auto name = _ecm.Component<components::Name>(_parent->Data())->Data();
-        const math::Pose3d relPose = modelPose.Inverse() * pose;
+  this->index->Update(_info, _ecm);
+  this->index->Query(region, this->candidates);
 
-        // We assume the geometry contains a box.
-        auto perfBox = _geometry->Data().BoxShape();
-        if (nullptr == perfBox)
-        {
-          ignerr << "Internal error: geometry of performer [" << _entity
-                 << "] missing box." << std::endl;
-          return true;
-        }
+  this->insideEntities.clear();
+  for (const auto i : this->candidates)
+  {
+    const auto &performer = this->index->performers[i];
+    if (!region.Intersects(performer.box))
+      continue;
 
-        math::AxisAlignedBox performerVolume{pose.Pos() - perfBox->Size() / 2,
-                                             pose.Pos() + perfBox->Size() / 2};
+    this->insideEntities.insert(performer.entity);
+    if (!this->IsAlreadyDetected(performer.entity))
+    {
+      this->AddToDetected(performer.entity);
+      this->Publish(performer.entity, performer.name, true,
+          modelPose.Inverse() * performer.pose, _info.simTime);
+    }
+  }
 
-        bool alreadyDetected = this->IsAlreadyDetected(_entity);
-        if (region.Intersects(performerVolume))
-        {
-          if (!alreadyDetected)
-          {
-            this->AddToDetected(_entity);
-            this->Publish(_entity, name, true, relPose, _info.simTime);
-          }
-        }
-        else if (alreadyDetected)
-        {
-          this->RemoveFromDetected(_entity);
-          this->Publish(_entity, name, false, relPose, _info.simTime);
-        }
+  // Performers that left the region. Performers that were removed from the
+  // simulation are not reported.
+  if (this->detectedEntities.size() == this->insideEntities.size())
+    return;
 
-        return true;
-      });
+  std::vector<Entity> exited;
+  for (const auto entity : this->detectedEntities)
+  {
+    if (this->insideEntities.find(entity) == this->insideEntities.end() &&
+        this->index->Find(entity) != nullptr)
+    {
+      exited.push_back(entity);
+    }
+  }
+
+  for (const auto entity : exited)
+  {
+    const auto *performer = this->index->Find(entity);
+    this->RemoveFromDetected(entity);
+    this->Publish(entity, performer->name, false,
+        modelPose.Inverse() * performer->pose, _info.simTime);
+  }
 }
 
 //////////////////////////////////////////////////
@@ -22,6 +22,7 @@
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include <ignition/transport/Node.hh>
 
@@ -36,6 +37,9 @@ namespace gazebo
 inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
 namespace systems
 {
+  // Forward declaration
+  class PerformerIndex;
+
   /// \brief A system system that publishes on a topic when a performer enters
   /// or leaves a specified region.
   ///
@@ -61,6 +65,12 @@ namespace systems
   /// The system does not assume that levels are enabled, but it does require
   /// performers to be specified.
   ///
+  /// All PerformerDetector instances of a simulation share a single spatial
+  /// index of the performers' volumes, which is rebuilt at most once per
+  /// iteration. Each detector only tests the performers located in the grid
+  /// cells covered by its region, so the cost of a detector does not grow
+  /// with the total number of performers in the world.
+  ///
   /// ## System parameters
   ///
   /// `<topic>`: Custom topic to be used for publishing when a performer is
@@ -145,6 +155,17 @@ namespace systems
 
     /// \brief Optional extra header data.
     private: std::map<std::string, std::string> extraHeaderData;
+
+    /// \brief Spatial index of performers shared by all detectors of the
+    /// same simulation.
+    private: std::shared_ptr<PerformerIndex> index;
+
+    /// \brief Indices of candidate performers, reused across iterations.
+    private: std::vector<std::size_t> candidates;
+
+    /// \brief Performers inside the region this iteration, reused across
+    /// iterations.
+    private: std::unordered_set<Entity> insideEntities;
   };
 
   }
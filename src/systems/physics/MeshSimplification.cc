@@ -0,0 +1,646 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "MeshSimplification.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+#include <ignition/common/SubMesh.hh>
+
+namespace ignition::gazebo
+{
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems::physics_system
+{
+namespace
+{
+/// \brief Version of the simplification algorithms, part of the cache key
+/// so meshes are simplified again when the algorithms change.
+const char kAlgorithmVersion[] = "v2";
+
+/// \brief Finest grid tried when merging vertices, in cells along the
+/// longest side of the bounding box.
+const unsigned int kMaxCells = 1024;
+
+/// \brief Compute the bounding box of points.
+/// \param[in] _points The points.
+/// \param[out] _min Minimum corner.
+/// \param[out] _max Maximum corner.
+void bounds(const std::vector<math::Vector3d> &_points,
+    math::Vector3d &_min, math::Vector3d &_max)
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  _min.Set(inf, inf, inf);
+  _max.Set(-inf, -inf, -inf);
+  for (const auto &point : _points)
+  {
+    _min.Min(point);
+    _max.Max(point);
+  }
+}
+
+/// \brief Merge points which fall in the same cell of a grid.
+/// \param[in] _points The points.
+/// \param[in] _cells Number of cells along the longest side of the bounding
+/// box.
+/// \param[out] _map Index of the merged point of each point.
+/// \return Merged points, each at the mean of the points of its cell.
+std::vector<math::Vector3d> cluster(const std::vector<math::Vector3d> &_points,
+    unsigned int _cells, std::vector<unsigned int> &_map)
+{
+  math::Vector3d min, max;
+  bounds(_points, min, max);
+  const double extent = (max - min).Max();
+  const double cell = extent > 0 ? extent / _cells : 1.0;
+
+  auto index = [&](double _value, double _min) -> uint64_t
+  {
+    // Points on the maximum side belong to the last cell
+    return std::min<uint64_t>(static_cast<uint64_t>((_value - _min) / cell),
+        _cells - 1);
+  };
+
+  std::unordered_map<uint64_t, unsigned int> cellPoints;
+  std::vector<math::Vector3d> sums;
+  std::vector<unsigned int> counts;
+  _map.resize(_points.size());
+  for (std::size_t i = 0; i < _points.size(); ++i)
+  {
+    const auto &point = _points[i];
+    const uint64_t key = index(point.X(), min.X()) + _cells *
+        (index(point.Y(), min.Y()) + _cells * index(point.Z(), min.Z()));
+    auto it = cellPoints.emplace(key, static_cast<unsigned int>(sums.size()));
+    if (it.second)
+    {
+      sums.push_back(math::Vector3d::Zero);
+      counts.push_back(0);
+    }
+    sums[it.first->second] += point;
+    ++counts[it.first->second];
+    _map[i] = it.first->second;
+  }
+
+  for (std::size_t i = 0; i < sums.size(); ++i)
+    sums[i] /= counts[i];
+  return sums;
+}
+
+/// \brief Remove vertices which aren't used by any triangle.
+/// \param[in, out] _mesh The mesh.
+void compact(TriangleMesh &_mesh)
+{
+  const unsigned int unused = std::numeric_limits<unsigned int>::max();
+  std::vector<unsigned int> map(_mesh.vertices.size(), unused);
+  std::vector<math::Vector3d> vertices;
+  for (auto &triangle : _mesh.triangles)
+  {
+    for (auto &vertex : triangle)
+    {
+      if (map[vertex] == unused)
+      {
+        map[vertex] = static_cast<unsigned int>(vertices.size());
+        vertices.push_back(_mesh.vertices[vertex]);
+      }
+      vertex = map[vertex];
+    }
+  }
+  _mesh.vertices = std::move(vertices);
+}
+
+/// \brief Merge the vertices of a mesh on a grid, dropping triangles which
+/// collapse or become duplicates.
+/// \param[in] _mesh The mesh.
+/// \param[in] _cells Number of cells along the longest side of the bounding
+/// box.
+/// \return Merged mesh.
+TriangleMesh clusterTriangles(const TriangleMesh &_mesh, unsigned int _cells)
+{
+  TriangleMesh result;
+  std::vector<unsigned int> map;
+  result.vertices = cluster(_mesh.vertices, _cells, map);
+
+  std::set<std::array<unsigned int, 3>> seen;
+  for (const auto &triangle : _mesh.triangles)
+  {
+    std::array<unsigned int, 3> merged{
+        map[triangle[0]], map[triangle[1]], map[triangle[2]]};
+    if (merged[0] == merged[1] || merged[1] == merged[2] ||
+        merged[2] == merged[0])
+    {
+      continue;
+    }
+
+    auto sorted = merged;
+    std::sort(sorted.begin(), sorted.end());
+    if (seen.insert(sorted).second)
+      result.triangles.push_back(merged);
+  }
+  compact(result);
+  return result;
+}
+
+/// \brief Compute the convex hull of points incrementally, adding one point
+/// at a time and replacing the faces it can see.
+/// \param[in] _points The points.
+/// \return The hull, empty if the points are all on a plane.
+TriangleMesh incrementalHull(const std::vector<math::Vector3d> &_points)
+{
+  TriangleMesh hull;
+  if (_points.size() < 4)
+    return hull;
+
+  math::Vector3d min, max;
+  bounds(_points, min, max);
+  const double eps = 1e-9 * (max - min).Max();
+  if (eps <= 0)
+    return hull;
+
+  // Initial tetrahedron from extreme points
+  const auto &p = _points;
+  std::size_t i0 = 0;
+  for (std::size_t i = 1; i < p.size(); ++i)
+  {
+    if (p[i].X() < p[i0].X())
+      i0 = i;
+  }
+
+  auto farthest = [&](auto _distance)
+  {
+    std::size_t best = 0;
+    double bestDistance = -1;
+    for (std::size_t i = 0; i < p.size(); ++i)
+    {
+      double distance = _distance(p[i]);
+      if (distance > bestDistance)
+      {
+        best = i;
+        bestDistance = distance;
+      }
+    }
+    return std::make_pair(best, bestDistance);
+  };
+
+  auto [i1, d1] = farthest([&](const math::Vector3d &_p)
+      {return _p.Distance(p[i0]);});
+  if (d1 <= eps)
+    return hull;
+
+  const auto axis = (p[i1] - p[i0]).Normalized();
+  auto [i2, d2] = farthest([&](const math::Vector3d &_p)
+      {return (_p - p[i0]).Cross(axis).Length();});
+  if (d2 <= eps)
+    return hull;
+
+  const auto normal = (p[i1] - p[i0]).Cross(p[i2] - p[i0]).Normalized();
+  auto [i3, d3] = farthest([&](const math::Vector3d &_p)
+      {return std::abs(normal.Dot(_p - p[i0]));});
+  if (d3 <= eps)
+    return hull;
+
+  // The 4th point must be behind the first face
+  if (normal.Dot(p[i3] - p[i0]) > 0)
+    std::swap(i1, i2);
+
+  struct Face
+  {
+    std::array<unsigned int, 3> v;
+    math::Vector3d normal;
+    double offset;
+    bool alive;
+  };
+  std::vector<Face> faces;
+  std::vector<std::size_t> visibleFrom;
+  std::unordered_map<uint64_t, std::size_t> edges;
+  auto edgeKey = [](unsigned int _a, unsigned int _b)
+  {
+    return (static_cast<uint64_t>(_a) << 32) | _b;
+  };
+  auto addFace = [&](unsigned int _a, unsigned int _b, unsigned int _c)
+  {
+    Face face;
+    face.v = {_a, _b, _c};
+    face.normal = (p[_b] - p[_a]).Cross(p[_c] - p[_a]).Normalized();
+    face.offset = face.normal.Dot(p[_a]);
+    face.alive = true;
+    edges[edgeKey(_a, _b)] = faces.size();
+    edges[edgeKey(_b, _c)] = faces.size();
+    edges[edgeKey(_c, _a)] = faces.size();
+    faces.push_back(face);
+    visibleFrom.push_back(std::numeric_limits<std::size_t>::max());
+  };
+
+  const auto a = static_cast<unsigned int>(i0);
+  const auto b = static_cast<unsigned int>(i1);
+  const auto c = static_cast<unsigned int>(i2);
+  const auto d = static_cast<unsigned int>(i3);
+  addFace(a, b, c);
+  addFace(a, d, b);
+  addFace(b, d, c);
+  addFace(c, d, a);
+
+  // Faces still on the hull, so replaced faces aren't tested again
+  std::vector<std::size_t> current{0, 1, 2, 3};
+  std::vector<std::size_t> visible;
+  std::vector<std::pair<unsigned int, unsigned int>> horizon;
+  for (std::size_t i = 0; i < p.size(); ++i)
+  {
+    if (i == i0 || i == i1 || i == i2 || i == i3)
+      continue;
+
+    visible.clear();
+    for (auto f : current)
+    {
+      if (faces[f].normal.Dot(p[i]) - faces[f].offset > eps)
+      {
+        visible.push_back(f);
+        visibleFrom[f] = i;
+      }
+    }
+    if (visible.empty())
+      continue;
+
+    // Edges between visible and hidden faces
+    horizon.clear();
+    for (auto f : visible)
+    {
+      for (int k = 0; k < 3; ++k)
+      {
+        auto from = faces[f].v[k];
+        auto to = faces[f].v[(k + 1) % 3];
+        auto twin = edges.find(edgeKey(to, from));
+        if (twin == edges.end() || visibleFrom[twin->second] != i)
+          horizon.emplace_back(from, to);
+      }
+    }
+
+    for (auto f : visible)
+    {
+      faces[f].alive = false;
+      for (int k = 0; k < 3; ++k)
+        edges.erase(edgeKey(faces[f].v[k], faces[f].v[(k + 1) % 3]));
+    }
+
+    current.erase(std::remove_if(current.begin(), current.end(),
+        [&](std::size_t _f) {return !faces[_f].alive;}), current.end());
+    for (const auto &edge : horizon)
+    {
+      current.push_back(faces.size());
+      addFace(edge.first, edge.second, static_cast<unsigned int>(i));
+    }
+  }
+
+  hull.vertices = _points;
+  for (auto f : current)
+    hull.triangles.push_back(faces[f].v);
+  compact(hull);
+  return hull;
+}
+
+/// \brief Scale a convex hull about its center until it contains points.
+/// Hulls of merged vertices lie inside the hull of the original ones, so
+/// they're scaled back out to cover the original shape.
+/// \param[in, out] _hull The hull.
+/// \param[in] _points Points which must be inside the hull.
+void enclose(TriangleMesh &_hull, const std::vector<math::Vector3d> &_points)
+{
+  if (_hull.vertices.empty())
+    return;
+
+  // The mean of the vertices is inside the hull
+  math::Vector3d center;
+  for (const auto &vertex : _hull.vertices)
+    center += vertex;
+  center /= static_cast<double>(_hull.vertices.size());
+
+  // Scaling by s moves the plane of each face to s times its distance from
+  // the center, find the smallest s which puts every point behind all faces
+  double scale{1.0};
+  for (const auto &triangle : _hull.triangles)
+  {
+    const auto &a = _hull.vertices[triangle[0]];
+    auto normal = (_hull.vertices[triangle[1]] - a).Cross(
+        _hull.vertices[triangle[2]] - a);
+    double offset = normal.Dot(a - center);
+    if (offset < 0)
+    {
+      normal = -normal;
+      offset = -offset;
+    }
+    if (offset <= std::numeric_limits<double>::epsilon() * normal.Length())
+      continue;
+
+    for (const auto &point : _points)
+      scale = std::max(scale, normal.Dot(point - center) / offset);
+  }
+
+  if (scale > 1.0)
+  {
+    for (auto &vertex : _hull.vertices)
+      vertex = center + (vertex - center) * scale;
+  }
+}
+}
+
+//////////////////////////////////////////////////
+std::optional<MeshSimplification> parseMeshSimplification(
+    const std::string &_name)
+{
+  if (_name == "none")
+    return MeshSimplification::kNone;
+  if (_name == "decimate")
+    return MeshSimplification::kDecimate;
+  if (_name == "convex_hull")
+    return MeshSimplification::kConvexHull;
+  if (_name == "convex_decomposition")
+    return MeshSimplification::kConvexDecomposition;
+  return std::nullopt;
+}
+
+//////////////////////////////////////////////////
+std::string meshSimplificationVariant(
+    const MeshSimplificationOptions &_options)
+{
+  std::string variant = kAlgorithmVersion;
+  switch (_options.method)
+  {
+    case MeshSimplification::kDecimate:
+      variant += "_decimate";
+      break;
+    case MeshSimplification::kConvexHull:
+      variant += "_convex_hull";
+      break;
+    case MeshSimplification::kConvexDecomposition:
+      variant += "_convex_decomposition_" + std::to_string(_options.maxHulls);
+      break;
+    case MeshSimplification::kNone:
+    default:
+      return "none";
+  }
+  return variant + "_" + std::to_string(_options.maxTriangles);
+}
+
+//////////////////////////////////////////////////
+TriangleMesh triangles(const common::Mesh &_mesh)
+{
+  TriangleMesh result;
+  for (unsigned int s = 0; s < _mesh.SubMeshCount(); ++s)
+  {
+    auto subMesh = _mesh.SubMeshByIndex(s).lock();
+    if (!subMesh ||
+        subMesh->SubMeshPrimitiveType() != common::SubMesh::TRIANGLES)
+    {
+      continue;
+    }
+
+    const auto offset = static_cast<unsigned int>(result.vertices.size());
+    for (unsigned int v = 0; v < subMesh->VertexCount(); ++v)
+      result.vertices.push_back(subMesh->Vertex(v));
+
+    // Submeshes without indices list the vertices of each triangle in order
+    const bool indexed = subMesh->IndexCount() > 0;
+    const unsigned int count = indexed ? subMesh->IndexCount() :
+        subMesh->VertexCount();
+    for (unsigned int i = 0; i + 2 < count; i += 3)
+    {
+      std::array<unsigned int, 3> triangle;
+      for (unsigned int k = 0; k < 3; ++k)
+      {
+        triangle[k] = offset + (indexed ?
+            static_cast<unsigned int>(subMesh->Index(i + k)) : i + k);
+      }
+      result.triangles.push_back(triangle);
+    }
+  }
+  return result;
+}
+
+//////////////////////////////////////////////////
+TriangleMesh decimate(const TriangleMesh &_mesh, std::size_t _maxTriangles)
+{
+  if (_mesh.triangles.size() <= _maxTriangles)
+    return _mesh;
+
+  // Finer grids keep more triangles, find the finest which fits the budget
+  TriangleMesh best;
+  unsigned int low = 2;
+  unsigned int high = kMaxCells;
+  while (low <= high)
+  {
+    const unsigned int cells = low + (high - low) / 2;
+    auto candidate = clusterTriangles(_mesh, cells);
+    if (candidate.triangles.size() <= _maxTriangles)
+    {
+      best = std::move(candidate);
+      low = cells + 1;
+    }
+    else
+    {
+      high = cells - 1;
+    }
+  }
+  return best;
+}
+
+//////////////////////////////////////////////////
+TriangleMesh convexHull(const std::vector<math::Vector3d> &_points,
+    std::size_t _maxTriangles)
+{
+  auto hull = incrementalHull(_points);
+  if (hull.triangles.size() <= _maxTriangles)
+    return hull;
+
+  // Merge the vertices of the hull until its hull fits the budget
+  TriangleMesh best;
+  unsigned int low = 2;
+  unsigned int high = kMaxCells;
+  while (low <= high)
+  {
+    const unsigned int cells = low + (high - low) / 2;
+    std::vector<unsigned int> map;
+    auto candidate = incrementalHull(cluster(hull.vertices, cells, map));
+    if (!candidate.triangles.empty() &&
+        candidate.triangles.size() <= _maxTriangles)
+    {
+      best = std::move(candidate);
+      low = cells + 1;
+    }
+    else
+    {
+      high = cells - 1;
+    }
+  }
+  enclose(best, hull.vertices);
+  return best;
+}
+
+//////////////////////////////////////////////////
+std::vector<TriangleMesh> convexDecomposition(const TriangleMesh &_mesh,
+    std::size_t _maxHulls, std::size_t _maxTriangles)
+{
+  std::vector<TriangleMesh> hulls;
+  if (_mesh.triangles.empty() || _maxHulls == 0)
+    return hulls;
+
+  std::vector<math::Vector3d> centroids;
+  centroids.reserve(_mesh.triangles.size());
+  for (const auto &triangle : _mesh.triangles)
+  {
+    centroids.push_back((_mesh.vertices[triangle[0]] +
+        _mesh.vertices[triangle[1]] + _mesh.vertices[triangle[2]]) / 3.0);
+  }
+
+  std::vector<std::vector<std::size_t>> parts(1);
+  parts[0].resize(_mesh.triangles.size());
+  std::iota(parts[0].begin(), parts[0].end(), 0);
+  std::vector<bool> splittable{true};
+
+  auto partBounds = [&](const std::vector<std::size_t> &_part,
+      math::Vector3d &_min, math::Vector3d &_max)
+  {
+    std::vector<math::Vector3d> points;
+    for (auto t : _part)
+    {
+      for (auto v : _mesh.triangles[t])
+        points.push_back(_mesh.vertices[v]);
+    }
+    bounds(points, _min, _max);
+  };
+
+  while (parts.size() < _maxHulls)
+  {
+    // Split the biggest part
+    std::size_t biggest = parts.size();
+    double biggestSize = 0;
+    math::Vector3d min, max;
+    for (std::size_t i = 0; i < parts.size(); ++i)
+    {
+      if (!splittable[i])
+        continue;
+      partBounds(parts[i], min, max);
+      double size = (max - min).Length();
+      if (size > biggestSize)
+      {
+        biggest = i;
+        biggestSize = size;
+      }
+    }
+    if (biggest == parts.size())
+      break;
+
+    partBounds(parts[biggest], min, max);
+    const auto extent = max - min;
+    int axis = 0;
+    if (extent.Y() > extent[axis])
+      axis = 1;
+    if (extent.Z() > extent[axis])
+      axis = 2;
+
+    auto &part = parts[biggest];
+    auto middle = part.begin() + part.size() / 2;
+    std::nth_element(part.begin(), middle, part.end(),
+        [&](std::size_t _a, std::size_t _b)
+        {
+          return centroids[_a][axis] < centroids[_b][axis];
+        });
+
+    std::vector<std::size_t> upper(middle, part.end());
+    part.erase(middle, part.end());
+    if (part.empty() || upper.empty())
+    {
+      part.insert(part.end(), upper.begin(), upper.end());
+      splittable[biggest] = false;
+      continue;
+    }
+    parts.push_back(std::move(upper));
+    splittable.push_back(true);
+  }
+
+  const std::size_t budget = std::max<std::size_t>(4,
+      _maxTriangles / parts.size());
+  for (const auto &part : parts)
+  {
+    std::vector<math::Vector3d> points;
+    for (auto t : part)
+    {
+      for (auto v : _mesh.triangles[t])
+        points.push_back(_mesh.vertices[v]);
+    }
+    auto hull = convexHull(points, budget);
+    if (!hull.triangles.empty())
+      hulls.push_back(std::move(hull));
+  }
+  return hulls;
+}
+
+//////////////////////////////////////////////////
+std::unique_ptr<common::Mesh> simplifyMesh(const common::Mesh &_mesh,
+    const MeshSimplificationOptions &_options)
+{
+  auto soup = triangles(_mesh);
+  if (soup.triangles.empty())
+    return nullptr;
+
+  std::vector<TriangleMesh> parts;
+  switch (_options.method)
+  {
+    case MeshSimplification::kDecimate:
+      parts.push_back(decimate(soup, _options.maxTriangles));
+      break;
+    case MeshSimplification::kConvexHull:
+      parts.push_back(convexHull(soup.vertices, _options.maxTriangles));
+      break;
+    case MeshSimplification::kConvexDecomposition:
+      parts = convexDecomposition(soup, _options.maxHulls,
+          _options.maxTriangles);
+      break;
+    case MeshSimplification::kNone:
+    default:
+      return nullptr;
+  }
+
+  auto result = std::make_unique<common::Mesh>();
+  for (std::size_t i = 0; i < parts.size(); ++i)
+  {
+    if (parts[i].triangles.empty())
+      continue;
+
+    common::SubMesh subMesh;
+    subMesh.SetName("collision_" + std::to_string(i));
+    subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+    for (const auto &vertex : parts[i].vertices)
+      subMesh.AddVertex(vertex);
+    for (const auto &triangle : parts[i].triangles)
+    {
+      for (auto vertex : triangle)
+        subMesh.AddIndex(vertex);
+    }
+    result->AddSubMesh(subMesh);
+  }
+
+  if (result->SubMeshCount() == 0)
+    return nullptr;
+  return result;
+}
+}
+}
+}
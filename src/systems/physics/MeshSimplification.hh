@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_PHYSICS_MESH_SIMPLIFICATION_HH_
+#define IGNITION_GAZEBO_SYSTEMS_PHYSICS_MESH_SIMPLIFICATION_HH_
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Mesh.hh>
+#include <ignition/math/Vector3.hh>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/physics-system/Export.hh>
+
+namespace ignition::gazebo
+{
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems::physics_system
+{
+  /// \brief How collision meshes are simplified before they're given to the
+  /// physics engine.
+  enum class MeshSimplification
+  {
+    /// \brief Use the mesh as is.
+    kNone,
+
+    /// \brief Reduce the number of triangles to a budget.
+    kDecimate,
+
+    /// \brief Replace the mesh with its convex hull.
+    kConvexHull,
+
+    /// \brief Replace the mesh with the convex hulls of up to a number of
+    /// its parts.
+    kConvexDecomposition,
+  };
+
+  /// \brief Parameters of collision mesh simplification.
+  struct MeshSimplificationOptions
+  {
+    /// \brief Simplification method.
+    MeshSimplification method{MeshSimplification::kNone};
+
+    /// \brief Maximum number of triangles of the simplified mesh, shared by
+    /// all hulls of a decomposition.
+    std::size_t maxTriangles{1000};
+
+    /// \brief Maximum number of hulls of a convex decomposition.
+    std::size_t maxHulls{8};
+  };
+
+  /// \brief Triangles sharing a list of vertices.
+  struct TriangleMesh
+  {
+    /// \brief Vertices.
+    std::vector<math::Vector3d> vertices;
+
+    /// \brief Indices of the vertices of each triangle, counter-clockwise
+    /// when seen from outside.
+    std::vector<std::array<unsigned int, 3>> triangles;
+  };
+
+  /// \brief Parse a simplification method, as used in the SDF of the
+  /// physics system.
+  /// \param[in] _name One of "none", "decimate", "convex_hull" and
+  /// "convex_decomposition".
+  /// \return The method, or nullopt if the name is unknown.
+  IGNITION_GAZEBO_PHYSICS_SYSTEM_VISIBLE
+  std::optional<MeshSimplification> parseMeshSimplification(
+      const std::string &_name);
+
+  /// \brief Get a name which identifies the result of simplifying any mesh
+  /// with some options, used as a cache key.
+  /// \param[in] _options Simplification options.
+  /// \return Name, such as "v1_convex_hull_1000".
+  IGNITION_GAZEBO_PHYSICS_SYSTEM_VISIBLE
+  std::string meshSimplificationVariant(
+      const MeshSimplificationOptions &_options);
+
+  /// \brief Get the triangles of all triangle list submeshes of a mesh.
+  /// \param[in] _mesh The mesh.
+  /// \return Triangles. Other primitive types are skipped.
+  IGNITION_GAZEBO_PHYSICS_SYSTEM_VISIBLE
+  TriangleMesh triangles(const common::Mesh &_mesh);
+
+  /// \brief Reduce the number of triangles of a mesh by merging vertices
+  /// which fall in the same cell of a grid. The finest grid which fits the
+  /// budget is used.
+  /// \param[in] _mesh The mesh.
+  /// \param[in] _maxTriangles Maximum number of triangles.
+  /// \return Decimated mesh, which may be empty if the budget can't be met
+  /// with a grid of more than one cell.
+  IGNITION_GAZEBO_PHYSICS_SYSTEM_VISIBLE
+  TriangleMesh decimate(const TriangleMesh &_mesh, std::size_t _maxTriangles);
+
+  /// \brief Compute the convex hull of points.
+  /// \param[in] _points The points.
+  /// \param[in] _maxTriangles Maximum number of triangles of the hull. Points
+  /// are merged on a grid until the hull fits the budget, and the merged
+  /// hull is then scaled up so it still contains all the points.
+  /// \return The hull, empty if the points are all on a plane.
+  IGNITION_GAZEBO_PHYSICS_SYSTEM_VISIBLE
+  TriangleMesh convexHull(const std::vector<math::Vector3d> &_points,
+      std::size_t _maxTriangles);
+
+  /// \brief Approximate a mesh with the convex hulls of its parts. The mesh
+  /// is split recursively at the median of its longest axis, biggest part
+  /// first, until the number of hulls is reached.
+  /// \param[in] _mesh The mesh.
+  /// \param[in] _maxHulls Maximum number of hulls.
+  /// \param[in] _maxTriangles Maximum number of triangles of all hulls.
+  /// \return The hulls.
+  IGNITION_GAZEBO_PHYSICS_SYSTEM_VISIBLE
+  std::vector<TriangleMesh> convexDecomposition(const TriangleMesh &_mesh,
+      std::size_t _maxHulls, std::size_t _maxTriangles);
+
+  /// \brief Simplify a mesh.
+  /// \param[in] _mesh The mesh.
+  /// \param[in] _options Simplification options.
+  /// \return Simplified mesh, with one submesh per hull for decompositions,
+  /// or null if the mesh couldn't be simplified.
+  IGNITION_GAZEBO_PHYSICS_SYSTEM_VISIBLE
+  std::unique_ptr<common::Mesh> simplifyMesh(const common::Mesh &_mesh,
+      const MeshSimplificationOptions &_options);
+}
+}
+}
+#endif
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "MeshSimplification.hh"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <ignition/common/SubMesh.hh>
+#include <ignition/math/Helpers.hh>
+
+using namespace ignition;
+using namespace ignition::gazebo::systems::physics_system;
+
+/// \brief Create a UV sphere.
+/// \param[in] _rings Number of rings between the poles.
+/// \param[in] _segments Number of segments around the vertical axis.
+/// \return Sphere of radius 1 centered on the origin.
+TriangleMesh sphere(unsigned int _rings, unsigned int _segments)
+{
+  TriangleMesh mesh;
+  for (unsigned int r = 0; r <= _rings; ++r)
+  {
+    const double polar = IGN_PI * r / _rings;
+    for (unsigned int s = 0; s < _segments; ++s)
+    {
+      const double azimuth = 2 * IGN_PI * s / _segments;
+      mesh.vertices.emplace_back(std::sin(polar) * std::cos(azimuth),
+          std::sin(polar) * std::sin(azimuth), std::cos(polar));
+    }
+  }
+
+  for (unsigned int r = 0; r < _rings; ++r)
+  {
+    for (unsigned int s = 0; s < _segments; ++s)
+    {
+      const unsigned int a = r * _segments + s;
+      const unsigned int b = r * _segments + (s + 1) % _segments;
+      const unsigned int c = a + _segments;
+      const unsigned int d = b + _segments;
+      if (r > 0)
+        mesh.triangles.push_back({a, c, b});
+      if (r + 1 < _rings)
+        mesh.triangles.push_back({b, c, d});
+    }
+  }
+  return mesh;
+}
+
+/// \brief Check that all vertices of a mesh are behind or on every face of
+/// a hull.
+/// \param[in] _hull The hull.
+/// \param[in] _points Points which must be inside the hull.
+/// \param[in] _tolerance Distance points may be in front of faces.
+void expectConvex(const TriangleMesh &_hull,
+    const std::vector<math::Vector3d> &_points, double _tolerance)
+{
+  for (const auto &triangle : _hull.triangles)
+  {
+    const auto &a = _hull.vertices[triangle[0]];
+    const auto normal = (_hull.vertices[triangle[1]] - a).Cross(
+        _hull.vertices[triangle[2]] - a).Normalized();
+    for (const auto &point : _points)
+      EXPECT_LE(normal.Dot(point - a), _tolerance);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(MeshSimplificationTest, Parse)
+{
+  EXPECT_EQ(MeshSimplification::kNone, parseMeshSimplification("none"));
+  EXPECT_EQ(MeshSimplification::kDecimate,
+      parseMeshSimplification("decimate"));
+  EXPECT_EQ(MeshSimplification::kConvexHull,
+      parseMeshSimplification("convex_hull"));
+  EXPECT_EQ(MeshSimplification::kConvexDecomposition,
+      parseMeshSimplification("convex_decomposition"));
+  EXPECT_FALSE(parseMeshSimplification("vhacd"));
+
+  MeshSimplificationOptions options;
+  options.method = MeshSimplification::kConvexHull;
+  options.maxTriangles = 200;
+  const auto hull = meshSimplificationVariant(options);
+  options.maxTriangles = 100;
+  EXPECT_NE(hull, meshSimplificationVariant(options));
+  options.method = MeshSimplification::kConvexDecomposition;
+  const auto decomposition = meshSimplificationVariant(options);
+  options.maxHulls = 4;
+  EXPECT_NE(decomposition, meshSimplificationVariant(options));
+}
+
+/////////////////////////////////////////////////
+TEST(MeshSimplificationTest, Decimate)
+{
+  const auto mesh = sphere(32, 64);
+  ASSERT_GT(mesh.triangles.size(), 1000u);
+
+  // Within budget, unchanged
+  auto same = decimate(mesh, mesh.triangles.size());
+  EXPECT_EQ(mesh.triangles.size(), same.triangles.size());
+
+  auto decimated = decimate(mesh, 500);
+  EXPECT_LE(decimated.triangles.size(), 500u);
+  EXPECT_GT(decimated.triangles.size(), 100u);
+  for (const auto &triangle : decimated.triangles)
+  {
+    for (auto vertex : triangle)
+      ASSERT_LT(vertex, decimated.vertices.size());
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(MeshSimplificationTest, ConvexHull)
+{
+  const auto mesh = sphere(16, 32);
+
+  auto hull = convexHull(mesh.vertices, 10000);
+  ASSERT_FALSE(hull.triangles.empty());
+  // Closed surface with 2V - 4 triangles
+  EXPECT_EQ(2 * hull.vertices.size() - 4, hull.triangles.size());
+  expectConvex(hull, mesh.vertices, 1e-9);
+
+  auto small = convexHull(mesh.vertices, 100);
+  ASSERT_FALSE(small.triangles.empty());
+  EXPECT_LE(small.triangles.size(), 100u);
+  expectConvex(small, small.vertices, 1e-9);
+  // The merged hull still encloses the original points
+  expectConvex(small, mesh.vertices, 1e-9);
+
+  // Points on a plane have no hull
+  std::vector<math::Vector3d> flat{
+      {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}, {0.5, 0.5, 0}};
+  EXPECT_TRUE(convexHull(flat, 100).triangles.empty());
+
+  // A cube, with a point inside
+  std::vector<math::Vector3d> cube;
+  for (int i = 0; i < 8; ++i)
+    cube.emplace_back(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+  cube.emplace_back(0.5, 0.5, 0.5);
+  auto cubeHull = convexHull(cube, 100);
+  EXPECT_EQ(8u, cubeHull.vertices.size());
+  EXPECT_EQ(12u, cubeHull.triangles.size());
+  expectConvex(cubeHull, cube, 1e-9);
+}
+
+/////////////////////////////////////////////////
+TEST(MeshSimplificationTest, ConvexDecomposition)
+{
+  // Two spheres, far apart
+  auto mesh = sphere(8, 16);
+  const auto offset = static_cast<unsigned int>(mesh.vertices.size());
+  const auto count = mesh.triangles.size();
+  for (unsigned int i = 0; i < offset; ++i)
+    mesh.vertices.push_back(mesh.vertices[i] + math::Vector3d(10, 0, 0));
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    auto triangle = mesh.triangles[i];
+    for (auto &vertex : triangle)
+      vertex += offset;
+    mesh.triangles.push_back(triangle);
+  }
+
+  auto hulls = convexDecomposition(mesh, 2, 400);
+  ASSERT_EQ(2u, hulls.size());
+  for (const auto &hull : hulls)
+  {
+    EXPECT_LE(hull.triangles.size(), 200u);
+    expectConvex(hull, hull.vertices, 1e-9);
+
+    // Each hull wraps one sphere only
+    math::Vector3d center;
+    for (const auto &vertex : hull.vertices)
+      center += vertex;
+    center /= static_cast<double>(hull.vertices.size());
+    for (const auto &vertex : hull.vertices)
+      EXPECT_LT(vertex.Distance(center), 1.5);
+  }
+
+  EXPECT_LE(convexDecomposition(mesh, 8, 800).size(), 8u);
+  EXPECT_TRUE(convexDecomposition(TriangleMesh(), 8, 800).empty());
+}
+
+/////////////////////////////////////////////////
+TEST(MeshSimplificationTest, SimplifyMesh)
+{
+  const auto soup = sphere(16, 32);
+  common::SubMesh subMesh;
+  subMesh.SetPrimitiveType(common::SubMesh::TRIANGLES);
+  for (const auto &vertex : soup.vertices)
+    subMesh.AddVertex(vertex);
+  for (const auto &triangle : soup.triangles)
+  {
+    for (auto vertex : triangle)
+      subMesh.AddIndex(vertex);
+  }
+  common::Mesh mesh;
+  mesh.AddSubMesh(subMesh);
+
+  auto extracted = triangles(mesh);
+  EXPECT_EQ(soup.vertices.size(), extracted.vertices.size());
+  EXPECT_EQ(soup.triangles.size(), extracted.triangles.size());
+
+  MeshSimplificationOptions options;
+  EXPECT_EQ(nullptr, simplifyMesh(mesh, options));
+
+  options.method = MeshSimplification::kConvexHull;
+  options.maxTriangles = 64;
+  auto hull = simplifyMesh(mesh, options);
+  ASSERT_NE(nullptr, hull);
+  ASSERT_EQ(1u, hull->SubMeshCount());
+  auto hullSubMesh = hull->SubMeshByIndex(0).lock();
+  ASSERT_NE(nullptr, hullSubMesh);
+  EXPECT_EQ(common::SubMesh::TRIANGLES, hullSubMesh->SubMeshPrimitiveType());
+  EXPECT_LE(hullSubMesh->IndexCount(), 3u * 64u);
+
+  options.method = MeshSimplification::kConvexDecomposition;
+  options.maxHulls = 4;
+  options.maxTriangles = 400;
+  auto decomposition = simplifyMesh(mesh, options);
+  ASSERT_NE(nullptr, decomposition);
+  EXPECT_GE(decomposition->SubMeshCount(), 1u);
+  EXPECT_LE(decomposition->SubMeshCount(), 4u);
+
+  // Nothing to simplify
+  EXPECT_EQ(nullptr, simplifyMesh(common::Mesh(), options));
+}
@@ -25,11 +25,13 @@
 #include <algorithm>
 #include <iostream>
 #include <deque>
+#include <functional>
 #include <map>
 #include <set>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <ignition/common/HeightmapData.hh>
@@ -86,6 +88,7 @@
 #include <sdf/World.hh>
 
 #include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/MeshAssets.hh"
 #include "ignition/gazebo/Model.hh"
 #include "ignition/gazebo/Util.hh"
 
@@ -139,9 +142,11 @@
 
 #include "CanonicalLinkModelTracker.hh"
 // Events
+#include "ignition/gazebo/Events.hh"
 #include "ignition/gazebo/physics/Events.hh"
 
 #include "EntityFeatureMap.hh"
+#include "MeshSimplification.hh"
 
 using namespace ignition;
 using namespace ignition::gazebo;
@@ -217,6 +222,16 @@ class ignition::gazebo::systems::PhysicsPrivate
   /// \param[in] _ecm Constant reference to ECM.
   public: void CreateBatteryEntities(const EntityComponentManager &_ecm);
 
+  /// \brief Set the velocities of new links and joints which already have
+  /// velocity components, such as those of a forked world.
+  /// \param[in] _ecm Constant reference to ECM.
+  public: void SetInitialVelocities(const EntityComponentManager &_ecm);
+
+  /// \brief Store the velocities of all links and joints in components, so
+  /// they're part of snapshots of the world.
+  /// \param[in] _ecm Mutable reference to ECM.
+  public: void StoreVelocities(EntityComponentManager &_ecm);
+
   /// \brief Remove physics entities if they are removed from the ECM
   /// \param[in] _ecm Constant reference to ECM.
   public: void RemovePhysicsEntities(const EntityComponentManager &_ecm);
@@ -670,6 +685,9 @@ class ignition::gazebo::systems::PhysicsPrivate
   /// \brief Event manager from simulation runner.
   public: EventManager *eventManager = nullptr;
 
+  /// \brief Connection to the BeforeSnapshot event.
+  public: common::ConnectionPtr beforeSnapshotConn;
+
   /// \brief Keep track of what entities use customized contact surfaces.
   /// Map keys are expected to be world entities so that we keep a set of
   /// entities with customizations per world.
@@ -692,6 +710,10 @@ class ignition::gazebo::systems::PhysicsPrivate
   /// \brief Flag to store whether the names of colliding entities should
   /// be populated in the contact points.
   public: bool contactsEntityNames = true;
+
+  /// \brief How collision meshes are simplified before they're attached to
+  /// links.
+  public: MeshSimplificationOptions collisionMeshOptions;
 };
 
 //////////////////////////////////////////////////
@@ -746,6 +768,41 @@ void Physics::Configure(const Entity &_entity,
       "include_entity_names", true).first;
   }
 
+  // Check if collision meshes should be simplified.
+  auto collisionMeshElement = _sdf->FindElement("collision_mesh");
+  if (collisionMeshElement)
+  {
+    auto &options = this->dataPtr->collisionMeshOptions;
+    auto method = collisionMeshElement->Get<std::string>("simplification",
+        "none").first;
+    auto parsed = parseMeshSimplification(method);
+    if (!parsed)
+    {
+      ignerr << "Unknown collision mesh simplification [" << method
+             << "], meshes won't be simplified." << std::endl;
+    }
+    else
+    {
+      options.method = *parsed;
+    }
+
+    auto maxTriangles = collisionMeshElement->Get<int>("max_triangles",
+        static_cast<int>(options.maxTriangles)).first;
+    auto maxHulls = collisionMeshElement->Get<int>("max_convex_hulls",
+        static_cast<int>(options.maxHulls)).first;
+    if (maxTriangles < 4 || maxHulls < 1)
+    {
+      ignerr << "Collision meshes need at least 4 triangles and 1 convex "
+             << "hull, meshes won't be simplified." << std::endl;
+      options.method = MeshSimplification::kNone;
+    }
+    else
+    {
+      options.maxTriangles = static_cast<std::size_t>(maxTriangles);
+      options.maxHulls = static_cast<std::size_t>(maxHulls);
+    }
+  }
+
   // Find engine shared library
   // Look in:
   // * Paths from environment variable
@@ -828,6 +885,11 @@ void Physics::Configure(const Entity &_entity,
   }
 
   this->dataPtr->eventManager = &_eventMgr;
+
+  this->dataPtr->beforeSnapshotConn =
+      _eventMgr.Connect<events::BeforeSnapshot>(
+      std::bind(&PhysicsPrivate::StoreVelocities, this->dataPtr.get(),
+      std::placeholders::_1));
 }
 
 //////////////////////////////////////////////////
@@ -880,6 +942,7 @@ void PhysicsPrivate::CreatePhysicsEntities(const EntityComponentManager &_ecm)
   this->CreateCollisionEntities(_ecm);
   this->CreateJointEntities(_ecm);
   this->CreateBatteryEntities(_ecm);
+  this->SetInitialVelocities(_ecm);
 }
 
 //////////////////////////////////////////////////
@@ -1226,9 +1289,29 @@ void PhysicsPrivate::CreateCollisionEntities(const EntityComponentManager &_ecm)
             return true;
           }
 
-          auto &meshManager = *ignition::common::MeshManager::Instance();
           auto fullPath = asFullPath(meshSdf->Uri(), meshSdf->FilePath());
-          auto *mesh = meshManager.Load(fullPath);
+
+          // Simplified meshes are read from the cache without decoding the
+          // original mesh when possible
+          const common::Mesh *mesh{nullptr};
+          const auto &simplification = this->collisionMeshOptions;
+          if (simplification.method != MeshSimplification::kNone)
+          {
+            mesh = MeshAssets::Instance().LoadDerived(fullPath,
+                meshSimplificationVariant(simplification),
+                [&simplification](const common::Mesh &_mesh)
+                {
+                  return simplifyMesh(_mesh, simplification);
+                });
+            if (nullptr == mesh)
+            {
+              ignwarn << "Failed to simplify mesh [" << fullPath
+                      << "], using it as is." << std::endl;
+            }
+          }
+
+          if (nullptr == mesh)
+            mesh = MeshAssets::Instance().Load(fullPath);
           if (nullptr == mesh)
           {
             ignwarn << "Failed to load mesh from [" << fullPath
@@ -1652,6 +1735,117 @@ void PhysicsPrivate::CreateBatteryEntities(const EntityComponentManager &_ecm)
       });
 }
 
+//////////////////////////////////////////////////
+void PhysicsPrivate::SetInitialVelocities(const EntityComponentManager &_ecm)
+{
+  // Free groups are set through their root links, the velocities of the
+  // other links follow from the joints
+  _ecm.EachNew<components::Link, components::WorldLinearVelocity,
+               components::WorldAngularVelocity>(
+      [&](const Entity &_entity, const components::Link *,
+          const components::WorldLinearVelocity *_linearVel,
+          const components::WorldAngularVelocity *_angularVel)->bool
+      {
+        if (_linearVel->Data() == math::Vector3d::Zero &&
+            _angularVel->Data() == math::Vector3d::Zero)
+        {
+          return true;
+        }
+
+        auto linkPtrPhys = this->entityLinkMap.Get(_entity);
+        if (nullptr == linkPtrPhys)
+          return true;
+
+        auto freeGroup = linkPtrPhys->FindFreeGroup();
+        if (!freeGroup ||
+            this->entityLinkMap.Get(freeGroup->RootLink()) != _entity)
+        {
+          return true;
+        }
+        this->entityFreeGroupMap.AddEntity(_entity, freeGroup);
+
+        auto worldVelFeature =
+            this->entityFreeGroupMap
+                .EntityCast<WorldVelocityCommandFeatureList>(_entity);
+        if (!worldVelFeature)
+        {
+          static bool informed{false};
+          if (!informed)
+          {
+            igndbg << "Attempting to set initial link velocities, but the "
+                   << "physics engine doesn't support velocity commands. "
+                   << "Velocities won't be set."
+                   << std::endl;
+            informed = true;
+          }
+          return true;
+        }
+
+        worldVelFeature->SetWorldLinearVelocity(
+            math::eigen3::convert(_linearVel->Data()));
+        worldVelFeature->SetWorldAngularVelocity(
+            math::eigen3::convert(_angularVel->Data()));
+        return true;
+      });
+
+  _ecm.EachNew<components::Joint, components::JointVelocity>(
+      [&](const Entity &_entity, const components::Joint *,
+          const components::JointVelocity *_jointVel)->bool
+      {
+        auto jointPhys = this->entityJointMap.Get(_entity);
+        if (nullptr == jointPhys)
+          return true;
+
+        std::size_t nDofs = std::min(
+            _jointVel->Data().size(), jointPhys->GetDegreesOfFreedom());
+        for (std::size_t i = 0; i < nDofs; ++i)
+          jointPhys->SetVelocity(i, _jointVel->Data()[i]);
+        return true;
+      });
+}
+
+//////////////////////////////////////////////////
+void PhysicsPrivate::StoreVelocities(EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("PhysicsPrivate::StoreVelocities");
+
+  // Components are set after going through the entities, since creating
+  // them changes the views being iterated
+  std::vector<std::pair<Entity, physics::FrameData3d>> links;
+  _ecm.Each<components::Link>(
+      [&](const Entity &_entity, const components::Link *)->bool
+      {
+        if (auto linkPhys = this->entityLinkMap.Get(_entity))
+          links.emplace_back(_entity, linkPhys->FrameDataRelativeToWorld());
+        return true;
+      });
+
+  for (const auto &[entity, frameData] : links)
+  {
+    _ecm.SetComponentData<components::WorldLinearVelocity>(entity,
+        math::eigen3::convert(frameData.linearVelocity));
+    _ecm.SetComponentData<components::WorldAngularVelocity>(entity,
+        math::eigen3::convert(frameData.angularVelocity));
+  }
+
+  std::vector<std::pair<Entity, std::vector<double>>> joints;
+  _ecm.Each<components::Joint>(
+      [&](const Entity &_entity, const components::Joint *)->bool
+      {
+        if (auto jointPhys = this->entityJointMap.Get(_entity))
+        {
+          std::vector<double> velocities(jointPhys->GetDegreesOfFreedom());
+          for (std::size_t i = 0; i < velocities.size(); ++i)
+            velocities[i] = jointPhys->GetVelocity(i);
+          joints.emplace_back(_entity, std::move(velocities));
+        }
+        return true;
+      });
+
+  for (const auto &[entity, velocities] : joints)
+    _ecm.SetComponentData<components::JointVelocity>(entity, velocities);
+}
+
 //////////////////////////////////////////////////
 void PhysicsPrivate::RemovePhysicsEntities(const EntityComponentManager &_ecm)
 {
@@ -76,6 +76,29 @@ namespace systems
   ///    </contacts>
   ///  </plugin>
   ///  ```
+  ///
+  /// Collision meshes can be simplified before they're given to the physics
+  /// engine with the optional <collision_mesh> element:
+  /// * <simplification>: One of "none" (default), "decimate", "convex_hull"
+  ///   and "convex_decomposition".
+  /// * <max_triangles>: Maximum number of triangles of each simplified mesh,
+  ///   shared by all hulls of a decomposition. Defaults to 1000.
+  /// * <max_convex_hulls>: Maximum number of hulls of a convex
+  ///   decomposition. Defaults to 8.
+  ///
+  /// Simplified meshes are cached on disk along with decoded meshes, see
+  /// MeshAssets. Usage :
+  /// ```
+  ///  <plugin
+  ///    filename="ignition-gazebo-physics-system"
+  ///    name="ignition::gazebo::systems::Physics">
+  ///    <collision_mesh>
+  ///      <simplification>convex_decomposition</simplification>
+  ///      <max_triangles>2000</max_triangles>
+  ///      <max_convex_hulls>16</max_convex_hulls>
+  ///    </collision_mesh>
+  ///  </plugin>
+  ///  ```
 
   class Physics:
     public System,
@@ -17,14 +17,18 @@
 
 #include "SceneBroadcaster.hh"
 
+#include <ignition/msgs/param.pb.h>
 #include <ignition/msgs/scene.pb.h>
 
 #include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <map>
+#include <sstream>
 #include <string>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Profiler.hh>
 #include <ignition/math/graph/Graph.hh>
@@ -37,6 +41,7 @@
 #include "ignition/gazebo/components/CastShadows.hh"
 #include "ignition/gazebo/components/ContactSensor.hh"
 #include "ignition/gazebo/components/DepthCamera.hh"
+#include "ignition/gazebo/components/Factory.hh"
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/GpuLidar.hh"
 #include "ignition/gazebo/components/Imu.hh"
@@ -61,6 +66,7 @@
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/Conversions.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/Util.hh"
 
 #include <sdf/Camera.hh>
 #include <sdf/Imu.hh>
@@ -75,6 +81,22 @@ using namespace ignition;
 using namespace gazebo;
 using namespace systems;
 
+/// \brief A filtered state request waiting to be served by PostUpdate.
+struct FilteredStateRequest
+{
+  /// \brief Request message.
+  const msgs::Param *req{nullptr};
+
+  /// \brief Response message, filled by PostUpdate.
+  msgs::SerializedStepMap *res{nullptr};
+
+  /// \brief Whether the request has been served.
+  bool done{false};
+
+  /// \brief Whether the request was valid.
+  bool success{false};
+};
+
 // Private data class.
 class ignition::gazebo::systems::SceneBroadcasterPrivate
 {
@@ -105,6 +127,31 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   /// \param[out] _res Response containing the last available full state.
   public: void StateAsyncService(const ignition::msgs::StringMsg &_req);
 
+  /// \brief Callback for filtered state service.
+  /// \param[in] _req Request containing the filter, see SetupTransport.
+  /// \param[out] _res Response containing the state of the requested
+  /// entities only.
+  /// \return True if successful.
+  public: bool FilteredStateService(const ignition::msgs::Param &_req,
+                                    ignition::msgs::SerializedStepMap &_res);
+
+  /// \brief Serve the pending filtered state requests.
+  /// \param[in] _info The update information
+  /// \param[in] _manager The entity component manager
+  public: void ServeFilteredState(const UpdateInfo &_info,
+                                  const EntityComponentManager &_manager);
+
+  /// \brief Fill the response of a filtered state request.
+  /// \param[in] _info The update information
+  /// \param[in] _manager The entity component manager
+  /// \param[in] _req Request containing the filter.
+  /// \param[out] _res Response.
+  /// \return True if the filter is valid.
+  public: bool FilteredState(const UpdateInfo &_info,
+                             const EntityComponentManager &_manager,
+                             const msgs::Param &_req,
+                             msgs::SerializedStepMap &_res) const;
+
   /// \brief Updates the scene graph when entities are added
   /// \param[in] _manager The entity component manager
   public: void SceneGraphAddEntities(const EntityComponentManager &_manager);
@@ -250,6 +297,16 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   /// \brief A list of async state requests
   public: std::unordered_set<std::string> stateRequests;
 
+  /// \brief Protects filteredStateRequests.
+  public: std::mutex filteredStateMutex;
+
+  /// \brief Used to coordinate the filtered state service responses.
+  public: std::condition_variable filteredStateCv;
+
+  /// \brief Filtered state requests waiting for PostUpdate. They're owned
+  /// by the service callbacks.
+  public: std::vector<FilteredStateRequest *> filteredStateRequests;
+
   /// \brief Store SDF scene information so that it can be inserted into
   /// scene message.
   public: sdf::Scene sdfScene;
@@ -337,6 +394,8 @@ void SceneBroadcaster::PostUpdate(const UpdateInfo &_info,
     this->dataPtr->PoseUpdate(_info, _manager);
   }
 
+  this->dataPtr->ServeFilteredState(_info, _manager);
+
   // call SceneGraphRemoveEntities at the end of this update cycle so that
   // removed entities are removed from the scene graph for the next update cycle
   this->dataPtr->SceneGraphRemoveEntities(_manager);
@@ -520,8 +579,7 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
   if (dyPoseConnections)
   {
     // Set the time stamp in the header
-    dyPoseMsg.mutable_header()->mutable_stamp()->CopyFrom(
-        convert<msgs::Time>(_info.simTime));
+    set(dyPoseMsg.mutable_header()->mutable_stamp(), _info.simTime);
 
     this->dyPosePub.Publish(dyPoseMsg);
   }
@@ -529,8 +587,7 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
   // Visuals
   if (poseConnections)
   {
-    poseMsg.mutable_header()->mutable_stamp()->CopyFrom(
-        convert<msgs::Time>(_info.simTime));
+    set(poseMsg.mutable_header()->mutable_stamp(), _info.simTime);
 
     _manager.Each<components::Visual, components::Name, components::Pose>(
       [&](const Entity &_entity, const components::Visual *,
@@ -616,6 +673,22 @@ void SceneBroadcasterPrivate::SetupTransport(const std::string &_worldName)
   ignmsg << "Serving full state (async) on [" << opts.NameSpace() << "/"
          << stateAsyncService << "]" << std::endl;
 
+  // Filtered state service. The request is a msgs::Param with the
+  // following optional parameters:
+  //  * name: Scoped name of the root entity, relative to the world. Defaults
+  //    to the world. All entities matching the name are included.
+  //  * depth: Number of levels of descendants included under the root.
+  //    Defaults to -1, for all descendants.
+  //  * components: Comma separated names of the component types to include.
+  //    Defaults to all components.
+  std::string filteredStateService{"state/filtered"};
+
+  this->node->Advertise(filteredStateService,
+      &SceneBroadcasterPrivate::FilteredStateService, this);
+
+  ignmsg << "Serving filtered state on [" << opts.NameSpace() << "/"
+         << filteredStateService << "]" << std::endl;
+
   // Scene info topic
   std::string sceneTopic{ns + "/scene/info"};
 
@@ -716,6 +789,140 @@ bool SceneBroadcasterPrivate::StateService(
   return success;
 }
 
+//////////////////////////////////////////////////
+bool SceneBroadcasterPrivate::FilteredStateService(
+    const ignition::msgs::Param &_req,
+    ignition::msgs::SerializedStepMap &_res)
+{
+  _res.Clear();
+
+  FilteredStateRequest request;
+  request.req = &_req;
+  request.res = &_res;
+
+  // Wait for an iteration to serve the request
+  std::unique_lock<std::mutex> lock(this->filteredStateMutex);
+  this->filteredStateRequests.push_back(&request);
+  auto served = this->filteredStateCv.wait_for(lock, 5s, [&]
+  {
+    return request.done;
+  });
+
+  if (!served)
+  {
+    // The request lives on this stack, don't leave it behind
+    this->filteredStateRequests.erase(
+        std::remove(this->filteredStateRequests.begin(),
+                    this->filteredStateRequests.end(), &request),
+        this->filteredStateRequests.end());
+    ignerr << "Timed out waiting for filtered state" << std::endl;
+    return false;
+  }
+
+  return request.success;
+}
+
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::ServeFilteredState(const UpdateInfo &_info,
+    const EntityComponentManager &_manager)
+{
+  std::lock_guard<std::mutex> lock(this->filteredStateMutex);
+  if (this->filteredStateRequests.empty())
+    return;
+
+  IGN_PROFILE("SceneBroadcast::ServeFilteredState");
+  for (auto request : this->filteredStateRequests)
+  {
+    request->success =
+        this->FilteredState(_info, _manager, *request->req, *request->res);
+    request->done = true;
+  }
+  this->filteredStateRequests.clear();
+  this->filteredStateCv.notify_all();
+}
+
+//////////////////////////////////////////////////
+bool SceneBroadcasterPrivate::FilteredState(const UpdateInfo &_info,
+    const EntityComponentManager &_manager, const msgs::Param &_req,
+    msgs::SerializedStepMap &_res) const
+{
+  const auto &params = _req.params();
+
+  std::string name;
+  auto it = params.find("name");
+  if (it != params.end())
+    name = it->second.string_value();
+
+  int depth{-1};
+  it = params.find("depth");
+  if (it != params.end())
+    depth = it->second.int_value();
+
+  std::unordered_set<ComponentTypeId> types;
+  it = params.find("components");
+  if (it != params.end() && !it->second.string_value().empty())
+  {
+    auto factory = components::Factory::Instance();
+    const auto typeIds = factory->TypeIds();
+
+    std::stringstream ss(it->second.string_value());
+    std::string typeName;
+    while (std::getline(ss, typeName, ','))
+    {
+      auto typeIt = std::find_if(typeIds.begin(), typeIds.end(),
+          [&](const ComponentTypeId _id)
+          {
+            return factory->Name(_id) == typeName;
+          });
+      if (typeIt == typeIds.end())
+      {
+        ignerr << "Unknown component type [" << typeName
+               << "] in filtered state request." << std::endl;
+        return false;
+      }
+      types.insert(*typeIt);
+    }
+  }
+
+  std::vector<Entity> level;
+  if (name.empty())
+  {
+    level.push_back(this->worldEntity);
+  }
+  else
+  {
+    auto roots = entitiesFromScopedName(name, _manager, this->worldEntity);
+    level.assign(roots.begin(), roots.end());
+  }
+
+  // Walk the entity graph down to the requested depth, so the cost is
+  // proportional to the size of the subtree, not of the world
+  std::unordered_set<Entity> entities(level.begin(), level.end());
+  const auto &graph = _manager.Entities();
+  for (int d = 0; (depth < 0 || d < depth) && !level.empty(); ++d)
+  {
+    std::vector<Entity> next;
+    for (const Entity entity : level)
+    {
+      for (const auto &child : graph.AdjacentsFrom(entity))
+      {
+        if (entities.insert(child.first).second)
+          next.push_back(child.first);
+      }
+    }
+    level = std::move(next);
+  }
+
+  set(_res.mutable_stats(), _info);
+
+  // An empty set would mean all entities
+  if (entities.empty())
+    _res.mutable_state();
+  else
+    _manager.State(*_res.mutable_state(), entities, types, true);
+  return true;
+}
+
 //////////////////////////////////////////////////
 bool SceneBroadcasterPrivate::SceneGraphService(ignition::msgs::StringMsg &_res)
 {
@@ -764,7 +971,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         auto modelMsg = std::make_shared<msgs::Model>();
         modelMsg->set_id(_entity);
         modelMsg->set_name(_nameComp->Data());
-        modelMsg->mutable_pose()->CopyFrom(msgs::Convert(_poseComp->Data()));
+        set(modelMsg->mutable_pose(), _poseComp->Data());
 
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), modelMsg, _entity);
@@ -785,7 +992,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         auto linkMsg = std::make_shared<msgs::Link>();
         linkMsg->set_id(_entity);
         linkMsg->set_name(_nameComp->Data());
-        linkMsg->mutable_pose()->CopyFrom(msgs::Convert(_poseComp->Data()));
+        set(linkMsg->mutable_pose(), _poseComp->Data());
 
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), linkMsg, _entity);
@@ -810,7 +1017,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         visualMsg->set_id(_entity);
         visualMsg->set_parent_id(_parentComp->Data());
         visualMsg->set_name(_nameComp->Data());
-        visualMsg->mutable_pose()->CopyFrom(msgs::Convert(_poseComp->Data()));
+        set(visualMsg->mutable_pose(), _poseComp->Data());
         visualMsg->set_cast_shadows(_castShadowsComp->Data());
 
         // Geometry is optional
@@ -850,7 +1057,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         lightMsg->set_id(_entity);
         lightMsg->set_parent_id(_parentComp->Data());
         lightMsg->set_name(_nameComp->Data());
-        lightMsg->mutable_pose()->CopyFrom(msgs::Convert(_poseComp->Data()));
+        set(lightMsg->mutable_pose(), _poseComp->Data());
 
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), lightMsg, _entity);
@@ -871,7 +1078,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         sensorMsg->set_id(_entity);
         sensorMsg->set_parent_id(_parentComp->Data());
         sensorMsg->set_name(_nameComp->Data());
-        sensorMsg->mutable_pose()->CopyFrom(msgs::Convert(_poseComp->Data()));
+        set(sensorMsg->mutable_pose(), _poseComp->Data());
 
         auto altimeterComp = _manager.Component<components::Altimeter>(_entity);
         if (altimeterComp)
@@ -1054,7 +1261,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
         auto emitterMsg = std::make_shared<msgs::ParticleEmitter>();
         emitterMsg->CopyFrom(_emitterComp->Data());
         emitterMsg->set_id(_entity);
-        emitterMsg->mutable_pose()->CopyFrom(msgs::Convert(_poseComp->Data()));
+        set(emitterMsg->mutable_pose(), _poseComp->Data());
 
         // Add to graph
         newGraph.AddVertex(emitterMsg->name(), emitterMsg, _entity);
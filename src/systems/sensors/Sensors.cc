@@ -57,6 +57,7 @@
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/Events.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/ThreadRegistry.hh"
 
 #include "ignition/gazebo/rendering/Events.hh"
 #include "ignition/gazebo/rendering/RenderUtil.hh"
@@ -374,6 +375,8 @@ void SensorsPrivate::RunOnce()
 void SensorsPrivate::RenderThread()
 {
   IGN_PROFILE_THREAD_NAME("RenderThread");
+  ScopedThreadRegistration registration(ThreadClass::kRendering,
+      "sensors_render");
 
   igndbg << "SensorsPrivate::RenderThread started" << std::endl;
 
@@ -0,0 +1,770 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ThresholdWatch.hh"
+
+#include <ignition/msgs/param_v.pb.h>
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/Matrix3.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/plugin/Register.hh>
+
+#include "ignition/gazebo/components/AngularVelocity.hh"
+#include "ignition/gazebo/components/CanonicalLink.hh"
+#include "ignition/gazebo/components/Inertial.hh"
+#include "ignition/gazebo/components/LinearVelocity.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/Conversions.hh"
+#include "ignition/gazebo/Link.hh"
+#include "ignition/gazebo/MessageBus.hh"
+#include "ignition/gazebo/Model.hh"
+#include "ignition/gazebo/Util.hh"
+#include "ignition/gazebo/World.hh"
+
+#include "../../ParamUtil.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Quantities a watch can be evaluated on.
+enum class WatchType
+{
+  /// \brief Kinetic energy of the link.
+  KINETIC_ENERGY,
+
+  /// \brief Kinetic energy lost during the last step.
+  KINETIC_ENERGY_LOSS,
+
+  /// \brief Linear speed of the link origin.
+  SPEED,
+
+  /// \brief Distance of the link origin outside of a box.
+  POSITION
+};
+
+/// \brief Flags of the link state a watch needs.
+enum LinkNeeds : unsigned char
+{
+  /// \brief World pose, which is always read.
+  kNeedsPose = 0,
+
+  /// \brief World linear and angular velocities.
+  kNeedsVelocity = 1,
+
+  /// \brief Kinetic energy, which needs velocities.
+  kNeedsEnergy = 2 | kNeedsVelocity
+};
+
+/// \brief One `<watch>` element and the state of the links it watches.
+class Watch
+{
+  /// \brief Whether a model is watched by this watch.
+  /// \param[in] _name Model name.
+  /// \return True if one of the patterns matches.
+  public: bool Matches(const std::string &_name) const;
+
+  /// \brief Name of the watch.
+  public: std::string name;
+
+  /// \brief Watched quantity.
+  public: WatchType type{WatchType::SPEED};
+
+  /// \brief Model name patterns. Patterns ending with `*` are prefixes.
+  public: std::vector<std::string> patterns;
+
+  /// \brief Name of the watched link. Empty for the canonical link.
+  public: std::string linkName;
+
+  /// \brief Value above which a link is triggered.
+  public: double threshold{0.0};
+
+  /// \brief Margin below the threshold at which a triggered link stops
+  /// being triggered.
+  public: double hysteresis{0.0};
+
+  /// \brief Minimum corner of the box of position watches.
+  public: math::Vector3d min;
+
+  /// \brief Maximum corner of the box of position watches.
+  public: math::Vector3d max;
+
+  /// \brief Publisher of transitions.
+  public: MessageBus::Publisher pub;
+
+  // Row table, indexed by watched link.
+
+  /// \brief Index of the link in the link table.
+  public: std::vector<std::size_t> rows;
+
+  /// \brief Last evaluated values.
+  public: std::vector<double> values;
+
+  /// \brief Whether the link is triggered.
+  public: std::vector<char> triggered;
+};
+
+class ignition::gazebo::systems::ThresholdWatchPrivate
+{
+  /// \brief Add a watch described by a `<watch>` element.
+  /// \param[in] _sdf The `<watch>` element.
+  /// \param[in] _worldName Name of the world, for the default topic.
+  /// \return True if the watch was added.
+  public: bool AddWatch(const sdf::ElementPtr &_sdf,
+                        const std::string &_worldName);
+
+  /// \brief Add the links of a model to the watches that match it.
+  /// \param[in] _ecm The EntityComponentManager.
+  /// \param[in] _model Model entity.
+  /// \param[in] _name Model name.
+  public: void AddModel(EntityComponentManager &_ecm, const Entity _model,
+                        const std::string &_name);
+
+  /// \brief Get the row of a link in the link table, adding it if needed.
+  /// \param[in] _ecm The EntityComponentManager.
+  /// \param[in] _link Link entity.
+  /// \param[in] _model Model entity.
+  /// \param[in] _modelName Model name.
+  /// \param[in] _needs State needed by the watch, see LinkNeeds.
+  /// \return Row in the link table.
+  public: std::size_t LinkRow(EntityComponentManager &_ecm,
+                              const Entity _link, const Entity _model,
+                              const std::string &_modelName,
+                              unsigned char _needs);
+
+  /// \brief Remove the links of removed models from all tables.
+  /// \param[in] _models Removed models.
+  public: void RemoveModels(const std::unordered_set<Entity> &_models);
+
+  /// \brief Read the state of all watched links.
+  /// \param[in] _ecm The EntityComponentManager.
+  public: void ReadLinks(const EntityComponentManager &_ecm);
+
+  /// \brief Evaluate all watches and publish their transitions.
+  /// \param[in] _info System update information.
+  public: void Evaluate(const UpdateInfo &_info);
+
+  /// \brief World's message bus.
+  public: std::shared_ptr<MessageBus> bus;
+
+  /// \brief All watches.
+  public: std::vector<Watch> watches;
+
+  /// \brief Whether existing models have been added.
+  public: bool initialized{false};
+
+  /// \brief Row of each link in the link table.
+  public: std::unordered_map<Entity, std::size_t> linkRows;
+
+  // Link table, indexed by link row. Links watched by more than one watch
+  // are read once.
+
+  /// \brief Link entities.
+  public: std::vector<Entity> links;
+
+  /// \brief Model entities.
+  public: std::vector<Entity> models;
+
+  /// \brief Model names.
+  public: std::vector<std::string> modelNames;
+
+  /// \brief Link names.
+  public: std::vector<std::string> linkNames;
+
+  /// \brief State needed by the watches of each link, see LinkNeeds.
+  public: std::vector<unsigned char> needs;
+
+  /// \brief Whether the state of the link could be read this step.
+  public: std::vector<char> valid;
+
+  /// \brief Link mass.
+  public: std::vector<double> mass;
+
+  /// \brief Pose of the center of mass in the link frame.
+  public: std::vector<math::Pose3d> inertialPose;
+
+  /// \brief Moments of inertia about the center of mass, in the inertial
+  /// frame.
+  public: std::vector<math::Matrix3d> moi;
+
+  /// \brief World positions.
+  public: std::vector<math::Vector3d> position;
+
+  /// \brief World orientations.
+  public: std::vector<math::Quaterniond> rotation;
+
+  /// \brief World linear velocities.
+  public: std::vector<math::Vector3d> linVel;
+
+  /// \brief World angular velocities.
+  public: std::vector<math::Vector3d> angVel;
+
+  /// \brief Linear speeds.
+  public: std::vector<double> speed;
+
+  /// \brief Kinetic energies.
+  public: std::vector<double> energy;
+
+  /// \brief Kinetic energies lost during the last step.
+  public: std::vector<double> energyLoss;
+};
+
+//////////////////////////////////////////////////
+/// \brief Remove the elements of a table column whose row was dropped.
+/// \param[in, out] _column Column to compact.
+/// \param[in] _keep Whether each row is kept.
+template<typename T>
+static void compact(std::vector<T> &_column, const std::vector<char> &_keep)
+{
+  std::size_t next{0};
+  for (std::size_t i = 0; i < _column.size(); ++i)
+  {
+    if (_keep[i])
+      _column[next++] = std::move(_column[i]);
+  }
+  _column.resize(next);
+}
+
+//////////////////////////////////////////////////
+bool Watch::Matches(const std::string &_name) const
+{
+  for (const auto &pattern : this->patterns)
+  {
+    if (!pattern.empty() && pattern.back() == '*')
+    {
+      if (_name.compare(0, pattern.size() - 1, pattern, 0,
+            pattern.size() - 1) == 0)
+      {
+        return true;
+      }
+    }
+    else if (_name == pattern)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////
+bool ThresholdWatchPrivate::AddWatch(const sdf::ElementPtr &_sdf,
+    const std::string &_worldName)
+{
+  Watch watch;
+  watch.name = _sdf->Get<std::string>("name", "").first;
+  if (watch.name.empty())
+  {
+    ignerr << "<watch> element missing name attribute." << std::endl;
+    return false;
+  }
+
+  const auto type = _sdf->Get<std::string>("type", "").first;
+  if (type == "kinetic_energy")
+  {
+    watch.type = WatchType::KINETIC_ENERGY;
+  }
+  else if (type == "kinetic_energy_loss")
+  {
+    watch.type = WatchType::KINETIC_ENERGY_LOSS;
+  }
+  else if (type == "speed")
+  {
+    watch.type = WatchType::SPEED;
+  }
+  else if (type == "position")
+  {
+    watch.type = WatchType::POSITION;
+  }
+  else
+  {
+    ignerr << "Unknown type [" << type << "] for watch [" << watch.name
+           << "]. Supported types are [kinetic_energy], "
+           << "[kinetic_energy_loss], [speed] and [position]." << std::endl;
+    return false;
+  }
+
+  for (auto elem = _sdf->FindElement("model"); elem;
+       elem = elem->GetNextElement("model"))
+  {
+    watch.patterns.push_back(elem->Get<std::string>());
+  }
+  if (watch.patterns.empty())
+  {
+    ignerr << "Missing <model> for watch [" << watch.name << "]."
+           << std::endl;
+    return false;
+  }
+
+  watch.linkName = _sdf->Get<std::string>("link", "").first;
+
+  if (watch.type == WatchType::POSITION)
+  {
+    if (!_sdf->HasElement("min") || !_sdf->HasElement("max"))
+    {
+      ignerr << "Missing <min> or <max> for position watch [" << watch.name
+             << "]." << std::endl;
+      return false;
+    }
+    watch.min = _sdf->Get<math::Vector3d>("min");
+    watch.max = _sdf->Get<math::Vector3d>("max");
+    watch.threshold = _sdf->Get<double>("threshold", 0.0).first;
+  }
+  else
+  {
+    if (!_sdf->HasElement("threshold"))
+    {
+      ignerr << "Missing <threshold> for watch [" << watch.name << "]."
+             << std::endl;
+      return false;
+    }
+    watch.threshold = _sdf->Get<double>("threshold");
+  }
+
+  watch.hysteresis = _sdf->Get<double>("hysteresis", 0.0).first;
+  if (watch.hysteresis < 0)
+  {
+    ignerr << "<hysteresis> of watch [" << watch.name
+           << "] must not be negative." << std::endl;
+    return false;
+  }
+
+  std::vector<std::string> topics;
+  if (_sdf->HasElement("topic"))
+    topics.push_back(_sdf->Get<std::string>("topic"));
+  topics.push_back("/world/" + _worldName + "/watch/" + watch.name);
+  const auto topic = validTopic(topics);
+
+  watch.pub = this->bus->Advertise<msgs::Param_V>(topic);
+  if (!watch.pub)
+  {
+    ignerr << "Failed to advertise [" << topic << "] for watch ["
+           << watch.name << "]." << std::endl;
+    return false;
+  }
+
+  igndbg << "ThresholdWatch added [" << type << "] watch [" << watch.name
+         << "] publishing on [" << topic << "]" << std::endl;
+
+  this->watches.push_back(std::move(watch));
+  return true;
+}
+
+//////////////////////////////////////////////////
+void ThresholdWatchPrivate::AddModel(EntityComponentManager &_ecm,
+    const Entity _model, const std::string &_name)
+{
+  for (auto &watch : this->watches)
+  {
+    if (!watch.Matches(_name))
+      continue;
+
+    Entity link{kNullEntity};
+    if (watch.linkName.empty())
+    {
+      auto canonical = _ecm.ChildrenByComponents(_model,
+          components::CanonicalLink());
+      if (!canonical.empty())
+        link = canonical.front();
+    }
+    else
+    {
+      link = Model(_model).LinkByName(_ecm, watch.linkName);
+    }
+
+    if (link == kNullEntity)
+    {
+      // Wildcards are expected to match models without the link
+      igndbg << "Model [" << _name << "] has no link to watch for ["
+             << watch.name << "]." << std::endl;
+      continue;
+    }
+
+    unsigned char linkNeeds{kNeedsPose};
+    if (watch.type == WatchType::SPEED)
+      linkNeeds = kNeedsVelocity;
+    else if (watch.type == WatchType::KINETIC_ENERGY ||
+             watch.type == WatchType::KINETIC_ENERGY_LOSS)
+      linkNeeds = kNeedsEnergy;
+
+    watch.rows.push_back(
+        this->LinkRow(_ecm, link, _model, _name, linkNeeds));
+    watch.values.push_back(std::numeric_limits<double>::quiet_NaN());
+    watch.triggered.push_back(false);
+  }
+}
+
+//////////////////////////////////////////////////
+std::size_t ThresholdWatchPrivate::LinkRow(EntityComponentManager &_ecm,
+    const Entity _link, const Entity _model, const std::string &_modelName,
+    unsigned char _needs)
+{
+  std::size_t row;
+  auto it = this->linkRows.find(_link);
+  if (it != this->linkRows.end())
+  {
+    row = it->second;
+  }
+  else
+  {
+    row = this->links.size();
+    this->linkRows[_link] = row;
+    this->links.push_back(_link);
+    this->models.push_back(_model);
+    this->modelNames.push_back(_modelName);
+    this->linkNames.push_back(Link(_link).Name(_ecm).value_or(""));
+    this->needs.push_back(kNeedsPose);
+    this->valid.push_back(false);
+    this->mass.push_back(0.0);
+    this->inertialPose.push_back(math::Pose3d::Zero);
+    this->moi.push_back(math::Matrix3d::Zero);
+    this->position.push_back(math::Vector3d::Zero);
+    this->rotation.push_back(math::Quaterniond::Identity);
+    this->linVel.push_back(math::Vector3d::Zero);
+    this->angVel.push_back(math::Vector3d::Zero);
+    this->speed.push_back(0.0);
+    this->energy.push_back(0.0);
+    this->energyLoss.push_back(0.0);
+
+    enableComponent<components::WorldPose>(_ecm, _link, true);
+  }
+
+  if ((_needs & kNeedsVelocity) && !(this->needs[row] & kNeedsVelocity))
+    Link(_link).EnableVelocityChecks(_ecm, true);
+
+  if ((_needs & kNeedsEnergy) == kNeedsEnergy &&
+      (this->needs[row] & kNeedsEnergy) != kNeedsEnergy)
+  {
+    // Create a default inertia in case the link doesn't have it. Inertia
+    // is assumed to be constant, so it's read once.
+    enableComponent<components::Inertial>(_ecm, _link, true);
+    const auto &inertial = _ecm.Component<components::Inertial>(_link)->Data();
+    this->mass[row] = inertial.MassMatrix().Mass();
+    this->inertialPose[row] = inertial.Pose();
+    this->moi[row] = inertial.MassMatrix().Moi();
+  }
+
+  this->needs[row] |= _needs;
+  return row;
+}
+
+//////////////////////////////////////////////////
+void ThresholdWatchPrivate::RemoveModels(
+    const std::unordered_set<Entity> &_models)
+{
+  const std::size_t count = this->links.size();
+  std::vector<char> keep(count);
+  std::vector<std::size_t> newRows(count);
+  std::size_t next{0};
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    keep[i] = _models.find(this->models[i]) == _models.end();
+    newRows[i] = next;
+    if (keep[i])
+      ++next;
+  }
+  if (next == count)
+    return;
+
+  for (auto &watch : this->watches)
+  {
+    std::vector<char> keepRow(watch.rows.size());
+    for (std::size_t r = 0; r < watch.rows.size(); ++r)
+    {
+      keepRow[r] = keep[watch.rows[r]];
+      watch.rows[r] = newRows[watch.rows[r]];
+    }
+    compact(watch.rows, keepRow);
+    compact(watch.values, keepRow);
+    compact(watch.triggered, keepRow);
+  }
+
+  compact(this->links, keep);
+  compact(this->models, keep);
+  compact(this->modelNames, keep);
+  compact(this->linkNames, keep);
+  compact(this->needs, keep);
+  compact(this->valid, keep);
+  compact(this->mass, keep);
+  compact(this->inertialPose, keep);
+  compact(this->moi, keep);
+  compact(this->position, keep);
+  compact(this->rotation, keep);
+  compact(this->linVel, keep);
+  compact(this->angVel, keep);
+  compact(this->speed, keep);
+  compact(this->energy, keep);
+  compact(this->energyLoss, keep);
+
+  this->linkRows.clear();
+  for (std::size_t i = 0; i < this->links.size(); ++i)
+    this->linkRows[this->links[i]] = i;
+}
+
+//////////////////////////////////////////////////
+void ThresholdWatchPrivate::ReadLinks(const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("ThresholdWatch::ReadLinks");
+
+  const std::size_t count = this->links.size();
+
+  // Gather the state of all links into the table
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const Entity link = this->links[i];
+    auto worldPose = _ecm.Component<components::WorldPose>(link);
+    if (!worldPose)
+    {
+      this->valid[i] = false;
+      continue;
+    }
+    this->position[i] = worldPose->Data().Pos();
+    this->rotation[i] = worldPose->Data().Rot();
+    this->valid[i] = true;
+
+    if (!(this->needs[i] & kNeedsVelocity))
+      continue;
+
+    auto worldLinVel = _ecm.Component<components::WorldLinearVelocity>(link);
+    auto worldAngVel = _ecm.Component<components::WorldAngularVelocity>(link);
+    if (!worldLinVel || !worldAngVel)
+    {
+      this->valid[i] = false;
+      continue;
+    }
+    this->linVel[i] = worldLinVel->Data();
+    this->angVel[i] = worldAngVel->Data();
+  }
+
+  // Derived quantities, same as Link::WorldKineticEnergy but using the
+  // cached inertia
+  for (std::size_t i = 0; i < count; ++i)
+    this->speed[i] = this->linVel[i].Length();
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if ((this->needs[i] & kNeedsEnergy) != kNeedsEnergy || !this->valid[i])
+      continue;
+
+    const auto &com = this->inertialPose[i];
+    const math::Vector3d comVel = this->linVel[i] +
+        this->angVel[i].Cross(this->rotation[i].RotateVector(com.Pos()));
+
+    // Angular velocity in the inertial frame, so the inertia doesn't need to
+    // be rotated to the world frame
+    const math::Vector3d w =
+        (this->rotation[i] * com.Rot()).RotateVectorReverse(this->angVel[i]);
+
+    const double current = 0.5 * (this->mass[i] * comVel.SquaredLength() +
+        w.Dot(this->moi[i] * w));
+    this->energyLoss[i] = this->energy[i] - current;
+    this->energy[i] = current;
+  }
+}
+
+//////////////////////////////////////////////////
+void ThresholdWatchPrivate::Evaluate(const UpdateInfo &_info)
+{
+  IGN_PROFILE("ThresholdWatch::Evaluate");
+
+  for (auto &watch : this->watches)
+  {
+    const std::size_t count = watch.rows.size();
+
+    // Reduce the predicate to a scalar value per link
+    switch (watch.type)
+    {
+      case WatchType::KINETIC_ENERGY:
+        for (std::size_t r = 0; r < count; ++r)
+          watch.values[r] = this->energy[watch.rows[r]];
+        break;
+      case WatchType::KINETIC_ENERGY_LOSS:
+        for (std::size_t r = 0; r < count; ++r)
+          watch.values[r] = this->energyLoss[watch.rows[r]];
+        break;
+      case WatchType::SPEED:
+        for (std::size_t r = 0; r < count; ++r)
+          watch.values[r] = this->speed[watch.rows[r]];
+        break;
+      case WatchType::POSITION:
+        for (std::size_t r = 0; r < count; ++r)
+        {
+          const auto &pos = this->position[watch.rows[r]];
+          watch.values[r] = std::max({
+              watch.min.X() - pos.X(), pos.X() - watch.max.X(),
+              watch.min.Y() - pos.Y(), pos.Y() - watch.max.Y(),
+              watch.min.Z() - pos.Z(), pos.Z() - watch.max.Z()});
+        }
+        break;
+    }
+
+    // Only build a message if someone listens, but keep track of the
+    // transitions anyway
+    const bool publish = watch.pub.HasConnections();
+    std::shared_ptr<msgs::Param_V> msg;
+
+    for (std::size_t r = 0; r < count; ++r)
+    {
+      const std::size_t row = watch.rows[r];
+      if (!this->valid[row])
+        continue;
+
+      const double limit =
+          watch.threshold - (watch.triggered[r] ? watch.hysteresis : 0.0);
+      const bool triggered = watch.values[r] > limit;
+      if (triggered == static_cast<bool>(watch.triggered[r]))
+        continue;
+      watch.triggered[r] = triggered;
+
+      if (!publish)
+        continue;
+
+      if (!msg)
+      {
+        msg = std::make_shared<msgs::Param_V>();
+        set(msg->mutable_header()->mutable_stamp(), _info.simTime);
+      }
+      auto param = msg->add_param();
+      setParam(*param, "watch", watch.name);
+      setParam(*param, "model", this->modelNames[row]);
+      setParam(*param, "link", this->linkNames[row]);
+      setParam(*param, "value", watch.values[r]);
+      setParam(*param, "triggered", triggered);
+    }
+
+    if (msg)
+      watch.pub.Publish(msg);
+  }
+}
+
+//////////////////////////////////////////////////
+ThresholdWatch::ThresholdWatch()
+  : dataPtr(std::make_unique<ThresholdWatchPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+void ThresholdWatch::Configure(const Entity &_entity,
+    const std::shared_ptr<const sdf::Element> &_sdf,
+    EntityComponentManager &_ecm,
+    EventManager &_eventMgr)
+{
+  World world(_entity);
+  if (!world.Valid(_ecm))
+  {
+    ignerr << "ThresholdWatch system should be attached to a world entity. "
+           << "Failed to initialize." << std::endl;
+    return;
+  }
+
+  this->dataPtr->bus = MessageBus::Instance(_eventMgr);
+
+  const auto worldName = world.Name(_ecm).value_or("");
+  auto sdfClone = _sdf->Clone();
+  for (auto watchElem = sdfClone->FindElement("watch"); watchElem;
+       watchElem = watchElem->GetNextElement("watch"))
+  {
+    this->dataPtr->AddWatch(watchElem, worldName);
+  }
+
+  if (this->dataPtr->watches.empty())
+  {
+    ignerr << "ThresholdWatch has no valid <watch> elements, system is "
+           << "disabled." << std::endl;
+    return;
+  }
+
+  ignmsg << "ThresholdWatch evaluating [" << this->dataPtr->watches.size()
+         << "] watches." << std::endl;
+}
+
+//////////////////////////////////////////////////
+void ThresholdWatch::PreUpdate(const ignition::gazebo::UpdateInfo &,
+    ignition::gazebo::EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("ThresholdWatch::PreUpdate");
+
+  if (this->dataPtr->watches.empty())
+    return;
+
+  std::unordered_set<Entity> removed;
+  _ecm.EachRemoved<components::Model>(
+      [&](const Entity &_entity, const components::Model *) -> bool
+      {
+        removed.insert(_entity);
+        return true;
+      });
+  if (!removed.empty())
+    this->dataPtr->RemoveModels(removed);
+
+  // Collect the models first, adding links creates components
+  std::vector<std::pair<Entity, std::string>> added;
+  auto collect = [&](const Entity &_entity, const components::Model *,
+      const components::Name *_name) -> bool
+  {
+    added.emplace_back(_entity, _name->Data());
+    return true;
+  };
+
+  if (!this->dataPtr->initialized)
+  {
+    _ecm.Each<components::Model, components::Name>(collect);
+    this->dataPtr->initialized = true;
+  }
+  else
+  {
+    _ecm.EachNew<components::Model, components::Name>(collect);
+  }
+
+  for (const auto &[model, name] : added)
+    this->dataPtr->AddModel(_ecm, model, name);
+}
+
+//////////////////////////////////////////////////
+void ThresholdWatch::PostUpdate(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("ThresholdWatch::PostUpdate");
+  // Nothing left to do if paused.
+  if (_info.paused || this->dataPtr->links.empty())
+    return;
+
+  this->dataPtr->ReadLinks(_ecm);
+  this->dataPtr->Evaluate(_info);
+}
+
+IGNITION_ADD_PLUGIN(ThresholdWatch,
+                    ignition::gazebo::System,
+                    ThresholdWatch::ISystemConfigure,
+                    ThresholdWatch::ISystemPreUpdate,
+                    ThresholdWatch::ISystemPostUpdate)
+
+IGNITION_ADD_PLUGIN_ALIAS(ThresholdWatch,
+                          "ignition::gazebo::systems::ThresholdWatch")
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_THRESHOLDWATCH_HH_
+#define IGNITION_GAZEBO_SYSTEMS_THRESHOLDWATCH_HH_
+
+#include <memory>
+
+#include <ignition/gazebo/System.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  // Forward declaration
+  class ThresholdWatchPrivate;
+
+  /// \brief Watches a quantity of many links and publishes when it crosses
+  /// a threshold. It generalizes the KineticEnergyMonitor system: instead of
+  /// one plugin instance per link, a single instance attached to the world
+  /// evaluates any number of watches over any number of models, reading the
+  /// state of all watched links once per step into contiguous tables.
+  ///
+  /// Each watch reduces its predicate to a scalar value per link, and the
+  /// link is triggered while the value is above the watch's threshold.
+  /// Messages are only published on transitions, i.e. when a link becomes
+  /// triggered or stops being triggered, so a watch over thousands of
+  /// quiet entities costs no messages.
+  ///
+  /// Transitions of each step are published as a single `msgs::Param_V`
+  /// on the watch's topic, through the world's MessageBus, so other systems
+  /// can subscribe to them without going through ign-transport. Each
+  /// `msgs::Param` has the following parameters:
+  ///
+  ///   * `watch`: Name of the watch.
+  ///   * `model`: Name of the model.
+  ///   * `link`: Name of the watched link.
+  ///   * `value`: Value of the watched quantity.
+  ///   * `triggered`: True if the link became triggered, false if it
+  ///     stopped being triggered.
+  ///
+  /// # System Parameters
+  ///
+  /// `<watch>`: Declares one watch. This element can appear multiple times.
+  /// It accepts the following attributes and child elements:
+  ///
+  ///   * `name` attribute: Name of the watch. Required.
+  ///
+  ///   * `type` attribute: Watched quantity, required. One of:
+  ///     * `kinetic_energy`: Kinetic energy of the link, in Joule.
+  ///     * `kinetic_energy_loss`: Kinetic energy lost by the link during the
+  ///       last step, in Joule. This is what KineticEnergyMonitor watches.
+  ///     * `speed`: Linear speed of the link origin, in m/s.
+  ///     * `position`: How far the link origin is outside the box defined by
+  ///       `<min>` and `<max>`, in meters, along the axis where it's the
+  ///       farthest. It's zero or negative inside the box, so with the
+  ///       default threshold a link is triggered while it's outside the box,
+  ///       which makes a geofence.
+  ///
+  ///   * `<model>`: Name of a watched model. A name ending with `*` matches
+  ///     all models whose name starts with what comes before it, so `*`
+  ///     alone matches all models. This element can appear multiple times,
+  ///     and must appear at least once. Models spawned later are watched
+  ///     too.
+  ///
+  ///   * `<link>`: Name of the watched link of each model. Defaults to the
+  ///     canonical link.
+  ///
+  ///   * `<threshold>`: Threshold the value must exceed to trigger. Required
+  ///     for all types except `position`, where it defaults to 0.
+  ///
+  ///   * `<hysteresis>`: A triggered link stops being triggered when its
+  ///     value goes below the threshold minus this. Defaults to 0.
+  ///
+  ///   * `<min>`/`<max>`: Corners of the box of a `position` watch, in world
+  ///     coordinates. Required for `position` watches.
+  ///
+  ///   * `<topic>`: Topic on which transitions are published. Defaults to
+  ///     `/world/{world_name}/watch/{watch_name}`.
+  ///
+  /// # Example
+  ///
+  /// ```
+  /// <plugin filename="ignition-gazebo-threshold-watch-system"
+  ///         name="ignition::gazebo::systems::ThresholdWatch">
+  ///   <watch name="impacts" type="kinetic_energy_loss">
+  ///     <model>box_*</model>
+  ///     <threshold>7</threshold>
+  ///   </watch>
+  ///   <watch name="speeding" type="speed">
+  ///     <model>robot_*</model>
+  ///     <link>chassis</link>
+  ///     <threshold>2.0</threshold>
+  ///     <hysteresis>0.2</hysteresis>
+  ///   </watch>
+  ///   <watch name="geofence" type="position">
+  ///     <model>*</model>
+  ///     <min>-50 -50 -1</min>
+  ///     <max>50 50 10</max>
+  ///   </watch>
+  /// </plugin>
+  /// ```
+  class ThresholdWatch
+      : public System,
+        public ISystemConfigure,
+        public ISystemPreUpdate,
+        public ISystemPostUpdate
+  {
+    /// \brief Constructor
+    public: ThresholdWatch();
+
+    /// \brief Destructor
+    public: ~ThresholdWatch() override = default;
+
+    // Documentation inherited
+    public: void Configure(const Entity &_entity,
+                           const std::shared_ptr<const sdf::Element> &_sdf,
+                           EntityComponentManager &_ecm,
+                           EventManager &_eventMgr) override;
+
+    // Documentation inherited
+    public: void PreUpdate(
+                const ignition::gazebo::UpdateInfo &_info,
+                ignition::gazebo::EntityComponentManager &_ecm) override;
+
+    // Documentation inherited
+    public: void PostUpdate(
+                const UpdateInfo &_info,
+                const EntityComponentManager &_ecm) override;
+
+    /// \brief Private data pointer
+    private: std::unique_ptr<ThresholdWatchPrivate> dataPtr;
+  };
+  }
+}
+}
+}
+
+#endif
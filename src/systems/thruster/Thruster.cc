@@ -15,7 +15,6 @@
  *
  */
 #include <memory>
-#include <mutex>
 #include <string>
 
 #include <ignition/msgs/double.pb.h>
@@ -35,6 +34,7 @@
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/Link.hh"
+#include "ignition/gazebo/MessageBus.hh"
 #include "ignition/gazebo/Model.hh"
 #include "ignition/gazebo/Util.hh"
 
@@ -46,9 +46,6 @@ using namespace systems;
 
 class ignition::gazebo::systems::ThrusterPrivateData
 {
-  /// \brief Mutex for read/write access to class
-  public: std::mutex mtx;
-
   /// \brief Thrust output by propeller in N
   public: double thrust = 0.0;
 
@@ -75,8 +72,8 @@ class ignition::gazebo::systems::ThrusterPrivateData
   /// \brief Propeller koint entity
   public: ignition::gazebo::Entity jointEntity;
 
-  /// \brief ignition node for handling transport
-  public: ignition::transport::Node node;
+  /// \brief Message bus on which commands are received
+  public: std::shared_ptr<MessageBus> bus;
 
   /// \brief The PID which controls the propeller. This isn't used if
   /// velocityControl is true.
@@ -130,10 +127,11 @@ void Thruster::Configure(
   const Entity &_entity,
   const std::shared_ptr<const sdf::Element> &_sdf,
   EntityComponentManager &_ecm,
-  EventManager &/*_eventMgr*/)
+  EventManager &_eventMgr)
 {
   // Create model object, to access convenient functions
   this->dataPtr->modelEntity = _entity;
+  this->dataPtr->bus = MessageBus::Instance(_eventMgr);
   auto model = Model(_entity);
   auto modelName = model.Name(_ecm);
 
@@ -191,7 +189,7 @@ void Thruster::Configure(
   std::string thrusterTopicOld = ignition::transport::TopicUtils::AsValidTopic(
     "/model/" + ns + "/joint/" + jointName + "/cmd_pos");
 
-  this->dataPtr->node.Subscribe(
+  this->dataPtr->bus->Subscribe(
     thrusterTopicOld,
     &ThrusterPrivateData::OnCmdThrust,
     this->dataPtr.get());
@@ -200,7 +198,7 @@ void Thruster::Configure(
   std::string thrusterTopic = ignition::transport::TopicUtils::AsValidTopic(
     "/model/" + ns + "/joint/" + jointName + "/cmd_thrust");
 
-  this->dataPtr->node.Subscribe(
+  this->dataPtr->bus->Subscribe(
     thrusterTopic,
     &ThrusterPrivateData::OnCmdThrust,
     this->dataPtr.get());
@@ -292,7 +290,6 @@ void Thruster::Configure(
 /////////////////////////////////////////////////
 void ThrusterPrivateData::OnCmdThrust(const msgs::Double &_msg)
 {
-  std::lock_guard<std::mutex> lock(mtx);
   this->thrust = math::clamp(math::fixnan(_msg.data()),
     this->cmdMin, this->cmdMax);
 
@@ -362,13 +359,8 @@ void Thruster::PreUpdate(
   auto unitVector =
       jointWorldPose.Rot().RotateVector(this->dataPtr->jointAxis).Normalize();
 
-  double desiredThrust;
-  double desiredPropellerAngVel;
-  {
-    std::lock_guard<std::mutex> lock(this->dataPtr->mtx);
-    desiredThrust = this->dataPtr->thrust;
-    desiredPropellerAngVel = this->dataPtr->propellerAngVel;
-  }
+  double desiredThrust = this->dataPtr->thrust;
+  double desiredPropellerAngVel = this->dataPtr->propellerAngVel;
 
   // PID control
   double torque = 0.0;
@@ -137,8 +137,21 @@ class ignition::gazebo::systems::TrackControllerPrivate
 
   /// \brief World pose of the track's link.
   public: math::Pose3d linkWorldPose;
+  /// \brief Poses of all collision elements of the track's link relative to
+  /// the link. Collisions are rigidly attached to the link, so these are
+  /// cached once when the collision is registered.
+  public: std::unordered_map<Entity, math::Pose3d> collisionsRelativePose;
   /// \brief World poses of all collision elements of the track's link.
   public: std::unordered_map<Entity, math::Pose3d> collisionsWorldPose;
+  /// \brief World orientation of the track, updated once per step.
+  public: math::Quaterniond trackWorldRot;
+  /// \brief Track Y axis in world coordinates, updated once per step.
+  public: math::Vector3d trackYAxisGlobal;
+  /// \brief Copy of centerOfRotation taken once per step, so that the contact
+  /// callback, which runs once per contact point, does not need to lock
+  /// cmdMutex.
+  public: math::Vector3d stepCenterOfRotation
+    {math::Vector3d::Zero * math::INF_D};
 
   /// \brief The last commanded velocity.
   public: double velocity {0};
@@ -392,11 +405,21 @@ void TrackController::PreUpdate(
     return;
   }
 
-  // Cache poses
+  // Cache poses. Only the link pose is resolved through the entity tree, the
+  // collision poses are derived from it using the cached relative offsets.
   this->dataPtr->linkWorldPose = worldPose(this->dataPtr->linkEntity, _ecm);
-  for (auto& collisionEntity : this->dataPtr->trackCollisions)
+  for (const auto &[collisionEntity, relativePose] :
+       this->dataPtr->collisionsRelativePose)
+  {
     this->dataPtr->collisionsWorldPose[collisionEntity] =
-      worldPose(collisionEntity, _ecm);
+      this->dataPtr->linkWorldPose * relativePose;
+  }
+
+  // Values shared by all contact points of this step
+  this->dataPtr->trackWorldRot =
+    this->dataPtr->linkWorldPose.Rot() * this->dataPtr->trackOrientation;
+  this->dataPtr->trackYAxisGlobal =
+    this->dataPtr->trackWorldRot.RotateVector(math::Vector3d::UnitY);
 
   std::chrono::steady_clock::duration lastCommandTimeCopy;
   {
@@ -410,6 +433,8 @@ void TrackController::PreUpdate(
 
     // Compute limited velocity command
     this->dataPtr->limitedVelocity = this->dataPtr->velocity;
+
+    this->dataPtr->stepCenterOfRotation = this->dataPtr->centerOfRotation;
   }
 
   if (this->dataPtr->maxCommandAge != std::chrono::steady_clock::duration::max()
@@ -468,34 +493,24 @@ void TrackControllerPrivate::ComputeSurfaceProperties(
   auto contactNormal = _normal.value();
 
   // In case we have not yet cached the collision pose, skip this iteration
-  if (this->collisionsWorldPose.find(trackCollision) ==
-      this->collisionsWorldPose.end())
+  const auto collisionPoseIt = this->collisionsWorldPose.find(trackCollision);
+  if (collisionPoseIt == this->collisionsWorldPose.end())
     return;
-  const auto& collisionPose = this->collisionsWorldPose[trackCollision];
+  const auto& collisionPose = collisionPoseIt->second;
 
   // Flip the contact normal if it points outside the track collision
   if (contactNormal.Dot(collisionPose.Pos() - _point) < 0)
     contactNormal = -contactNormal;
 
-  const auto trackWorldRot = this->linkWorldPose.Rot() * this->trackOrientation;
-  const auto trackYAxisGlobal =
-    trackWorldRot.RotateVector(math::Vector3d::UnitY);
-
   // Vector tangent to the belt pointing in the belt's movement direction
   // The belt's bottom moves backwards when the robot should move forward!
-  auto beltDirection = contactNormal.Cross(trackYAxisGlobal);
+  auto beltDirection = contactNormal.Cross(this->trackYAxisGlobal);
 
   if (this->limitedVelocity < 0)
     beltDirection = -beltDirection;
 
-  math::Vector3d cor;
-  {
-    std::lock_guard<std::mutex> lock(this->cmdMutex);
-    cor = this->centerOfRotation;
-  }
-
   const auto frictionDirection = this->ComputeFrictionDirection(
-    cor, _point, contactNormal, beltDirection);
+    this->stepCenterOfRotation, _point, contactNormal, beltDirection);
 
   _params.firstFrictionalDirection =
     convert(isCollision1Track ? frictionDirection : -frictionDirection);
@@ -518,8 +533,9 @@ void TrackControllerPrivate::ComputeSurfaceProperties(
     igndbg << "- surface motion       " << surfaceMotion << std::endl;
     igndbg << "- contact point        " << convert(_point) << std::endl;
     igndbg << "- contact normal       " << contactNormal << std::endl;
-    igndbg << "- track rot            " << trackWorldRot << std::endl;
-    igndbg << "- track Y              " << trackYAxisGlobal << std::endl;
+    igndbg << "- track rot            " << this->trackWorldRot << std::endl;
+    igndbg << "- track Y              " << this->trackYAxisGlobal
+           << std::endl;
     igndbg << "- belt direction       " << beltDirection << std::endl;
 
     this->debugMarker.set_id(++this->markerId);
@@ -593,6 +609,11 @@ void TrackControllerPrivate::RegisterCollision(EntityComponentManager& _ecm,
 
   this->trackCollisions.insert(_entity);
 
+  // Collision poses are expressed relative to their parent link
+  auto poseComp = _ecm.Component<components::Pose>(_entity);
+  this->collisionsRelativePose[_entity] =
+    poseComp ? poseComp->Data() : math::Pose3d::Zero;
+
   _ecm.SetComponentData<components::EnableContactSurfaceCustomization>(
     _entity, true);
 }
@@ -37,18 +37,27 @@
 #include <ignition/msgs/visual.pb.h>
 #include <ignition/msgs/wheel_slip_parameters_cmd.pb.h>
 
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <list>
+#include <mutex>
 #include <string>
 #include <utility>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include <ignition/math/SphericalCoordinates.hh>
 #include <ignition/msgs/Utility.hh>
 
+#include <sdf/Element.hh>
 #include <sdf/Physics.hh>
 #include <sdf/Root.hh>
+#include <sdf/Types.hh>
 #include <sdf/Error.hh>
 #include <sdf/Light.hh>
+#include <sdf/parser.hh>
 
 #include <ignition/plugin/Register.hh>
 #include <ignition/transport/Node.hh>
@@ -114,6 +123,73 @@ class UserCommandsInterface
   public: bool HasContactSensor(const Entity _collision);
 };
 
+/// \brief SDF files parsed by create commands, shared by all worlds in the
+/// process, so worlds spawning the same models only parse and resolve the
+/// includes of each file once. Each load gets its own copy of the parsed
+/// elements, since loading the DOM may modify them.
+class SdfFileCache
+{
+  /// \brief Get the cache shared by all worlds.
+  /// \return The cache.
+  public: static SdfFileCache &Instance();
+
+  /// \brief Load an SDF file into a root, parsing it only if neither it nor
+  /// the files it includes changed since it was last parsed.
+  /// \param[in] _filename Path or URI of the file.
+  /// \param[out] _root Root to load into.
+  /// \return Errors, empty on success.
+  public: sdf::Errors Load(const std::string &_filename, sdf::Root &_root);
+
+  /// \brief Modification time and size of a file, which is much cheaper
+  /// to check than its contents.
+  private: struct FileStamp
+  {
+    /// \brief Path of the file.
+    std::string path;
+
+    /// \brief Whether the file exists locally. URIs which aren't local
+    /// files are never considered changed.
+    bool exists{false};
+
+    /// \brief Modification time, in seconds.
+    int64_t mtime{0};
+
+    /// \brief Size in bytes.
+    int64_t size{0};
+  };
+
+  /// \brief Get the current stamp of a file.
+  /// \param[in] _path Path of the file.
+  /// \return The stamp.
+  private: static FileStamp Stamp(const std::string &_path);
+
+  /// \brief A parsed file.
+  private: struct Entry
+  {
+    /// \brief Stamps of the file and all the files it included when it was
+    /// parsed.
+    std::vector<FileStamp> files;
+
+    /// \brief Parsed file, never modified.
+    sdf::SDFPtr sdf;
+
+    /// \brief Position in the recently used list.
+    std::list<std::string>::iterator lru;
+  };
+
+  /// \brief Maximum number of parsed files kept.
+  private: static constexpr std::size_t kMaxEntries{64};
+
+  /// \brief Parsed files, keyed by path or URI.
+  private: std::unordered_map<std::string, Entry> entries;
+
+  /// \brief Keys of entries, most recently used first.
+  private: std::list<std::string> recentlyUsed;
+
+  /// \brief Protects entries and recentlyUsed.
+  private: std::mutex mutex;
+};
+
 /// \brief All user commands should inherit from this class so they can be
 /// undone / redone.
 class UserCommandBase
@@ -1043,6 +1119,128 @@ UserCommandBase::~UserCommandBase()
   this->msg = nullptr;
 }
 
+//////////////////////////////////////////////////
+SdfFileCache &SdfFileCache::Instance()
+{
+  static SdfFileCache instance;
+  return instance;
+}
+
+//////////////////////////////////////////////////
+SdfFileCache::FileStamp SdfFileCache::Stamp(const std::string &_path)
+{
+  FileStamp stamp;
+  stamp.path = _path;
+
+  struct stat info;
+  if (stat(_path.c_str(), &info) == 0)
+  {
+    stamp.exists = true;
+    stamp.mtime = static_cast<int64_t>(info.st_mtime);
+    stamp.size = static_cast<int64_t>(info.st_size);
+  }
+  return stamp;
+}
+
+//////////////////////////////////////////////////
+sdf::Errors SdfFileCache::Load(const std::string &_filename,
+    sdf::Root &_root)
+{
+  sdf::SDFPtr copy;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->entries.find(_filename);
+    if (it != this->entries.end())
+    {
+      // Edited files are parsed again
+      bool changed{false};
+      for (const auto &file : it->second.files)
+      {
+        auto current = Stamp(file.path);
+        if (current.exists != file.exists || current.mtime != file.mtime ||
+            current.size != file.size)
+        {
+          changed = true;
+          break;
+        }
+      }
+
+      if (!changed)
+      {
+        this->recentlyUsed.splice(this->recentlyUsed.begin(),
+            this->recentlyUsed, it->second.lru);
+
+        copy = std::make_shared<sdf::SDF>();
+        copy->Root(it->second.sdf->Root()->Clone());
+        copy->SetOriginalVersion(it->second.sdf->OriginalVersion());
+      }
+    }
+  }
+
+  if (!copy)
+  {
+    sdf::Errors errors;
+    auto parsed = std::make_shared<sdf::SDF>();
+    sdf::init(parsed);
+    if (!sdf::readFile(_filename, parsed, errors))
+    {
+      if (errors.empty())
+      {
+        errors.push_back({sdf::ErrorCode::FILE_READ,
+            "Unable to read file [" + _filename + "]"});
+      }
+      return errors;
+    }
+
+    copy = std::make_shared<sdf::SDF>();
+    copy->Root(parsed->Root()->Clone());
+    copy->SetOriginalVersion(parsed->OriginalVersion());
+
+    // Stamp the file and every file it included, which the parser recorded
+    // on the elements read from them
+    Entry entry;
+    entry.sdf = parsed;
+    entry.files.push_back(Stamp(_filename));
+    std::unordered_set<std::string> visited{_filename};
+    std::vector<sdf::ElementPtr> toVisit{parsed->Root()};
+    while (!toVisit.empty())
+    {
+      auto elem = toVisit.back();
+      toVisit.pop_back();
+
+      const auto &filePath = elem->FilePath();
+      if (!filePath.empty() && filePath != sdf::kSdfStringSource &&
+          visited.insert(filePath).second)
+      {
+        entry.files.push_back(Stamp(filePath));
+      }
+
+      for (auto child = elem->GetFirstElement(); child;
+          child = child->GetNextElement())
+      {
+        toVisit.push_back(child);
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->entries.find(_filename);
+    if (it != this->entries.end())
+      this->recentlyUsed.erase(it->second.lru);
+    this->recentlyUsed.push_front(_filename);
+    entry.lru = this->recentlyUsed.begin();
+    this->entries[_filename] = std::move(entry);
+
+    // Drop the least recently used files
+    while (this->entries.size() > kMaxEntries)
+    {
+      this->entries.erase(this->recentlyUsed.back());
+      this->recentlyUsed.pop_back();
+    }
+  }
+
+  return _root.Load(copy);
+}
+
 //////////////////////////////////////////////////
 CreateCommand::CreateCommand(msgs::EntityFactory *_msg,
     std::shared_ptr<UserCommandsInterface> &_iface)
@@ -1073,7 +1271,8 @@ bool CreateCommand::Execute()
     }
     case msgs::EntityFactory::kSdfFilename:
     {
-      errors = root.Load(createMsg->sdf_filename());
+      errors = SdfFileCache::Instance().Load(createMsg->sdf_filename(),
+          root);
       break;
     }
     case msgs::EntityFactory::kModel:
@@ -1420,6 +1619,8 @@ bool LightCommand::Execute()
   if (lightMsg->has_pose())
   {
     lightPose->Data().Pos() = msgs::Convert(lightMsg->pose()).Pos();
+    this->iface->ecm->SetChanged(lightEntity, components::Pose::typeId,
+        ComponentState::OneTimeChange);
   }
 
   auto lightCmdComp =
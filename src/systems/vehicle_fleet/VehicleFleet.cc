@@ -0,0 +1,1221 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "VehicleFleet.hh"
+
+#include <ignition/msgs/double.pb.h>
+#include <ignition/msgs/odometry.pb.h>
+#include <ignition/msgs/pose_v.pb.h>
+#include <ignition/msgs/twist.pb.h>
+#include <ignition/msgs/vector3d.pb.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/Angle.hh>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/SpeedLimiter.hh>
+#include <ignition/plugin/Register.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gazebo/components/CanonicalLink.hh"
+#include "ignition/gazebo/components/JointPosition.hh"
+#include "ignition/gazebo/components/JointVelocityCmd.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/Conversions.hh"
+#include "ignition/gazebo/Link.hh"
+#include "ignition/gazebo/Model.hh"
+#include "ignition/gazebo/Util.hh"
+#include "ignition/gazebo/World.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Kinds of vehicles.
+enum class VehicleType
+{
+  /// \brief Left and right wheels, like the DiffDrive system.
+  kDiffDrive,
+
+  /// \brief Four mecanum wheels, like the MecanumDrive system.
+  kMecanum,
+
+  /// \brief Steered front wheels, like the AckermannSteering system.
+  kAckermann,
+
+  /// \brief Left and right tracks driven by TrackController systems, like
+  /// the TrackedVehicle system.
+  kTracked,
+};
+
+/// \brief Kinematic coefficients of one group of wheels, i.e. all joints
+/// that are commanded with the same speed. For tracks, speeds are linear
+/// track speeds instead of joint speeds.
+struct WheelGroupKinematics
+{
+  /// \brief SDF element holding the joint or track names of this group.
+  std::string element;
+
+  /// \brief Inverse kinematics: the linear wheel speed is
+  /// lin * invLin + lat * invLat + ang * invAng.
+  double invLin;
+
+  /// \brief See invLin.
+  double invLat;
+
+  /// \brief See invLin. Multiplied by the vehicle's angular length.
+  double invAng;
+
+  /// \brief Forward kinematics: the contribution of this group's linear wheel
+  /// displacement to the body displacement along x.
+  double fwdLin;
+
+  /// \brief See fwdLin, along y.
+  double fwdLat;
+
+  /// \brief See fwdLin, around z. Divided by the vehicle's angular length.
+  double fwdAng;
+};
+
+/// \brief Wheel groups of a differential drive vehicle. The angular length
+/// is half the wheel separation.
+static const std::vector<WheelGroupKinematics> kDiffDriveGroups =
+{
+  {"left_joint", 1.0, 0.0, -1.0, 0.5, 0.0, -0.5},
+  {"right_joint", 1.0, 0.0, 1.0, 0.5, 0.0, 0.5},
+};
+
+/// \brief Wheel groups of a mecanum vehicle. The angular length is half the
+/// sum of wheel separation and wheelbase. See the references in
+/// MecanumDrive.cc.
+static const std::vector<WheelGroupKinematics> kMecanumGroups =
+{
+  {"front_left_joint", 1.0, -1.0, -1.0, 0.25, -0.25, -0.25},
+  {"front_right_joint", 1.0, 1.0, 1.0, 0.25, 0.25, 0.25},
+  {"back_left_joint", 1.0, 1.0, -1.0, 0.25, 0.25, -0.25},
+  {"back_right_joint", 1.0, -1.0, 1.0, 0.25, -0.25, 0.25},
+};
+
+/// \brief Driven wheel groups of an Ackermann vehicle. Only the linear
+/// velocity is converted here, the differential and the steering depend on
+/// the turning radius and are applied per vehicle.
+static const std::vector<WheelGroupKinematics> kAckermannGroups =
+{
+  {"left_joint", 1.0, 0.0, 0.0, 0.5, 0.0, 0.0},
+  {"right_joint", 1.0, 0.0, 0.0, 0.5, 0.0, 0.0},
+};
+
+/// \brief Tracks of a tracked vehicle. The angular length is half the
+/// tracks separation divided by the steering efficiency for commands, and
+/// half the tracks separation for odometry, as in the TrackedVehicle system.
+static const std::vector<WheelGroupKinematics> kTrackedGroups =
+{
+  {"left_track", 1.0, 0.0, -1.0, 0.5, 0.0, -0.5},
+  {"right_track", 1.0, 0.0, 1.0, 0.5, 0.0, 0.5},
+};
+
+class ignition::gazebo::systems::VehicleFleetPrivate
+{
+  /// \brief Add a vehicle described by a `<vehicle>` element.
+  /// \param[in] _sdf The `<vehicle>` element.
+  /// \return True if the vehicle was added.
+  public: bool AddVehicle(const sdf::ElementPtr &_sdf);
+
+  /// \brief Look for models and joints of vehicles that haven't been found
+  /// yet.
+  /// \param[in] _ecm The EntityComponentManager.
+  public: void FindVehicles(EntityComponentManager &_ecm);
+
+  /// \brief Callback for velocity subscriptions.
+  /// \param[in] _vehicle Index of the commanded vehicle.
+  /// \param[in] _msg Velocity message.
+  public: void OnCmdVel(std::size_t _vehicle, const msgs::Twist &_msg);
+
+  /// \brief Limit the commanded velocities of all vehicles and convert them
+  /// to wheel speeds.
+  /// \param[in] _info System update information.
+  public: void UpdateVelocities(const UpdateInfo &_info);
+
+  /// \brief Write the wheel speeds of all vehicles to the joints, and
+  /// steer the wheels of Ackermann vehicles.
+  /// \param[in] _ecm The EntityComponentManager.
+  public: void WriteJointCommands(EntityComponentManager &_ecm);
+
+  /// \brief Send the track speeds of tracked vehicles whose speeds changed
+  /// to their TrackController systems.
+  /// \param[in] _ecm The EntityComponentManager.
+  public: void PublishTrackCommands(const EntityComponentManager &_ecm);
+
+  /// \brief Integrate the odometry of all vehicles.
+  /// \param[in] _info System update information.
+  /// \param[in] _ecm The EntityComponentManager.
+  public: void UpdateOdometry(const UpdateInfo &_info,
+                              const EntityComponentManager &_ecm);
+
+  /// \brief Publish the fleet odometry message and the per-vehicle odometry
+  /// messages that have subscribers.
+  /// \param[in] _info System update information.
+  public: void PublishOdometry(const UpdateInfo &_info);
+
+  /// \brief Handle a jump back in time, such as a rewind. The command
+  /// history is cleared, so limits apply as if vehicles started from rest,
+  /// and odometry restarts from the origin, like the single vehicle systems
+  /// do.
+  /// \param[in] _info System update information.
+  public: void JumpBack(const UpdateInfo &_info);
+
+  /// \brief Ignition communication node.
+  public: transport::Node node;
+
+  /// \brief World entity.
+  public: Entity world{kNullEntity};
+
+  /// \brief Number of vehicles whose model or joints are still missing.
+  public: std::size_t unresolvedCount{0};
+
+  // Vehicle table, indexed by vehicle.
+
+  /// \brief Model names.
+  public: std::vector<std::string> names;
+
+  /// \brief Vehicle types.
+  public: std::vector<VehicleType> types;
+
+  /// \brief Model entities, kNullEntity until found.
+  public: std::vector<Entity> models;
+
+  /// \brief Whether the model and all joints have been found.
+  public: std::vector<char> resolved;
+
+  /// \brief Index of the first wheel group of each vehicle.
+  public: std::vector<std::size_t> groupBegin;
+
+  /// \brief One past the index of the last wheel group of each vehicle.
+  public: std::vector<std::size_t> groupEnd;
+
+  /// \brief Linear velocity limiters, also used for lateral velocity.
+  public: std::vector<math::SpeedLimiter> limiterLin;
+
+  /// \brief Angular velocity limiters.
+  public: std::vector<math::SpeedLimiter> limiterAng;
+
+  /// \brief Target linear velocities, written from transport callbacks.
+  public: std::vector<double> targetLin;
+
+  /// \brief Target lateral velocities, written from transport callbacks.
+  public: std::vector<double> targetLat;
+
+  /// \brief Target angular velocities, written from transport callbacks.
+  public: std::vector<double> targetAng;
+
+  /// \brief Protects the target velocities.
+  public: std::mutex mutex;
+
+  /// \brief Limited commands of this step (index 0) and of the two previous
+  /// steps (indices 1 and 2), for linear, lateral and angular velocity.
+  public: std::vector<double> cmdLin[3];
+
+  /// \brief See cmdLin.
+  public: std::vector<double> cmdLat[3];
+
+  /// \brief See cmdLin.
+  public: std::vector<double> cmdAng[3];
+
+  /// \brief Odometry position along x.
+  public: std::vector<double> odomX;
+
+  /// \brief Odometry position along y.
+  public: std::vector<double> odomY;
+
+  /// \brief Odometry heading.
+  public: std::vector<double> odomHeading;
+
+  /// \brief Odometry linear velocity along the body x axis.
+  public: std::vector<double> odomLin;
+
+  /// \brief Odometry linear velocity along the body y axis.
+  public: std::vector<double> odomLat;
+
+  /// \brief Odometry angular velocity.
+  public: std::vector<double> odomAng;
+
+  /// \brief Per-vehicle odometry publishers.
+  public: std::vector<transport::Node::Publisher> odomPubs;
+
+  /// \brief Per-vehicle odometry topics.
+  public: std::vector<std::string> odomTopics;
+
+  /// \brief Canonical links, which tracked vehicles turn around.
+  public: std::vector<Entity> bodyLinks;
+
+  /// \brief Distance between front and back axles of Ackermann vehicles.
+  public: std::vector<double> wheelBase;
+
+  /// \brief Distance between the steering kingpins of Ackermann vehicles.
+  public: std::vector<double> kingpinWidth;
+
+  /// \brief Maximum steering angle of Ackermann vehicles.
+  public: std::vector<double> steeringLimit;
+
+  /// \brief Wheel separation divided by twice the wheel base, scales the
+  /// differential of Ackermann vehicles.
+  public: std::vector<double> differential;
+
+  /// \brief Left (index 0) and right (index 1) steering joint names of
+  /// Ackermann vehicles, empty for other vehicles.
+  public: std::vector<std::vector<std::string>> steeringJointNames[2];
+
+  /// \brief Left and right steering joints, see steeringJointNames.
+  public: std::vector<std::vector<Entity>> steeringJoints[2];
+
+  /// \brief Left and right steering angle targets.
+  public: std::vector<double> steeringTarget[2];
+
+  // Wheel group table, indexed by wheel group.
+
+  /// \brief Joint names of each group.
+  public: std::vector<std::vector<std::string>> groupJointNames;
+
+  /// \brief Joint entities of each group.
+  public: std::vector<std::vector<Entity>> groupJoints;
+
+  /// \brief Inverse kinematics coefficients, already divided by the wheel
+  /// radius, see WheelGroupKinematics.
+  public: std::vector<double> invLin;
+
+  /// \brief See invLin.
+  public: std::vector<double> invLat;
+
+  /// \brief See invLin.
+  public: std::vector<double> invAng;
+
+  /// \brief Forward kinematics coefficients, already multiplied by the
+  /// wheel radius, see WheelGroupKinematics.
+  public: std::vector<double> fwdLin;
+
+  /// \brief See fwdLin.
+  public: std::vector<double> fwdLat;
+
+  /// \brief See fwdLin.
+  public: std::vector<double> fwdAng;
+
+  /// \brief Commanded joint speed of each group.
+  public: std::vector<double> groupSpeed;
+
+  /// \brief Speed last sent to the tracks of each group of a tracked
+  /// vehicle. NaN until the first command.
+  public: std::vector<double> groupSentSpeed;
+
+  /// \brief Track speed publishers of each group, empty for wheels.
+  public: std::vector<std::vector<transport::Node::Publisher>> trackVelPubs;
+
+  /// \brief Track center of rotation publishers of each group, empty for
+  /// wheels.
+  public: std::vector<std::vector<transport::Node::Publisher>> trackCorPubs;
+
+  /// \brief Joint position of the first joint of each group at the last
+  /// odometry update. NaN until the first update.
+  public: std::vector<double> groupLastPos;
+
+  /// \brief Update period calculated from <odom_publish_frequency>.
+  public: std::chrono::steady_clock::duration odomPubPeriod{0};
+
+  /// \brief Last sim time odometry was published.
+  public: std::chrono::steady_clock::duration lastOdomPubTime{0};
+
+  /// \brief Last sim time odometry was integrated.
+  public: std::chrono::steady_clock::duration lastOdomTime{0};
+
+  /// \brief Fleet odometry publisher.
+  public: transport::Node::Publisher fleetPub;
+
+  /// \brief Fleet odometry message, reused across publications. Holds one
+  /// pose per vehicle.
+  public: msgs::Pose_V fleetMsg;
+
+  /// \brief Per-vehicle odometry message, reused across publications.
+  public: msgs::Odometry odomMsg;
+};
+
+//////////////////////////////////////////////////
+/// \brief Configure linear and angular speed limiters from SDF using the
+/// same parameters as the DiffDrive system.
+/// \param[in] _sdf Element holding the parameters.
+/// \param[out] _lin Linear speed limiter.
+/// \param[out] _ang Angular speed limiter.
+static void configureLimiters(const sdf::ElementPtr &_sdf,
+    math::SpeedLimiter &_lin, math::SpeedLimiter &_ang)
+{
+  using Setter = void (math::SpeedLimiter::*)(double);
+  const std::vector<std::pair<std::string, Setter>> limits =
+  {
+    {"velocity", &math::SpeedLimiter::SetMinVelocity},
+    {"velocity", &math::SpeedLimiter::SetMaxVelocity},
+    {"acceleration", &math::SpeedLimiter::SetMinAcceleration},
+    {"acceleration", &math::SpeedLimiter::SetMaxAcceleration},
+    {"jerk", &math::SpeedLimiter::SetMinJerk},
+    {"jerk", &math::SpeedLimiter::SetMaxJerk},
+  };
+
+  for (std::size_t i = 0; i < limits.size(); ++i)
+  {
+    const std::string bound = (i % 2 == 0) ? "min_" : "max_";
+    const auto &[quantity, setter] = limits[i];
+
+    // The generic limit applies to both, the specific ones override it.
+    if (_sdf->HasElement(bound + quantity))
+    {
+      const double value = _sdf->Get<double>(bound + quantity);
+      (_lin.*setter)(value);
+      (_ang.*setter)(value);
+    }
+    if (_sdf->HasElement(bound + "linear_" + quantity))
+      (_lin.*setter)(_sdf->Get<double>(bound + "linear_" + quantity));
+    if (_sdf->HasElement(bound + "angular_" + quantity))
+      (_ang.*setter)(_sdf->Get<double>(bound + "angular_" + quantity));
+  }
+}
+
+//////////////////////////////////////////////////
+bool VehicleFleetPrivate::AddVehicle(const sdf::ElementPtr &_sdf)
+{
+  if (!_sdf->HasAttribute("model"))
+  {
+    ignerr << "<vehicle> element missing model attribute." << std::endl;
+    return false;
+  }
+  const auto name = _sdf->Get<std::string>("model");
+
+  const auto typeName = _sdf->Get<std::string>("type", "diff_drive").first;
+  VehicleType type;
+  const std::vector<WheelGroupKinematics> *groups{nullptr};
+  const double wheelSeparation =
+      _sdf->Get<double>("wheel_separation", 1.0).first;
+  double wheelRadius = _sdf->Get<double>("wheel_radius", 0.2).first;
+  double wheelBase{1.0};
+  double kingpinWidth{0.8};
+  double steeringLimit{0.5};
+
+  // Angular lengths used to convert commands and to integrate odometry
+  double invAngularLength{0.0};
+  double fwdAngularLength{0.0};
+  if (typeName == "diff_drive")
+  {
+    type = VehicleType::kDiffDrive;
+    groups = &kDiffDriveGroups;
+    invAngularLength = 0.5 * wheelSeparation;
+  }
+  else if (typeName == "mecanum")
+  {
+    type = VehicleType::kMecanum;
+    groups = &kMecanumGroups;
+    invAngularLength = 0.5 *
+        (wheelSeparation + _sdf->Get<double>("wheelbase", 1.0).first);
+  }
+  else if (typeName == "ackermann")
+  {
+    type = VehicleType::kAckermann;
+    groups = &kAckermannGroups;
+    wheelBase = _sdf->Get<double>("wheel_base", wheelBase).first;
+    kingpinWidth = _sdf->Get<double>("kingpin_width", kingpinWidth).first;
+    steeringLimit = _sdf->Get<double>("steering_limit", steeringLimit).first;
+    if (wheelBase <= 0 || steeringLimit <= 0)
+    {
+      ignerr << "Wheel base and steering limit of model [" << name
+             << "] must be positive." << std::endl;
+      return false;
+    }
+    // Turning is applied per vehicle, the groups have no angular terms
+    invAngularLength = 1.0;
+  }
+  else if (typeName == "tracked")
+  {
+    type = VehicleType::kTracked;
+    groups = &kTrackedGroups;
+    const double separation =
+        _sdf->Get<double>("tracks_separation", 1.0).first;
+    const double efficiency =
+        _sdf->Get<double>("steering_efficiency", 0.5).first;
+    if (efficiency <= 0)
+    {
+      ignerr << "Steering efficiency of model [" << name
+             << "] must be positive." << std::endl;
+      return false;
+    }
+    invAngularLength = 0.5 * separation / efficiency;
+    fwdAngularLength = 0.5 * separation;
+
+    // Tracks are commanded with linear speeds
+    wheelRadius = 1.0;
+  }
+  else
+  {
+    ignerr << "Unknown vehicle type [" << typeName << "] for model [" << name
+           << "]. Supported types are [diff_drive], [mecanum], [ackermann] "
+           << "and [tracked]." << std::endl;
+    return false;
+  }
+  if (fwdAngularLength <= 0)
+    fwdAngularLength = invAngularLength;
+
+  if (wheelRadius <= 0 || invAngularLength <= 0)
+  {
+    ignerr << "Wheel radius and separation of model [" << name
+           << "] must be positive." << std::endl;
+    return false;
+  }
+
+  // Joint names of wheels, link names of tracks
+  std::vector<std::vector<std::string>> jointNames;
+  std::vector<std::vector<sdf::ElementPtr>> trackElems;
+  for (const auto &group : *groups)
+  {
+    jointNames.emplace_back();
+    trackElems.emplace_back();
+    for (auto elem = _sdf->FindElement(group.element); elem;
+         elem = elem->GetNextElement(group.element))
+    {
+      if (type == VehicleType::kTracked)
+      {
+        jointNames.back().push_back(elem->Get<std::string>("link"));
+        trackElems.back().push_back(elem);
+      }
+      else
+      {
+        jointNames.back().push_back(elem->Get<std::string>());
+      }
+    }
+    if (jointNames.back().empty())
+    {
+      ignerr << "Missing <" << group.element << "> for model [" << name
+             << "]." << std::endl;
+      return false;
+    }
+  }
+
+  std::vector<std::string> steeringNames[2];
+  if (type == VehicleType::kAckermann)
+  {
+    const std::string steeringElements[2] =
+        {"left_steering_joint", "right_steering_joint"};
+    for (std::size_t side = 0; side < 2; ++side)
+    {
+      for (auto elem = _sdf->FindElement(steeringElements[side]); elem;
+           elem = elem->GetNextElement(steeringElements[side]))
+      {
+        steeringNames[side].push_back(elem->Get<std::string>());
+      }
+      if (steeringNames[side].empty())
+      {
+        ignerr << "Missing <" << steeringElements[side] << "> for model ["
+               << name << "]." << std::endl;
+        return false;
+      }
+    }
+  }
+
+  const std::size_t index = this->names.size();
+  this->names.push_back(name);
+  this->types.push_back(type);
+  this->models.push_back(kNullEntity);
+  this->resolved.push_back(false);
+  this->bodyLinks.push_back(kNullEntity);
+  this->wheelBase.push_back(wheelBase);
+  this->kingpinWidth.push_back(kingpinWidth);
+  this->steeringLimit.push_back(steeringLimit);
+  this->differential.push_back(0.5 * wheelSeparation / wheelBase);
+  for (std::size_t side = 0; side < 2; ++side)
+  {
+    this->steeringJointNames[side].push_back(steeringNames[side]);
+    this->steeringJoints[side].emplace_back();
+    this->steeringTarget[side].push_back(0.0);
+  }
+
+  math::SpeedLimiter lin;
+  math::SpeedLimiter ang;
+  configureLimiters(_sdf, lin, ang);
+  this->limiterLin.push_back(lin);
+  this->limiterAng.push_back(ang);
+
+  {
+    // Vehicles added before this one may already be receiving commands
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->targetLin.push_back(0.0);
+    this->targetLat.push_back(0.0);
+    this->targetAng.push_back(0.0);
+  }
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    this->cmdLin[i].push_back(0.0);
+    this->cmdLat[i].push_back(0.0);
+    this->cmdAng[i].push_back(0.0);
+  }
+
+  this->odomX.push_back(0.0);
+  this->odomY.push_back(0.0);
+  this->odomHeading.push_back(0.0);
+  this->odomLin.push_back(0.0);
+  this->odomLat.push_back(0.0);
+  this->odomAng.push_back(0.0);
+
+  this->groupBegin.push_back(this->groupJointNames.size());
+  for (std::size_t g = 0; g < groups->size(); ++g)
+  {
+    const auto &group = (*groups)[g];
+    this->groupJointNames.push_back(jointNames[g]);
+    this->groupJoints.emplace_back();
+    this->invLin.push_back(group.invLin / wheelRadius);
+    this->invLat.push_back(group.invLat / wheelRadius);
+    this->invAng.push_back(group.invAng * invAngularLength / wheelRadius);
+    this->fwdLin.push_back(group.fwdLin * wheelRadius);
+    this->fwdLat.push_back(group.fwdLat * wheelRadius);
+    this->fwdAng.push_back(group.fwdAng * wheelRadius / fwdAngularLength);
+    this->groupSpeed.push_back(0.0);
+    this->groupSentSpeed.push_back(std::numeric_limits<double>::quiet_NaN());
+    this->groupLastPos.push_back(std::numeric_limits<double>::quiet_NaN());
+
+    // Tracks are commanded through their TrackController systems
+    this->trackVelPubs.emplace_back();
+    this->trackCorPubs.emplace_back();
+    for (const auto &elem : trackElems[g])
+    {
+      const auto prefix = "/model/" + name + "/link/" +
+          elem->Get<std::string>("link");
+      const auto velTopic = validTopic({elem->Get<std::string>(
+          "velocity_topic", prefix + "/track_cmd_vel").first});
+      const auto corTopic = validTopic({elem->Get<std::string>(
+          "center_of_rotation_topic",
+          prefix + "/track_cmd_center_of_rotation").first});
+      this->trackVelPubs.back().push_back(
+          this->node.Advertise<msgs::Double>(velTopic));
+      this->trackCorPubs.back().push_back(
+          this->node.Advertise<msgs::Vector3d>(corTopic));
+    }
+  }
+  this->groupEnd.push_back(this->groupJointNames.size());
+
+  // Subscribe to commands
+  std::vector<std::string> topics;
+  if (_sdf->HasElement("topic"))
+    topics.push_back(_sdf->Get<std::string>("topic"));
+  topics.push_back("/model/" + name + "/cmd_vel");
+  const auto topic = validTopic(topics);
+
+  std::function<void(const msgs::Twist &)> cmdCb =
+      [this, index](const msgs::Twist &_msg)
+      {
+        this->OnCmdVel(index, _msg);
+      };
+  this->node.Subscribe(topic, cmdCb);
+
+  // Odometry is only generated when someone listens, but the topic is
+  // always advertised so subscribers can discover it.
+  std::vector<std::string> odomTopicNames;
+  if (_sdf->HasElement("odom_topic"))
+    odomTopicNames.push_back(_sdf->Get<std::string>("odom_topic"));
+  odomTopicNames.push_back("/model/" + name + "/odometry");
+  this->odomTopics.push_back(validTopic(odomTopicNames));
+  this->odomPubs.push_back(
+      this->node.Advertise<msgs::Odometry>(this->odomTopics.back()));
+
+  auto pose = this->fleetMsg.add_pose();
+  pose->set_name(name);
+
+  ++this->unresolvedCount;
+
+  igndbg << "VehicleFleet added [" << typeName << "] vehicle [" << name
+         << "] subscribing to twist messages on [" << topic << "]"
+         << std::endl;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void VehicleFleetPrivate::FindVehicles(EntityComponentManager &_ecm)
+{
+  for (std::size_t v = 0; v < this->names.size(); ++v)
+  {
+    if (this->resolved[v])
+      continue;
+
+    if (this->models[v] == kNullEntity)
+    {
+      this->models[v] = _ecm.EntityByComponents(components::Model(),
+          components::Name(this->names[v]),
+          components::ParentEntity(this->world));
+      if (this->models[v] == kNullEntity)
+        continue;
+    }
+
+    Model model(this->models[v]);
+    bool found{true};
+    for (std::size_t g = this->groupBegin[v]; g < this->groupEnd[v]; ++g)
+    {
+      if (!this->groupJoints[g].empty())
+        continue;
+
+      // Tracks are links
+      const bool tracked = this->types[v] == VehicleType::kTracked;
+      std::vector<Entity> joints;
+      for (const auto &jointName : this->groupJointNames[g])
+      {
+        Entity joint = tracked ? model.LinkByName(_ecm, jointName) :
+            model.JointByName(_ecm, jointName);
+        if (joint == kNullEntity)
+        {
+          found = false;
+          break;
+        }
+        joints.push_back(joint);
+      }
+      if (!found)
+        break;
+
+      // Odometry reads the first joint of each group
+      if (!tracked && !_ecm.Component<components::JointPosition>(joints[0]))
+        _ecm.CreateComponent(joints[0], components::JointPosition());
+
+      this->groupJoints[g] = joints;
+    }
+
+    for (std::size_t side = 0; found && side < 2; ++side)
+    {
+      if (this->steeringJointNames[side][v].empty() ||
+          !this->steeringJoints[side][v].empty())
+      {
+        continue;
+      }
+
+      std::vector<Entity> joints;
+      for (const auto &jointName : this->steeringJointNames[side][v])
+      {
+        Entity joint = model.JointByName(_ecm, jointName);
+        if (joint == kNullEntity)
+        {
+          found = false;
+          break;
+        }
+        joints.push_back(joint);
+      }
+      if (!found)
+        break;
+
+      // Steering and odometry read the first steering joint of each side
+      if (!_ecm.Component<components::JointPosition>(joints[0]))
+        _ecm.CreateComponent(joints[0], components::JointPosition());
+
+      this->steeringJoints[side][v] = joints;
+    }
+    if (!found)
+      continue;
+
+    // Fill the frame ids of the fleet message once
+    auto header = this->fleetMsg.mutable_pose(v)->mutable_header();
+    auto frame = header->add_data();
+    frame->set_key("frame_id");
+    frame->add_value(this->names[v] + "/odom");
+
+    std::vector<Entity> links = _ecm.ChildrenByComponents(
+        this->models[v], components::CanonicalLink());
+    std::optional<std::string> linkName;
+    if (!links.empty())
+    {
+      this->bodyLinks[v] = links[0];
+      linkName = Link(links[0]).Name(_ecm);
+    }
+    if (linkName)
+    {
+      auto childFrame = header->add_data();
+      childFrame->set_key("child_frame_id");
+      childFrame->add_value(this->names[v] + "/" + *linkName);
+    }
+
+    this->resolved[v] = true;
+    --this->unresolvedCount;
+    ignmsg << "Found joints for model [" << this->names[v]
+           << "], vehicle will start working." << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+void VehicleFleetPrivate::UpdateVelocities(const UpdateInfo &_info)
+{
+  IGN_PROFILE("VehicleFleet::UpdateVelocities");
+
+  const std::size_t count = this->names.size();
+
+  // Age the command history
+  for (std::size_t i = 2; i > 0; --i)
+  {
+    this->cmdLin[i] = this->cmdLin[i - 1];
+    this->cmdLat[i] = this->cmdLat[i - 1];
+    this->cmdAng[i] = this->cmdAng[i - 1];
+  }
+
+  // Take all targets under a single lock
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->cmdLin[0] = this->targetLin;
+    this->cmdLat[0] = this->targetLat;
+    this->cmdAng[0] = this->targetAng;
+  }
+
+  for (std::size_t v = 0; v < count; ++v)
+  {
+    this->limiterLin[v].Limit(this->cmdLin[0][v], this->cmdLin[1][v],
+        this->cmdLin[2][v], _info.dt);
+    this->limiterLin[v].Limit(this->cmdLat[0][v], this->cmdLat[1][v],
+        this->cmdLat[2][v], _info.dt);
+    this->limiterAng[v].Limit(this->cmdAng[0][v], this->cmdAng[1][v],
+        this->cmdAng[2][v], _info.dt);
+  }
+
+  // Convert the limited velocities to joint speeds
+  for (std::size_t v = 0; v < count; ++v)
+  {
+    const double lin = this->cmdLin[0][v];
+    const double lat = this->cmdLat[0][v];
+    const double ang = this->cmdAng[0][v];
+    for (std::size_t g = this->groupBegin[v]; g < this->groupEnd[v]; ++g)
+    {
+      this->groupSpeed[g] =
+          lin * this->invLin[g] + lat * this->invLat[g] + ang * this->invAng[g];
+    }
+  }
+
+  // Steer Ackermann vehicles and partially simulate a simple differential,
+  // as the AckermannSteering system does
+  for (std::size_t v = 0; v < count; ++v)
+  {
+    if (this->types[v] != VehicleType::kAckermann)
+      continue;
+
+    const double lin = this->cmdLin[0][v];
+    const double ang = this->cmdAng[0][v];
+    const double base = this->wheelBase[v];
+    const double minimumRadius = base / std::sin(this->steeringLimit[v]);
+    double radius = lin / ang;
+    if (radius >= 0.0 && radius < minimumRadius)
+      radius = minimumRadius;
+    if (radius <= 0.0 && radius > -minimumRadius)
+      radius = -minimumRadius;
+    // Driving straight
+    if (std::fabs(ang) < 0.001)
+      radius = 1e9;
+
+    const double halfKingpin = 0.5 * this->kingpinWidth[v];
+    this->steeringTarget[0][v] = std::atan(base / (radius - halfKingpin));
+    this->steeringTarget[1][v] = std::atan(base / (radius + halfKingpin));
+
+    const double spread = this->differential[v] * (base / radius);
+    const std::size_t left = this->groupBegin[v];
+    this->groupSpeed[left] *= 1.0 - spread;
+    this->groupSpeed[left + 1] *= 1.0 + spread;
+  }
+}
+
+//////////////////////////////////////////////////
+void VehicleFleetPrivate::WriteJointCommands(EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("VehicleFleet::WriteJointCommands");
+
+  auto write = [&_ecm](Entity _joint, double _speed)
+  {
+    auto vel = _ecm.Component<components::JointVelocityCmd>(_joint);
+    if (vel == nullptr)
+    {
+      // skip this entity if it has been removed
+      if (!_ecm.HasEntity(_joint))
+        return;
+
+      _ecm.CreateComponent(_joint, components::JointVelocityCmd({_speed}));
+    }
+    else
+    {
+      vel->Data().resize(1);
+      vel->Data()[0] = _speed;
+    }
+  };
+
+  for (std::size_t v = 0; v < this->names.size(); ++v)
+  {
+    // Tracks are commanded through transport
+    if (this->types[v] == VehicleType::kTracked)
+      continue;
+
+    for (std::size_t g = this->groupBegin[v]; g < this->groupEnd[v]; ++g)
+    {
+      for (const Entity joint : this->groupJoints[g])
+        write(joint, this->groupSpeed[g]);
+    }
+
+    // Simple proportional steering control with a gain of 1
+    for (std::size_t side = 0; side < 2; ++side)
+    {
+      const auto &joints = this->steeringJoints[side][v];
+      if (joints.empty())
+        continue;
+      auto pos = _ecm.Component<components::JointPosition>(joints[0]);
+      if (!pos || pos->Data().empty())
+        continue;
+      const double speed = this->steeringTarget[side][v] - pos->Data()[0];
+      for (const Entity joint : joints)
+        write(joint, speed);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void VehicleFleetPrivate::PublishTrackCommands(
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("VehicleFleet::PublishTrackCommands");
+
+  msgs::Double velMsg;
+  for (std::size_t v = 0; v < this->names.size(); ++v)
+  {
+    if (this->types[v] != VehicleType::kTracked || !this->resolved[v])
+      continue;
+
+    // Tracks keep their last command, so they're only sent changes
+    bool changed{false};
+    for (std::size_t g = this->groupBegin[v]; g < this->groupEnd[v]; ++g)
+    {
+      if (!(std::abs(this->groupSpeed[g] - this->groupSentSpeed[g]) <= 1e-6))
+        changed = true;
+    }
+    if (!changed)
+      continue;
+
+    // Radius of the turn, infinite when driving straight and zero when
+    // rotating in place
+    const double lin = this->cmdLin[0][v];
+    const double ang = this->cmdAng[0][v];
+    double radius = math::INF_D;
+    if (std::fabs(ang) >= 0.1)
+      radius = std::fabs(lin) < 0.1 ? 0.0 : lin / ang;
+
+    math::Vector3d centerOfRotation;
+    if (this->bodyLinks[v] != kNullEntity)
+    {
+      const auto bodyPose = worldPose(this->bodyLinks[v], _ecm);
+      centerOfRotation = bodyPose.Rot().RotateVector(math::Vector3d::UnitY) *
+          radius + bodyPose.Pos();
+    }
+    const auto corMsg = msgs::Convert(centerOfRotation);
+
+    for (std::size_t g = this->groupBegin[v]; g < this->groupEnd[v]; ++g)
+    {
+      velMsg.set_data(this->groupSpeed[g]);
+      for (std::size_t t = 0; t < this->trackVelPubs[g].size(); ++t)
+      {
+        this->trackVelPubs[g][t].Publish(velMsg);
+        this->trackCorPubs[g][t].Publish(corMsg);
+      }
+      this->groupSentSpeed[g] = this->groupSpeed[g];
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void VehicleFleetPrivate::UpdateOdometry(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("VehicleFleet::UpdateOdometry");
+
+  const double dt = std::chrono::duration<double>(
+      _info.simTime - this->lastOdomTime).count();
+  this->lastOdomTime = _info.simTime;
+
+  for (std::size_t v = 0; v < this->names.size(); ++v)
+  {
+    if (!this->resolved[v])
+      continue;
+
+    // Body displacement accumulated from all wheel groups
+    double dLin{0.0};
+    double dLat{0.0};
+    double dAng{0.0};
+    bool valid{true};
+
+    for (std::size_t g = this->groupBegin[v]; g < this->groupEnd[v]; ++g)
+    {
+      // Tracks have no encoders, their commanded speeds are integrated
+      if (this->types[v] == VehicleType::kTracked)
+      {
+        const double delta = this->groupSpeed[g] * dt;
+        dLin += this->fwdLin[g] * delta;
+        dLat += this->fwdLat[g] * delta;
+        dAng += this->fwdAng[g] * delta;
+        continue;
+      }
+
+      auto pos = _ecm.Component<components::JointPosition>(
+          this->groupJoints[g][0]);
+
+      // Abort if the joints were not found or just created.
+      if (!pos || pos->Data().empty())
+      {
+        valid = false;
+        continue;
+      }
+
+      const double delta = pos->Data()[0] - this->groupLastPos[g];
+      this->groupLastPos[g] = pos->Data()[0];
+
+      dLin += this->fwdLin[g] * delta;
+      dLat += this->fwdLat[g] * delta;
+      dAng += this->fwdAng[g] * delta;
+    }
+
+    // Ackermann vehicles turn along the arc given by their mean steering
+    // angle
+    if (this->types[v] == VehicleType::kAckermann)
+    {
+      auto leftPos = _ecm.Component<components::JointPosition>(
+          this->steeringJoints[0][v][0]);
+      auto rightPos = _ecm.Component<components::JointPosition>(
+          this->steeringJoints[1][v][0]);
+      if (!leftPos || !rightPos || leftPos->Data().empty() ||
+          rightPos->Data().empty())
+      {
+        valid = false;
+      }
+      else
+      {
+        const double phi = 0.5 * (leftPos->Data()[0] + rightPos->Data()[0]);
+        dAng = dLin * std::tan(phi) / this->wheelBase[v];
+      }
+    }
+
+    // The first update only records the joint positions, NaN deltas land
+    // here too.
+    if (!valid || !std::isfinite(dLin + dLat + dAng))
+      continue;
+
+    // Integrate using the heading at the middle of the step
+    const double heading = this->odomHeading[v] + 0.5 * dAng;
+    const double cosH = std::cos(heading);
+    const double sinH = std::sin(heading);
+    this->odomX[v] += dLin * cosH - dLat * sinH;
+    this->odomY[v] += dLin * sinH + dLat * cosH;
+    this->odomHeading[v] = math::Angle(this->odomHeading[v] + dAng).Normalized()
+        .Radian();
+
+    if (dt > 0)
+    {
+      this->odomLin[v] = dLin / dt;
+      this->odomLat[v] = dLat / dt;
+      this->odomAng[v] = dAng / dt;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void VehicleFleetPrivate::PublishOdometry(const UpdateInfo &_info)
+{
+  IGN_PROFILE("VehicleFleet::PublishOdometry");
+
+  // Throttle publishing
+  auto diff = _info.simTime - this->lastOdomPubTime;
+  if (diff > std::chrono::steady_clock::duration::zero() &&
+      diff < this->odomPubPeriod)
+  {
+    return;
+  }
+  this->lastOdomPubTime = _info.simTime;
+
+  const auto stamp = convert<msgs::Time>(_info.simTime);
+  this->fleetMsg.mutable_header()->mutable_stamp()->CopyFrom(stamp);
+
+  for (std::size_t v = 0; v < this->names.size(); ++v)
+  {
+    if (!this->resolved[v])
+      continue;
+
+    auto pose = this->fleetMsg.mutable_pose(v);
+    pose->mutable_header()->mutable_stamp()->CopyFrom(stamp);
+    pose->mutable_position()->set_x(this->odomX[v]);
+    pose->mutable_position()->set_y(this->odomY[v]);
+    msgs::Set(pose->mutable_orientation(),
+        math::Quaterniond(0, 0, this->odomHeading[v]));
+
+    // Per-vehicle messages are only generated on demand
+    if (!this->odomPubs[v].HasConnections())
+      continue;
+
+    this->odomMsg.mutable_header()->CopyFrom(pose->header());
+    this->odomMsg.mutable_pose()->mutable_position()->CopyFrom(
+        pose->position());
+    this->odomMsg.mutable_pose()->mutable_orientation()->CopyFrom(
+        pose->orientation());
+    this->odomMsg.mutable_twist()->mutable_linear()->set_x(this->odomLin[v]);
+    this->odomMsg.mutable_twist()->mutable_linear()->set_y(this->odomLat[v]);
+    this->odomMsg.mutable_twist()->mutable_angular()->set_z(this->odomAng[v]);
+    this->odomPubs[v].Publish(this->odomMsg);
+  }
+
+  this->fleetPub.Publish(this->fleetMsg);
+}
+
+//////////////////////////////////////////////////
+void VehicleFleetPrivate::JumpBack(const UpdateInfo &_info)
+{
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    std::fill(this->cmdLin[i].begin(), this->cmdLin[i].end(), 0.0);
+    std::fill(this->cmdLat[i].begin(), this->cmdLat[i].end(), 0.0);
+    std::fill(this->cmdAng[i].begin(), this->cmdAng[i].end(), 0.0);
+  }
+  std::fill(this->groupLastPos.begin(), this->groupLastPos.end(),
+      std::numeric_limits<double>::quiet_NaN());
+  std::fill(this->groupSentSpeed.begin(), this->groupSentSpeed.end(),
+      std::numeric_limits<double>::quiet_NaN());
+  for (auto *odom : {&this->odomX, &this->odomY, &this->odomHeading,
+       &this->odomLin, &this->odomLat, &this->odomAng})
+  {
+    std::fill(odom->begin(), odom->end(), 0.0);
+  }
+  this->lastOdomTime = _info.simTime;
+  this->lastOdomPubTime = _info.simTime;
+}
+
+//////////////////////////////////////////////////
+void VehicleFleetPrivate::OnCmdVel(std::size_t _vehicle,
+    const msgs::Twist &_msg)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->targetLin[_vehicle] = _msg.linear().x();
+  this->targetLat[_vehicle] = _msg.linear().y();
+  this->targetAng[_vehicle] = _msg.angular().z();
+}
+
+//////////////////////////////////////////////////
+VehicleFleet::VehicleFleet()
+  : dataPtr(std::make_unique<VehicleFleetPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+void VehicleFleet::Configure(const Entity &_entity,
+    const std::shared_ptr<const sdf::Element> &_sdf,
+    EntityComponentManager &_ecm,
+    EventManager &/*_eventMgr*/)
+{
+  World world(_entity);
+  if (!world.Valid(_ecm))
+  {
+    ignerr << "VehicleFleet system should be attached to a world entity. "
+           << "Failed to initialize." << std::endl;
+    return;
+  }
+  this->dataPtr->world = _entity;
+
+  auto sdfClone = _sdf->Clone();
+  for (auto vehicleElem = sdfClone->FindElement("vehicle"); vehicleElem;
+       vehicleElem = vehicleElem->GetNextElement("vehicle"))
+  {
+    this->dataPtr->AddVehicle(vehicleElem);
+  }
+
+  if (this->dataPtr->names.empty())
+  {
+    ignerr << "VehicleFleet has no valid <vehicle> elements, system is "
+           << "disabled." << std::endl;
+    return;
+  }
+
+  double odomFreq = _sdf->Get<double>("odom_publish_frequency", 50).first;
+  if (odomFreq > 0)
+  {
+    std::chrono::duration<double> odomPer{1 / odomFreq};
+    this->dataPtr->odomPubPeriod =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(odomPer);
+  }
+
+  std::vector<std::string> fleetTopics;
+  if (_sdf->HasElement("fleet_odom_topic"))
+    fleetTopics.push_back(_sdf->Get<std::string>("fleet_odom_topic"));
+  fleetTopics.push_back("/world/" + world.Name(_ecm).value_or("") +
+      "/fleet/odometry");
+  const auto fleetTopic = validTopic(fleetTopics);
+  this->dataPtr->fleetPub =
+      this->dataPtr->node.Advertise<msgs::Pose_V>(fleetTopic);
+
+  ignmsg << "VehicleFleet controlling [" << this->dataPtr->names.size()
+         << "] vehicles, publishing fleet odometry on [" << fleetTopic << "]"
+         << std::endl;
+}
+
+//////////////////////////////////////////////////
+void VehicleFleet::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
+    ignition::gazebo::EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("VehicleFleet::PreUpdate");
+
+  if (_info.dt < std::chrono::steady_clock::duration::zero())
+  {
+    igndbg << "Detected jump back in time ["
+        << std::chrono::duration_cast<std::chrono::seconds>(_info.dt).count()
+        << "s], restarting velocity limits and odometry." << std::endl;
+    this->dataPtr->JumpBack(_info);
+  }
+
+  if (this->dataPtr->unresolvedCount > 0)
+    this->dataPtr->FindVehicles(_ecm);
+
+  // Nothing left to do if paused.
+  if (_info.paused)
+    return;
+
+  this->dataPtr->UpdateVelocities(_info);
+  this->dataPtr->WriteJointCommands(_ecm);
+  this->dataPtr->PublishTrackCommands(_ecm);
+}
+
+//////////////////////////////////////////////////
+void VehicleFleet::PostUpdate(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("VehicleFleet::PostUpdate");
+  // Nothing left to do if paused.
+  if (_info.paused)
+    return;
+
+  this->dataPtr->UpdateOdometry(_info, _ecm);
+  this->dataPtr->PublishOdometry(_info);
+}
+
+IGNITION_ADD_PLUGIN(VehicleFleet,
+                    ignition::gazebo::System,
+                    VehicleFleet::ISystemConfigure,
+                    VehicleFleet::ISystemPreUpdate,
+                    VehicleFleet::ISystemPostUpdate)
+
+IGNITION_ADD_PLUGIN_ALIAS(VehicleFleet,
+                          "ignition::gazebo::systems::VehicleFleet")
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_VEHICLEFLEET_HH_
+#define IGNITION_GAZEBO_SYSTEMS_VEHICLEFLEET_HH_
+
+#include <memory>
+
+#include <ignition/gazebo/System.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  // Forward declaration
+  class VehicleFleetPrivate;
+
+  /// \brief Kinematic controller for many wheeled vehicles at once. It
+  /// provides the behavior of the DiffDrive, MecanumDrive,
+  /// AckermannSteering and TrackedVehicle systems, but
+  /// keeps the parameters and state of all vehicles in contiguous tables and
+  /// processes them in a single pass per step, instead of running one
+  /// plugin instance per vehicle.
+  ///
+  /// The system should be attached to the world. Each vehicle is declared
+  /// with a `<vehicle>` element.
+  ///
+  /// # System Parameters
+  ///
+  /// `<vehicle>`: Declares one vehicle. This element can appear multiple
+  /// times. It accepts the following attributes and child elements:
+  ///
+  ///   * `model` attribute: Name of the model. Required.
+  ///
+  ///   * `type` attribute: One of `diff_drive` (default), `mecanum`,
+  ///     `ackermann` or `tracked`.
+  ///
+  ///   * `<left_joint>`/`<right_joint>`: Wheel joints of a `diff_drive`
+  ///     vehicle, or driven wheel joints of an `ackermann` vehicle. Each
+  ///     element can appear multiple times, and must appear at least once.
+  ///
+  ///   * `<front_left_joint>`/`<front_right_joint>`/`<back_left_joint>`/
+  ///     `<back_right_joint>`: Wheel joints of a `mecanum` vehicle. Each
+  ///     element can appear multiple times, and must appear at least once.
+  ///
+  ///   * `<left_steering_joint>`/`<right_steering_joint>`: Steering joints
+  ///     of an `ackermann` vehicle. Each element can appear multiple times,
+  ///     and must appear at least once.
+  ///
+  ///   * `<left_track>`/`<right_track>`: Tracks of a `tracked` vehicle, each
+  ///     driven by a TrackController system. Each element can appear
+  ///     multiple times, and must appear at least once. It contains a
+  ///     `<link>` with the name of the track link, and optionally a
+  ///     `<velocity_topic>` and `<center_of_rotation_topic>` on which the
+  ///     TrackController listens, with the same defaults as in the
+  ///     TrackedVehicle system.
+  ///
+  ///   * `<wheel_separation>`: Distance between left and right wheels, in
+  ///     meters. Defaults to 1.0m.
+  ///
+  ///   * `<wheelbase>`: Distance between front and back wheels of a
+  ///     `mecanum` vehicle, in meters. Defaults to 1.0m.
+  ///
+  ///   * `<wheel_radius>`: Wheel radius in meters. Defaults to 0.2m.
+  ///
+  ///   * `<wheel_base>`, `<kingpin_width>`, `<steering_limit>`: Distance
+  ///     between front and rear axles, distance between the steering
+  ///     kingpins and maximum steering angle of an `ackermann` vehicle.
+  ///     Default to 1.0m, 0.8m and 0.5rad, as in the AckermannSteering
+  ///     system.
+  ///
+  ///   * `<tracks_separation>`, `<steering_efficiency>`: Distance between
+  ///     left and right tracks and steering efficiency of a `tracked`
+  ///     vehicle. Default to 1.0m and 0.5. Unlike the TrackedVehicle system,
+  ///     the steering efficiency can't be changed at runtime, and odometry
+  ///     integrates the commanded track speeds, so `<track_height>` isn't
+  ///     needed.
+  ///
+  ///   * `<min_velocity>`, `<max_velocity>`, `<min_acceleration>`,
+  ///     `<max_acceleration>`, `<min_jerk>`, `<max_jerk>` and their
+  ///     `_linear_` and `_angular_` variants: Same as in the DiffDrive
+  ///     system. The linear limits also apply to the lateral velocity of
+  ///     `mecanum` vehicles. `ackermann` and `tracked` vehicles ignore
+  ///     lateral velocity.
+  ///
+  ///   * `<topic>`: Topic on which the vehicle receives `msgs::Twist`
+  ///     commands. Defaults to `/model/{model_name}/cmd_vel`.
+  ///
+  ///   * `<odom_topic>`: Topic on which the vehicle's `msgs::Odometry` is
+  ///     published. Defaults to `/model/{model_name}/odometry`. Messages are
+  ///     only generated while the topic has subscribers.
+  ///
+  /// `<odom_publish_frequency>`: Odometry publication frequency shared by all
+  /// vehicles. Defaults to 50Hz.
+  ///
+  /// `<fleet_odom_topic>`: Topic on which the odometry poses of all vehicles
+  /// are published as a single `msgs::Pose_V` message. Each pose is named
+  /// after its model and carries `frame_id` and `child_frame_id` in its
+  /// header. Defaults to `/world/{world_name}/fleet/odometry`.
+  ///
+  /// # Example
+  ///
+  /// ```
+  /// <plugin filename="ignition-gazebo-vehicle-fleet-system"
+  ///         name="ignition::gazebo::systems::VehicleFleet">
+  ///   <vehicle model="robot_0">
+  ///     <left_joint>left_wheel_joint</left_joint>
+  ///     <right_joint>right_wheel_joint</right_joint>
+  ///     <wheel_separation>1.25</wheel_separation>
+  ///     <wheel_radius>0.3</wheel_radius>
+  ///   </vehicle>
+  ///   <vehicle model="robot_1" type="mecanum">
+  ///     <front_left_joint>front_left_wheel_joint</front_left_joint>
+  ///     <front_right_joint>front_right_wheel_joint</front_right_joint>
+  ///     <back_left_joint>rear_left_wheel_joint</back_left_joint>
+  ///     <back_right_joint>rear_right_wheel_joint</back_right_joint>
+  ///     <wheel_separation>1.25</wheel_separation>
+  ///     <wheelbase>1.5</wheelbase>
+  ///     <wheel_radius>0.3</wheel_radius>
+  ///   </vehicle>
+  ///   <vehicle model="robot_2" type="ackermann">
+  ///     <left_joint>rear_left_wheel_joint</left_joint>
+  ///     <right_joint>rear_right_wheel_joint</right_joint>
+  ///     <left_steering_joint>front_left_wheel_steering_joint
+  ///       </left_steering_joint>
+  ///     <right_steering_joint>front_right_wheel_steering_joint
+  ///       </right_steering_joint>
+  ///     <wheel_separation>1.25</wheel_separation>
+  ///     <wheel_base>1.0</wheel_base>
+  ///     <wheel_radius>0.3</wheel_radius>
+  ///   </vehicle>
+  ///   <vehicle model="robot_3" type="tracked">
+  ///     <left_track><link>left_track</link></left_track>
+  ///     <right_track><link>right_track</link></right_track>
+  ///     <tracks_separation>0.5</tracks_separation>
+  ///   </vehicle>
+  /// </plugin>
+  /// ```
+  class VehicleFleet
+      : public System,
+        public ISystemConfigure,
+        public ISystemPreUpdate,
+        public ISystemPostUpdate
+  {
+    /// \brief Constructor
+    public: VehicleFleet();
+
+    /// \brief Destructor
+    public: ~VehicleFleet() override = default;
+
+    // Documentation inherited
+    public: void Configure(const Entity &_entity,
+                           const std::shared_ptr<const sdf::Element> &_sdf,
+                           EntityComponentManager &_ecm,
+                           EventManager &_eventMgr) override;
+
+    // Documentation inherited
+    public: void PreUpdate(
+                const ignition::gazebo::UpdateInfo &_info,
+                ignition::gazebo::EntityComponentManager &_ecm) override;
+
+    // Documentation inherited
+    public: void PostUpdate(
+                const UpdateInfo &_info,
+                const EntityComponentManager &_ecm) override;
+
+    /// \brief Private data pointer
+    private: std::unique_ptr<VehicleFleetPrivate> dataPtr;
+  };
+  }
+}
+}
+}
+
+#endif
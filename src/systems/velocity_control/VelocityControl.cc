@@ -15,8 +15,8 @@
  *
  */
 
+#include <functional>
 #include <map>
-#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -28,6 +28,7 @@
 
 #include "ignition/gazebo/components/AngularVelocityCmd.hh"
 #include "ignition/gazebo/components/LinearVelocityCmd.hh"
+#include "ignition/gazebo/MessageBus.hh"
 #include "ignition/gazebo/Model.hh"
 #include "ignition/gazebo/Util.hh"
 
@@ -44,9 +45,10 @@ class ignition::gazebo::systems::VelocityControlPrivate
   public: void OnCmdVel(const ignition::msgs::Twist &_msg);
 
   /// \brief Callback for link velocity subscription
+  /// \param[in] _linkName Name of the commanded link
   /// \param[in] _msg Velocity message
-  public: void OnLinkCmdVel(const ignition::msgs::Twist &_msg,
-    const ignition::transport::MessageInfo &_info);
+  public: void OnLinkCmdVel(const std::string &_linkName,
+    const ignition::msgs::Twist &_msg);
 
   /// \brief Update the linear and angular velocities.
   /// \param[in] _info System update information.
@@ -62,8 +64,8 @@ class ignition::gazebo::systems::VelocityControlPrivate
   public: void UpdateLinkVelocity(const ignition::gazebo::UpdateInfo &_info,
     const ignition::gazebo::EntityComponentManager &_ecm);
 
-  /// \brief Ignition communication node.
-  public: transport::Node node;
+  /// \brief Message bus on which commands are received
+  public: std::shared_ptr<MessageBus> bus;
 
   /// \brief Model interface
   public: Model model{kNullEntity};
@@ -77,9 +79,6 @@ class ignition::gazebo::systems::VelocityControlPrivate
   /// \brief Last target velocity requested.
   public: msgs::Twist targetVel;
 
-  /// \brief A mutex to protect the model velocity command.
-  public: std::mutex mutex;
-
   /// \brief Link names
   public: std::vector<std::string> linkNames;
 
@@ -106,9 +105,10 @@ VelocityControl::VelocityControl()
 void VelocityControl::Configure(const Entity &_entity,
     const std::shared_ptr<const sdf::Element> &_sdf,
     EntityComponentManager &_ecm,
-    EventManager &/*_eventMgr*/)
+    EventManager &_eventMgr)
 {
   this->dataPtr->model = Model(_entity);
+  this->dataPtr->bus = MessageBus::Instance(_eventMgr);
 
   if (!this->dataPtr->model.Valid(_ecm))
   {
@@ -145,7 +145,7 @@ void VelocityControl::Configure(const Entity &_entity,
   modelTopics.push_back(
     "/model/" + this->dataPtr->model.Name(_ecm) + "/cmd_vel");
   auto modelTopic = validTopic(modelTopics);
-  this->dataPtr->node.Subscribe(
+  this->dataPtr->bus->Subscribe(
     modelTopic, &VelocityControlPrivate::OnCmdVel, this->dataPtr.get());
   ignmsg << "VelocityControl subscribing to twist messages on ["
          << modelTopic << "]"
@@ -171,8 +171,10 @@ void VelocityControl::Configure(const Entity &_entity,
     std::string linkTopic{"/model/" + this->dataPtr->model.Name(_ecm) +
                              "/link/" + linkName + "/cmd_vel"};
     linkTopic = transport::TopicUtils::AsValidTopic(linkTopic);
-    this->dataPtr->node.Subscribe(
-        linkTopic, &VelocityControlPrivate::OnLinkCmdVel, this->dataPtr.get());
+    std::function<void(const msgs::Twist &)> callback =
+        std::bind(&VelocityControlPrivate::OnLinkCmdVel, this->dataPtr.get(),
+        linkName, std::placeholders::_1);
+    this->dataPtr->bus->Subscribe(linkTopic, callback);
     ignmsg << "VelocityControl subscribing to twist messages on ["
            << linkTopic << "]"
            << std::endl;
@@ -329,7 +331,6 @@ void VelocityControlPrivate::UpdateVelocity(
 {
   IGN_PROFILE("VeocityControl::UpdateVelocity");
 
-  std::lock_guard<std::mutex> lock(this->mutex);
   this->linearVelocity = msgs::Convert(this->targetVel.linear());
   this->angularVelocity = msgs::Convert(this->targetVel.angular());
 }
@@ -341,7 +342,6 @@ void VelocityControlPrivate::UpdateLinkVelocity(
 {
   IGN_PROFILE("VelocityControl::UpdateLinkVelocity");
 
-  std::lock_guard<std::mutex> lock(this->mutex);
   for (const auto& [linkName, msg] : this->linkVels)
   {
     auto linearVel = msgs::Convert(msg.linear());
@@ -355,23 +355,14 @@ void VelocityControlPrivate::UpdateLinkVelocity(
 //////////////////////////////////////////////////
 void VelocityControlPrivate::OnCmdVel(const msgs::Twist &_msg)
 {
-  std::lock_guard<std::mutex> lock(this->mutex);
   this->targetVel = _msg;
 }
 
 //////////////////////////////////////////////////
-void VelocityControlPrivate::OnLinkCmdVel(const msgs::Twist &_msg,
-                                      const transport::MessageInfo &_info)
+void VelocityControlPrivate::OnLinkCmdVel(const std::string &_linkName,
+                                          const msgs::Twist &_msg)
 {
-  std::lock_guard<std::mutex> lock(this->mutex);
-  for (const auto &linkName : this->linkNames)
-  {
-    if (_info.Topic().find("/" + linkName + "/cmd_vel") != std::string::npos)
-    {
-      this->linkVels.insert({linkName, _msg});
-      break;
-    }
-  }
+  this->linkVels.insert({_linkName, _msg});
 }
 
 IGNITION_ADD_PLUGIN(VelocityControl,
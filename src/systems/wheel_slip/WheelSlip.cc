@@ -98,8 +98,60 @@ class ignition::gazebo::systems::WheelSlipPrivate
     };
 
   /// \brief The map relating links to their respective surface parameters.
+  /// Only used while loading, the per-step data lives in `wheels`.
   public: std::map<Entity, LinkSurfaceParams> mapLinkSurfaceParams;
 
+  /// \brief Per-wheel data laid out as parallel arrays indexed by wheel, so
+  /// that the slip computation for all wheels runs as a single pass over
+  /// contiguous memory.
+  public: class WheelTable
+    {
+      /// \brief Add a wheel to the table.
+      /// \param[in] _link Wheel link entity.
+      /// \param[in] _params Surface parameters of the wheel.
+      public: void Add(const Entity _link, const LinkSurfaceParams &_params);
+
+      /// \brief Number of wheels in the table.
+      /// \return Number of wheels.
+      public: std::size_t Size() const;
+
+      /// \brief Recompute the slip factors of one wheel after its
+      /// compliances changed.
+      /// \param[in] _i Wheel index.
+      public: void UpdateFactors(std::size_t _i);
+
+      /// \brief Wheel link entities.
+      public: std::vector<Entity> links;
+
+      /// \brief Wheel spin joint entities.
+      public: std::vector<Entity> joints;
+
+      /// \brief Wheel collision entities.
+      public: std::vector<Entity> collisions;
+
+      /// \brief Unitless slip compliances in lateral direction.
+      public: std::vector<double> slipComplianceLateral;
+
+      /// \brief Unitless slip compliances in longitudinal direction.
+      public: std::vector<double> slipComplianceLongitudinal;
+
+      /// \brief Wheel radius divided by wheel normal force, in m / N.
+      public: std::vector<double> radiusOverForce;
+
+      /// \brief radiusOverForce * slipComplianceLateral.
+      public: std::vector<double> lateralFactor;
+
+      /// \brief radiusOverForce * slipComplianceLongitudinal.
+      public: std::vector<double> longitudinalFactor;
+
+      /// \brief Absolute spin rate of each wheel, gathered every step.
+      /// Negative if the joint velocity is not available yet.
+      public: std::vector<double> spinSpeed;
+    };
+
+  /// \brief All wheels handled by this plugin.
+  public: WheelTable wheels;
+
   /// \brief Vector2d equality comparison function.
   public: std::function<bool(const std::vector<double> &,
               const std::vector<double> &)>
@@ -239,88 +291,144 @@ bool WheelSlipPrivate::Load(const EntityComponentManager &_ecm,
     return false;
   }
 
+  for (const auto &linkSurface : this->mapLinkSurfaceParams)
+    this->wheels.Add(linkSurface.first, linkSurface.second);
+
   return true;
 }
 
+/////////////////////////////////////////////////
+void WheelSlipPrivate::WheelTable::Add(const Entity _link,
+    const LinkSurfaceParams &_params)
+{
+  this->links.push_back(_link);
+  this->joints.push_back(_params.joint);
+  this->collisions.push_back(_params.collision);
+  this->slipComplianceLateral.push_back(_params.slipComplianceLateral);
+  this->slipComplianceLongitudinal.push_back(
+      _params.slipComplianceLongitudinal);
+  this->radiusOverForce.push_back(
+      _params.wheelRadius / _params.wheelNormalForce);
+  this->lateralFactor.push_back(0.0);
+  this->longitudinalFactor.push_back(0.0);
+  this->spinSpeed.push_back(-1.0);
+  this->UpdateFactors(this->links.size() - 1);
+}
+
+/////////////////////////////////////////////////
+std::size_t WheelSlipPrivate::WheelTable::Size() const
+{
+  return this->links.size();
+}
+
+/////////////////////////////////////////////////
+void WheelSlipPrivate::WheelTable::UpdateFactors(std::size_t _i)
+{
+  this->lateralFactor[_i] =
+      this->radiusOverForce[_i] * this->slipComplianceLateral[_i];
+  this->longitudinalFactor[_i] =
+      this->radiusOverForce[_i] * this->slipComplianceLongitudinal[_i];
+}
+
 /////////////////////////////////////////////////
 void WheelSlipPrivate::Update(EntityComponentManager &_ecm)
 {
-  for (auto &linkSurface : this->mapLinkSurfaceParams)
+  auto &table = this->wheels;
+  const std::size_t count = table.Size();
+
+  // Slip commands are rare, so skip the lookups until one has been created.
+  if (_ecm.HasComponentType(components::WheelSlipCmd::typeId))
   {
-    auto &params = linkSurface.second;
-    const auto * wheelSlipCmdComp =
-      _ecm.Component<components::WheelSlipCmd>(linkSurface.first);
-    if (wheelSlipCmdComp)
+    for (std::size_t i = 0; i < count; ++i)
     {
+      const auto * wheelSlipCmdComp =
+        _ecm.Component<components::WheelSlipCmd>(table.links[i]);
+      if (!wheelSlipCmdComp)
+        continue;
+
       const auto & wheelSlipCmdParams = wheelSlipCmdComp->Data();
       bool changed = (!math::equal(
-          params.slipComplianceLateral,
+          table.slipComplianceLateral[i],
           wheelSlipCmdParams.slip_compliance_lateral(),
           1e-6)) ||
         (!math::equal(
-          params.slipComplianceLongitudinal,
+          table.slipComplianceLongitudinal[i],
           wheelSlipCmdParams.slip_compliance_longitudinal(),
           1e-6));
 
       if (changed)
       {
-        params.slipComplianceLateral =
+        table.slipComplianceLateral[i] =
           wheelSlipCmdParams.slip_compliance_lateral();
-        params.slipComplianceLongitudinal =
+        table.slipComplianceLongitudinal[i] =
           wheelSlipCmdParams.slip_compliance_longitudinal();
+        table.UpdateFactors(i);
       }
-      _ecm.RemoveComponent<components::WheelSlipCmd>(linkSurface.first);
+      _ecm.RemoveComponent<components::WheelSlipCmd>(table.links[i]);
     }
+  }
 
-    // get user-defined normal force constant
-    double force = params.wheelNormalForce;
-
-    auto joint = params.joint;
-
+  // Gather spin rates of all wheels
+  for (std::size_t i = 0; i < count; ++i)
+  {
     auto spinAngularVelocityComp =
-        _ecm.Component<components::JointVelocity>(joint);
+        _ecm.Component<components::JointVelocity>(table.joints[i]);
 
     if (!spinAngularVelocityComp || spinAngularVelocityComp->Data().empty())
+      table.spinSpeed[i] = -1.0;
+    else
+      table.spinSpeed[i] = std::abs(spinAngularVelocityComp->Data()[0]);
+  }
+
+  // As discussed in WheelSlip.hh, the slip1 and slip2
+  // parameters have units of inverse viscous damping:
+  // [linear velocity / force] or [m / s / N].
+  // Since the slip compliance parameters supplied to the plugin
+  // are unitless, they must be scaled by a linear speed and force
+  // magnitude.
+  // The force is taken from a user-defined constant that should roughly
+  // match the steady-state normal force at the wheel.
+  // The linear speed is computed dynamically at each time step as
+  // radius * spin angular velocity.
+  // This choice of linear speed corresponds to the denominator of
+  // the slip ratio during acceleration (see equation (1) in
+  // Yoshida, Hamano 2002 DOI 10.1109/ROBOT.2002.1013712
+  // "Motion dynamics of a rover with slip-based traction model").
+  // The acceleration form is more well-behaved numerically at low-speed
+  // and when the vehicle is at rest than the braking form,
+  // so it is used for both slip directions.
+  // The constant radius / force ratio scaled by each compliance is
+  // precomputed in the lateral and longitudinal factors.
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    if (table.spinSpeed[i] < 0)
       continue;
-    double spinAngularVelocity = spinAngularVelocityComp->Data()[0];
-
-    // As discussed in WheelSlip.hh, the slip1 and slip2
-    // parameters have units of inverse viscous damping:
-    // [linear velocity / force] or [m / s / N].
-    // Since the slip compliance parameters supplied to the plugin
-    // are unitless, they must be scaled by a linear speed and force
-    // magnitude.
-    // The force is taken from a user-defined constant that should roughly
-    // match the steady-state normal force at the wheel.
-    // The linear speed is computed dynamically at each time step as
-    // radius * spin angular velocity.
-    // This choice of linear speed corresponds to the denominator of
-    // the slip ratio during acceleration (see equation (1) in
-    // Yoshida, Hamano 2002 DOI 10.1109/ROBOT.2002.1013712
-    // "Motion dynamics of a rover with slip-based traction model").
-    // The acceleration form is more well-behaved numerically at low-speed
-    // and when the vehicle is at rest than the braking form,
-    // so it is used for both slip directions.
-    double speed = params.wheelRadius * std::abs(spinAngularVelocity);
-    double slip1 = speed / force * params.slipComplianceLateral;
-    double slip2 = speed / force * params.slipComplianceLongitudinal;
-
-    components::SlipComplianceCmd newSlipCmdComp({slip1, slip2});
 
+    double slip1 = table.spinSpeed[i] * table.lateralFactor[i];
+    double slip2 = table.spinSpeed[i] * table.longitudinalFactor[i];
+
+    // Write into the existing component when possible to avoid allocating a
+    // new vector for every wheel on every step.
     auto currSlipCmdComp =
-        _ecm.Component<components::SlipComplianceCmd>(params.collision);
+        _ecm.Component<components::SlipComplianceCmd>(table.collisions[i]);
     if (currSlipCmdComp)
     {
-      *currSlipCmdComp = newSlipCmdComp;
-      _ecm.SetChanged(params.collision, components::SlipComplianceCmd::typeId,
+      auto &slip = currSlipCmdComp->Data();
+      slip.resize(2);
+      slip[0] = slip1;
+      slip[1] = slip2;
+      _ecm.SetChanged(table.collisions[i],
+                      components::SlipComplianceCmd::typeId,
                       ComponentState::PeriodicChange);
     }
     else
     {
-      _ecm.CreateComponent(params.collision, newSlipCmdComp);
+      _ecm.CreateComponent(table.collisions[i],
+          components::SlipComplianceCmd({slip1, slip2}));
     }
   }
 }
+
 //////////////////////////////////////////////////
 WheelSlip::WheelSlip()
   : dataPtr(std::make_unique<WheelSlipPrivate>())
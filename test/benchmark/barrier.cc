@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../../src/Barrier.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Worker threads which go through a start and a stop barrier in a
+/// loop, as the simulation runner's PostUpdate threads do on every step.
+class BarrierFixture: public benchmark::Fixture
+{
+  /// \brief Start the workers.
+  /// \param[in] _threadCount Number of worker threads.
+  /// \param[in] _policy Wait policy of the barriers.
+  protected: void Start(unsigned int _threadCount,
+                        Barrier::WaitPolicy _policy)
+  {
+    this->start = std::make_unique<Barrier>(_threadCount + 1, _policy);
+    this->stop = std::make_unique<Barrier>(_threadCount + 1, _policy);
+    this->running = true;
+    for (unsigned int i = 0; i < _threadCount; ++i)
+    {
+      this->threads.push_back(std::thread([this]()
+      {
+        while (this->running)
+        {
+          this->start->Wait();
+          this->stop->Wait();
+        }
+      }));
+    }
+  }
+
+  /// \brief Stop and join the workers.
+  protected: void Stop()
+  {
+    this->running = false;
+    this->start->Cancel();
+    this->stop->Cancel();
+    for (auto &thread : this->threads)
+      thread.join();
+    this->threads.clear();
+  }
+
+  /// \brief Run steps until the benchmark is done.
+  /// \param[in] _st Benchmark state.
+  /// \param[in] _policy Wait policy of the barriers.
+  protected: void Run(benchmark::State &_st, Barrier::WaitPolicy _policy)
+  {
+    this->Start(static_cast<unsigned int>(_st.range(0)), _policy);
+    for (auto _ : _st)
+    {
+      this->start->Wait();
+      this->stop->Wait();
+    }
+    this->Stop();
+  }
+
+  std::unique_ptr<Barrier> start;
+
+  std::unique_ptr<Barrier> stop;
+
+  std::atomic<bool> running{false};
+
+  std::vector<std::thread> threads;
+};
+
+BENCHMARK_DEFINE_F(BarrierFixture, Park)
+(benchmark::State &_st)
+{
+  this->Run(_st, Barrier::WaitPolicy::PARK);
+}
+
+BENCHMARK_DEFINE_F(BarrierFixture, SpinThenPark)
+(benchmark::State &_st)
+{
+  this->Run(_st, Barrier::WaitPolicy::SPIN_THEN_PARK);
+}
+
+BENCHMARK_REGISTER_F(BarrierFixture, Park)
+  ->Arg(1)
+  ->Arg(2)
+  ->Arg(4)
+  ->Arg(8)
+  ->Arg(16)
+  ->UseRealTime()
+  ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(BarrierFixture, SpinThenPark)
+  ->Arg(1)
+  ->Arg(2)
+  ->Arg(4)
+  ->Arg(8)
+  ->Arg(16)
+  ->UseRealTime()
+  ->Unit(benchmark::kMicrosecond);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <ignition/msgs/header.pb.h>
+#include <ignition/msgs/pose_v.pb.h>
+#include <ignition/msgs/world_stats.pb.h>
+
+#include <chrono>
+#include <vector>
+
+#include <ignition/math/Pose3.hh>
+#include <ignition/msgs/Utility.hh>
+
+#include "ignition/gazebo/Conversions.hh"
+#include "ignition/gazebo/Types.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Holds one pose per entity, and a message with as many poses to
+/// reuse across iterations, as publishers do every step.
+class PoseFixture: public benchmark::Fixture
+{
+  protected: void SetUp(const ::benchmark::State &_state) override
+  {
+    auto entityCount = _state.range(0);
+    this->poses.clear();
+    this->msg.Clear();
+    for (int i = 0; i < entityCount; ++i)
+    {
+      this->poses.emplace_back(i, 2 * i, 3 * i, 0.1 * i, 0.2, 0.3);
+      this->msg.add_pose();
+    }
+  }
+
+  std::vector<math::Pose3d> poses;
+
+  msgs::Pose_V msg;
+};
+
+BENCHMARK_DEFINE_F(PoseFixture, PoseToMsgConvert)
+(benchmark::State &_st)
+{
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < this->poses.size(); ++i)
+      this->msg.mutable_pose(i)->CopyFrom(msgs::Convert(this->poses[i]));
+    benchmark::DoNotOptimize(this->msg);
+  }
+}
+
+BENCHMARK_DEFINE_F(PoseFixture, PoseToMsgSet)
+(benchmark::State &_st)
+{
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < this->poses.size(); ++i)
+      set(this->msg.mutable_pose(i), this->poses[i]);
+    benchmark::DoNotOptimize(this->msg);
+  }
+}
+
+BENCHMARK_DEFINE_F(PoseFixture, MsgToPoseConvert)
+(benchmark::State &_st)
+{
+  for (std::size_t i = 0; i < this->poses.size(); ++i)
+    set(this->msg.mutable_pose(i), this->poses[i]);
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < this->poses.size(); ++i)
+      this->poses[i] = convert<math::Pose3d>(this->msg.pose(i));
+    benchmark::DoNotOptimize(this->poses);
+  }
+}
+
+BENCHMARK_DEFINE_F(PoseFixture, MsgToPoseSet)
+(benchmark::State &_st)
+{
+  for (std::size_t i = 0; i < this->poses.size(); ++i)
+    set(this->msg.mutable_pose(i), this->poses[i]);
+
+  for (auto _ : _st)
+  {
+    for (std::size_t i = 0; i < this->poses.size(); ++i)
+      set(&this->poses[i], this->msg.pose(i));
+    benchmark::DoNotOptimize(this->poses);
+  }
+}
+
+/// \brief Stamp a header, as publishers do before every publication.
+static void StampConvert(benchmark::State &_st)
+{
+  msgs::Header header;
+  std::chrono::steady_clock::duration simTime{std::chrono::milliseconds(1)};
+  for (auto _ : _st)
+  {
+    header.mutable_stamp()->CopyFrom(convert<msgs::Time>(simTime));
+    simTime += std::chrono::milliseconds(1);
+    benchmark::DoNotOptimize(header);
+  }
+}
+
+static void StampSet(benchmark::State &_st)
+{
+  msgs::Header header;
+  std::chrono::steady_clock::duration simTime{std::chrono::milliseconds(1)};
+  for (auto _ : _st)
+  {
+    set(header.mutable_stamp(), simTime);
+    simTime += std::chrono::milliseconds(1);
+    benchmark::DoNotOptimize(header);
+  }
+}
+
+/// \brief Round trip an update info through world statistics, as the
+/// network managers and GUI do every step.
+static void UpdateInfoConvert(benchmark::State &_st)
+{
+  UpdateInfo info;
+  info.dt = std::chrono::milliseconds(1);
+  msgs::WorldStatistics msg;
+  for (auto _ : _st)
+  {
+    info.simTime += info.dt;
+    ++info.iterations;
+    msg.CopyFrom(convert<msgs::WorldStatistics>(info));
+    info = convert<UpdateInfo>(msg);
+    benchmark::DoNotOptimize(info);
+  }
+}
+
+static void UpdateInfoSet(benchmark::State &_st)
+{
+  UpdateInfo info;
+  info.dt = std::chrono::milliseconds(1);
+  msgs::WorldStatistics msg;
+  for (auto _ : _st)
+  {
+    info.simTime += info.dt;
+    ++info.iterations;
+    set(&msg, info);
+    set(&info, msg);
+    benchmark::DoNotOptimize(info);
+  }
+}
+
+BENCHMARK_REGISTER_F(PoseFixture, PoseToMsgConvert)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(1000)
+  ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(PoseFixture, PoseToMsgSet)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(1000)
+  ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(PoseFixture, MsgToPoseConvert)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(1000)
+  ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_REGISTER_F(PoseFixture, MsgToPoseSet)
+  ->Arg(10)
+  ->Arg(100)
+  ->Arg(1000)
+  ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(StampConvert);
+BENCHMARK(StampSet);
+BENCHMARK(UpdateInfoConvert);
+BENCHMARK(UpdateInfoSet);
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <vector>
+
+#include <ignition/common/Event.hh>
+
+#include "ignition/gazebo/Events.hh"
+#include "ignition/gazebo/EventManager.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Counter incremented by every callback.
+static std::atomic<int> gCalls{0};
+
+/// \brief Emit through common::EventT, which is what the EventManager used
+/// before, as a baseline.
+static void EventTSignal(benchmark::State &_st)
+{
+  events::Pause event;
+  std::vector<common::ConnectionPtr> connections;
+  for (int i = 0; i < _st.range(0); ++i)
+    connections.push_back(event.Connect([](bool){ gCalls++; }));
+
+  for (auto _ : _st)
+    event.Signal(true);
+}
+
+/// \brief Emit through the EventManager.
+static void EventManagerEmit(benchmark::State &_st)
+{
+  EventManager eventManager;
+  std::vector<common::ConnectionPtr> connections;
+  for (int i = 0; i < _st.range(0); ++i)
+  {
+    connections.push_back(
+        eventManager.Connect<events::Pause>([](bool){ gCalls++; }));
+  }
+
+  for (auto _ : _st)
+    eventManager.Emit<events::Pause>(true);
+}
+
+/// \brief Emit an event without connections, as most events are on a
+/// server without GUI or sensors.
+static void EventManagerEmitUnused(benchmark::State &_st)
+{
+  EventManager eventManager;
+  auto connection = eventManager.Connect<events::Stop>([](){ gCalls++; });
+
+  for (auto _ : _st)
+    eventManager.Emit<events::Pause>(true);
+}
+
+/// \brief Emit from several threads at once, such as sensors and GUI
+/// threads do.
+static void EventManagerEmitThreads(benchmark::State &_st)
+{
+  // Shared by all threads, connected once
+  static EventManager eventManager;
+  static std::vector<common::ConnectionPtr> connections = []()
+  {
+    std::vector<common::ConnectionPtr> result;
+    for (int i = 0; i < 4; ++i)
+    {
+      result.push_back(
+          eventManager.Connect<events::Pause>([](bool){ gCalls++; }));
+    }
+    return result;
+  }();
+
+  for (auto _ : _st)
+    eventManager.Emit<events::Pause>(true);
+}
+
+BENCHMARK(EventTSignal)
+  ->Arg(1)
+  ->Arg(4)
+  ->Arg(16);
+
+BENCHMARK(EventManagerEmit)
+  ->Arg(1)
+  ->Arg(4)
+  ->Arg(16);
+
+BENCHMARK(EventManagerEmitUnused);
+
+BENCHMARK(EventManagerEmitThreads)
+  ->ThreadRange(1, 8)
+  ->UseRealTime();
+
+// OSX needs the semicolon, Ubuntu complains that there's an extra ';'
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
@@ -22,14 +22,28 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <ignition/msgs/int32.pb.h>
 
 #include <ignition/transport/Node.hh>
+#include <sdf/Model.hh>
+#include <sdf/Root.hh>
+#include <sdf/World.hh>
 
+#include "ignition/gazebo/components/Link.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/Server.hh"
 #include "ignition/gazebo/SystemLoader.hh"
 #include "ignition/gazebo/test_config.hh"
 
+#include "../helpers/Relay.hh"
+
 using namespace ignition;
 using namespace gazebo;
 using namespace std::chrono_literals;
@@ -52,6 +66,59 @@ class ElevatorTestFixture : public ::testing::Test
       this->states.push_back(msg.data());
   }
 
+  /// \brief Load the elevator world and drive its joints from the elevator
+  /// system itself instead of joint position controller systems, using the
+  /// same gains.
+  /// \param[in] _root Root to load the world into.
+  protected: void LoadDirectControllers(sdf::Root &_root)
+  {
+    ASSERT_TRUE(_root.Load(std::string(PROJECT_SOURCE_PATH) +
+        "/test/worlds/elevator.sdf").empty());
+    ASSERT_EQ(1u, _root.WorldCount());
+    const sdf::Model *model = _root.WorldByIndex(0)->ModelByName("elevator");
+    ASSERT_NE(nullptr, model);
+
+    sdf::ElementPtr elevator;
+    std::vector<sdf::ElementPtr> controllers;
+    for (auto plugin = model->Element()->GetElement("plugin"); plugin;
+         plugin = plugin->GetNextElement("plugin"))
+    {
+      const auto name = plugin->GetAttribute("name")->GetAsString();
+      if (name == "ignition::gazebo::systems::JointPositionController")
+        controllers.push_back(plugin);
+      else if (name == "ignition::gazebo::systems::Elevator")
+        elevator = plugin;
+    }
+    ASSERT_NE(nullptr, elevator);
+    ASSERT_EQ(5u, controllers.size());
+    for (const auto &controller : controllers)
+      controller->RemoveFromParent();
+
+    using Gains = std::vector<std::pair<std::string, std::string>>;
+    auto addController = [&elevator](const std::string &_name,
+        const Gains &_gains)
+    {
+      sdf::ElementPtr desc = std::make_shared<sdf::Element>();
+      desc->SetName(_name);
+      elevator->AddElementDescription(desc);
+      sdf::ElementPtr controller = elevator->GetElement(_name);
+      for (const auto &[key, value] : _gains)
+      {
+        sdf::ElementPtr gainDesc = std::make_shared<sdf::Element>();
+        gainDesc->SetName(key);
+        controller->AddElementDescription(gainDesc);
+        sdf::ElementPtr gain = controller->GetElement(key);
+        gain->AddValue("double", value, false, "");
+        gain->Set<std::string>(value);
+      }
+    };
+    addController("cabin_controller", {{"p_gain", "4000000"},
+        {"i_gain", "2000"}, {"d_gain", "5000"}, {"i_min", "-2000"},
+        {"i_max", "2000"}, {"cmd_min", "-80000"}, {"cmd_max", "120000"}});
+    addController("door_controller", {{"p_gain", "60"}, {"i_gain", "0"},
+        {"d_gain", "40"}, {"cmd_min", "-20"}, {"cmd_max", "20"}});
+  }
+
   /// \brief Communication node
   protected: transport::Node node;
 
@@ -111,3 +178,80 @@ TEST_F(ElevatorTestFixture, Interface)
   server.Run(true, runIters, false);
   EXPECT_EQ(this->states, (std::vector<int32_t>{0, 1, 2, 1}));
 }
+
+/////////////////////////////////////////////////
+// Tests that the cabin and doors move when they're driven by the elevator
+// system itself, without joint position controller systems
+TEST_F(ElevatorTestFixture, DirectControllers)
+{
+  sdf::Root root;
+  this->LoadDirectControllers(root);
+  if (this->HasFatalFailure())
+    return;
+
+  ServerConfig serverConfig;
+  serverConfig.SetSdfString(root.Element()->ToString(""));
+
+  Server server(serverConfig);
+  server.SetUpdatePeriod(0ns);
+
+  // Record the heights of the cabin and the opening of the door of the
+  // target floor
+  std::vector<double> cabinZ;
+  std::vector<double> doorY;
+  test::Relay testSystem;
+  testSystem.OnPostUpdate([&](const gazebo::UpdateInfo &,
+    const gazebo::EntityComponentManager &_ecm)
+    {
+      auto cabin = _ecm.EntityByComponents(components::Link(),
+          components::Name("cabin"));
+      auto door = _ecm.EntityByComponents(components::Link(),
+          components::Name("door_panel_1"));
+      ASSERT_NE(kNullEntity, cabin);
+      ASSERT_NE(kNullEntity, door);
+
+      cabinZ.push_back(_ecm.Component<components::Pose>(cabin)->Data()
+          .Pos().Z());
+      doorY.push_back(_ecm.Component<components::Pose>(door)->Data()
+          .Pos().Y());
+    });
+  server.AddSystem(testSystem.systemPtr);
+
+  const std::size_t initIters = 100;
+  server.Run(true, initIters, false);
+
+  std::string stateTopic = "/model/elevator/state";
+  EXPECT_TRUE(this->node.Subscribe(stateTopic, &ElevatorTestFixture::OnStateMsg,
+                                   static_cast<ElevatorTestFixture *>(this)));
+
+  // The joints are held in place until the first command
+  server.Run(true, initIters, false);
+  std::this_thread::sleep_for(100ms);
+  EXPECT_EQ(this->states, (std::vector<int32_t>{0}));
+  ASSERT_EQ(2 * initIters, cabinZ.size());
+  EXPECT_NEAR(cabinZ.front(), cabinZ.back(), 1e-2);
+  EXPECT_NEAR(doorY.front(), doorY.back(), 1e-2);
+
+  // Move the elevator to the next floor
+  auto cmdPub = this->node.Advertise<msgs::Int32>("/model/elevator/cmd");
+  msgs::Int32 msg;
+  msg.set_data(1);
+  cmdPub.Publish(msg);
+  std::this_thread::sleep_for(100ms);
+
+  // Long enough to move, open the door, wait and close it
+  const std::size_t runIters = 30000;
+  server.Run(true, runIters, false);
+  EXPECT_EQ(this->states, (std::vector<int32_t>{0, 1}));
+
+  // The cabin reached the floor, 3.2 m above the first one
+  EXPECT_NEAR(cabinZ.front() + 3.2, cabinZ.back(), 0.05);
+
+  // The door of the floor opened while the cabin was there, and closed
+  // again after the wait
+  double maxOpening{0.0};
+  for (auto y : doorY)
+    maxOpening = std::max(maxOpening, std::abs(y - doorY.front()));
+  EXPECT_GT(maxOpening, 0.5);
+  EXPECT_NEAR(doorY.front(), doorY.back(), 0.05);
+}
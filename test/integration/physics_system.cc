@@ -2075,6 +2075,49 @@ TEST_F(PhysicsSystemFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(Heightmap))
   EXPECT_EQ(1000, maxIt);
 }
 
+/////////////////////////////////////////////////
+// A mesh whose collision is replaced by a convex hull with fewer triangles
+// than the mesh lands on the ground and rests there.
+TEST_F(PhysicsSystemFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(CollisionMesh))
+{
+  ignition::gazebo::ServerConfig serverConfig;
+
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/collision_mesh.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  gazebo::Server server(serverConfig);
+  server.SetUpdatePeriod(1us);
+
+  std::vector<math::Pose3d> duckPoses;
+  test::Relay testSystem;
+  testSystem.OnPostUpdate(
+    [&duckPoses](const gazebo::UpdateInfo &,
+    const gazebo::EntityComponentManager &_ecm)
+    {
+      _ecm.Each<components::Model, components::Name, components::Pose>(
+        [&](const ignition::gazebo::Entity &, const components::Model *,
+        const components::Name *_name, const components::Pose *_pose)->bool
+        {
+          if (_name->Data() == "duck")
+            duckPoses.push_back(_pose->Data());
+          return true;
+        });
+    });
+
+  server.AddSystem(testSystem.systemPtr);
+  server.Run(true, 3000, false);
+  ASSERT_EQ(3000u, duckPoses.size());
+
+  // The duck starts 1m high and its collision reaches 0.35m below its
+  // origin, it falls and stops on the ground instead of going through it
+  const auto &last = duckPoses.back();
+  EXPECT_LT(last.Pos().Z(), 0.9);
+  EXPECT_GT(last.Pos().Z(), 0.1);
+  EXPECT_NEAR(last.Pos().Z(), duckPoses[duckPoses.size() - 200].Pos().Z(),
+      1e-2);
+}
+
 /////////////////////////////////////////////////
 // Joint force
 TEST_F(PhysicsSystemFixture,
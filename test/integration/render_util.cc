@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/math/Inertial.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/rendering/Scene.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+#include <sdf/Light.hh>
+
+#include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/Types.hh"
+#include "ignition/gazebo/components/Inertial.hh"
+#include "ignition/gazebo/components/Light.hh"
+#include "ignition/gazebo/components/Link.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/World.hh"
+#include "ignition/gazebo/rendering/RenderUtil.hh"
+#include "ignition/gazebo/rendering/SceneManager.hh"
+
+#include "../helpers/EnvTestFixture.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Entity component manager which can be stepped like the
+/// simulation runner does.
+class SteppedEntityComponentManager : public EntityComponentManager
+{
+  /// \brief Finish a simulation step, removing the entities whose removal
+  /// was requested.
+  public: void Step()
+  {
+    this->ClearNewlyCreatedEntities();
+    this->ProcessRemoveEntityRequests();
+    this->ClearRemovedComponents();
+    this->SetAllComponentsUnchanged();
+  }
+};
+
+class RenderUtilTest : public InternalFixture<::testing::Test>
+{
+};
+
+/////////////////////////////////////////////////
+// Links and lights are added and removed by the ECM side while the render
+// thread updates the scene and toggles inertia visuals.
+TEST_F(RenderUtilTest,
+    IGN_UTILS_TEST_DISABLED_ON_MAC(AddRemoveWhileUpdating))
+{
+  SteppedEntityComponentManager ecm;
+  RenderUtil renderUtil;
+  renderUtil.SetEngineName("ogre2");
+  renderUtil.SetSceneName("render_util_test");
+
+  Entity world = ecm.CreateEntity();
+  ecm.CreateComponent(world, components::World());
+  ecm.CreateComponent(world, components::Name("default"));
+
+  Entity model = ecm.CreateEntity();
+  ecm.CreateComponent(model, components::Model());
+  ecm.CreateComponent(model, components::Name("model"));
+  ecm.CreateComponent(model, components::Pose(math::Pose3d::Zero));
+  ecm.CreateComponent(model, components::ParentEntity(world));
+
+  std::atomic<bool> running{true};
+  std::atomic<Entity> latestLink{kNullEntity};
+  unsigned int initialVisualCount{0};
+  unsigned int finalVisualCount{0};
+
+  std::thread renderThread([&]()
+  {
+    renderUtil.Init();
+    auto scene = renderUtil.Scene();
+    ASSERT_NE(nullptr, scene);
+    initialVisualCount = scene->VisualCount();
+
+    while (running)
+    {
+      renderUtil.Update();
+
+      Entity link = latestLink;
+      if (link != kNullEntity)
+      {
+        renderUtil.ViewInertia(link);
+        renderUtil.ViewCOM(link);
+      }
+    }
+
+    // Apply what's left
+    renderUtil.Update();
+    finalVisualCount = scene->VisualCount();
+  });
+
+  UpdateInfo info;
+  Entity link{kNullEntity};
+  Entity light{kNullEntity};
+  std::vector<Entity> removed;
+  const unsigned int steps = 500;
+  for (unsigned int i = 0; i <= steps; ++i)
+  {
+    info.iterations = i;
+    if (link != kNullEntity)
+    {
+      ecm.RequestRemoveEntity(link);
+      ecm.RequestRemoveEntity(light);
+      removed.push_back(link);
+      removed.push_back(light);
+    }
+
+    // Everything is removed on the last step
+    if (i < steps)
+    {
+      link = ecm.CreateEntity();
+      ecm.CreateComponent(link, components::Link());
+      ecm.CreateComponent(link, components::Name("link_" + std::to_string(i)));
+      ecm.CreateComponent(link, components::Pose(math::Pose3d::Zero));
+      ecm.CreateComponent(link, components::ParentEntity(model));
+      math::Inertiald inertial;
+      inertial.SetMassMatrix(math::MassMatrix3d(1.0, {1.0, 1.0, 1.0}, {}));
+      ecm.CreateComponent(link, components::Inertial(inertial));
+
+      sdf::Light sdfLight;
+      sdfLight.SetType(sdf::LightType::POINT);
+      sdfLight.SetName("light_" + std::to_string(i));
+      light = ecm.CreateEntity();
+      ecm.CreateComponent(light, components::Light(sdfLight));
+      ecm.CreateComponent(light, components::Name(sdfLight.Name()));
+      ecm.CreateComponent(light, components::ParentEntity(model));
+    }
+
+    renderUtil.UpdateFromECM(info, ecm);
+    ecm.Step();
+    latestLink = link;
+  }
+
+  running = false;
+  renderThread.join();
+
+  // Only the model is left, the links, lights, and the inertia, center of
+  // mass and light visuals created for them are removed
+  auto &sceneManager = renderUtil.SceneManager();
+  EXPECT_TRUE(sceneManager.HasEntity(model));
+  for (const auto &entity : removed)
+    EXPECT_FALSE(sceneManager.HasEntity(entity)) << entity;
+  EXPECT_EQ(initialVisualCount + 1, finalVisualCount);
+}
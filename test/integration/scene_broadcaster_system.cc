@@ -28,10 +28,14 @@
 #pragma warning(pop)
 #endif
 
+#include <sstream>
 #include <thread>
 
+#include <ignition/msgs/param.pb.h>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Util.hh>
+#include "ignition/gazebo/components/Factory.hh"
 #include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/Pose.hh"
@@ -1020,6 +1024,116 @@ TEST_P(SceneBroadcasterTest,
   EXPECT_EQ(1, count);
 }
 
+/////////////////////////////////////////////////
+TEST_P(SceneBroadcasterTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(FilteredState))
+{
+  // Start server
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/shapes.sdf");
+
+  gazebo::Server server(serverConfig);
+  EXPECT_EQ(24u, *server.EntityCount());
+
+  // Run server without blocking, requests are served on PostUpdate
+  server.Run(true, 1, false);
+  server.Run(false, 0, false);
+
+  transport::Node node;
+  auto request = [&](const std::string &_name, int _depth,
+      const std::string &_components, msgs::SerializedStepMap &_res)
+  {
+    msgs::Param req;
+    auto &params = *req.mutable_params();
+    params["name"].set_type(msgs::Any::STRING);
+    params["name"].set_string_value(_name);
+    params["depth"].set_type(msgs::Any::INT32);
+    params["depth"].set_int_value(_depth);
+    params["components"].set_type(msgs::Any::STRING);
+    params["components"].set_string_value(_components);
+
+    bool result{false};
+    EXPECT_TRUE(node.Request("/world/default/state/filtered", req, 5000,
+        _res, result));
+    return result;
+  };
+
+  auto hasName = [](const msgs::SerializedEntityMap &_entity,
+      const std::string &_name)
+  {
+    auto it = _entity.components().find(gazebo::components::Name::typeId);
+    if (it == _entity.components().end())
+      return false;
+    gazebo::components::Name name;
+    std::istringstream istr(it->second.component());
+    name.Deserialize(istr);
+    return name.Data() == _name;
+  };
+
+  // Whole model subtree: model, link, collision and visual
+  {
+    msgs::SerializedStepMap res;
+    EXPECT_TRUE(request("box", -1, "", res));
+    EXPECT_TRUE(res.has_stats());
+    EXPECT_EQ(4, res.state().entities_size());
+  }
+
+  // Model only, with pose only
+  {
+    const auto poseName = gazebo::components::Factory::Instance()->Name(
+        gazebo::components::Pose::typeId);
+
+    msgs::SerializedStepMap res;
+    EXPECT_TRUE(request("box", 0, poseName, res));
+    ASSERT_EQ(1, res.state().entities_size());
+    const auto &entity = res.state().entities().begin()->second;
+    ASSERT_EQ(1, entity.components_size());
+    EXPECT_EQ(gazebo::components::Pose::typeId,
+        entity.components().begin()->first);
+  }
+
+  // Scoped name
+  {
+    msgs::SerializedStepMap res;
+    EXPECT_TRUE(request("box::box_link", 0, "", res));
+    ASSERT_EQ(1, res.state().entities_size());
+    EXPECT_TRUE(hasName(res.state().entities().begin()->second, "box_link"));
+  }
+
+  // World and its children
+  {
+    msgs::SerializedStepMap res;
+    EXPECT_TRUE(request("", 1, "", res));
+    EXPECT_GT(24, res.state().entities_size());
+    bool foundWorld{false};
+    bool foundBox{false};
+    for (const auto &entity : res.state().entities())
+    {
+      foundWorld = foundWorld || hasName(entity.second, "default");
+      foundBox = foundBox || hasName(entity.second, "box");
+      EXPECT_FALSE(hasName(entity.second, "box_link"));
+    }
+    EXPECT_TRUE(foundWorld);
+    EXPECT_TRUE(foundBox);
+  }
+
+  // Missing entity is not an error, but the state is empty
+  {
+    msgs::SerializedStepMap res;
+    EXPECT_TRUE(request("not_a_model", -1, "", res));
+    EXPECT_TRUE(res.has_state());
+    EXPECT_EQ(0, res.state().entities_size());
+  }
+
+  // Unknown component types are an error
+  {
+    msgs::SerializedStepMap res;
+    EXPECT_FALSE(request("box", 0, "not_a_component", res));
+  }
+
+  server.Stop();
+}
+
 // Run multiple times
 INSTANTIATE_TEST_SUITE_P(ServerRepeat, SceneBroadcasterTest,
     ::testing::Range(1, 2));
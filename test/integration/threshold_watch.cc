@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <ignition/msgs/param_v.pb.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "ignition/gazebo/MessageBus.hh"
+#include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/System.hh"
+#include "ignition/gazebo/test_config.hh"
+
+#include "../helpers/EnvTestFixture.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Test ThresholdWatch system
+class ThresholdWatchTest : public InternalFixture<::testing::Test>
+{
+};
+
+/// \brief Transitions received for each model on one watch, in order.
+using Transitions = std::map<std::string, std::vector<bool>>;
+
+/// \brief System that records the transitions of the watches through the
+/// world's message bus, so they're received in the simulation thread.
+class WatchListener : public System, public ISystemConfigure
+{
+  // Documentation inherited
+  public: void Configure(const Entity &,
+                         const std::shared_ptr<const sdf::Element> &,
+                         EntityComponentManager &,
+                         EventManager &_eventMgr) override
+  {
+    auto bus = MessageBus::Instance(_eventMgr);
+    for (const auto &topic : {"/world/threshold_watch/watch/speeding",
+                              "/world/threshold_watch/watch/impacts",
+                              "/geofence"})
+    {
+      std::function<void(const msgs::Param_V &)> cb =
+          [this](const msgs::Param_V &_msg)
+          {
+            EXPECT_TRUE(_msg.has_header());
+            for (const auto &param : _msg.param())
+            {
+              const auto &params = param.params();
+              const auto watch = params.at("watch").string_value();
+              const auto model = params.at("model").string_value();
+              this->transitions[watch][model].push_back(
+                  params.at("triggered").boolean_value());
+            }
+          };
+      EXPECT_TRUE(bus->Subscribe(topic, cb));
+    }
+  }
+
+  /// \brief Transitions, keyed by watch name.
+  public: std::map<std::string, Transitions> transitions;
+};
+
+/////////////////////////////////////////////////
+TEST_F(ThresholdWatchTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(FallingModels))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/threshold_watch.sdf");
+
+  Server server(serverConfig);
+
+  auto listener = std::make_shared<WatchListener>();
+  server.AddSystem(listener);
+
+  server.Run(true, 3000, false);
+
+  auto &transitions = listener->transitions;
+
+  // Spheres sped up while falling and stopped on the ground. Transitions
+  // alternate, so each model is reported once per edge.
+  const auto &speeding = transitions["speeding"];
+  EXPECT_EQ(2u, speeding.size());
+  for (const auto &model : {"sphere_0", "sphere_1"})
+  {
+    ASSERT_EQ(1u, speeding.count(model)) << model;
+    const auto &edges = speeding.at(model);
+    ASSERT_GE(edges.size(), 2u) << model;
+    EXPECT_TRUE(edges.front()) << model;
+    EXPECT_FALSE(edges.back()) << model;
+    for (std::size_t i = 1; i < edges.size(); ++i)
+      EXPECT_NE(edges[i - 1], edges[i]) << model;
+  }
+
+  // Both spheres lost energy on impact
+  const auto &impacts = transitions["impacts"];
+  EXPECT_EQ(2u, impacts.size());
+  for (const auto &model : {"sphere_0", "sphere_1"})
+  {
+    ASSERT_EQ(1u, impacts.count(model)) << model;
+    EXPECT_TRUE(impacts.at(model).front()) << model;
+  }
+
+  // Everything ends up below the geofence, and stays there
+  const auto &geofence = transitions["geofence"];
+  EXPECT_EQ(4u, geofence.size());
+  for (const auto &model : {"ground_plane", "sphere_0", "sphere_1", "crate"})
+  {
+    ASSERT_EQ(1u, geofence.count(model)) << model;
+    EXPECT_EQ(std::vector<bool>({true}), geofence.at(model)) << model;
+  }
+}
@@ -17,12 +17,16 @@
 
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <string>
+
 #include <ignition/msgs/entity_factory.pb.h>
 #include <ignition/msgs/light.pb.h>
 #include <ignition/msgs/physics.pb.h>
 #include <ignition/msgs/visual.pb.h>
 
 #include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
 #include <ignition/common/Util.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/transport/Node.hh>
@@ -332,6 +336,102 @@ TEST_F(UserCommandsTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Create))
 
   EXPECT_NE(kNullEntity, ecm->EntityByComponents(components::Model(),
       components::Name("test_model")));
+
+  // Spawn from the same file again, which was already parsed
+  req.set_allow_renaming(true);
+
+  EXPECT_TRUE(node.Request(service, req, timeout, res, result));
+  EXPECT_TRUE(result);
+  EXPECT_TRUE(res.data());
+
+  server.Run(true, 1, false);
+  EXPECT_EQ(entityCount + 8, ecm->EntityCount());
+
+  EXPECT_NE(kNullEntity, ecm->EntityByComponents(components::Model(),
+      components::Name("test_model_0")));
+}
+
+/////////////////////////////////////////////////
+TEST_F(UserCommandsTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(CreateEditedInclude))
+{
+  // Start server
+  ServerConfig serverConfig;
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/empty.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  Server server(serverConfig);
+
+  EntityComponentManager *ecm{nullptr};
+  test::Relay testSystem;
+  testSystem.OnPreUpdate([&](const gazebo::UpdateInfo &,
+                             gazebo::EntityComponentManager &_ecm)
+      {
+        ecm = &_ecm;
+      });
+
+  server.AddSystem(testSystem.systemPtr);
+  server.Run(true, 1, false);
+  ASSERT_NE(nullptr, ecm);
+
+  // Model which includes another model
+  auto dir = common::joinPaths(PROJECT_BINARY_PATH, "user_commands_include");
+  auto innerDir = common::joinPaths(dir, "inner");
+  common::removeAll(dir);
+  ASSERT_TRUE(common::createDirectories(innerDir));
+
+  auto writeInner = [&](const std::string &_linkName)
+  {
+    std::ofstream config(common::joinPaths(innerDir, "model.config"));
+    config << "<?xml version='1.0'?><model><name>inner</name>"
+           << "<sdf version='1.6'>model.sdf</sdf></model>";
+    std::ofstream inner(common::joinPaths(innerDir, "model.sdf"));
+    inner << "<?xml version='1.0'?><sdf version='1.6'>"
+          << "<model name='inner'><link name='" << _linkName << "'/>"
+          << "</model></sdf>";
+  };
+  writeInner("link");
+
+  auto outerFile = common::joinPaths(dir, "outer.sdf");
+  {
+    std::ofstream outer(outerFile);
+    outer << "<?xml version='1.0'?><sdf version='1.6'>"
+          << "<model name='outer'><include><uri>" << innerDir
+          << "</uri></include></model></sdf>";
+  }
+
+  transport::Node node;
+  msgs::EntityFactory req;
+  msgs::Boolean res;
+  bool result;
+  unsigned int timeout = 5000;
+  std::string service{"/world/empty/create"};
+
+  req.set_sdf_filename(outerFile);
+  req.set_allow_renaming(true);
+
+  EXPECT_TRUE(node.Request(service, req, timeout, res, result));
+  EXPECT_TRUE(result);
+  EXPECT_TRUE(res.data());
+
+  server.Run(true, 1, false);
+  EXPECT_NE(kNullEntity, ecm->EntityByComponents(components::Link(),
+      components::Name("link")));
+
+  // Edit only the included file, the spawned file is parsed again
+  writeInner("edited_link");
+
+  EXPECT_TRUE(node.Request(service, req, timeout, res, result));
+  EXPECT_TRUE(result);
+  EXPECT_TRUE(res.data());
+
+  server.Run(true, 1, false);
+  EXPECT_NE(kNullEntity, ecm->EntityByComponents(components::Model(),
+      components::Name("outer_0")));
+  EXPECT_NE(kNullEntity, ecm->EntityByComponents(components::Link(),
+      components::Name("edited_link")));
+
+  common::removeAll(dir);
 }
 
 /////////////////////////////////////////////////
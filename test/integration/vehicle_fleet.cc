@@ -0,0 +1,447 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <ignition/msgs/double.pb.h>
+#include <ignition/msgs/odometry.pb.h>
+#include <ignition/msgs/pose_v.pb.h>
+#include <ignition/msgs/twist.pb.h>
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/transport/Node.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/test_config.hh"
+
+#include "../helpers/Relay.hh"
+#include "../helpers/EnvTestFixture.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace std::chrono_literals;
+
+/// \brief Test VehicleFleet system
+class VehicleFleetTest : public InternalFixture<::testing::Test>
+{
+  /// \brief Load a test world, replacing a single vehicle plugin with a
+  /// VehicleFleet world plugin.
+  /// \param[in] _world File name of the world in test/worlds.
+  /// \param[in] _plugin Name of the single vehicle plugin to remove.
+  /// \param[in] _vehicle `<vehicle>` element declaring the same vehicle.
+  /// \return The edited world.
+  protected: std::string FleetWorld(const std::string &_world,
+      const std::string &_plugin, const std::string &_vehicle)
+  {
+    std::ifstream file(std::string(PROJECT_SOURCE_PATH) + "/test/worlds/" +
+        _world);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string sdf = buffer.str();
+
+    const auto name = sdf.find(_plugin);
+    EXPECT_NE(std::string::npos, name);
+    const auto begin = sdf.rfind("<plugin", name);
+    const std::string endTag{"</plugin>"};
+    const auto end = sdf.find(endTag, name) + endTag.size();
+    sdf.erase(begin, end - begin);
+
+    sdf.insert(sdf.rfind("</world>"),
+        "<plugin filename='ignition-gazebo-vehicle-fleet-system' "
+        "name='ignition::gazebo::systems::VehicleFleet'>" + _vehicle +
+        "</plugin>");
+    return sdf;
+  }
+};
+
+/////////////////////////////////////////////////
+TEST_F(VehicleFleetTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(PublishCmd))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/vehicle_fleet.sdf");
+
+  Server server(serverConfig);
+  server.SetUpdatePeriod(0ns);
+
+  // Record the poses of both vehicles
+  test::Relay testSystem;
+  std::vector<math::Pose3d> poses0;
+  std::vector<math::Pose3d> poses1;
+  testSystem.OnPostUpdate([&](const gazebo::UpdateInfo &,
+    const gazebo::EntityComponentManager &_ecm)
+    {
+      auto id0 = _ecm.EntityByComponents(components::Model(),
+          components::Name("vehicle_0"));
+      auto id1 = _ecm.EntityByComponents(components::Model(),
+          components::Name("vehicle_1"));
+      ASSERT_NE(kNullEntity, id0);
+      ASSERT_NE(kNullEntity, id1);
+
+      poses0.push_back(_ecm.Component<components::Pose>(id0)->Data());
+      poses1.push_back(_ecm.Component<components::Pose>(id1)->Data());
+    });
+  server.AddSystem(testSystem.systemPtr);
+
+  // Vehicles don't move without commands
+  server.Run(true, 1000, false);
+  ASSERT_EQ(1000u, poses0.size());
+  EXPECT_EQ(poses0.front(), poses0.back());
+  EXPECT_EQ(poses1.front(), poses1.back());
+
+  std::mutex mutex;
+  msgs::Pose_V lastFleetMsg;
+  std::function<void(const msgs::Pose_V &)> fleetCb =
+    [&](const msgs::Pose_V &_msg)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      lastFleetMsg = _msg;
+    };
+
+  int odomCount{0};
+  std::function<void(const msgs::Odometry &)> odomCb =
+    [&](const msgs::Odometry &)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++odomCount;
+    };
+
+  transport::Node node;
+  node.Subscribe("/world/vehicle_fleet/fleet/odometry", fleetCb);
+  node.Subscribe("/model/vehicle_0/odometry", odomCb);
+
+  // Only command the first vehicle
+  auto pub = node.Advertise<msgs::Twist>("/model/vehicle_0/cmd_vel");
+  msgs::Twist msg;
+  msgs::Set(msg.mutable_linear(), math::Vector3d(0.5, 0, 0));
+  msgs::Set(msg.mutable_angular(), math::Vector3d(0.0, 0, 0.2));
+
+  int sleep = 0;
+  int maxSleep = 30;
+  for (; !pub.HasConnections() && sleep < maxSleep; ++sleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_NE(maxSleep, sleep);
+  pub.Publish(msg);
+
+  // Step until the odometry subscription is seen by the system, so all
+  // steps below publish odometry
+  sleep = 0;
+  for (; sleep < maxSleep; ++sleep)
+  {
+    server.Run(true, 100, false);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (odomCount > 0)
+      break;
+  }
+  ASSERT_NE(maxSleep, sleep);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    odomCount = 0;
+  }
+  const std::size_t startIndex = poses0.size();
+
+  server.Run(true, 3000, false);
+  ASSERT_EQ(startIndex + 3000u, poses0.size());
+
+  // The commanded vehicle moved, the other one didn't
+  EXPECT_LT(poses0[0].Pos().X(), poses0.back().Pos().X());
+  EXPECT_LT(poses0[0].Rot().Yaw(), poses0.back().Rot().Yaw());
+  EXPECT_NEAR(poses1[0].Pos().X(), poses1.back().Pos().X(), 1e-3);
+  EXPECT_NEAR(poses1[0].Pos().Y(), poses1.back().Pos().Y(), 1e-3);
+
+  sleep = 0;
+  for (; sleep < maxSleep; ++sleep)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (odomCount >= 150 && lastFleetMsg.pose_size() > 0)
+        break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_NE(maxSleep, sleep);
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // 3s at 50Hz
+  EXPECT_GE(odomCount, 150);
+
+  // One aggregated pose per vehicle
+  ASSERT_EQ(2, lastFleetMsg.pose_size());
+  EXPECT_EQ("vehicle_0", lastFleetMsg.pose(0).name());
+  EXPECT_EQ("vehicle_1", lastFleetMsg.pose(1).name());
+
+  // Odometry is relative to the starting pose
+  EXPECT_GT(lastFleetMsg.pose(0).position().x(), 0.5);
+  EXPECT_NEAR(0.0, lastFleetMsg.pose(1).position().x(), 1e-3);
+  EXPECT_NEAR(0.0, lastFleetMsg.pose(1).position().y(), 1e-3);
+}
+
+/////////////////////////////////////////////////
+// The wheels of a mecanum vehicle floating without gravity spin freely, so
+// odometry integrated from them follows the commanded lateral velocity.
+TEST_F(VehicleFleetTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(MecanumLateral))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/vehicle_fleet_mecanum.sdf");
+
+  Server server(serverConfig);
+  server.SetUpdatePeriod(0ns);
+
+  std::mutex mutex;
+  msgs::Odometry lastOdomMsg;
+  int odomCount{0};
+  std::function<void(const msgs::Odometry &)> odomCb =
+    [&](const msgs::Odometry &_msg)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      lastOdomMsg = _msg;
+      ++odomCount;
+    };
+
+  transport::Node node;
+  node.Subscribe("/model/mecanum/odometry", odomCb);
+
+  auto pub = node.Advertise<msgs::Twist>("/model/mecanum/cmd_vel");
+  int sleep = 0;
+  int maxSleep = 30;
+  for (; !pub.HasConnections() && sleep < maxSleep; ++sleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_NE(maxSleep, sleep);
+
+  // Sideways only
+  msgs::Twist msg;
+  msgs::Set(msg.mutable_linear(), math::Vector3d(0, 0.4, 0));
+  pub.Publish(msg);
+
+  server.Run(true, 2000, false);
+
+  sleep = 0;
+  for (; sleep < maxSleep; ++sleep)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (odomCount > 0)
+        break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_NE(maxSleep, sleep);
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // The lateral wheel coefficients cancel along x and around z
+  EXPECT_NEAR(0.4, lastOdomMsg.twist().linear().y(), 1e-2);
+  EXPECT_NEAR(0.0, lastOdomMsg.twist().linear().x(), 1e-2);
+  EXPECT_NEAR(0.0, lastOdomMsg.twist().angular().z(), 1e-2);
+  EXPECT_GT(lastOdomMsg.pose().position().y(), 0.5);
+  EXPECT_NEAR(0.0, lastOdomMsg.pose().position().x(), 1e-2);
+  EXPECT_NEAR(0.0, msgs::Convert(lastOdomMsg.pose().orientation()).Yaw(),
+      1e-2);
+}
+
+/////////////////////////////////////////////////
+TEST_F(VehicleFleetTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Ackermann))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfString(this->FleetWorld("ackermann_steering.sdf",
+      "ignition::gazebo::systems::AckermannSteering",
+      "<vehicle model='vehicle' type='ackermann'>"
+      "<left_joint>front_left_wheel_joint</left_joint>"
+      "<left_joint>rear_left_wheel_joint</left_joint>"
+      "<right_joint>front_right_wheel_joint</right_joint>"
+      "<right_joint>rear_right_wheel_joint</right_joint>"
+      "<left_steering_joint>front_left_wheel_steering_joint"
+      "</left_steering_joint>"
+      "<right_steering_joint>front_right_wheel_steering_joint"
+      "</right_steering_joint>"
+      "<kingpin_width>1.0</kingpin_width>"
+      "<steering_limit>0.5</steering_limit>"
+      "<wheel_base>1.0</wheel_base>"
+      "<wheel_separation>1.25</wheel_separation>"
+      "<wheel_radius>0.3</wheel_radius>"
+      "</vehicle>"));
+
+  Server server(serverConfig);
+  server.SetUpdatePeriod(0ns);
+
+  test::Relay testSystem;
+  std::vector<math::Pose3d> poses;
+  testSystem.OnPostUpdate([&](const gazebo::UpdateInfo &,
+    const gazebo::EntityComponentManager &_ecm)
+    {
+      auto id = _ecm.EntityByComponents(components::Model(),
+          components::Name("vehicle"));
+      ASSERT_NE(kNullEntity, id);
+      poses.push_back(_ecm.Component<components::Pose>(id)->Data());
+    });
+  server.AddSystem(testSystem.systemPtr);
+
+  std::mutex mutex;
+  msgs::Odometry lastOdomMsg;
+  int odomCount{0};
+  std::function<void(const msgs::Odometry &)> odomCb =
+    [&](const msgs::Odometry &_msg)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      lastOdomMsg = _msg;
+      ++odomCount;
+    };
+
+  transport::Node node;
+  node.Subscribe("/model/vehicle/odometry", odomCb);
+
+  auto pub = node.Advertise<msgs::Twist>("/model/vehicle/cmd_vel");
+  int sleep = 0;
+  int maxSleep = 30;
+  for (; !pub.HasConnections() && sleep < maxSleep; ++sleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_NE(maxSleep, sleep);
+
+  // Turn left
+  msgs::Twist msg;
+  msgs::Set(msg.mutable_linear(), math::Vector3d(0.5, 0, 0));
+  msgs::Set(msg.mutable_angular(), math::Vector3d(0.0, 0, 0.2));
+  pub.Publish(msg);
+
+  server.Run(true, 3000, false);
+  ASSERT_EQ(3000u, poses.size());
+
+  // The vehicle drove forward along a left turn
+  EXPECT_LT(poses[0].Pos().X(), poses.back().Pos().X());
+  EXPECT_LT(poses[0].Pos().Y(), poses.back().Pos().Y());
+  EXPECT_LT(poses[0].Rot().Yaw(), poses.back().Rot().Yaw());
+
+  sleep = 0;
+  for (; sleep < maxSleep; ++sleep)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (odomCount > 0)
+        break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_NE(maxSleep, sleep);
+
+  // Odometry follows the steered arc
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_GT(lastOdomMsg.pose().position().x(), 0.0);
+  EXPECT_GT(lastOdomMsg.pose().position().y(), 0.0);
+  EXPECT_GT(msgs::Convert(lastOdomMsg.pose().orientation()).Yaw(), 0.0);
+  EXPECT_GT(lastOdomMsg.twist().angular().z(), 0.0);
+}
+
+/////////////////////////////////////////////////
+// Tracks are commanded through their TrackController systems, using the
+// same kinematics as the TrackedVehicle system.
+TEST_F(VehicleFleetTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Tracked))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfString(this->FleetWorld("tracked_vehicle_simple.sdf",
+      "ignition::gazebo::systems::TrackedVehicle",
+      "<vehicle model='simple_tracked' type='tracked'>"
+      "<left_track><link>left_track</link></left_track>"
+      "<left_track><link>front_left_flipper</link></left_track>"
+      "<left_track><link>rear_left_flipper</link></left_track>"
+      "<right_track><link>right_track</link></right_track>"
+      "<right_track><link>front_right_flipper</link></right_track>"
+      "<right_track><link>rear_right_flipper</link></right_track>"
+      "<tracks_separation>0.4</tracks_separation>"
+      "<steering_efficiency>0.5</steering_efficiency>"
+      "</vehicle>"));
+
+  Server server(serverConfig);
+  server.SetUpdatePeriod(0ns);
+
+  std::mutex mutex;
+  double leftSpeed{0.0};
+  double rightSpeed{0.0};
+  int leftCount{0};
+  std::function<void(const msgs::Double &)> leftCb =
+    [&](const msgs::Double &_msg)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      leftSpeed = _msg.data();
+      ++leftCount;
+    };
+  std::function<void(const msgs::Double &)> rightCb =
+    [&](const msgs::Double &_msg)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      rightSpeed = _msg.data();
+    };
+
+  transport::Node node;
+  node.Subscribe("/model/simple_tracked/link/left_track/track_cmd_vel",
+      leftCb);
+  node.Subscribe("/model/simple_tracked/link/right_track/track_cmd_vel",
+      rightCb);
+
+  auto pub = node.Advertise<msgs::Twist>("/model/simple_tracked/cmd_vel");
+  int sleep = 0;
+  int maxSleep = 30;
+  for (; !pub.HasConnections() && sleep < maxSleep; ++sleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_NE(maxSleep, sleep);
+
+  msgs::Twist msg;
+  msgs::Set(msg.mutable_linear(), math::Vector3d(1.0, 0, 0));
+  msgs::Set(msg.mutable_angular(), math::Vector3d(0.0, 0, 0.2));
+  pub.Publish(msg);
+
+  server.Run(true, 100, false);
+
+  // 1.0 -/+ 0.2 * 0.4 / (2 * 0.5)
+  sleep = 0;
+  for (; sleep < maxSleep; ++sleep)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (std::abs(leftSpeed - 0.92) < 1e-6)
+        break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  ASSERT_NE(maxSleep, sleep);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_NEAR(1.08, rightSpeed, 1e-6);
+
+  // Speeds are only sent when they change: at most the initial stop and the
+  // command
+  EXPECT_LE(leftCount, 2);
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/transport/Node.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/test_config.hh"
+
+#include "../helpers/EnvTestFixture.hh"
+#include "../helpers/Relay.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Test world checkpoints
+class WorldCheckpointTest : public InternalFixture<::testing::Test>
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(WorldCheckpointTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(SaveAndRestore))
+{
+  const auto checkpointPath =
+      common::joinPaths(PROJECT_BINARY_PATH, "test_world_checkpoint.ckpt");
+  common::removeFile(checkpointPath);
+
+  // Poses of the models when the checkpoint was taken
+  std::map<std::string, math::Pose3d> savedPoses;
+  std::size_t savedEntityCount{0};
+
+  {
+    ServerConfig serverConfig;
+    serverConfig.SetSdfFile(common::joinPaths(PROJECT_SOURCE_PATH,
+        "test", "worlds", "shapes.sdf"));
+    Server server(serverConfig);
+
+    test::Relay relay;
+    relay.OnPostUpdate([&](const UpdateInfo &,
+                           const EntityComponentManager &_ecm)
+        {
+          savedEntityCount = _ecm.EntityCount();
+          _ecm.Each<components::Model, components::Name, components::Pose>(
+              [&](const Entity &, const components::Model *,
+                  const components::Name *_name,
+                  const components::Pose *_pose) -> bool
+              {
+                savedPoses[_name->Data()] = _pose->Data();
+                return true;
+              });
+        });
+    server.AddSystem(relay.systemPtr);
+
+    server.Run(true, 100, false);
+
+    // The checkpoint is taken at the end of the next step
+    transport::Node node;
+    msgs::StringMsg req;
+    req.set_data(checkpointPath);
+    msgs::Boolean res;
+    bool result{false};
+    EXPECT_TRUE(node.Request("/world/default/checkpoint", req, 5000, res,
+        result));
+    EXPECT_TRUE(result);
+    EXPECT_TRUE(res.data());
+
+    server.Run(true, 1, false);
+    EXPECT_EQ(101u, *server.IterationCount());
+  }
+
+  // The checkpoint is written by the time the server is destroyed
+  ASSERT_TRUE(common::exists(checkpointPath));
+  ASSERT_FALSE(savedPoses.empty());
+
+  ServerConfig serverConfig;
+  EXPECT_TRUE(serverConfig.SetCheckpointRestorePath(checkpointPath));
+  EXPECT_EQ(ServerConfig::SourceType::kCheckpoint, serverConfig.Source());
+  Server server(serverConfig);
+
+  // Simulation resumes where it was
+  EXPECT_EQ(101u, *server.IterationCount());
+  EXPECT_EQ(savedEntityCount, *server.EntityCount());
+  for (const auto &[name, pose] : savedPoses)
+    EXPECT_TRUE(server.HasEntity(name)) << name;
+
+  // Same systems, the physics system keeps the restored models moving from
+  // where they were
+  std::map<std::string, math::Pose3d> restoredPoses;
+  test::Relay relay;
+  relay.OnPreUpdate([&](const UpdateInfo &_info,
+                        EntityComponentManager &_ecm)
+      {
+        if (_info.iterations != 102u)
+          return;
+
+        _ecm.Each<components::Model, components::Name, components::Pose>(
+            [&](const Entity &, const components::Model *,
+                const components::Name *_name,
+                const components::Pose *_pose) -> bool
+            {
+              restoredPoses[_name->Data()] = _pose->Data();
+              return true;
+            });
+      });
+  server.AddSystem(relay.systemPtr);
+
+  server.Run(true, 1, false);
+  EXPECT_EQ(102u, *server.IterationCount());
+
+  EXPECT_EQ(savedPoses.size(), restoredPoses.size());
+  for (const auto &[name, pose] : savedPoses)
+  {
+    ASSERT_EQ(1u, restoredPoses.count(name)) << name;
+    EXPECT_EQ(pose, restoredPoses[name]) << name;
+  }
+
+  common::removeFile(checkpointPath);
+}